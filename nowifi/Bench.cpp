@@ -0,0 +1,365 @@
+/*
+ * Benchmark suite driver.
+ *
+ *   cmake -S .. -B ../build && cmake --build ../build --target bench
+ *   cl /std:c++17 /O2 /EHsc /openmp /I.. Bench.cpp
+ *   g++ -std=c++17 -O2 -fopenmp -I.. -include compiler/msvc_stl.hpp Bench.cpp -o bench
+ *
+ *   bench [--filter=<substring>] [--json=<file>] [--min-time-ms=<n>] [--repetitions=<n>] [--counters]
+ */
+
+#include <nowifi/array/multi_array.hpp>
+
+#include <nowifi/io/scanner.hpp>
+#include <nowifi/io/writer.hpp>
+
+#include <nowifi/math/modular.hpp>
+
+#include <nowifi/string/from_string.hpp>
+#include <nowifi/string/to_string.hpp>
+
+#include <nowifi/util/bench.hpp>
+#include <nowifi/util/hash.hpp>
+#include <nowifi/util/perf.hpp>
+#include <nowifi/util/unique.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace nw;
+
+std::vector<int> make_ints(size_t count, int lo, int hi)
+{
+	std::mt19937 gen(12345);
+	std::uniform_int_distribution<int> dist(lo, hi);
+	std::vector<int> result(count);
+	for (int& value : result) value = dist(gen);
+	return result;
+}
+
+std::vector<std::string> make_keys(size_t count, size_t length)
+{
+	std::vector<std::string> keys(count);
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		keys[idx].resize(length);
+		for (size_t ch = 0; ch < length; ch++)
+		{
+			keys[idx][ch] = static_cast<char>('a' + (idx * 31 + ch * 7) % 26);
+		}
+	}
+	return keys;
+}
+
+//-------------------- io --------------------//
+
+void register_io(bench::Suite& suite)
+{
+	const std::vector<size_t> sizes{ 1000, 100000 };
+
+	suite.add_sweep("scanner/readArray<int>", sizes, [](size_t count) {
+		const std::vector<int> ints = make_ints(count, -1000000, 1000000);
+		std::ostringstream os;
+		Writer(os).writeArray(ints.data(), count, " ");
+		auto text = std::make_shared<const std::string>(os.str());
+		auto buffer = std::make_shared<std::vector<int>>(count);
+
+		return bench::Case{ [text, buffer]() {
+			std::istringstream is(*text);
+			Scanner(is).readArray(buffer->data(), buffer->size());
+			bench::do_not_optimize(buffer->back());
+		}, static_cast<double>(text->size()), static_cast<double>(count) };
+	});
+
+	suite.add_sweep("scanner/nextWord", sizes, [](size_t count) {
+		const std::vector<std::string> keys = make_keys(count, 8);
+		std::ostringstream os;
+		Writer(os).stl_writeArray(keys.begin(), keys.end(), " ");
+		auto text = std::make_shared<const std::string>(os.str());
+
+		return bench::Case{ [text, count]() {
+			std::istringstream is(*text);
+			Scanner scanner(is);
+			size_t total = 0;
+			for (size_t idx = 0; idx < count; idx++) total += scanner.nextWord().size();
+			bench::do_not_optimize(total);
+		}, static_cast<double>(text->size()), static_cast<double>(count) };
+	});
+
+	suite.add_sweep("writer/writeArray<int>", sizes, [](size_t count) {
+		auto ints = std::make_shared<const std::vector<int>>(make_ints(count, -1000000, 1000000));
+		auto os = std::make_shared<std::ostringstream>();
+		Writer(*os).writeArray(ints->data(), count, " ");
+		const double bytes = static_cast<double>(os->tellp());
+
+		return bench::Case{ [ints, os]() {
+			os->seekp(0);
+			Writer(*os).writeArray(ints->data(), ints->size(), " ");
+			bench::do_not_optimize(os->tellp());
+		}, bytes, static_cast<double>(count) };
+	});
+}
+
+//-------------------- string --------------------//
+
+void register_string(bench::Suite& suite)
+{
+	constexpr size_t count = 1000;
+	auto ints = std::make_shared<const std::vector<int>>(make_ints(count, -1000000, 1000000));
+
+	auto int_strings = std::make_shared<std::vector<std::string>>();
+	auto double_strings = std::make_shared<std::vector<std::string>>();
+	for (int value : *ints)
+	{
+		int_strings->push_back(to_string::dec(value));
+		double_strings->push_back(to_string::fixed(value / 1000.0));
+	}
+
+	suite.add("from_string/toInt", [int_strings]() {
+		long long total = 0;
+		for (const std::string& str : *int_strings) total += from_string::toInt(str);
+		bench::do_not_optimize(total);
+	}, 0, count);
+
+	suite.add("from_string/toDouble", [double_strings]() {
+		double total = 0;
+		for (const std::string& str : *double_strings) total += from_string::toDouble(str);
+		bench::do_not_optimize(total);
+	}, 0, count);
+
+	suite.add("to_string/dec<int>", [ints]() {
+		size_t total = 0;
+		for (int value : *ints) total += to_string::dec(value).size();
+		bench::do_not_optimize(total);
+	}, 0, count);
+
+	suite.add("to_string/hex<int>", [ints]() {
+		size_t total = 0;
+		for (int value : *ints) total += to_string::hex(value).size();
+		bench::do_not_optimize(total);
+	}, 0, count);
+}
+
+//-------------------- hash --------------------//
+
+template <class Function>
+void register_hash_one(bench::Suite& suite, const std::string& name, Function fn)
+{
+	// About 64 KiB of keys per op, so every length sees the same cache footprint
+	suite.add_sweep(name, std::vector<size_t>{ 8, 64, 1024, 65536 }, [fn](size_t length) {
+		const size_t count = std::max<size_t>((size_t(1) << 16) / length, 1);
+		auto keys = std::make_shared<const std::vector<std::string>>(make_keys(count, length));
+
+		return bench::Case{ [keys, fn]() {
+			unsigned long long sink = 0;
+			for (const std::string& key : *keys) sink += fn(key);
+			bench::do_not_optimize(sink);
+		}, static_cast<double>(count * length), static_cast<double>(count) };
+	});
+}
+
+void register_hash(bench::Suite& suite)
+{
+	register_hash_one(suite, "hash/nw::Hash", [](const std::string& key) { return static_cast<unsigned long long>(nw::Hash(key)); });
+	register_hash_one(suite, "hash/std::hash", [](const std::string& key) { return static_cast<unsigned long long>(std::hash<std::string>()(key)); });
+	register_hash_one(suite, "hash/hash64::hash", [](const std::string& key) { return hash64::hash(key); });
+	register_hash_one(suite, "hash/hash64::stream", [](const std::string& key) { return hash64::stream().update(key).digest(); });
+}
+
+//-------------------- unique --------------------//
+
+void register_unique(bench::Suite& suite)
+{
+	constexpr size_t count = 100000;
+
+	suite.add_sweep("unique/inc<int>", std::vector<int>{ 16, 4096, 65536 }, [](int distinct) {
+		auto values = std::make_shared<const std::vector<int>>(make_ints(count, 0, distinct - 1));
+
+		return bench::Case{ [values]() {
+			unique::map<int> counts;
+			for (int value : *values) unique::inc(counts, value);
+			bench::do_not_optimize(counts.size());
+		}, 0, static_cast<double>(count) };
+	});
+
+	suite.add_sweep("unique/inc<string>", std::vector<int>{ 16, 4096 }, [](int distinct) {
+		auto keys = std::make_shared<std::vector<std::string>>();
+		for (int value : make_ints(count, 0, distinct - 1)) keys->push_back(to_string::dec(value));
+
+		return bench::Case{ [keys]() {
+			unique::map<std::string> counts;
+			for (const std::string& key : *keys) unique::inc(counts, key);
+			bench::do_not_optimize(counts.size());
+		}, 0, static_cast<double>(count) };
+	});
+}
+
+//-------------------- multi_array --------------------//
+
+// Owns a multi_array2D of int for the lifetime of a sweep point
+struct bench_array2D
+{
+	multi_array2D::index_type size;
+	multi_array2D::iterator<int> arr;
+	multi_array2D::iterator<int> result;
+
+	explicit bench_array2D(size_t side)
+		: size{ side, side }
+	{
+		arr = multi_array2D::generate_i_new<int>(size, [](const multi_array2D::index_type& pos) {
+			return static_cast<int>(pos.array[0] * 31 + pos.array[1]) % 1000;
+		});
+		result = multi_array2D::allocate<int>(size);
+	}
+
+	bench_array2D(const bench_array2D&) = delete;
+	bench_array2D& operator=(const bench_array2D&) = delete;
+
+	~bench_array2D()
+	{
+		multi_array2D::deallocate(arr, size);
+		multi_array2D::deallocate(result, size);
+	}
+
+	double elements() const
+	{
+		return static_cast<double>(size.array[0] * size.array[1]);
+	}
+};
+
+void register_multi_array(bench::Suite& suite)
+{
+	const std::vector<size_t> sides{ 64, 1024 };
+
+	suite.add_sweep("multi_array/count", sides, [](size_t side) {
+		auto data = std::make_shared<bench_array2D>(side);
+		return bench::Case{ [data]() {
+			bench::do_not_optimize(multi_array2D::count(data->arr, data->size, 7));
+		}, data->elements() * sizeof(int), data->elements() };
+	});
+
+	suite.add_sweep("multi_array/find", sides, [](size_t side) {
+		auto data = std::make_shared<bench_array2D>(side);
+		return bench::Case{ [data]() {
+			bench::do_not_optimize(multi_array2D::find(data->arr, data->size, -1));
+		}, data->elements() * sizeof(int), data->elements() };
+	});
+
+	suite.add_sweep("multi_array/fill", sides, [](size_t side) {
+		auto data = std::make_shared<bench_array2D>(side);
+		return bench::Case{ [data]() {
+			multi_array2D::fill(data->result, data->size, 1);
+			bench::clobber_memory();
+		}, data->elements() * sizeof(int), data->elements() };
+	});
+
+	suite.add_sweep("multi_array/transform", sides, [](size_t side) {
+		auto data = std::make_shared<bench_array2D>(side);
+		return bench::Case{ [data]() {
+			multi_array2D::transform(data->arr, data->size, data->result, [](int value) { return value * 3 + 1; });
+			bench::clobber_memory();
+		}, 2 * data->elements() * sizeof(int), data->elements() };
+	});
+
+	suite.add_sweep("multi_array/for_each", sides, [](size_t side) {
+		auto data = std::make_shared<bench_array2D>(side);
+		return bench::Case{ [data]() {
+			multi_array2D::for_each(data->result, data->size, [](int& value) { value++; });
+			bench::clobber_memory();
+		}, 2 * data->elements() * sizeof(int), data->elements() };
+	});
+}
+
+//-------------------- modular --------------------//
+
+void register_modular(bench::Suite& suite)
+{
+	static constexpr long long MOD = 1000000007;
+	using Math = ModularMath_LL<MOD>;
+	constexpr size_t count = 1000;
+
+	auto bases = std::make_shared<std::vector<long long>>();
+	for (int value : make_ints(count, 2, 1000000)) bases->push_back(value);
+
+	suite.add("modular/multiply", [bases]() {
+		long long product = 1;
+		for (long long base : *bases) product = Math::multiply(product, base);
+		bench::do_not_optimize(product);
+	}, 0, count);
+
+	suite.add("modular/power", [bases]() {
+		long long total = 0;
+		for (long long base : *bases) total += Math::power(base, 1000003);
+		bench::do_not_optimize(total);
+	}, 0, count);
+
+	suite.add("modular/inverse", [bases]() {
+		long long total = 0;
+		for (long long base : *bases) total += Math::inverse(base, MOD);
+		bench::do_not_optimize(total);
+	}, 0, count);
+
+	suite.add("modular/factorial_nomem", []() {
+		long long n = 100000;
+		bench::do_not_optimize(n);
+		bench::do_not_optimize(Math::factorial_nomem(n));
+	}, 0, 100000);
+}
+
+//-------------------- main --------------------//
+
+int main(int argc, char** argv)
+{
+	std::string filter;
+	std::string json;
+	bench::Options options;
+
+	for (int idx = 1; idx < argc; idx++)
+	{
+		const std::string arg = argv[idx];
+		const size_t eq = arg.find('=');
+		const std::string key = arg.substr(0, eq);
+		const std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+
+		if (key == "--filter") filter = value;
+		else if (key == "--json") json = value;
+		else if (key == "--min-time-ms") options.min_time = std::chrono::milliseconds(from_string::toInt(value));
+		else if (key == "--repetitions") options.repetitions = static_cast<size_t>(from_string::toInt(value));
+		else if (key == "--counters") options.counters = true;
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--filter=<substring>] [--json=<file>] [--min-time-ms=<n>] [--repetitions=<n>] [--counters]" << std::endl;
+			return 2;
+		}
+	}
+
+	bench::Suite suite;
+	register_io(suite);
+	register_string(suite);
+	register_hash(suite);
+	register_unique(suite);
+	register_multi_array(suite);
+	register_modular(suite);
+
+	if (options.counters && !perf::supported()) std::cerr << "hardware counters unavailable, timing only" << std::endl;
+
+	bench::Suite::print_header(std::cout);
+	const std::vector<bench::Result> results = suite.run(filter, options, std::cout);
+
+	if (!json.empty())
+	{
+		std::ofstream out(json);
+		bench::write_json(out, results, options);
+		if (!out)
+		{
+			std::cerr << "cannot write " << json << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -1,5 +1,6 @@
 #include <nowifi/array/linear_multi_array.hpp>
 #include <nowifi/array/multi_array.hpp>
+#include <nowifi/array/span.hpp>
 #include <nowifi/array/std_array.hpp>
 #include <nowifi/array/stl.hpp>
 #include <nowifi/array/uvector.hpp>
@@ -7,8 +8,11 @@
 #include <nowifi/compiler/assert.hpp>
 #include <nowifi/compiler/class.hpp>
 #include <nowifi/compiler/loop.hpp>
+#include <nowifi/compiler/msvc_stl.hpp>
 #include <nowifi/compiler/ternary_exec.hpp>
 
+#include <nowifi/io/binary.hpp>
+#include <nowifi/io/compress.hpp>
 #include <nowifi/io/inputSeparator.hpp>
 #include <nowifi/io/scanner.hpp>
 #include <nowifi/io/writer.hpp>
@@ -22,26 +26,50 @@
 #include <nowifi/math/safe.hpp>
 
 #include <nowifi/math/reducer/minmax.hpp>
+#include <nowifi/math/reducer/parallel.hpp>
+#include <nowifi/math/reducer/reduce.hpp>
+#include <nowifi/math/reducer/scan.hpp>
+#include <nowifi/math/reducer/simd.hpp>
+#include <nowifi/math/reducer/stats.hpp>
 #include <nowifi/math/reducer/sum.hpp>
+#include <nowifi/math/reducer/summation.hpp>
+#include <nowifi/math/reducer/window.hpp>
 
 #include <nowifi/pack/compare.hpp>
 
 #include <nowifi/string/former.hpp>
 #include <nowifi/string/from_string.hpp>
+#include <nowifi/string/pool.hpp>
 #include <nowifi/string/splitter.hpp>
 #include <nowifi/string/to_string.hpp>
 #include <nowifi/string/traits.hpp>
 
 #include <nowifi/util/map/binOps.hpp>
 #include <nowifi/util/map/charMap.hpp>
+#include <nowifi/util/map/flatMap.hpp>
 
+#include <nowifi/util/bench.hpp>
+#include <nowifi/util/bitpack.hpp>
+#include <nowifi/util/checksum.hpp>
+#include <nowifi/util/concurrentQueue.hpp>
+#include <nowifi/util/concurrentUnique.hpp>
 #include <nowifi/util/consumer.hpp>
+#include <nowifi/util/cpu.hpp>
 #include <nowifi/util/error.hpp>
+#include <nowifi/util/expected.hpp>
+#include <nowifi/util/filter.hpp>
 #include <nowifi/util/fixed.hpp>
 #include <nowifi/util/hash.hpp>
+#include <nowifi/util/metrics.hpp>
+#include <nowifi/util/perf.hpp>
+#include <nowifi/util/perfectHash.hpp>
+#include <nowifi/util/profile.hpp>
 #include <nowifi/util/rawbin.hpp>
+#include <nowifi/util/ringBuffer.hpp>
+#include <nowifi/util/sketch.hpp>
 #include <nowifi/util/time.hpp>
 #include <nowifi/util/unique.hpp>
+#include <nowifi/util/varint.hpp>
 
 #include <omp.h>
 #include <stdio.h>
@@ -144,10 +172,10 @@ void test_uvector()
 		<< vec.arr[3] << std::endl;
 }
 
-void main() {
+int main() {
 	//test_std_array();
 	//test_multi_array();
 	test_uvector();
-	
-	system("pause");
+
+	return 0;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <nowifi/compiler/class.hpp>
 #include <nowifi/array/uvector.hpp>
+#include <nowifi/util/metrics.hpp>
 #include <algorithm>
 #include <stdexcept>
 
@@ -96,7 +97,7 @@ namespace nw {
 		static iterator<Ty> allocate(const index_type& size)
 		{
 			size_t _size = size.first;
-			iterator<Ty> arr = new item_type<Ty>[_size];
+			iterator<Ty> arr = new typename below_type::template iterator<Ty>[_size];
 #pragma omp parallel for
 			for (int idx = 0; idx < _size; idx++)
 			{
@@ -154,7 +155,7 @@ namespace nw {
 		 * @return **See above**
 		 */
 		template <class Ty> _NODISCARD inline
-		static const Ty& get_const(typename iterator<Ty> const arr, const index_type& pos)
+		static const Ty& get_const(iterator<Ty> const arr, const index_type& pos)
 		{
 			return below_type::template get_const<Ty>(arr[pos.first], pos.after_first);
 		}
@@ -1041,6 +1042,43 @@ namespace nw {
 			return newarr;
 		}
 
+		//-------------------- Serialization --------------------//
+
+		/*
+		 * Feeds the elements to <enc> row by row, in index order.
+		 *
+		 * @param <arr> - Pointer to array
+		 * @param <size> - Size of array
+		 * @param <enc> - Streaming encoder with put(const Ty*, size_t)
+		 *                (bitpack::PackedArray, VarintEncoder, ...)
+		 */
+		template <class Ty, class Encoder> inline
+		static void dump(iterator<Ty> arr, const index_type& size, Encoder& enc)
+		{
+			for (size_t idx = 0; idx < size.first; idx++)
+			{
+				below_type::template dump<Ty, Encoder>(arr[idx], size.after_first, enc);
+			}
+		}
+
+		/*
+		 * Fills the elements from <dec> row by row, in index order.
+		 *
+		 * @param <arr> - Pointer to array
+		 * @param <size> - Size of array
+		 * @param <dec> - Streaming decoder with size_t next(Ty*, size_t)
+		 *                (bitpack::PackedView::reader, VarintDecoder, ...)
+		 * @exception std::out_of_range - <dec> ran out of values
+		 */
+		template <class Ty, class Decoder> inline
+		static void load(iterator<Ty> arr, const index_type& size, Decoder& dec)
+		{
+			for (size_t idx = 0; idx < size.first; idx++)
+			{
+				below_type::template load<Ty, Decoder>(arr[idx], size.after_first, dec);
+			}
+		}
+
 	}; // class multi_array
 
 	////////////////////////////////                ////////////////////////////////
@@ -1127,6 +1165,8 @@ namespace nw {
 		template <class Ty> _NODISCARD inline
 		static iterator<Ty> allocate(const index_type& size)
 		{
+			NW_METRIC_ADD("multi_array.rows_allocated", 1);
+			NW_METRIC_GAUGE_ADD("multi_array.live_bytes", size.first * sizeof(Ty));
 			return new Ty[size.first];
 		}
 		
@@ -1139,6 +1179,7 @@ namespace nw {
 		template <class Ty> inline
 		static void deallocate(iterator<Ty> arr, const index_type& size)
 		{
+			NW_METRIC_GAUGE_ADD("multi_array.live_bytes", -static_cast<int64_t>(size.first * sizeof(Ty)));
 			delete[] arr;
 		}
 
@@ -1914,6 +1955,37 @@ namespace nw {
 			return newarr;
 		}
 
+		//-------------------- Serialization --------------------//
+
+		/*
+		 * Feeds the elements to <enc> as one row.
+		 *
+		 * @param <arr> - Pointer to array
+		 * @param <size> - Size of array
+		 * @param <enc> - Streaming encoder with put(const Ty*, size_t)
+		 */
+		template <class Ty, class Encoder> inline
+		static void dump(iterator<Ty> arr, const index_type& size, Encoder& enc)
+		{
+			NW_METRIC_ADD("multi_array.elements_dumped", size.first);
+			enc.put(arr, size.first);
+		}
+
+		/*
+		 * Fills the elements from <dec> as one row.
+		 *
+		 * @param <arr> - Pointer to array
+		 * @param <size> - Size of array
+		 * @param <dec> - Streaming decoder with size_t next(Ty*, size_t)
+		 * @exception std::out_of_range - <dec> ran out of values
+		 */
+		template <class Ty, class Decoder> inline
+		static void load(iterator<Ty> arr, const index_type& size, Decoder& dec)
+		{
+			NW_METRIC_ADD("multi_array.elements_loaded", size.first);
+			if (dec.next(arr, size.first) != size.first) throw std::out_of_range("multi_array::load: not enough values");
+		}
+
 	}; // class multi_array<1>
 
 	////////////////////////////////                ////////////////////////////////
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace nw {
+
+	////////////////////////////////      ////////////////////////////////
+	//------------------------------      ------------------------------//
+	//------------------------------ span ------------------------------//
+	//------------------------------      ------------------------------//
+	////////////////////////////////      ////////////////////////////////
+
+	/*
+	 * Non-owning view of <size> contiguous elements (std::span subset for C++17).
+	 */
+	template <class Ty>
+	class span
+	{
+	public:
+
+		using element_type = Ty;
+		using value_type = std::remove_cv_t<Ty>;
+		using size_type = size_t;
+		using pointer = Ty*;
+		using reference = Ty&;
+		using iterator = Ty*;
+
+	protected:
+
+		Ty* _data = nullptr;
+		size_t _size = 0;
+
+	public:
+
+		constexpr span() noexcept = default;
+
+		constexpr span(Ty* data, size_t size) noexcept
+			: _data(data), _size(size) { }
+
+		constexpr span(Ty* first, Ty* last) noexcept
+			: _data(first), _size(static_cast<size_t>(last - first)) { }
+
+		template <size_t N>
+		constexpr span(Ty (&arr)[N]) noexcept
+			: _data(arr), _size(N) { }
+
+		// Containers with data() and size() (std::vector, std::array, std::string, ...)
+		template <class Container, class = std::enable_if_t<std::is_convertible<decltype(std::declval<Container&>().data()), Ty*>::value>>
+		constexpr span(Container& container) noexcept
+			: _data(container.data()), _size(container.size()) { }
+
+		// span<Ty> -> span<const Ty>
+		template <class OtherTy, class = std::enable_if_t<std::is_convertible<OtherTy(*)[], Ty(*)[]>::value>>
+		constexpr span(const span<OtherTy>& second) noexcept
+			: _data(second.data()), _size(second.size()) { }
+
+		//-------------------- access --------------------//
+
+		[[nodiscard]] constexpr Ty* data() const noexcept { return _data; }
+		[[nodiscard]] constexpr size_t size() const noexcept { return _size; }
+		[[nodiscard]] constexpr size_t size_bytes() const noexcept { return _size * sizeof(Ty); }
+		[[nodiscard]] constexpr bool empty() const noexcept { return _size == 0; }
+
+		[[nodiscard]] constexpr Ty& operator[](size_t idx) const noexcept { return _data[idx]; }
+
+		[[nodiscard]] constexpr Ty& at(size_t idx) const
+		{
+			if (idx >= _size) throw std::out_of_range("span: index out of range");
+			return _data[idx];
+		}
+
+		[[nodiscard]] constexpr Ty& front() const noexcept { return _data[0]; }
+		[[nodiscard]] constexpr Ty& back() const noexcept { return _data[_size - 1]; }
+
+		[[nodiscard]] constexpr Ty* begin() const noexcept { return _data; }
+		[[nodiscard]] constexpr Ty* end() const noexcept { return _data + _size; }
+
+		//-------------------- subviews --------------------//
+
+		[[nodiscard]] constexpr span first(size_t count) const noexcept
+		{
+			return span(_data, count);
+		}
+
+		[[nodiscard]] constexpr span last(size_t count) const noexcept
+		{
+			return span(_data + _size - count, count);
+		}
+
+		[[nodiscard]] constexpr span subspan(size_t offset, size_t count = static_cast<size_t>(-1)) const noexcept
+		{
+			return span(_data + offset, count == static_cast<size_t>(-1) ? _size - offset : count);
+		}
+
+	}; // class span
+
+	template <class Ty>
+	[[nodiscard]] span<const unsigned char> as_bytes(span<Ty> view) noexcept
+	{
+		return span<const unsigned char>(reinterpret_cast<const unsigned char*>(view.data()), view.size_bytes());
+	}
+
+	template <class Ty>
+	[[nodiscard]] span<unsigned char> as_writable_bytes(span<Ty> view) noexcept
+	{
+		static_assert(!std::is_const<Ty>::value, "as_writable_bytes: const elements");
+		return span<unsigned char>(reinterpret_cast<unsigned char*>(view.data()), view.size_bytes());
+	}
+
+} // namespace nw
@@ -0,0 +1,13 @@
+#pragma once
+
+// Macros of the MSVC standard library the headers use. Other standard
+// libraries do not define them: force-include this header there
+// (g++ -include nowifi/compiler/msvc_stl.hpp, as CMakeLists.txt does).
+
+#ifndef _NODISCARD
+#define _NODISCARD [[nodiscard]]
+#endif
+
+#ifndef _CONSTEXPR17
+#define _CONSTEXPR17 constexpr
+#endif
@@ -0,0 +1,537 @@
+#pragma once
+
+#include <nowifi/array/span.hpp>
+
+#include <memory>
+#include <new>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+namespace nw {
+
+	//-------------------- endian --------------------//
+
+	enum class endian
+	{
+		little,
+		big,
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		native = big
+#else
+		native = little
+#endif
+	};
+
+	namespace bin {
+
+		using byte_type = unsigned char;
+
+		[[nodiscard]] inline uint16_t byteswap(uint16_t value) noexcept
+		{
+#if defined(_MSC_VER)
+			return _byteswap_ushort(value);
+#else
+			return __builtin_bswap16(value);
+#endif
+		}
+
+		[[nodiscard]] inline uint32_t byteswap(uint32_t value) noexcept
+		{
+#if defined(_MSC_VER)
+			return _byteswap_ulong(value);
+#else
+			return __builtin_bswap32(value);
+#endif
+		}
+
+		[[nodiscard]] inline uint64_t byteswap(uint64_t value) noexcept
+		{
+#if defined(_MSC_VER)
+			return _byteswap_uint64(value);
+#else
+			return __builtin_bswap64(value);
+#endif
+		}
+
+		// Values that can be stored in a non-native byte order
+		template <class Ty>
+		constexpr bool is_swappable = std::is_arithmetic<Ty>::value || std::is_enum<Ty>::value;
+
+		/*
+		 * Copies <count> elements from <src> to <dst> (raw bytes), converting
+		 * between native order and <Order>. Either side may be unaligned.
+		 */
+		template <endian Order, class Ty>
+		inline void copy_order(void* dst, const void* src, size_t count) noexcept
+		{
+			static_assert(std::is_trivially_copyable<Ty>::value, "bin: trivially copyable types only");
+			if constexpr (Order == endian::native || sizeof(Ty) == 1)
+			{
+				std::memcpy(dst, src, count * sizeof(Ty));
+			}
+			else
+			{
+				static_assert(is_swappable<Ty>, "bin: non-native byte order needs arithmetic or enum elements");
+				using word_type = std::conditional_t<sizeof(Ty) == 2, uint16_t, std::conditional_t<sizeof(Ty) == 4, uint32_t, uint64_t>>;
+				static_assert(sizeof(word_type) == sizeof(Ty), "bin: unsupported element size");
+				auto* out = static_cast<byte_type*>(dst);
+				const auto* in = static_cast<const byte_type*>(src);
+				for (size_t idx = 0; idx < count; idx++)
+				{
+					word_type word;
+					std::memcpy(&word, in + idx * sizeof(Ty), sizeof(Ty));
+					word = byteswap(word);
+					std::memcpy(out + idx * sizeof(Ty), &word, sizeof(Ty));
+				}
+			}
+		}
+
+		[[nodiscard]] constexpr bool is_alignment(size_t alignment) noexcept
+		{
+			return alignment != 0 && (alignment & (alignment - 1)) == 0;
+		}
+
+		/*
+		 * @exception std::invalid_argument - <alignment> is 0 or not a power of two
+		 */
+		inline void check_alignment(size_t alignment)
+		{
+			if (!is_alignment(alignment)) throw std::invalid_argument("bin: alignment must be a power of two");
+		}
+
+		// <alignment> must pass is_alignment()
+		[[nodiscard]] constexpr size_t align_up(size_t offset, size_t alignment) noexcept
+		{
+			return (offset + alignment - 1) & ~(alignment - 1);
+		}
+
+		//-------------------- buffer --------------------//
+
+		/*
+		 * Owning byte buffer with a guaranteed start alignment (default: cache line),
+		 * so arrays written at aligned offsets can be viewed in place.
+		 *
+		 * @exception std::invalid_argument - <alignment> is 0 or not a power of two
+		 */
+		class buffer
+		{
+		protected:
+
+			struct _deleter
+			{
+				size_t alignment;
+
+				void operator()(byte_type* ptr) const noexcept
+				{
+					::operator delete[](ptr, std::align_val_t(alignment));
+				}
+			};
+
+			std::unique_ptr<byte_type[], _deleter> _data;
+			size_t _size = 0;
+
+		public:
+
+			static constexpr size_t default_alignment = 64;
+
+			buffer() noexcept
+				: _data(nullptr, _deleter{ default_alignment }) { }
+
+			explicit buffer(size_t size, size_t alignment = default_alignment)
+				: _data(nullptr, _deleter{ alignment }), _size(size)
+			{
+				check_alignment(alignment);
+				_data.reset(static_cast<byte_type*>(::operator new[](size == 0 ? 1 : size, std::align_val_t(alignment))));
+			}
+
+			[[nodiscard]] byte_type* data() noexcept { return _data.get(); }
+			[[nodiscard]] const byte_type* data() const noexcept { return _data.get(); }
+			[[nodiscard]] size_t size() const noexcept { return _size; }
+
+			[[nodiscard]] span<byte_type> bytes() noexcept { return span<byte_type>(_data.get(), _size); }
+			[[nodiscard]] span<const byte_type> bytes() const noexcept { return span<const byte_type>(_data.get(), _size); }
+
+			[[nodiscard]] std::string str() const
+			{
+				return std::string(reinterpret_cast<const char*>(_data.get()), _size);
+			}
+
+		}; // class buffer
+
+	} // namespace bin
+
+	////////////////////////////////             ////////////////////////////////
+	//------------------------------             ------------------------------//
+	//------------------------------ BinarySizer ------------------------------//
+	//------------------------------             ------------------------------//
+	////////////////////////////////             ////////////////////////////////
+
+	/*
+	 * Dry run of BinaryWriter: same calls, only counts bytes (padding included).
+	 *
+	 *   const size_t size = BinarySizer().write(header).write_array(arr, n).size();
+	 *
+	 * @exception std::invalid_argument - An alignment that is 0 or not a power of two
+	 */
+	class BinarySizer
+	{
+	protected:
+
+		size_t _size = 0;
+
+	public:
+
+		template <class Ty>
+		BinarySizer& write(const Ty&) noexcept
+		{
+			_size += sizeof(Ty);
+			return *this;
+		}
+
+		template <class Ty>
+		BinarySizer& write_array(const Ty*, size_t count, size_t alignment = alignof(Ty))
+		{
+			this->align(alignment);
+			_size += count * sizeof(Ty);
+			return *this;
+		}
+
+		template <class Ty>
+		BinarySizer& write_span(span<Ty> values, size_t alignment = alignof(Ty))
+		{
+			return this->write_array(values.data(), values.size(), alignment);
+		}
+
+		BinarySizer& write_bytes(const void*, size_t size) noexcept
+		{
+			_size += size;
+			return *this;
+		}
+
+		BinarySizer& align(size_t alignment)
+		{
+			bin::check_alignment(alignment);
+			_size = bin::align_up(_size, alignment);
+			return *this;
+		}
+
+		[[nodiscard]] size_t size() const noexcept
+		{
+			return _size;
+		}
+
+	}; // class BinarySizer
+
+	////////////////////////////////              ////////////////////////////////
+	//------------------------------              ------------------------------//
+	//------------------------------ BinaryWriter ------------------------------//
+	//------------------------------              ------------------------------//
+	////////////////////////////////              ////////////////////////////////
+
+	/*
+	 * Writes trivially copyable values into a caller-provided buffer.
+	 *
+	 * Scalars are packed without padding; write_array() first pads to
+	 * <alignment> (relative to the buffer start) so a BinaryReader on an
+	 * equally aligned buffer can view() the array in place.
+	 *
+	 * @exception std::out_of_range - Buffer too small
+	 * @exception std::invalid_argument - An alignment that is 0 or not a power of two
+	 */
+	template <endian Order = endian::little>
+	class basic_BinaryWriter
+	{
+	protected:
+
+		using byte_type = bin::byte_type;
+
+		byte_type* _begin;
+		byte_type* _cursor;
+		byte_type* _end;
+
+		byte_type* _take(size_t size)
+		{
+			if (static_cast<size_t>(_end - _cursor) < size) throw std::out_of_range("BinaryWriter: buffer overflow");
+			byte_type* result = _cursor;
+			_cursor += size;
+			return result;
+		}
+
+		// _take() for <count> elements, checked before count * sizeof(Ty) can wrap
+		template <class Ty>
+		byte_type* _take_array(size_t count)
+		{
+			if (count > static_cast<size_t>(_end - _cursor) / sizeof(Ty)) throw std::out_of_range("BinaryWriter: buffer overflow");
+			return this->_take(count * sizeof(Ty));
+		}
+
+	public:
+
+		static constexpr endian order = Order;
+
+		basic_BinaryWriter(void* buffer, size_t size) noexcept
+			: _begin(static_cast<byte_type*>(buffer)), _cursor(_begin), _end(_begin + size) { }
+
+		explicit basic_BinaryWriter(bin::buffer& buffer) noexcept
+			: basic_BinaryWriter(buffer.data(), buffer.size()) { }
+
+		template <class Ty>
+		basic_BinaryWriter& write(const Ty& value)
+		{
+			bin::copy_order<Order, Ty>(this->_take(sizeof(Ty)), &value, 1);
+			return *this;
+		}
+
+		template <class Ty>
+		basic_BinaryWriter& write_array(const Ty* arr, size_t count, size_t alignment = alignof(Ty))
+		{
+			this->align(alignment);
+			bin::copy_order<Order, Ty>(this->_take_array<Ty>(count), arr, count);
+			return *this;
+		}
+
+		template <class Ty>
+		basic_BinaryWriter& write_span(span<Ty> values, size_t alignment = alignof(Ty))
+		{
+			return this->write_array(values.data(), values.size(), alignment);
+		}
+
+		basic_BinaryWriter& write_bytes(const void* data, size_t size)
+		{
+			std::memcpy(this->_take(size), data, size);
+			return *this;
+		}
+
+		// Zero-pads to a multiple of <alignment> from the buffer start
+		basic_BinaryWriter& align(size_t alignment)
+		{
+			bin::check_alignment(alignment);
+			const size_t offset = this->size();
+			const size_t padding = bin::align_up(offset, alignment) - offset;
+			std::memset(this->_take(padding), 0, padding);
+			return *this;
+		}
+
+		/*
+		 * Reserves <count> elements and returns a view to fill directly
+		 * (native order only, since the caller writes the values).
+		 */
+		template <class Ty>
+		span<Ty> reserve_array(size_t count, size_t alignment = alignof(Ty))
+		{
+			static_assert(Order == endian::native || sizeof(Ty) == 1, "BinaryWriter: in-place writes need native byte order");
+			this->align(alignment);
+			return span<Ty>(reinterpret_cast<Ty*>(this->_take_array<Ty>(count)), count);
+		}
+
+		// Bytes written so far
+		[[nodiscard]] size_t size() const noexcept
+		{
+			return static_cast<size_t>(_cursor - _begin);
+		}
+
+		[[nodiscard]] size_t remaining() const noexcept
+		{
+			return static_cast<size_t>(_end - _cursor);
+		}
+
+		[[nodiscard]] span<const bin::byte_type> written() const noexcept
+		{
+			return span<const bin::byte_type>(_begin, this->size());
+		}
+
+	}; // class basic_BinaryWriter
+
+	using BinaryWriter = basic_BinaryWriter<endian::little>;
+
+	////////////////////////////////              ////////////////////////////////
+	//------------------------------              ------------------------------//
+	//------------------------------ BinaryReader ------------------------------//
+	//------------------------------              ------------------------------//
+	////////////////////////////////              ////////////////////////////////
+
+	/*
+	 * Reads what basic_BinaryWriter<Order> wrote, from a buffer it does not own.
+	 *
+	 * view() returns typed spans into the buffer itself (no copy) when the
+	 * byte order is native and the data is aligned; read_array() copies and
+	 * converts in every case.
+	 *
+	 * @exception std::out_of_range - Reading past the end of the buffer
+	 * @exception std::invalid_argument - An alignment that is 0 or not a power of two
+	 */
+	template <endian Order = endian::little>
+	class basic_BinaryReader
+	{
+	protected:
+
+		using byte_type = bin::byte_type;
+
+		const byte_type* _begin;
+		const byte_type* _cursor;
+		const byte_type* _end;
+
+		const byte_type* _take(size_t size)
+		{
+			if (static_cast<size_t>(_end - _cursor) < size) throw std::out_of_range("BinaryReader: read past end of buffer");
+			const byte_type* result = _cursor;
+			_cursor += size;
+			return result;
+		}
+
+		// _take() for <count> elements, checked before count * sizeof(Ty) can wrap
+		template <class Ty>
+		const byte_type* _take_array(size_t count)
+		{
+			if (count > static_cast<size_t>(_end - _cursor) / sizeof(Ty)) throw std::out_of_range("BinaryReader: read past end of buffer");
+			return this->_take(count * sizeof(Ty));
+		}
+
+	public:
+
+		static constexpr endian order = Order;
+
+		basic_BinaryReader(const void* buffer, size_t size) noexcept
+			: _begin(static_cast<const byte_type*>(buffer)), _cursor(_begin), _end(_begin + size) { }
+
+		explicit basic_BinaryReader(span<const bin::byte_type> bytes) noexcept
+			: basic_BinaryReader(bytes.data(), bytes.size()) { }
+
+		explicit basic_BinaryReader(const bin::buffer& buffer) noexcept
+			: basic_BinaryReader(buffer.data(), buffer.size()) { }
+
+		template <class Ty>
+		basic_BinaryReader& read(Ty& value)
+		{
+			bin::copy_order<Order, Ty>(&value, this->_take(sizeof(Ty)), 1);
+			return *this;
+		}
+
+		template <class Ty>
+		[[nodiscard]] Ty read()
+		{
+			Ty value;
+			this->read(value);
+			return value;
+		}
+
+		template <class Ty>
+		basic_BinaryReader& read_array(Ty* arr, size_t count, size_t alignment = alignof(Ty))
+		{
+			this->align(alignment);
+			bin::copy_order<Order, Ty>(arr, this->_take_array<Ty>(count), count);
+			return *this;
+		}
+
+		basic_BinaryReader& read_bytes(void* data, size_t size)
+		{
+			std::memcpy(data, this->_take(size), size);
+			return *this;
+		}
+
+		/*
+		 * Returns the next <count> elements in place.
+		 *
+		 * @exception std::invalid_argument - The buffer is not aligned for Ty
+		 */
+		template <class Ty>
+		[[nodiscard]] span<const Ty> view(size_t count, size_t alignment = alignof(Ty))
+		{
+			static_assert(std::is_trivially_copyable<Ty>::value, "BinaryReader: trivially copyable types only");
+			static_assert(Order == endian::native || sizeof(Ty) == 1, "BinaryReader: in-place views need native byte order");
+			this->align(alignment);
+			if (reinterpret_cast<uintptr_t>(_cursor) % alignof(Ty) != 0) throw std::invalid_argument("BinaryReader: misaligned view, use read_array");
+			return span<const Ty>(reinterpret_cast<const Ty*>(this->_take_array<Ty>(count)), count);
+		}
+
+		// Skips padding to a multiple of <alignment> from the buffer start
+		basic_BinaryReader& align(size_t alignment)
+		{
+			bin::check_alignment(alignment);
+			const size_t offset = this->position();
+			this->_take(bin::align_up(offset, alignment) - offset);
+			return *this;
+		}
+
+		basic_BinaryReader& skip(size_t size)
+		{
+			this->_take(size);
+			return *this;
+		}
+
+		[[nodiscard]] size_t position() const noexcept
+		{
+			return static_cast<size_t>(_cursor - _begin);
+		}
+
+		[[nodiscard]] size_t remaining() const noexcept
+		{
+			return static_cast<size_t>(_end - _cursor);
+		}
+
+		[[nodiscard]] bool eof() const noexcept
+		{
+			return _cursor == _end;
+		}
+
+	}; // class basic_BinaryReader
+
+	using BinaryReader = basic_BinaryReader<endian::little>;
+
+	//-------------------- pack --------------------//
+
+	namespace bin {
+
+		template <class Ty, class = void>
+		struct _is_contiguous : std::false_type { };
+
+		template <class Ty>
+		struct _is_contiguous<Ty, std::void_t<decltype(std::declval<const Ty&>().data()), decltype(std::declval<const Ty&>().size())>> : std::true_type { };
+
+		template <class Sink>
+		inline void _write_all(Sink&) { }
+
+		template <class Sink, class Ty, class... Args>
+		inline void _write_all(Sink& sink, const Ty& value, const Args&... args)
+		{
+			if constexpr (_is_contiguous<Ty>::value)
+			{
+				sink.write(static_cast<uint64_t>(value.size()));
+				sink.write_array(value.data(), value.size());
+			}
+			else
+			{
+				sink.write(value);
+			}
+			_write_all(sink, args...);
+		}
+
+		/*
+		 * Serializes every argument into one exactly-sized buffer: one size
+		 * pass, one allocation, one write pass. Contiguous containers
+		 * (vector, array, string, span) are stored as uint64 count + aligned elements.
+		 *
+		 *   bin::buffer data = bin::pack(rows, cols, nw::span<const double>(grid, rows * cols));
+		 */
+		template <endian Order = endian::little, class... Args>
+		[[nodiscard]] buffer pack(const Args&... args)
+		{
+			BinarySizer sizer;
+			_write_all(sizer, args...);
+			buffer result(sizer.size());
+			basic_BinaryWriter<Order> writer(result);
+			_write_all(writer, args...);
+			return result;
+		}
+
+	} // namespace bin
+
+} // namespace nw
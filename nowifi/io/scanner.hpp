@@ -1,9 +1,13 @@
 #pragma once
 
 #include <nowifi/compiler/class.hpp>
+#include <nowifi/util/consumer.hpp>
 #include <nowifi/util/error.hpp>
+#include <nowifi/util/expected.hpp>
+#include <nowifi/util/metrics.hpp>
 #include <nowifi/string/former.hpp>
 #include <nowifi/string/from_string.hpp>
+#include <nowifi/string/pool.hpp>
 
 #include <string>
 #include <iostream>
@@ -11,6 +15,9 @@
 #include <algorithm>
 #include <vector>
 #include <limits>
+#include <utility>
+#include <type_traits>
+#include <new>
 
 namespace nw {
 
@@ -30,6 +37,9 @@ namespace nw {
 
 		using from_string_type = basic_from_string<charTy>;
 
+		using pool_type = basic_StringPool<charTy>;
+		using pool_id_type = typename pool_type::id_type;
+
 	protected:
 
 		using Scanner_type = basic_Scanner<charTy>;
@@ -54,6 +64,15 @@ namespace nw {
 		basic_Scanner(istream_type& in)
 			: Scanner_type(in, global::Error_Throw<std::string>) { }
 
+		//-------------------- error --------------------//
+
+		//STATIC
+		static void _error(const Error_type& err, const std::string& msg)
+		{
+			NW_METRIC_ADD("scanner.errors", 1);
+			err.execute(msg);
+		}
+
 		//-------------------- clear --------------------//
 
 		//STATIC
@@ -135,7 +154,8 @@ namespace nw {
 		static string_type _nextWord(istream_type& in, const Error_type& err = global::Error_Throw<std::string>)
 		{
 			string_type toread;
-			if (!(in >> toread)) err.execute("read");
+			if (!(in >> toread)) Scanner_type::_error(err, "read");
+			else NW_METRIC_ADD("scanner.tokens", 1);
 			return toread;
 		}
 
@@ -144,13 +164,37 @@ namespace nw {
 			return Scanner_type::_nextWord(in, err);
 		}
 
+		//-------------------- nextWord_intern --------------------//
+
+		//STATIC
+		static pool_id_type _nextWord_intern(pool_type& pool, istream_type& in, const Error_type& err = global::Error_Throw<std::string>)
+		{
+			// Reused per thread: after warm-up a read allocates only for new strings
+			thread_local string_type toread;
+			toread.clear();
+			// A failed read interns nothing and yields pool_type::npos
+			if (!(in >> toread))
+			{
+				Scanner_type::_error(err, "read");
+				return pool_type::npos;
+			}
+			NW_METRIC_ADD("scanner.tokens", 1);
+			return pool.intern(toread);
+		}
+
+		pool_id_type nextWord_intern(pool_type& pool)
+		{
+			return Scanner_type::_nextWord_intern(pool, in, err);
+		}
+
 		//-------------------- nextLine --------------------/
 
 		//STATIC
 		static string_type _nextLine(istream_type& in, const Error_type& err = global::Error_Throw<std::string>)
 		{
 			string_type toread;
-			if (!std::getline<charTy>(in, toread)) err.execute("getline");
+			if (!std::getline<charTy>(in, toread)) Scanner_type::_error(err, "getline");
+			else NW_METRIC_ADD("scanner.lines", 1);
 			return toread;
 		}
 
@@ -165,7 +209,8 @@ namespace nw {
 		static string_type _nextSentence(char end, istream_type& in, const Error_type& err = global::Error_Throw<std::string>)
 		{
 			string_type toread;
-			if (!std::getline<charTy>(in, toread, end)) err.execute("getline");
+			if (!std::getline<charTy>(in, toread, end)) Scanner_type::_error(err, "getline");
+			else NW_METRIC_ADD("scanner.lines", 1);
 			return toread;
 		}
 
@@ -182,7 +227,7 @@ namespace nw {
 		{
 			Ty var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::tryto(str, var)) err.execute(stringMaker("nextChecked:" << typeid(Ty).name()));
+			if (!from_string_type::tryto(str, var)) Scanner_type::_error(err, stringMaker("nextChecked:" << typeid(Ty).name()));
 			return var;
 		}
 
@@ -203,7 +248,7 @@ namespace nw {
 		{
 			short var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::trytoShort(str, var, base)) err.execute("nextChecked:short");
+			if (!from_string_type::trytoShort(str, var, base)) Scanner_type::_error(err, "nextChecked:short");
 			return var;
 		}
 
@@ -219,7 +264,7 @@ namespace nw {
 		{
 			int var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::trytoInt(str, var, base)) err.execute("nextChecked:int");
+			if (!from_string_type::trytoInt(str, var, base)) Scanner_type::_error(err, "nextChecked:int");
 			return var;
 		}
 
@@ -235,7 +280,7 @@ namespace nw {
 		{
 			long var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::trytoLong(str, var, base)) err.execute("nextChecked:int");
+			if (!from_string_type::trytoLong(str, var, base)) Scanner_type::_error(err, "nextChecked:int");
 			return var;
 		}
 
@@ -251,7 +296,7 @@ namespace nw {
 		{
 			long long var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::trytoLLong(str, var, base)) err.execute("nextChecked:int");
+			if (!from_string_type::trytoLLong(str, var, base)) Scanner_type::_error(err, "nextChecked:int");
 			return var;
 		}
 
@@ -267,7 +312,7 @@ namespace nw {
 		{
 			unsigned short var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::trytoUShort(str, var, base)) err.execute("nextChecked:short");
+			if (!from_string_type::trytoUShort(str, var, base)) Scanner_type::_error(err, "nextChecked:short");
 			return var;
 		}
 
@@ -283,7 +328,7 @@ namespace nw {
 		{
 			unsigned int var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::trytoUInt(str, var, base)) err.execute("nextChecked:int");
+			if (!from_string_type::trytoUInt(str, var, base)) Scanner_type::_error(err, "nextChecked:int");
 			return var;
 		}
 
@@ -299,7 +344,7 @@ namespace nw {
 		{
 			unsigned long var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::trytoULong(str, var, base)) err.execute("nextChecked:int");
+			if (!from_string_type::trytoULong(str, var, base)) Scanner_type::_error(err, "nextChecked:int");
 			return var;
 		}
 
@@ -315,7 +360,7 @@ namespace nw {
 		{
 			unsigned long long var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::trytoULLong(str, var, base)) err.execute("nextChecked:int");
+			if (!from_string_type::trytoULLong(str, var, base)) Scanner_type::_error(err, "nextChecked:int");
 			return var;
 		}
 
@@ -331,7 +376,7 @@ namespace nw {
 		{
 			float var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::trytoFloat(str, var)) err.execute("nextChecked:short");
+			if (!from_string_type::trytoFloat(str, var)) Scanner_type::_error(err, "nextChecked:short");
 			return var;
 		}
 
@@ -347,7 +392,7 @@ namespace nw {
 		{
 			double var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::trytoDouble(str, var)) err.execute("nextChecked:short");
+			if (!from_string_type::trytoDouble(str, var)) Scanner_type::_error(err, "nextChecked:short");
 			return var;
 		}
 
@@ -363,7 +408,7 @@ namespace nw {
 		{
 			long double var;
 			string_type str = Scanner_type::_nextWord(in, err);
-			if (!from_string_type::trytoLDouble(str, var)) err.execute("nextChecked:short");
+			if (!from_string_type::trytoLDouble(str, var)) Scanner_type::_error(err, "nextChecked:short");
 			return var;
 		}
 
@@ -386,10 +431,11 @@ namespace nw {
 			in >> toread;
 			while (in.fail())
 			{
-				err.execute(stringMaker("type:" << typeid(Ty).name()));
+				Scanner_type::_error(err, stringMaker("type:" << typeid(Ty).name()));
 				_clear(in);
 				in >> toread;
 			}
+			NW_METRIC_ADD("scanner.tokens", 1);
 			return toread;
 		}
 
@@ -406,7 +452,8 @@ namespace nw {
 		static istream_type& _nextParam(istream_type& in, const Error_type& err, Ty& first)
 		{
 			in >> first;
-			if (in.fail()) err.execute(stringMaker("type:" << typeid(Ty).name()));
+			if (in.fail()) Scanner_type::_error(err, stringMaker("type:" << typeid(Ty).name()));
+			else NW_METRIC_ADD("scanner.tokens", 1);
 			return in;
 		}
 
@@ -444,7 +491,7 @@ namespace nw {
 			toread = Scanner_type::_next<Ty>(in, err);
 			while (toread < min || toread > max)
 			{
-				err.execute(stringMaker("range:" << toread << ":" << min << ":" << max));
+				Scanner_type::_error(err, stringMaker("range:" << toread << ":" << min << ":" << max));
 				Scanner_type::_clear(in);
 				toread = Scanner_type::_next<Ty>(in, err);
 			}
@@ -493,7 +540,7 @@ namespace nw {
 		}
 
 		template <class Ty, class... Args>
-		static Scanner_type& nextParam_separated(charTy sep, Ty& first, Args&... args)
+		Scanner_type& nextParam_separated(charTy sep, Ty& first, Args&... args)
 		{
 			Scanner_type::_nextParam_separated(sep, in, err, first, args...);
 			return THIS;
@@ -552,6 +599,24 @@ namespace nw {
 			return Scanner_type::_readNewVector<Ty>(size1, in, err);
 		}
 
+		//-------------------- readNewVector_intern --------------------//
+
+		//STATIC
+		static std::vector<pool_id_type> _readNewVector_intern(size_t size1, pool_type& pool, istream_type& in, const Error_type& err = global::Error_Throw<std::string>)
+		{
+			std::vector<pool_id_type> arr(size1);
+			std::generate(arr.begin(), arr.end(), [&pool, &in, &err]()
+			{
+				return Scanner_type::_nextWord_intern(pool, in, err);
+			});
+			return arr;
+		}
+
+		std::vector<pool_id_type> readNewVector_intern(size_t size1, pool_type& pool)
+		{
+			return Scanner_type::_readNewVector_intern(size1, pool, in, err);
+		}
+
 		//-------------------- stl_readArray_separated --------------------//
 
 		//STATIC
@@ -605,6 +670,638 @@ namespace nw {
 			return Scanner_type::_readNewVector_separated<Ty>(size1, sep, in, err);
 		}
 
+		//-------------------- readChunked --------------------//
+
+		// Values per chunk of readChunked* and consumeArray
+		static constexpr size_t default_chunk = size_t(1) << 14;
+
+		/*
+		 * Parses <size1> values <chunk> at a time into one reused buffer and
+		 * calls <fn>(const Ty* arr, size_t count) after each chunk, so the
+		 * values never have to fit in memory at once.
+		 *
+		 * @param <size1> - Values to read
+		 * @param <fn> - Called with each parsed chunk
+		 * @param <chunk> - Values per chunk
+		 */
+		//STATIC
+		template <class Ty, class Fn>
+		static istream_type& _readChunked(size_t size1, Fn&& fn, size_t chunk, istream_type& in, const Error_type& err = global::Error_Throw<std::string>)
+		{
+			if (chunk == 0) chunk = default_chunk;
+			std::vector<Ty> buffer(std::min(size1, chunk));
+			for (size_t done = 0; done < size1;)
+			{
+				const size_t count = std::min(chunk, size1 - done);
+				Scanner_type::_readArray<Ty>(buffer.data(), count, in, err);
+				fn(static_cast<const Ty*>(buffer.data()), count);
+				done += count;
+			}
+			return in;
+		}
+
+		template <class Ty, class Fn>
+		Scanner_type& readChunked(size_t size1, Fn&& fn, size_t chunk = default_chunk)
+		{
+			Scanner_type::_readChunked<Ty>(size1, std::forward<Fn>(fn), chunk, in, err);
+			return THIS;
+		}
+
+		//-------------------- readChunked_all --------------------//
+
+		/*
+		 * readChunked until the end of the stream, for inputs of unknown length.
+		 * Only whitespace may follow the last value: any token that fails to
+		 * parse is an error, also at the very end of the stream.
+		 *
+		 * @return Values read
+		 */
+		//STATIC
+		template <class Ty, class Fn>
+		static size_t _readChunked_all(Fn&& fn, size_t chunk, istream_type& in, const Error_type& err = global::Error_Throw<std::string>)
+		{
+			if (chunk == 0) chunk = default_chunk;
+			std::vector<Ty> buffer(chunk);
+			size_t total = 0;
+			bool failed = false;
+			for (;;)
+			{
+				size_t count = 0;
+				for (; count < chunk; count++)
+				{
+					// Past the whitespace, eof is the only clean end: a token that is
+					// there but does not parse fails even when it ends the stream
+					in >> std::ws;
+					if (in.eof()) break;
+					if (!(in >> buffer[count]))
+					{
+						failed = true;
+						break;
+					}
+				}
+				NW_METRIC_ADD("scanner.tokens", count);
+				if (count != 0) fn(static_cast<const Ty*>(buffer.data()), count);
+				total += count;
+				if (count < chunk) break;
+			}
+			if (failed) Scanner_type::_error(err, stringMaker("type:" << typeid(Ty).name()));
+			return total;
+		}
+
+		template <class Ty, class Fn>
+		size_t readChunked_all(Fn&& fn, size_t chunk = default_chunk)
+		{
+			return Scanner_type::_readChunked_all<Ty>(std::forward<Fn>(fn), chunk, in, err);
+		}
+
+		//-------------------- readChunked_columns --------------------//
+
+		/*
+		 * Parses <rows> rows of <columns> values, <chunk> rows at a time, and
+		 * calls <fn>(size_t column, const Ty* arr, size_t count) for every
+		 * column of each chunk. The buffer is stored by column, so each call
+		 * gets that column's values contiguously.
+		 */
+		//STATIC
+		template <class Ty, class Fn>
+		static istream_type& _readChunked_columns(size_t rows, size_t columns, Fn&& fn, size_t chunk, istream_type& in, const Error_type& err = global::Error_Throw<std::string>)
+		{
+			if (chunk == 0) chunk = default_chunk;
+			const size_t stride = std::min(rows, chunk);
+			std::vector<Ty> buffer(stride * columns);
+			for (size_t done = 0; done < rows;)
+			{
+				const size_t count = std::min(chunk, rows - done);
+				for (size_t row = 0; row < count; row++)
+				{
+					for (size_t column = 0; column < columns; column++) buffer[column * stride + row] = Scanner_type::_next<Ty>(in, err);
+				}
+				for (size_t column = 0; column < columns; column++) fn(column, static_cast<const Ty*>(buffer.data() + column * stride), count);
+				done += count;
+			}
+			return in;
+		}
+
+		template <class Ty, class Fn>
+		Scanner_type& readChunked_columns(size_t rows, size_t columns, Fn&& fn, size_t chunk = default_chunk)
+		{
+			Scanner_type::_readChunked_columns<Ty>(rows, columns, std::forward<Fn>(fn), chunk, in, err);
+			return THIS;
+		}
+
+		//-------------------- consumeArray --------------------//
+
+		/*
+		 * Parses <size1> values straight into <consumer>, one bulk consume()
+		 * per chunk, instead of readNewVector and a pass over the vector.
+		 */
+		//STATIC
+		template <class Ty>
+		static istream_type& _consumeArray(size_t size1, Consumer<Ty>& consumer, size_t chunk, istream_type& in, const Error_type& err = global::Error_Throw<std::string>)
+		{
+			return Scanner_type::_readChunked<Ty>(size1, [&consumer](const Ty* arr, size_t count)
+			{
+				consumer.consume(arr, count);
+			}, chunk, in, err);
+		}
+
+		template <class Ty>
+		Scanner_type& consumeArray(size_t size1, Consumer<Ty>& consumer, size_t chunk = default_chunk)
+		{
+			Scanner_type::_consumeArray<Ty>(size1, consumer, chunk, in, err);
+			return THIS;
+		}
+
+		//---------------------------------------------------------------//
+		//---------------------------------------------------------------//
+		//-------------------- try (noexcept) --------------------//
+
+		/*
+		 * The try_* readers report failure as expected<...> (or errc, errc::none
+		 * on success) instead of going through Error_type, and never throw:
+		 *
+		 *   errc::end_of_stream    - only whitespace was left
+		 *   errc::invalid_argument - a malformed token; only that token is consumed
+		 *   errc::out_of_range     - a number the type can not hold (consumed), or outside try_nextRanged's bounds
+		 *   errc::io_error         - a bad stream, or an exception from it or from a try_readChunked* callback
+		 */
+
+		//STATIC
+		// Past the whitespace: errc::none if a token follows
+		static errc _try_skip(istream_type& in)
+		{
+			in >> std::ws;
+			if (in.bad()) return errc::io_error;
+			if (in.eof()) return errc::end_of_stream;
+			return errc::none;
+		}
+
+		//STATIC
+		// operator>> clamps a number out of range to the limit of its type and fails
+		template <class Ty>
+		static bool _try_clamped(const Ty& var)
+		{
+			if constexpr (std::is_arithmetic<Ty>::value && !std::is_same<Ty, bool>::value)
+			{
+				return var == std::numeric_limits<Ty>::max() || (std::is_signed<Ty>::value && var == std::numeric_limits<Ty>::lowest());
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		//STATIC
+		// After a failed extraction of a token that was there
+		template <class Ty>
+		static errc _try_error(istream_type& in, const Ty& var)
+		{
+			NW_METRIC_ADD("scanner.errors", 1);
+			if (in.bad()) return errc::io_error;
+			in.clear();
+			if (Scanner_type::_try_clamped(var)) return errc::out_of_range;
+
+			// Reused per thread: skipping a bad token does not allocate after warm-up
+			thread_local string_type rest;
+			in >> rest;
+			in.clear(in.rdstate() & std::ios_base::eofbit);
+			return errc::invalid_argument;
+		}
+
+		//STATIC
+		template <class Ty>
+		static errc _try_extract(istream_type& in, Ty& var)
+		{
+			const errc skipped = Scanner_type::_try_skip(in);
+			if (skipped != errc::none) return skipped;
+			if (!(in >> var)) return Scanner_type::_try_error(in, var);
+			NW_METRIC_ADD("scanner.tokens", 1);
+			return errc::none;
+		}
+
+		//STATIC
+		// <code> as an expected<...> error, or as itself for the readers returning errc
+		template <class Result>
+		static Result _try_failed(errc code) noexcept
+		{
+			if constexpr (std::is_same<Result, errc>::value) return code;
+			else return unexpected<errc>(code);
+		}
+
+		//STATIC
+		template <class Fn>
+		static auto _try_read(Fn&& fn) noexcept -> decltype(fn())
+		{
+			try
+			{
+				return fn();
+			}
+			catch (const std::bad_alloc&)
+			{
+				return Scanner_type::_try_failed<decltype(fn())>(errc::out_of_memory);
+			}
+			catch (...)
+			{
+				return Scanner_type::_try_failed<decltype(fn())>(errc::io_error);
+			}
+		}
+
+		//-------------------- try_next --------------------//
+
+		//STATIC
+		template <class Ty>
+		static expected<Ty> _try_next(istream_type& in) noexcept
+		{
+			return Scanner_type::_try_read([&in]() -> expected<Ty>
+			{
+				Ty toread{};
+				const errc code = Scanner_type::_try_extract(in, toread);
+				if (code != errc::none) return unexpected<errc>(code);
+				return toread;
+			});
+		}
+
+		template <class Ty>
+		expected<Ty> try_next() noexcept
+		{
+			return Scanner_type::_try_next<Ty>(in);
+		}
+
+		//-------------------- try_nextParam --------------------//
+
+		/*
+		 * Reads every argument in order, stopping at the first failure;
+		 * the arguments before it keep their values.
+		 *
+		 * @return errc::none, or the first failure
+		 */
+		//STATIC
+		template <class Ty>
+		static errc _try_nextParam(istream_type& in, Ty& first) noexcept
+		{
+			return Scanner_type::_try_read([&in, &first]() -> errc
+			{
+				return Scanner_type::_try_extract(in, first);
+			});
+		}
+
+		//STATIC
+		template <class Ty, class... Args>
+		static errc _try_nextParam(istream_type& in, Ty& first, Args&... args) noexcept
+		{
+			const errc code = Scanner_type::_try_nextParam(in, first);
+			if (code != errc::none) return code;
+			return Scanner_type::_try_nextParam(in, args...);
+		}
+
+		template <class Ty, class... Args>
+		errc try_nextParam(Ty& first, Args&... args) noexcept
+		{
+			return Scanner_type::_try_nextParam(in, first, args...);
+		}
+
+		//-------------------- try_nextWord --------------------//
+
+		//STATIC
+		static expected<string_type> _try_nextWord(istream_type& in) noexcept
+		{
+			return Scanner_type::_try_next<string_type>(in);
+		}
+
+		expected<string_type> try_nextWord() noexcept
+		{
+			return Scanner_type::_try_nextWord(in);
+		}
+
+		//-------------------- try_nextLine --------------------//
+
+		//STATIC
+		static expected<string_type> _try_nextLine(istream_type& in) noexcept
+		{
+			return Scanner_type::_try_read([&in]() -> expected<string_type>
+			{
+				string_type toread;
+				if (!std::getline<charTy>(in, toread)) return unexpected<errc>(in.bad() ? errc::io_error : errc::end_of_stream);
+				NW_METRIC_ADD("scanner.lines", 1);
+				return toread;
+			});
+		}
+
+		expected<string_type> try_nextLine() noexcept
+		{
+			return Scanner_type::_try_nextLine(in);
+		}
+
+		//-------------------- try_nextChecked --------------------//
+
+		/*
+		 * Reads a word and converts all of it with from_string::try_to,
+		 * so "12abc" is errc::invalid_argument rather than 12. Only the
+		 * word is consumed on failure.
+		 */
+		//STATIC
+		template <class Ty>
+		static expected<Ty> _try_nextChecked(istream_type& in, int base = 10) noexcept
+		{
+			return Scanner_type::_try_read([&in, base]() -> expected<Ty>
+			{
+				// Reused per thread: after warm-up a read does not allocate
+				thread_local string_type toread;
+				const errc code = Scanner_type::_try_extract(in, toread);
+				if (code != errc::none) return unexpected<errc>(code);
+				expected<Ty> var = from_string_type::template try_to<Ty>(toread, base);
+				if (!var) NW_METRIC_ADD("scanner.errors", 1);
+				return var;
+			});
+		}
+
+		template <class Ty>
+		expected<Ty> try_nextChecked(int base = 10) noexcept
+		{
+			return Scanner_type::_try_nextChecked<Ty>(in, base);
+		}
+
+		//-------------------- try_nextRanged --------------------//
+
+		// A value outside [min, max] is errc::out_of_range; it stays consumed
+		//STATIC
+		template <class Ty>
+		static expected<Ty> _try_nextRanged(const Ty min, const Ty max, istream_type& in) noexcept
+		{
+			return Scanner_type::_try_read([min, max, &in]() -> expected<Ty>
+			{
+				Ty toread{};
+				const errc code = Scanner_type::_try_extract(in, toread);
+				if (code != errc::none) return unexpected<errc>(code);
+				if (toread < min || toread > max)
+				{
+					NW_METRIC_ADD("scanner.errors", 1);
+					return unexpected<errc>(errc::out_of_range);
+				}
+				return toread;
+			});
+		}
+
+		template <class Ty>
+		expected<Ty> try_nextRanged(const Ty min, const Ty max) noexcept
+		{
+			return Scanner_type::_try_nextRanged<Ty>(min, max, in);
+		}
+
+		//-------------------- try_next_separated --------------------//
+
+		// Like next_separated: one <sep> after the value is skipped if present
+		//STATIC
+		template <class Ty>
+		static expected<Ty> _try_next_separated(charTy sep, istream_type& in) noexcept
+		{
+			return Scanner_type::_try_read([sep, &in]() -> expected<Ty>
+			{
+				Ty toread{};
+				const errc code = Scanner_type::_try_extract(in, toread);
+				if (code != errc::none) return unexpected<errc>(code);
+				Scanner_type::_ifNextSkip(sep, in);
+				return toread;
+			});
+		}
+
+		template <class Ty>
+		expected<Ty> try_next_separated(charTy sep) noexcept
+		{
+			return Scanner_type::_try_next_separated<Ty>(sep, in);
+		}
+
+		//-------------------- try_nextParam_separated --------------------//
+
+		//STATIC
+		template <class Ty>
+		static errc _try_nextParam_separated(charTy sep, istream_type& in, Ty& first) noexcept
+		{
+			return Scanner_type::_try_read([sep, &in, &first]() -> errc
+			{
+				const errc code = Scanner_type::_try_extract(in, first);
+				if (code == errc::none) Scanner_type::_ifNextSkip(sep, in);
+				return code;
+			});
+		}
+
+		//STATIC
+		template <class Ty, class... Args>
+		static errc _try_nextParam_separated(charTy sep, istream_type& in, Ty& first, Args&... args) noexcept
+		{
+			const errc code = Scanner_type::_try_nextParam_separated(sep, in, first);
+			if (code != errc::none) return code;
+			return Scanner_type::_try_nextParam_separated(sep, in, args...);
+		}
+
+		template <class Ty, class... Args>
+		errc try_nextParam_separated(charTy sep, Ty& first, Args&... args) noexcept
+		{
+			return Scanner_type::_try_nextParam_separated(sep, in, first, args...);
+		}
+
+		//-------------------- try_readArray --------------------//
+
+		/*
+		 * Reads up to <size1> values into <arr>, stopping early at the end
+		 * of the stream.
+		 *
+		 * @return Count of values read; an error for any other failure
+		 */
+		//STATIC
+		template <class Ty>
+		static expected<size_t> _try_readArray(Ty* arr, size_t size1, istream_type& in) noexcept
+		{
+			return Scanner_type::_try_read([arr, size1, &in]() -> expected<size_t>
+			{
+				for (size_t idx = 0; idx < size1; idx++)
+				{
+					const errc code = Scanner_type::_try_extract(in, arr[idx]);
+					if (code == errc::end_of_stream) return idx;
+					if (code != errc::none) return unexpected<errc>(code);
+				}
+				return size1;
+			});
+		}
+
+		template <class Ty>
+		expected<size_t> try_readArray(Ty* arr, size_t size1) noexcept
+		{
+			return Scanner_type::_try_readArray<Ty>(arr, size1, in);
+		}
+
+		//-------------------- try_readArray_separated --------------------//
+
+		// try_readArray with one <sep> skipped after each value
+		//STATIC
+		template <class Ty>
+		static expected<size_t> _try_readArray_separated(Ty* arr, size_t size1, charTy sep, istream_type& in) noexcept
+		{
+			return Scanner_type::_try_read([arr, size1, sep, &in]() -> expected<size_t>
+			{
+				for (size_t idx = 0; idx < size1; idx++)
+				{
+					const errc code = Scanner_type::_try_extract(in, arr[idx]);
+					if (code == errc::end_of_stream) return idx;
+					if (code != errc::none) return unexpected<errc>(code);
+					Scanner_type::_ifNextSkip(sep, in);
+				}
+				return size1;
+			});
+		}
+
+		template <class Ty>
+		expected<size_t> try_readArray_separated(Ty* arr, size_t size1, charTy sep) noexcept
+		{
+			return Scanner_type::_try_readArray_separated<Ty>(arr, size1, sep, in);
+		}
+
+		//-------------------- try_readNewVector --------------------//
+
+		// Exactly <size1> values: an early end is errc::end_of_stream
+		//STATIC
+		template <class Ty>
+		static expected<std::vector<Ty>> _try_readNewVector(size_t size1, istream_type& in) noexcept
+		{
+			return Scanner_type::_try_read([size1, &in]() -> expected<std::vector<Ty>>
+			{
+				std::vector<Ty> arr(size1);
+				for (Ty& value : arr)
+				{
+					const errc code = Scanner_type::_try_extract(in, value);
+					if (code != errc::none) return unexpected<errc>(code);
+				}
+				return arr;
+			});
+		}
+
+		template <class Ty>
+		expected<std::vector<Ty>> try_readNewVector(size_t size1) noexcept
+		{
+			return Scanner_type::_try_readNewVector<Ty>(size1, in);
+		}
+
+		//-------------------- try_readChunked --------------------//
+
+		/*
+		 * readChunked without Error_type. On a failure <fn> has already been
+		 * given every value before it, the last chunk cut short.
+		 *
+		 * @return errc::none once <size1> values were read; an early end is errc::end_of_stream
+		 */
+		//STATIC
+		template <class Ty, class Fn>
+		static errc _try_readChunked(size_t size1, Fn&& fn, size_t chunk, istream_type& in) noexcept
+		{
+			return Scanner_type::_try_read([size1, &fn, chunk, &in]() -> errc
+			{
+				const size_t step = chunk == 0 ? default_chunk : chunk;
+				std::vector<Ty> buffer(std::min(size1, step));
+				for (size_t done = 0; done < size1;)
+				{
+					const size_t count = std::min(step, size1 - done);
+					for (size_t idx = 0; idx < count; idx++)
+					{
+						const errc code = Scanner_type::_try_extract(in, buffer[idx]);
+						if (code != errc::none)
+						{
+							if (idx != 0) fn(static_cast<const Ty*>(buffer.data()), idx);
+							return code;
+						}
+					}
+					fn(static_cast<const Ty*>(buffer.data()), count);
+					done += count;
+				}
+				return errc::none;
+			});
+		}
+
+		template <class Ty, class Fn>
+		errc try_readChunked(size_t size1, Fn&& fn, size_t chunk = default_chunk) noexcept
+		{
+			return Scanner_type::_try_readChunked<Ty>(size1, std::forward<Fn>(fn), chunk, in);
+		}
+
+		//-------------------- try_readChunked_all --------------------//
+
+		/*
+		 * readChunked_all without Error_type: any token that fails to parse,
+		 * also the last one, is an error, after <fn> got the values before it.
+		 *
+		 * @return Values read, at the end of the stream
+		 */
+		//STATIC
+		template <class Ty, class Fn>
+		static expected<size_t> _try_readChunked_all(Fn&& fn, size_t chunk, istream_type& in) noexcept
+		{
+			return Scanner_type::_try_read([&fn, chunk, &in]() -> expected<size_t>
+			{
+				std::vector<Ty> buffer(chunk == 0 ? default_chunk : chunk);
+				size_t total = 0;
+				for (;;)
+				{
+					errc code = errc::none;
+					size_t count = 0;
+					for (; count < buffer.size(); count++)
+					{
+						code = Scanner_type::_try_extract(in, buffer[count]);
+						if (code != errc::none) break;
+					}
+					if (count != 0) fn(static_cast<const Ty*>(buffer.data()), count);
+					total += count;
+					if (code == errc::end_of_stream) return total;
+					if (code != errc::none) return unexpected<errc>(code);
+				}
+			});
+		}
+
+		template <class Ty, class Fn>
+		expected<size_t> try_readChunked_all(Fn&& fn, size_t chunk = default_chunk) noexcept
+		{
+			return Scanner_type::_try_readChunked_all<Ty>(std::forward<Fn>(fn), chunk, in);
+		}
+
+		//-------------------- try_readChunked_columns --------------------//
+
+		/*
+		 * readChunked_columns without Error_type; on a failure no column of
+		 * the unfinished chunk is handed to <fn>.
+		 *
+		 * @return errc::none once <rows> rows were read; an early end is errc::end_of_stream
+		 */
+		//STATIC
+		template <class Ty, class Fn>
+		static errc _try_readChunked_columns(size_t rows, size_t columns, Fn&& fn, size_t chunk, istream_type& in) noexcept
+		{
+			return Scanner_type::_try_read([rows, columns, &fn, chunk, &in]() -> errc
+			{
+				const size_t step = chunk == 0 ? default_chunk : chunk;
+				const size_t stride = std::min(rows, step);
+				std::vector<Ty> buffer(stride * columns);
+				for (size_t done = 0; done < rows;)
+				{
+					const size_t count = std::min(step, rows - done);
+					for (size_t row = 0; row < count; row++)
+					{
+						for (size_t column = 0; column < columns; column++)
+						{
+							const errc code = Scanner_type::_try_extract(in, buffer[column * stride + row]);
+							if (code != errc::none) return code;
+						}
+					}
+					for (size_t column = 0; column < columns; column++) fn(column, static_cast<const Ty*>(buffer.data() + column * stride), count);
+					done += count;
+				}
+				return errc::none;
+			});
+		}
+
+		template <class Ty, class Fn>
+		errc try_readChunked_columns(size_t rows, size_t columns, Fn&& fn, size_t chunk = default_chunk) noexcept
+		{
+			return Scanner_type::_try_readChunked_columns<Ty>(rows, columns, std::forward<Fn>(fn), chunk, in);
+		}
+
 	}; // class basic_Scanner
 
 	using Scanner = basic_Scanner<char>;
@@ -621,9 +1318,24 @@ namespace nw {
 
 	//STATIC
 	template <class Ty>
-	static std::istream& Scanner_readBinary(const Ty& val, std::istream& in, const Scanner::Error_type& err = global::Error_Throw<std::string>)
+	static std::istream& Scanner_readBinary(Ty& val, std::istream& in, const Scanner::Error_type& err = global::Error_Throw<std::string>)
 	{
-		in.read(reinterpret_cast<const char*>(&val), sizeof(Ty));
+		in.read(reinterpret_cast<char*>(&val), sizeof(Ty));
+		if (in.fail()) Scanner::_error(err, "readBinary");
+		else NW_METRIC_ADD("scanner.binary_bytes", in.gcount());
+		return in;
+	}
+
+	/*
+	 * Reads <size> trivially copyable elements into <arr> in one call.
+	 */
+	//STATIC
+	template <class Ty>
+	static std::istream& Scanner_readBinaryArray(Ty* arr, size_t size, std::istream& in, const Scanner::Error_type& err = global::Error_Throw<std::string>)
+	{
+		in.read(reinterpret_cast<char*>(arr), static_cast<std::streamsize>(size * sizeof(Ty)));
+		if (in.fail()) Scanner::_error(err, "readBinaryArray");
+		else NW_METRIC_ADD("scanner.binary_bytes", in.gcount());
 		return in;
 	}
 
@@ -636,4 +1348,51 @@ namespace nw {
 		return val;
 	}
 
+	/*
+	 * Scanner_readBinary / Scanner_readBinaryArray that also feed the
+	 * bytes read to <sum>, for checking against Scanner_verifyChecksum.
+	 */
+	//STATIC
+	template <class Ty, class Checksum>
+	static std::istream& Scanner_readBinaryChecked(Ty& val, std::istream& in, Checksum& sum, const Scanner::Error_type& err = global::Error_Throw<std::string>)
+	{
+		Scanner_readBinary(val, in, err);
+		if (!in.fail()) sum.update(&val, sizeof(Ty));
+		return in;
+	}
+
+	//STATIC
+	template <class Ty, class Checksum>
+	static std::istream& Scanner_readBinaryArrayChecked(Ty* arr, size_t size, std::istream& in, Checksum& sum, const Scanner::Error_type& err = global::Error_Throw<std::string>)
+	{
+		Scanner_readBinaryArray(arr, size, in, err);
+		if (!in.fail()) sum.update(arr, size * sizeof(Ty));
+		return in;
+	}
+
+	/*
+	 * Reads the checksum written by Writer_writeChecksum and compares it
+	 * with <sum>. A truncated stream or a mismatch is reported through <err>.
+	 *
+	 * @return Whether the stored value matched
+	 */
+	//STATIC
+	template <class Checksum>
+	static bool Scanner_verifyChecksum(const Checksum& sum, std::istream& in, const Scanner::Error_type& err = global::Error_Throw<std::string>)
+	{
+		typename Checksum::value_type stored{};
+		in.read(reinterpret_cast<char*>(&stored), sizeof(stored));
+		if (in.fail())
+		{
+			Scanner::_error(err, "verifyChecksum: truncated");
+			return false;
+		}
+		if (stored != sum.value())
+		{
+			Scanner::_error(err, "verifyChecksum: mismatch");
+			return false;
+		}
+		return true;
+	}
+
 } // namespace nw
\ No newline at end of file
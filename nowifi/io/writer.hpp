@@ -2,6 +2,7 @@
 
 #include <nowifi/compiler/class.hpp>
 #include <nowifi/util/error.hpp>
+#include <nowifi/util/metrics.hpp>
 
 #include <string>
 #include <iostream>
@@ -48,14 +49,24 @@ namespace nw {
 		basic_Writer(ostream_type& os)
 			: Writer_type(os, global::Error_Throw<std::string>) { }
 
+		//-------------------- error --------------------//
+
+		//STATIC
+		static void _error(const Error_type& err, const std::string& msg)
+		{
+			NW_METRIC_ADD("writer.errors", 1);
+			err.execute(msg);
+		}
+
 		//-------------------- write --------------------//
 
 		//STATIC
 		template <class Ty>
 		static ostream_type& _write(const Ty& data, ostream_type& os, const Error_type& err = global::Error_Throw<std::string>)
 		{
+			NW_METRIC_ADD("writer.items", 1);
 			os << data;
-			if (os.bad()) err.execute("write");
+			if (os.bad()) Writer_type::_error(err, "write");
 			return os;
 		}
 
@@ -65,8 +76,9 @@ namespace nw {
 		template <class Ty>
 		static ostream_type& _write(ostream_type& os, const Error_type& err, const Ty& data)
 		{
+			NW_METRIC_ADD("writer.items", 1);
 			os << data;
-			if (os.bad()) err.execute("write");
+			if (os.bad()) Writer_type::_error(err, "write");
 			return os;
 		}
 
@@ -172,7 +184,7 @@ namespace nw {
 		static ostream_type& _endline(ostream_type& os, const Error_type& err)
 		{
 			os << std::endl;
-			if (os.bad()) err.execute("write");
+			if (os.bad()) Writer_type::_error(err, "write");
 			return os;
 		}
 
@@ -185,7 +197,7 @@ namespace nw {
 		//-------------------- operator<< --------------------//
 
 		template <class Ty>
-		friend static Writer_type& operator<<(Writer_type& writer, Ty& data)
+		friend Writer_type& operator<<(Writer_type& writer, Ty& data)
 		{
 			return writer.write<Ty>(data);
 		}
@@ -196,8 +208,8 @@ namespace nw {
 		template <class _Iter>
 		static ostream_type& _stl_writeArray(const _Iter _First, const _Iter _Last, const string_type& itemDelimiter, ostream_type& os, const Error_type& err = global::Error_Throw<std::string>)
 		{
-			auto _UFirst = std::_Get_unwrapped(_First);
-			const auto _ULast = std::_Get_unwrapped(_Last);
+			auto _UFirst = _First;
+			const auto _ULast = _Last;
 			if (_UFirst != _ULast) {
 				for (; _UFirst + 1 != _ULast; ++_UFirst) {
 					Writer_type::_write(*_UFirst, os, err);
@@ -273,8 +285,54 @@ namespace nw {
 	static std::ostream& Writer_writeBinary(const Ty& value, std::ostream& os, const Writer::Error_type& err = global::Error_Throw<std::string>)
 	{
 		os.write(reinterpret_cast<const char*>(&value), sizeof(Ty));
-		if (os.bad()) err.execute("writeBinary");
+		if (os.bad()) Writer::_error(err, "writeBinary");
+		else NW_METRIC_ADD("writer.binary_bytes", sizeof(Ty));
+		return os;
+	}
+
+	/*
+	 * Writes <size> trivially copyable elements of <arr> in one call.
+	 */
+	//STATIC
+	template <class Ty>
+	static std::ostream& Writer_writeBinaryArray(const Ty* arr, size_t size, std::ostream& os, const Writer::Error_type& err = global::Error_Throw<std::string>)
+	{
+		os.write(reinterpret_cast<const char*>(arr), static_cast<std::streamsize>(size * sizeof(Ty)));
+		if (os.bad()) Writer::_error(err, "writeBinaryArray");
+		else NW_METRIC_ADD("writer.binary_bytes", size * sizeof(Ty));
 		return os;
 	}
 
+	/*
+	 * Writer_writeBinary / Writer_writeBinaryArray that also feed the
+	 * written bytes to <sum> (crc32c::stream, checksum64, ...).
+	 * Finish with Writer_writeChecksum; Scanner_verifyChecksum checks it back.
+	 */
+	//STATIC
+	template <class Ty, class Checksum>
+	static std::ostream& Writer_writeBinaryChecked(const Ty& value, std::ostream& os, Checksum& sum, const Writer::Error_type& err = global::Error_Throw<std::string>)
+	{
+		sum.update(&value, sizeof(Ty));
+		return Writer_writeBinary(value, os, err);
+	}
+
+	//STATIC
+	template <class Ty, class Checksum>
+	static std::ostream& Writer_writeBinaryArrayChecked(const Ty* arr, size_t size, std::ostream& os, Checksum& sum, const Writer::Error_type& err = global::Error_Throw<std::string>)
+	{
+		sum.update(arr, size * sizeof(Ty));
+		return Writer_writeBinaryArray(arr, size, os, err);
+	}
+
+	/*
+	 * Appends the current value of <sum> (not itself checksummed).
+	 */
+	//STATIC
+	template <class Checksum>
+	static std::ostream& Writer_writeChecksum(const Checksum& sum, std::ostream& os, const Writer::Error_type& err = global::Error_Throw<std::string>)
+	{
+		const typename Checksum::value_type value = sum.value();
+		return Writer_writeBinary(value, os, err);
+	}
+
 } // namespace nw
\ No newline at end of file
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace nw {
 
 	namespace Bitwise {
@@ -69,6 +75,59 @@ namespace nw {
 			return ((x) & (y));
 		}
 
+
+		// Number of leading zero bits; 64 for x == 0
+		inline int countl_zero(uint64_t x) noexcept
+		{
+			if (x == 0) return 64;
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+			unsigned long idx;
+			_BitScanReverse64(&idx, x);
+			return 63 - static_cast<int>(idx);
+#else
+			int count = 0;
+			while ((x & (1ULL << 63)) == 0) { x <<= 1; count++; }
+			return count;
+#endif
+		}
+
+		// Number of trailing zero bits; 64 for x == 0
+		inline int countr_zero(uint64_t x) noexcept
+		{
+			if (x == 0) return 64;
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+			unsigned long idx;
+			_BitScanForward64(&idx, x);
+			return static_cast<int>(idx);
+#else
+			int count = 0;
+			while ((x & 1) == 0) { x >>= 1; count++; }
+			return count;
+#endif
+		}
+
+		inline int popcount(uint64_t x) noexcept
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_popcountll(x);
+#else
+			x = x - ((x >> 1) & 0x5555555555555555ULL);
+			x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+			x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+			return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+		}
+
+		// Smallest power of two >= x (x > 0)
+		inline uint64_t bit_ceil(uint64_t x) noexcept
+		{
+			return x <= 1 ? 1 : 1ULL << (64 - countl_zero(x - 1));
+		}
+
 	} // namespace Bitwise
 
 } // namespace nw
\ No newline at end of file
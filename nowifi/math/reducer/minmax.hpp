@@ -1,5 +1,6 @@
 #pragma once
 
+#include <nowifi/math/reducer/reduce.hpp>
 #include <nowifi/pack/compare.hpp>
 #include <nowifi/util/consumer.hpp>
 
@@ -29,6 +30,16 @@ namespace nw {
             _min = Compare::constref::min(_min, value);
         }
 
+        void consume(const Ty* arr, size_t size)
+        {
+            _min = reducer::MinOf<Ty>(_min).consume(arr, size).result();
+        }
+
+        void merge(const MinReducer& other)
+        {
+            _min = Compare::constref::min(_min, other._min);
+        }
+
         Ty min() const
         {
             return _min;
@@ -57,6 +68,16 @@ namespace nw {
             _max = Compare::constref::max(_max, value);
         }
 
+        void consume(const Ty* arr, size_t size)
+        {
+            _max = reducer::MaxOf<Ty>(_max).consume(arr, size).result();
+        }
+
+        void merge(const MaxReducer& other)
+        {
+            _max = Compare::constref::max(_max, other._max);
+        }
+
         Ty max() const
         {
             return _max;
@@ -90,6 +111,20 @@ namespace nw {
             MinReducer<Ty>::consume(value);
             MaxReducer<Ty>::consume(value);
         }
+
+        // One pass for both bounds
+        void consume(const Ty* arr, size_t size)
+        {
+            const auto bounds = reducer::MinMaxOf<Ty>(this->_min, this->_max).consume(arr, size).result();
+            this->_min = bounds.first;
+            this->_max = bounds.second;
+        }
+
+        void merge(const MinMaxReducer& other)
+        {
+            MinReducer<Ty>::merge(other);
+            MaxReducer<Ty>::merge(other);
+        }
     };
 
 } // namespace nw
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <nowifi/math/reducer/reduce.hpp>
+
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+
+namespace nw {
+
+    namespace reducer {
+
+        //-------------------- parallel reduce --------------------//
+
+        // Elements per chunk of parallel_reduce()
+        constexpr size_t default_chunk = size_t(1) << 16;
+
+        template <class Tuple, size_t... Idx>
+        void _merge_each(Tuple& into, const Tuple& from, std::index_sequence<Idx...>)
+        {
+            (std::get<Idx>(into).merge(std::get<Idx>(from)), ...);
+        }
+
+        /*
+         * Merges <partial> as a fixed binary tree: neighbours first, then
+         * pairs of pairs, so [0] ends up holding everything, in order.
+         *
+         * @param <partial> - Mergeable accumulators (or tuples of them) of consecutive parts of the input
+         *
+         * @exception #pragma omp parallel (each level)
+         */
+        template <class Bound>
+        void tree_merge(std::vector<Bound>& partial)
+        {
+            const long long count = static_cast<long long>(partial.size());
+            for (long long step = 1; step < count; step *= 2)
+            {
+#pragma omp parallel for schedule(static)
+                for (long long idx = 0; idx < count - step; idx += 2 * step)
+                {
+                    if constexpr (is_mergeable<Bound>::value) partial[idx].merge(partial[idx + step]);
+                    else _merge_each(partial[idx], partial[idx + step], std::make_index_sequence<std::tuple_size<Bound>::value>());
+                }
+            }
+        }
+
+        /*
+         * Reduces <arr> with OpenMP threads: every <chunk> elements go to
+         * their own accumulators, which are then tree_merge()d.
+         *
+         * Chunks and the tree depend on <size> and <chunk> only, so the result
+         * is the same for any number of threads (and without OpenMP), float
+         * sums included. The first chunk starts from the state of bound
+         * accumulators in <specs>; the others start from their identity_of().
+         *
+         * @param <chunk> - Elements per chunk (0 means default_chunk)
+         * @param <arr> - Pointer to array
+         * @param <size> - Size of array
+         * @param <specs> - Specs or bound accumulators, all mergeable
+         * @return std::tuple of every result, in the order of <specs>
+         *
+         * @exception #pragma omp parallel
+         */
+        template <class Ty, class... Specs>
+        auto parallel_reduce_chunked(size_t chunk, const Ty* arr, size_t size, const Specs&... specs)
+        {
+            using tuple_type = std::tuple<bound_type<Ty, Specs>...>;
+            static_assert((is_mergeable<bound_type<Ty, Specs>>::value && ...), "parallel_reduce needs mergeable reducers");
+
+            if (chunk == 0) chunk = default_chunk;
+            const size_t chunks = size == 0 ? 1 : (size - 1) / chunk + 1;
+
+            const tuple_type first(_bind<Ty>(specs)...);
+            std::vector<tuple_type> partial(chunks, std::apply([](const auto&... each) { return tuple_type(reducer::identity_of(each)...); }, first));
+            partial[0] = first;
+
+#pragma omp parallel for schedule(static)
+            for (long long idx = 0; idx < static_cast<long long>(chunks); idx++)
+            {
+                const size_t begin = static_cast<size_t>(idx) * chunk;
+                const size_t count = size - begin < chunk ? size - begin : chunk;
+                std::apply([arr, begin, count](auto&... each) { reducer::consume(arr + begin, count, each...); }, partial[idx]);
+            }
+
+            reducer::tree_merge(partial);
+            return reducer::_results(partial[0]);
+        }
+
+        template <class Ty, class... Specs>
+        auto parallel_reduce(const Ty* arr, size_t size, const Specs&... specs)
+        {
+            return reducer::parallel_reduce_chunked(default_chunk, arr, size, specs...);
+        }
+
+        template <class Range, class... Specs, class = std::enable_if_t<_contiguous<Range>::value>>
+        auto parallel_reduce(const Range& range, const Specs&... specs)
+        {
+            return reducer::parallel_reduce_chunked(default_chunk, std::data(range), std::size(range), specs...);
+        }
+
+    } // namespace reducer
+
+} // namespace nw
@@ -0,0 +1,669 @@
+#pragma once
+
+#include <nowifi/util/consumer.hpp>
+#include <nowifi/math/reducer/simd.hpp>
+
+#include <tuple>
+#include <utility>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <cstdint>
+
+namespace nw {
+
+    /*
+     * Statically dispatched reducers.
+     *
+     * A spec (Min, Max, Sum, ...) is a stateless tag; spec.bind<Ty>() gives
+     * its accumulator for element type Ty, a CRTP Reducer with consume()
+     * and result(). reduce() binds every spec to the element type and runs
+     * them all in one loop with no virtual calls, so the whole fused body
+     * inlines and the data is read once:
+     *
+     *   auto [lo, hi, total, n] = reducer::reduce(vec, reducer::Min{}, reducer::Max{}, reducer::Sum{}, reducer::Count{});
+     *
+     * A bound accumulator may be passed instead of a spec to start from its
+     * state. Dynamic wraps any accumulator as a Consumer for runtime use.
+     *
+     * Every accumulator is mergeable: identity_of() gives an empty one
+     * (default-constructed unless it has parameters), and a.merge(b) leaves
+     * <a> as if it had also consumed what <b> did, right after its own
+     * input. parallel.hpp builds on that.
+     *
+     * Contiguous input goes through each accumulator's bulk consume() one
+     * block at a time; Min, Max, MinMax, Sum and ArgMin/ArgMax use the
+     * vector kernels of simd.hpp there.
+     */
+    namespace reducer {
+
+        // Base of every bound accumulator, to tell them from specs
+        struct _bound { };
+
+        //-------------------- Reducer --------------------//
+
+        /*
+         * <Derived> provides consume(const Ty&), merge(const Derived&) and
+         * result(), and brings the bulk overloads in with
+         * `using Reducer<...>::consume;`.
+         */
+        template <class Derived, class Ty>
+        class Reducer : public _bound
+        {
+        public:
+            using value_type = Ty;
+
+            Derived& derived() noexcept
+            {
+                return static_cast<Derived&>(*this);
+            }
+
+            const Derived& derived() const noexcept
+            {
+                return static_cast<const Derived&>(*this);
+            }
+
+            template <class _Iter>
+            Derived& stl_consume(_Iter _First, const _Iter _Last)
+            {
+                Derived& self = this->derived();
+                for (; _First != _Last; ++_First) self.consume(*_First);
+                return self;
+            }
+
+            Derived& consume(const Ty* arr, size_t size)
+            {
+                return this->stl_consume(arr, arr + size);
+            }
+        };
+
+        template <class Ty>
+        constexpr Ty _highest() noexcept
+        {
+            return std::numeric_limits<Ty>::has_infinity ? std::numeric_limits<Ty>::infinity() : std::numeric_limits<Ty>::max();
+        }
+
+        template <class Ty>
+        constexpr Ty _lowest() noexcept
+        {
+            return std::numeric_limits<Ty>::has_infinity ? -std::numeric_limits<Ty>::infinity() : std::numeric_limits<Ty>::lowest();
+        }
+
+        //-------------------- accumulators --------------------//
+
+        template <class Ty>
+        class MinOf : public Reducer<MinOf<Ty>, Ty>
+        {
+        protected:
+            Ty _min;
+
+        public:
+            using Reducer<MinOf<Ty>, Ty>::consume;
+
+            static constexpr Ty identity() noexcept { return _highest<Ty>(); }
+
+            explicit MinOf(const Ty& value = identity())
+                : _min(value) {}
+
+            // Select, not branch, so fused loops stay vectorizable
+            void consume(const Ty& value)
+            {
+                _min = value < _min ? value : _min;
+            }
+
+            MinOf& consume(const Ty* arr, size_t size)
+            {
+                _min = simd::min(arr, size, _min);
+                return *this;
+            }
+
+            MinOf& merge(const MinOf& other)
+            {
+                this->consume(other._min);
+                return *this;
+            }
+
+            const Ty& result() const
+            {
+                return _min;
+            }
+        };
+
+        template <class Ty>
+        class MaxOf : public Reducer<MaxOf<Ty>, Ty>
+        {
+        protected:
+            Ty _max;
+
+        public:
+            using Reducer<MaxOf<Ty>, Ty>::consume;
+
+            static constexpr Ty identity() noexcept { return _lowest<Ty>(); }
+
+            explicit MaxOf(const Ty& value = identity())
+                : _max(value) {}
+
+            void consume(const Ty& value)
+            {
+                _max = _max < value ? value : _max;
+            }
+
+            MaxOf& consume(const Ty* arr, size_t size)
+            {
+                _max = simd::max(arr, size, _max);
+                return *this;
+            }
+
+            MaxOf& merge(const MaxOf& other)
+            {
+                this->consume(other._max);
+                return *this;
+            }
+
+            const Ty& result() const
+            {
+                return _max;
+            }
+        };
+
+        template <class Ty>
+        class MinMaxOf : public Reducer<MinMaxOf<Ty>, Ty>
+        {
+        protected:
+            Ty _min;
+            Ty _max;
+
+        public:
+            using Reducer<MinMaxOf<Ty>, Ty>::consume;
+
+            MinMaxOf()
+                : _min(_highest<Ty>()), _max(_lowest<Ty>()) {}
+
+            MinMaxOf(const Ty& min, const Ty& max)
+                : _min(min), _max(max) {}
+
+            void consume(const Ty& value)
+            {
+                _min = value < _min ? value : _min;
+                _max = _max < value ? value : _max;
+            }
+
+            MinMaxOf& consume(const Ty* arr, size_t size)
+            {
+                std::tie(_min, _max) = simd::minmax(arr, size, _min, _max);
+                return *this;
+            }
+
+            MinMaxOf& merge(const MinMaxOf& other)
+            {
+                _min = other._min < _min ? other._min : _min;
+                _max = _max < other._max ? other._max : _max;
+                return *this;
+            }
+
+            // (min, max)
+            std::pair<Ty, Ty> result() const
+            {
+                return std::pair<Ty, Ty>(_min, _max);
+            }
+        };
+
+        /*
+         * Smallest value and the position of its first occurrence, counting
+         * from the first consumed element. NaNs never replace a value.
+         */
+        template <class Ty>
+        class ArgMinOf : public Reducer<ArgMinOf<Ty>, Ty>
+        {
+        protected:
+            Ty _min = Ty();
+            size_t _index = 0;
+            size_t _position = 0;
+
+        public:
+            using Reducer<ArgMinOf<Ty>, Ty>::consume;
+
+            void consume(const Ty& value)
+            {
+                if (_position == 0 || value < _min)
+                {
+                    _min = value;
+                    _index = _position;
+                }
+                _position++;
+            }
+
+            ArgMinOf& consume(const Ty* arr, size_t size)
+            {
+                if (size == 0) return *this;
+                const std::pair<Ty, size_t> found = simd::argmin(arr, size);
+                if (_position == 0 || found.first < _min)
+                {
+                    _min = found.first;
+                    _index = _position + found.second;
+                }
+                _position += size;
+                return *this;
+            }
+
+            // <other> counts its indices from the element after this one's last
+            ArgMinOf& merge(const ArgMinOf& other)
+            {
+                if (other._position == 0) return *this;
+                if (_position == 0 || other._min < _min)
+                {
+                    _min = other._min;
+                    _index = _position + other._index;
+                }
+                _position += other._position;
+                return *this;
+            }
+
+            // (value, index); (Ty(), 0) if nothing was consumed
+            std::pair<Ty, size_t> result() const
+            {
+                return std::pair<Ty, size_t>(_min, _index);
+            }
+        };
+
+        template <class Ty>
+        class ArgMaxOf : public Reducer<ArgMaxOf<Ty>, Ty>
+        {
+        protected:
+            Ty _max = Ty();
+            size_t _index = 0;
+            size_t _position = 0;
+
+        public:
+            using Reducer<ArgMaxOf<Ty>, Ty>::consume;
+
+            void consume(const Ty& value)
+            {
+                if (_position == 0 || _max < value)
+                {
+                    _max = value;
+                    _index = _position;
+                }
+                _position++;
+            }
+
+            ArgMaxOf& consume(const Ty* arr, size_t size)
+            {
+                if (size == 0) return *this;
+                const std::pair<Ty, size_t> found = simd::argmax(arr, size);
+                if (_position == 0 || _max < found.first)
+                {
+                    _max = found.first;
+                    _index = _position + found.second;
+                }
+                _position += size;
+                return *this;
+            }
+
+            ArgMaxOf& merge(const ArgMaxOf& other)
+            {
+                if (other._position == 0) return *this;
+                if (_position == 0 || _max < other._max)
+                {
+                    _max = other._max;
+                    _index = _position + other._index;
+                }
+                _position += other._position;
+                return *this;
+            }
+
+            // (value, index); (Ty(), 0) if nothing was consumed
+            std::pair<Ty, size_t> result() const
+            {
+                return std::pair<Ty, size_t>(_max, _index);
+            }
+        };
+
+        template <class Ty, class Acc = sum_type<Ty>>
+        class SumOf : public Reducer<SumOf<Ty, Acc>, Ty>
+        {
+        protected:
+            Acc _sum;
+
+        public:
+            using Reducer<SumOf<Ty, Acc>, Ty>::consume;
+
+            explicit SumOf(const Acc& value = Acc(0))
+                : _sum(value) {}
+
+            void consume(const Ty& value)
+            {
+                _sum += static_cast<Acc>(value);
+            }
+
+            // Vectorized with the default accumulator, and with any integer one:
+            // the 64-bit sum truncated to Acc wraps like adding in Acc
+            SumOf& consume(const Ty* arr, size_t size)
+            {
+                if constexpr (std::is_same<Acc, sum_type<Ty>>::value) _sum = simd::sum(arr, size, _sum);
+                else if constexpr (std::is_integral<Ty>::value && std::is_integral<Acc>::value) _sum = static_cast<Acc>(simd::sum(arr, size, static_cast<sum_type<Ty>>(_sum)));
+                else this->stl_consume(arr, arr + size);
+                return *this;
+            }
+
+            SumOf& merge(const SumOf& other)
+            {
+                _sum += other._sum;
+                return *this;
+            }
+
+            const Acc& result() const
+            {
+                return _sum;
+            }
+        };
+
+        template <class Ty>
+        class CountOf : public Reducer<CountOf<Ty>, Ty>
+        {
+        protected:
+            size_t _count;
+
+        public:
+            using Reducer<CountOf<Ty>, Ty>::consume;
+
+            explicit CountOf(size_t value = 0)
+                : _count(value) {}
+
+            void consume(const Ty&)
+            {
+                _count++;
+            }
+
+            CountOf& consume(const Ty*, size_t size)
+            {
+                _count += size;
+                return *this;
+            }
+
+            CountOf& merge(const CountOf& other)
+            {
+                _count += other._count;
+                return *this;
+            }
+
+            size_t result() const
+            {
+                return _count;
+            }
+        };
+
+        template <class Ty>
+        class MeanOf : public Reducer<MeanOf<Ty>, Ty>
+        {
+        protected:
+            double _sum = 0;
+            size_t _count = 0;
+
+        public:
+            using Reducer<MeanOf<Ty>, Ty>::consume;
+
+            void consume(const Ty& value)
+            {
+                _sum += static_cast<double>(value);
+                _count++;
+            }
+
+            MeanOf& merge(const MeanOf& other)
+            {
+                _sum += other._sum;
+                _count += other._count;
+                return *this;
+            }
+
+            // 0 if nothing was consumed
+            double result() const
+            {
+                return _count == 0 ? 0.0 : _sum / static_cast<double>(_count);
+            }
+        };
+
+        //-------------------- specs --------------------//
+
+        struct Min
+        {
+            template <class Ty>
+            MinOf<Ty> bind() const { return MinOf<Ty>(); }
+        };
+
+        struct Max
+        {
+            template <class Ty>
+            MaxOf<Ty> bind() const { return MaxOf<Ty>(); }
+        };
+
+        struct MinMax
+        {
+            template <class Ty>
+            MinMaxOf<Ty> bind() const { return MinMaxOf<Ty>(); }
+        };
+
+        struct ArgMin
+        {
+            template <class Ty>
+            ArgMinOf<Ty> bind() const { return ArgMinOf<Ty>(); }
+        };
+
+        struct ArgMax
+        {
+            template <class Ty>
+            ArgMaxOf<Ty> bind() const { return ArgMaxOf<Ty>(); }
+        };
+
+        // Sum<> accumulates in sum_type, Sum<Acc> in Acc
+        template <class Acc = void>
+        struct Sum
+        {
+            template <class Ty>
+            using bound = SumOf<Ty, std::conditional_t<std::is_void<Acc>::value, sum_type<Ty>, Acc>>;
+
+            template <class Ty>
+            bound<Ty> bind() const { return bound<Ty>(); }
+        };
+
+        struct Count
+        {
+            template <class Ty>
+            CountOf<Ty> bind() const { return CountOf<Ty>(); }
+        };
+
+        struct Mean
+        {
+            template <class Ty>
+            MeanOf<Ty> bind() const { return MeanOf<Ty>(); }
+        };
+
+        template <class Ty, class Spec>
+        auto _bind(const Spec& spec)
+        {
+            if constexpr (std::is_base_of<_bound, Spec>::value) return spec;
+            else return spec.template bind<Ty>();
+        }
+
+        template <class Ty, class Spec>
+        using bound_type = decltype(_bind<Ty>(std::declval<const Spec&>()));
+
+        // Has merge(const Bound&)
+        template <class Bound, class = void>
+        struct is_mergeable : std::false_type { };
+
+        template <class Bound>
+        struct is_mergeable<Bound, std::void_t<decltype(std::declval<Bound&>().merge(std::declval<const Bound&>()))>>
+            : std::true_type { };
+
+        template <class Bound, class = void>
+        struct _has_empty : std::false_type { };
+
+        template <class Bound>
+        struct _has_empty<Bound, std::void_t<decltype(std::declval<const Bound&>().empty())>>
+            : std::true_type { };
+
+        /*
+         * Identity with the parameters of <reducer> (k of a top-k, buckets of
+         * a histogram): reducer.empty() where defined, Bound() otherwise.
+         */
+        template <class Bound>
+        Bound identity_of(const Bound& reducer)
+        {
+            if constexpr (_has_empty<Bound>::value) return reducer.empty();
+            else return Bound();
+        }
+
+        //-------------------- fused loops --------------------//
+
+        /*
+         * Feeds [_First, _Last) once to every bound accumulator in <reducers>.
+         */
+        template <class _Iter, class... Reducers>
+        void stl_consume(_Iter _First, const _Iter _Last, Reducers&... reducers)
+        {
+            for (; _First != _Last; ++_First)
+            {
+                const auto& value = *_First;
+                (reducers.consume(value), ...);
+            }
+        }
+
+        // Elements of Ty per block of the blocked loop, about half of L1d
+        template <class Ty>
+        constexpr size_t _block_size = sizeof(Ty) < 16 * 1024 ? 16 * 1024 / sizeof(Ty) : 1;
+
+        /*
+         * Contiguous version: every reducer takes a block through its bulk
+         * consume() while the block is still in L1, so each one runs its own
+         * vector kernel and memory is still read once.
+         */
+        template <class Ty, class... Reducers>
+        void consume(const Ty* arr, size_t size, Reducers&... reducers)
+        {
+            if constexpr (sizeof...(Reducers) == 1)
+            {
+                (reducers.consume(arr, size), ...);
+            }
+            else
+            {
+                for (size_t begin = 0; begin < size; begin += _block_size<Ty>)
+                {
+                    const size_t count = size - begin < _block_size<Ty> ? size - begin : _block_size<Ty>;
+                    (reducers.consume(arr + begin, count), ...);
+                }
+            }
+        }
+
+        template <class Tuple>
+        auto _results(const Tuple& reducers)
+        {
+            return std::apply([](const auto&... each) { return std::make_tuple(each.result()...); }, reducers);
+        }
+
+        /*
+         * Binds <specs> to the element type and reduces [_First, _Last) in one pass.
+         *
+         * @return std::tuple of every result, in the order of <specs>
+         */
+        template <class _Iter, class... Specs>
+        auto stl_reduce(_Iter _First, const _Iter _Last, const Specs&... specs)
+        {
+            using value_type = typename std::iterator_traits<_Iter>::value_type;
+            std::tuple<bound_type<value_type, Specs>...> reducers(_bind<value_type>(specs)...);
+            std::apply([&_First, &_Last](auto&... each) { reducer::stl_consume(_First, _Last, each...); }, reducers);
+            return reducer::_results(reducers);
+        }
+
+        template <class Ty, class... Specs>
+        auto reduce(const Ty* arr, size_t size, const Specs&... specs)
+        {
+            std::tuple<bound_type<Ty, Specs>...> reducers(_bind<Ty>(specs)...);
+            std::apply([arr, size](auto&... each) { reducer::consume(arr, size, each...); }, reducers);
+            return reducer::_results(reducers);
+        }
+
+        template <class Range, class = void>
+        struct _contiguous : std::false_type { };
+
+        template <class Range>
+        struct _contiguous<Range, std::void_t<decltype(std::data(std::declval<const Range&>())), decltype(std::size(std::declval<const Range&>()))>>
+            : std::is_pointer<decltype(std::data(std::declval<const Range&>()))> { };
+
+        // Vectors, arrays and strings take the contiguous path
+        template <class Range, class... Specs, class = std::enable_if_t<!std::is_pointer<Range>::value>>
+        auto reduce(const Range& range, const Specs&... specs)
+        {
+            if constexpr (_contiguous<Range>::value) return reducer::reduce(std::data(range), std::size(range), specs...);
+            else return reducer::stl_reduce(std::begin(range), std::end(range), specs...);
+        }
+
+        //-------------------- Dynamic --------------------//
+
+        /*
+         * Consumer_Reset over a bound accumulator: one virtual call per
+         * consume(), and one per array for the bulk overload, which runs the
+         * static loop.
+         */
+        template <class Bound>
+        class Dynamic : public Consumer_Reset<typename Bound::value_type>
+        {
+        public:
+            using value_type = typename Bound::value_type;
+
+        protected:
+            Bound _initial;
+            Bound _reducer;
+
+        public:
+            explicit Dynamic(const Bound& reducer = Bound())
+                : _initial(reducer), _reducer(reducer) {}
+
+            void consume(const value_type& value) override
+            {
+                _reducer.consume(value);
+            }
+
+            void consume(const value_type* arr, size_t size) override
+            {
+                _reducer.consume(arr, size);
+            }
+
+            void merge(const Dynamic& other)
+            {
+                _reducer.merge(other._reducer);
+            }
+
+            // Back to the state given at construction
+            void reset()
+            {
+                _reducer = _initial;
+            }
+
+            // Back to the state given at construction, then <value>
+            void reset(const value_type& value) override
+            {
+                _reducer = _initial;
+                _reducer.consume(value);
+            }
+
+            const Bound& reducer() const
+            {
+                return _reducer;
+            }
+
+            auto result() const
+            {
+                return _reducer.result();
+            }
+        };
+
+        template <class Ty, class Spec>
+        Dynamic<bound_type<Ty, Spec>> make_dynamic(const Spec& spec)
+        {
+            return Dynamic<bound_type<Ty, Spec>>(_bind<Ty>(spec));
+        }
+
+    } // namespace reducer
+
+} // namespace nw
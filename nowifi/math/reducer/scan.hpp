@@ -0,0 +1,76 @@
+#pragma once
+
+#include <nowifi/io/scanner.hpp>
+#include <nowifi/math/reducer/reduce.hpp>
+
+#include <vector>
+#include <tuple>
+
+namespace nw {
+
+    /*
+     * Parse-and-reduce: Scanner::readChunked* hand each parsed chunk to the
+     * reducers while it is still in cache, so aggregating n values takes
+     * O(chunk) memory instead of readNewVector's O(n):
+     *
+     *   auto [lo, hi, total] = reducer::scan_reduce<int>(scanner, n, reducer::Min{}, reducer::Max{}, reducer::Sum<>{});
+     */
+    namespace reducer {
+
+        /*
+         * Reads <size> values of Ty from <scanner> and reduces them with <specs>.
+         *
+         * @return std::tuple of every result, in the order of <specs>
+         */
+        template <class Ty, class charTy, class... Specs>
+        auto scan_reduce(basic_Scanner<charTy>& scanner, size_t size, const Specs&... specs)
+        {
+            std::tuple<bound_type<Ty, Specs>...> reducers(_bind<Ty>(specs)...);
+            scanner.template readChunked<Ty>(size, [&reducers](const Ty* arr, size_t count)
+            {
+                std::apply([arr, count](auto&... each) { reducer::consume(arr, count, each...); }, reducers);
+            });
+            return reducer::_results(reducers);
+        }
+
+        /*
+         * scan_reduce until the end of the stream.
+         *
+         * @return std::tuple of every result, in the order of <specs>
+         */
+        template <class Ty, class charTy, class... Specs>
+        auto scan_reduce_all(basic_Scanner<charTy>& scanner, const Specs&... specs)
+        {
+            std::tuple<bound_type<Ty, Specs>...> reducers(_bind<Ty>(specs)...);
+            scanner.template readChunked_all<Ty>([&reducers](const Ty* arr, size_t count)
+            {
+                std::apply([arr, count](auto&... each) { reducer::consume(arr, count, each...); }, reducers);
+            });
+            return reducer::_results(reducers);
+        }
+
+        /*
+         * Reads <rows> rows of <columns> values and reduces every column on
+         * its own with the same <specs>.
+         *
+         * @return One std::tuple of results per column
+         */
+        template <class Ty, class charTy, class... Specs>
+        auto scan_reduce_columns(basic_Scanner<charTy>& scanner, size_t rows, size_t columns, const Specs&... specs)
+        {
+            using tuple_type = std::tuple<bound_type<Ty, Specs>...>;
+            std::vector<tuple_type> reducers(columns, tuple_type(_bind<Ty>(specs)...));
+            scanner.template readChunked_columns<Ty>(rows, columns, [&reducers](size_t column, const Ty* arr, size_t count)
+            {
+                std::apply([arr, count](auto&... each) { reducer::consume(arr, count, each...); }, reducers[column]);
+            });
+
+            std::vector<decltype(reducer::_results(reducers[0]))> results;
+            results.reserve(columns);
+            for (const tuple_type& each : reducers) results.push_back(reducer::_results(each));
+            return results;
+        }
+
+    } // namespace reducer
+
+} // namespace nw
@@ -0,0 +1,746 @@
+#pragma once
+
+#include <nowifi/util/cpu.hpp>
+
+#include <atomic>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+#if !defined(NW_REDUCER_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#include <immintrin.h>
+#define NW_REDUCER_SIMD
+#endif
+
+#if defined(NW_REDUCER_SIMD)
+#if defined(_MSC_VER) && !defined(__clang__)
+#define NW_REDUCER_TARGET_SSE42
+#define NW_REDUCER_TARGET_AVX2
+#define NW_REDUCER_TARGET_AVX512
+#else
+#define NW_REDUCER_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define NW_REDUCER_TARGET_AVX2 __attribute__((target("avx2")))
+#define NW_REDUCER_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+#endif
+#endif
+
+namespace nw {
+
+    namespace reducer {
+
+        // Accumulator type of Sum: 64-bit for integers, the type itself otherwise
+        template <class Ty>
+        using sum_type = std::conditional_t<std::is_integral<Ty>::value,
+            std::conditional_t<std::is_signed<Ty>::value, int64_t, uint64_t>, Ty>;
+
+        /*
+         * Bulk kernels over contiguous arrays: min, max, minmax, sum, argmin
+         * and argmax, with the same results (and NaN handling: NaNs are
+         * skipped unless first) as the scalar reducers in reduce.hpp.
+         *
+         * 32-bit integers, 64-bit signed integers, float and double run
+         * SSE4.2, AVX2 or AVX-512 code chosen at runtime from cpu::get(),
+         * with four independent accumulators so the loop is bound by loads,
+         * not by the latency of min/add. Other types, other targets and
+         * NW_REDUCER_NO_SIMD builds use the scalar loop.
+         *
+         * Float sums add in a different order than a sequential loop, so
+         * the last bits may differ from SumOf::consume(value) one by one.
+         */
+        namespace simd {
+
+            enum class level : uint8_t
+            {
+                scalar,
+                sse42,
+                avx2,
+                avx512,
+            };
+
+            [[nodiscard]] inline level detected() noexcept
+            {
+                static const level value = []() {
+#if defined(NW_REDUCER_SIMD)
+                    const cpu::features& features = cpu::get();
+                    if (features.avx512f && features.avx512dq) return level::avx512;
+                    if (features.avx2) return level::avx2;
+                    if (features.sse42) return level::sse42;
+#endif
+                    return level::scalar;
+                }();
+                return value;
+            }
+
+            inline std::atomic<level>& _limit() noexcept
+            {
+                static std::atomic<level> value{ level::avx512 };
+                return value;
+            }
+
+            /*
+             * Caps the instruction set used from now on, e.g. to compare paths or
+             * to keep AVX-512 frequency drops out of latency-sensitive code.
+             */
+            inline void limit(level cap) noexcept
+            {
+                _limit().store(cap, std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] inline level active() noexcept
+            {
+                const level cap = _limit().load(std::memory_order_relaxed);
+                return static_cast<uint8_t>(cap) < static_cast<uint8_t>(detected()) ? cap : detected();
+            }
+
+            enum class _kind : uint8_t { none, i32, u32, i64, f32, f64 };
+
+            template <class Ty>
+            constexpr _kind _kind_of() noexcept
+            {
+                if constexpr (std::is_same<Ty, float>::value) return _kind::f32;
+                else if constexpr (std::is_same<Ty, double>::value) return _kind::f64;
+                else if constexpr (std::is_integral<Ty>::value && !std::is_same<Ty, bool>::value && sizeof(Ty) == 4) return std::is_signed<Ty>::value ? _kind::i32 : _kind::u32;
+                else if constexpr (std::is_integral<Ty>::value && std::is_signed<Ty>::value && sizeof(Ty) == 8) return _kind::i64;
+                else return _kind::none;
+            }
+
+            template <class Ty>
+            constexpr bool vectorized = _kind_of<Ty>() != _kind::none;
+
+            //-------------------- scalar --------------------//
+
+            // Same select as MinOf / MaxOf::consume
+            template <bool Max, class Ty>
+            inline Ty _pick(const Ty& value, const Ty& best)
+            {
+                if constexpr (Max) return best < value ? value : best;
+                else return value < best ? value : best;
+            }
+
+            template <bool Max, class Ty>
+            Ty _extreme_scalar(const Ty* arr, size_t size, Ty init)
+            {
+                for (size_t idx = 0; idx < size; idx++) init = _pick<Max>(arr[idx], init);
+                return init;
+            }
+
+            template <class Ty>
+            std::pair<Ty, Ty> _minmax_scalar(const Ty* arr, size_t size, Ty lo, Ty hi)
+            {
+                for (size_t idx = 0; idx < size; idx++)
+                {
+                    lo = _pick<false>(arr[idx], lo);
+                    hi = _pick<true>(arr[idx], hi);
+                }
+                return std::pair<Ty, Ty>(lo, hi);
+            }
+
+            template <class Ty>
+            sum_type<Ty> _sum_scalar(const Ty* arr, size_t size, sum_type<Ty> init)
+            {
+                for (size_t idx = 0; idx < size; idx++) init += static_cast<sum_type<Ty>>(arr[idx]);
+                return init;
+            }
+
+#if defined(NW_REDUCER_SIMD)
+
+            /*
+             * Kernels shared by every instruction set, over a traits class <V>:
+             * reg, lanes, load, set1, pick<Max>(value, best), store, and for
+             * sums sum_reg, sum_lanes, sum_zero, sum_add, sum_merge, sum_store.
+             * Expanded once per target because GCC and Clang only inline the
+             * traits' intrinsics into functions compiled for that target.
+             */
+#define NW_REDUCER_SIMD_KERNELS(TARGET) \
+            template <class V, bool Max> TARGET \
+            typename V::value_type _extreme(const typename V::value_type* arr, size_t size, typename V::value_type init) \
+            { \
+                using Ty = typename V::value_type; \
+                typename V::reg a0 = V::set1(init), a1 = a0, a2 = a0, a3 = a0; \
+                size_t idx = 0; \
+                for (; idx + 4 * V::lanes <= size; idx += 4 * V::lanes) \
+                { \
+                    a0 = V::template pick<Max>(V::load(arr + idx), a0); \
+                    a1 = V::template pick<Max>(V::load(arr + idx + V::lanes), a1); \
+                    a2 = V::template pick<Max>(V::load(arr + idx + 2 * V::lanes), a2); \
+                    a3 = V::template pick<Max>(V::load(arr + idx + 3 * V::lanes), a3); \
+                } \
+                for (; idx + V::lanes <= size; idx += V::lanes) a0 = V::template pick<Max>(V::load(arr + idx), a0); \
+                a0 = V::template pick<Max>(V::template pick<Max>(a1, a0), V::template pick<Max>(a3, a2)); \
+                Ty lanes[V::lanes]; \
+                V::store(lanes, a0); \
+                for (size_t lane = 0; lane < V::lanes; lane++) init = _pick<Max>(lanes[lane], init); \
+                for (; idx < size; idx++) init = _pick<Max>(arr[idx], init); \
+                return init; \
+            } \
+            \
+            template <class V> TARGET \
+            std::pair<typename V::value_type, typename V::value_type> _minmax(const typename V::value_type* arr, size_t size, typename V::value_type lo, typename V::value_type hi) \
+            { \
+                using Ty = typename V::value_type; \
+                typename V::reg lo0 = V::set1(lo), lo1 = lo0, hi0 = V::set1(hi), hi1 = hi0; \
+                size_t idx = 0; \
+                for (; idx + 2 * V::lanes <= size; idx += 2 * V::lanes) \
+                { \
+                    const typename V::reg v0 = V::load(arr + idx); \
+                    const typename V::reg v1 = V::load(arr + idx + V::lanes); \
+                    lo0 = V::template pick<false>(v0, lo0); \
+                    hi0 = V::template pick<true>(v0, hi0); \
+                    lo1 = V::template pick<false>(v1, lo1); \
+                    hi1 = V::template pick<true>(v1, hi1); \
+                } \
+                lo0 = V::template pick<false>(lo1, lo0); \
+                hi0 = V::template pick<true>(hi1, hi0); \
+                Ty lanes[V::lanes]; \
+                V::store(lanes, lo0); \
+                for (size_t lane = 0; lane < V::lanes; lane++) lo = _pick<false>(lanes[lane], lo); \
+                V::store(lanes, hi0); \
+                for (size_t lane = 0; lane < V::lanes; lane++) hi = _pick<true>(lanes[lane], hi); \
+                return _minmax_scalar(arr + idx, size - idx, lo, hi); \
+            } \
+            \
+            template <class V> TARGET \
+            sum_type<typename V::value_type> _sum(const typename V::value_type* arr, size_t size, sum_type<typename V::value_type> init) \
+            { \
+                using Acc = sum_type<typename V::value_type>; \
+                typename V::sum_reg s0 = V::sum_zero(), s1 = s0, s2 = s0, s3 = s0; \
+                size_t idx = 0; \
+                for (; idx + 4 * V::lanes <= size; idx += 4 * V::lanes) \
+                { \
+                    s0 = V::sum_add(s0, V::load(arr + idx)); \
+                    s1 = V::sum_add(s1, V::load(arr + idx + V::lanes)); \
+                    s2 = V::sum_add(s2, V::load(arr + idx + 2 * V::lanes)); \
+                    s3 = V::sum_add(s3, V::load(arr + idx + 3 * V::lanes)); \
+                } \
+                for (; idx + V::lanes <= size; idx += V::lanes) s0 = V::sum_add(s0, V::load(arr + idx)); \
+                s0 = V::sum_merge(V::sum_merge(s0, s1), V::sum_merge(s2, s3)); \
+                Acc lanes[V::sum_lanes]; \
+                V::sum_store(lanes, s0); \
+                for (size_t lane = 0; lane < V::sum_lanes; lane++) init += lanes[lane]; \
+                return _sum_scalar(arr + idx, size - idx, init); \
+            }
+
+            //-------------------- SSE4.2 --------------------//
+
+            namespace _sse42 {
+
+                template <class Ty, _kind Kind = _kind_of<Ty>()>
+                struct traits;
+
+                template <class Ty>
+                struct traits<Ty, _kind::i32>
+                {
+                    using value_type = Ty;
+                    using reg = __m128i;
+                    using sum_reg = __m128i;
+                    static constexpr size_t lanes = 4;
+                    static constexpr size_t sum_lanes = 2;
+
+                    NW_REDUCER_TARGET_SSE42 static reg load(const Ty* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+                    NW_REDUCER_TARGET_SSE42 static reg set1(Ty value) { return _mm_set1_epi32(static_cast<int32_t>(value)); }
+                    NW_REDUCER_TARGET_SSE42 static void store(Ty* p, reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_SSE42 static reg pick(reg v, reg best) { return Max ? _mm_max_epi32(v, best) : _mm_min_epi32(v, best); }
+
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_zero() { return _mm_setzero_si128(); }
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_add(sum_reg acc, reg v)
+                    {
+                        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(v));
+                        return _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+                    }
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm_add_epi64(a, b); }
+                    NW_REDUCER_TARGET_SSE42 static void sum_store(sum_type<Ty>* p, sum_reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::u32> : traits<Ty, _kind::i32>
+                {
+                    using reg = __m128i;
+                    using sum_reg = __m128i;
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_SSE42 static reg pick(reg v, reg best) { return Max ? _mm_max_epu32(v, best) : _mm_min_epu32(v, best); }
+
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_add(sum_reg acc, reg v)
+                    {
+                        acc = _mm_add_epi64(acc, _mm_cvtepu32_epi64(v));
+                        return _mm_add_epi64(acc, _mm_cvtepu32_epi64(_mm_srli_si128(v, 8)));
+                    }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::i64>
+                {
+                    using value_type = Ty;
+                    using reg = __m128i;
+                    using sum_reg = __m128i;
+                    static constexpr size_t lanes = 2;
+                    static constexpr size_t sum_lanes = 2;
+
+                    NW_REDUCER_TARGET_SSE42 static reg load(const Ty* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+                    NW_REDUCER_TARGET_SSE42 static reg set1(Ty value) { return _mm_set1_epi64x(static_cast<long long>(value)); }
+                    NW_REDUCER_TARGET_SSE42 static void store(Ty* p, reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_SSE42 static reg pick(reg v, reg best)
+                    {
+                        return _mm_blendv_epi8(best, v, Max ? _mm_cmpgt_epi64(v, best) : _mm_cmpgt_epi64(best, v));
+                    }
+
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_zero() { return _mm_setzero_si128(); }
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_add(sum_reg acc, reg v) { return _mm_add_epi64(acc, v); }
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm_add_epi64(a, b); }
+                    NW_REDUCER_TARGET_SSE42 static void sum_store(sum_type<Ty>* p, sum_reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::f32>
+                {
+                    using value_type = float;
+                    using reg = __m128;
+                    using sum_reg = __m128;
+                    static constexpr size_t lanes = 4;
+                    static constexpr size_t sum_lanes = 4;
+
+                    NW_REDUCER_TARGET_SSE42 static reg load(const float* p) { return _mm_loadu_ps(p); }
+                    NW_REDUCER_TARGET_SSE42 static reg set1(float value) { return _mm_set1_ps(value); }
+                    NW_REDUCER_TARGET_SSE42 static void store(float* p, reg v) { _mm_storeu_ps(p, v); }
+
+                    // minps(a, b) is a < b ? a : b, so NaNs in <v> never win
+                    template <bool Max>
+                    NW_REDUCER_TARGET_SSE42 static reg pick(reg v, reg best) { return Max ? _mm_max_ps(v, best) : _mm_min_ps(v, best); }
+
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_zero() { return _mm_setzero_ps(); }
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_add(sum_reg acc, reg v) { return _mm_add_ps(acc, v); }
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm_add_ps(a, b); }
+                    NW_REDUCER_TARGET_SSE42 static void sum_store(float* p, sum_reg v) { _mm_storeu_ps(p, v); }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::f64>
+                {
+                    using value_type = double;
+                    using reg = __m128d;
+                    using sum_reg = __m128d;
+                    static constexpr size_t lanes = 2;
+                    static constexpr size_t sum_lanes = 2;
+
+                    NW_REDUCER_TARGET_SSE42 static reg load(const double* p) { return _mm_loadu_pd(p); }
+                    NW_REDUCER_TARGET_SSE42 static reg set1(double value) { return _mm_set1_pd(value); }
+                    NW_REDUCER_TARGET_SSE42 static void store(double* p, reg v) { _mm_storeu_pd(p, v); }
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_SSE42 static reg pick(reg v, reg best) { return Max ? _mm_max_pd(v, best) : _mm_min_pd(v, best); }
+
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_zero() { return _mm_setzero_pd(); }
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_add(sum_reg acc, reg v) { return _mm_add_pd(acc, v); }
+                    NW_REDUCER_TARGET_SSE42 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm_add_pd(a, b); }
+                    NW_REDUCER_TARGET_SSE42 static void sum_store(double* p, sum_reg v) { _mm_storeu_pd(p, v); }
+                };
+
+                NW_REDUCER_SIMD_KERNELS(NW_REDUCER_TARGET_SSE42)
+
+            } // namespace _sse42
+
+            //-------------------- AVX2 --------------------//
+
+            namespace _avx2 {
+
+                template <class Ty, _kind Kind = _kind_of<Ty>()>
+                struct traits;
+
+                template <class Ty>
+                struct traits<Ty, _kind::i32>
+                {
+                    using value_type = Ty;
+                    using reg = __m256i;
+                    using sum_reg = __m256i;
+                    static constexpr size_t lanes = 8;
+                    static constexpr size_t sum_lanes = 4;
+
+                    NW_REDUCER_TARGET_AVX2 static reg load(const Ty* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+                    NW_REDUCER_TARGET_AVX2 static reg set1(Ty value) { return _mm256_set1_epi32(static_cast<int32_t>(value)); }
+                    NW_REDUCER_TARGET_AVX2 static void store(Ty* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_AVX2 static reg pick(reg v, reg best) { return Max ? _mm256_max_epi32(v, best) : _mm256_min_epi32(v, best); }
+
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_zero() { return _mm256_setzero_si256(); }
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_add(sum_reg acc, reg v)
+                    {
+                        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+                        return _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+                    }
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm256_add_epi64(a, b); }
+                    NW_REDUCER_TARGET_AVX2 static void sum_store(sum_type<Ty>* p, sum_reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::u32> : traits<Ty, _kind::i32>
+                {
+                    using reg = __m256i;
+                    using sum_reg = __m256i;
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_AVX2 static reg pick(reg v, reg best) { return Max ? _mm256_max_epu32(v, best) : _mm256_min_epu32(v, best); }
+
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_add(sum_reg acc, reg v)
+                    {
+                        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v)));
+                        return _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1)));
+                    }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::i64>
+                {
+                    using value_type = Ty;
+                    using reg = __m256i;
+                    using sum_reg = __m256i;
+                    static constexpr size_t lanes = 4;
+                    static constexpr size_t sum_lanes = 4;
+
+                    NW_REDUCER_TARGET_AVX2 static reg load(const Ty* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+                    NW_REDUCER_TARGET_AVX2 static reg set1(Ty value) { return _mm256_set1_epi64x(static_cast<long long>(value)); }
+                    NW_REDUCER_TARGET_AVX2 static void store(Ty* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_AVX2 static reg pick(reg v, reg best)
+                    {
+                        return _mm256_blendv_epi8(best, v, Max ? _mm256_cmpgt_epi64(v, best) : _mm256_cmpgt_epi64(best, v));
+                    }
+
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_zero() { return _mm256_setzero_si256(); }
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_add(sum_reg acc, reg v) { return _mm256_add_epi64(acc, v); }
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm256_add_epi64(a, b); }
+                    NW_REDUCER_TARGET_AVX2 static void sum_store(sum_type<Ty>* p, sum_reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::f32>
+                {
+                    using value_type = float;
+                    using reg = __m256;
+                    using sum_reg = __m256;
+                    static constexpr size_t lanes = 8;
+                    static constexpr size_t sum_lanes = 8;
+
+                    NW_REDUCER_TARGET_AVX2 static reg load(const float* p) { return _mm256_loadu_ps(p); }
+                    NW_REDUCER_TARGET_AVX2 static reg set1(float value) { return _mm256_set1_ps(value); }
+                    NW_REDUCER_TARGET_AVX2 static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_AVX2 static reg pick(reg v, reg best) { return Max ? _mm256_max_ps(v, best) : _mm256_min_ps(v, best); }
+
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_zero() { return _mm256_setzero_ps(); }
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_add(sum_reg acc, reg v) { return _mm256_add_ps(acc, v); }
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm256_add_ps(a, b); }
+                    NW_REDUCER_TARGET_AVX2 static void sum_store(float* p, sum_reg v) { _mm256_storeu_ps(p, v); }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::f64>
+                {
+                    using value_type = double;
+                    using reg = __m256d;
+                    using sum_reg = __m256d;
+                    static constexpr size_t lanes = 4;
+                    static constexpr size_t sum_lanes = 4;
+
+                    NW_REDUCER_TARGET_AVX2 static reg load(const double* p) { return _mm256_loadu_pd(p); }
+                    NW_REDUCER_TARGET_AVX2 static reg set1(double value) { return _mm256_set1_pd(value); }
+                    NW_REDUCER_TARGET_AVX2 static void store(double* p, reg v) { _mm256_storeu_pd(p, v); }
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_AVX2 static reg pick(reg v, reg best) { return Max ? _mm256_max_pd(v, best) : _mm256_min_pd(v, best); }
+
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_zero() { return _mm256_setzero_pd(); }
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_add(sum_reg acc, reg v) { return _mm256_add_pd(acc, v); }
+                    NW_REDUCER_TARGET_AVX2 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm256_add_pd(a, b); }
+                    NW_REDUCER_TARGET_AVX2 static void sum_store(double* p, sum_reg v) { _mm256_storeu_pd(p, v); }
+                };
+
+                NW_REDUCER_SIMD_KERNELS(NW_REDUCER_TARGET_AVX2)
+
+            } // namespace _avx2
+
+            //-------------------- AVX-512 --------------------//
+
+            // GCC 12 fills the unused merge source of the unmasked AVX-512
+            // intrinsics with an undefined register and then warns about it
+            // at every call site (GCC bug 105593)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+            namespace _avx512 {
+
+                template <class Ty, _kind Kind = _kind_of<Ty>()>
+                struct traits;
+
+                template <class Ty>
+                struct traits<Ty, _kind::i32>
+                {
+                    using value_type = Ty;
+                    using reg = __m512i;
+                    using sum_reg = __m512i;
+                    static constexpr size_t lanes = 16;
+                    static constexpr size_t sum_lanes = 8;
+
+                    NW_REDUCER_TARGET_AVX512 static reg load(const Ty* p) { return _mm512_loadu_si512(p); }
+                    NW_REDUCER_TARGET_AVX512 static reg set1(Ty value) { return _mm512_set1_epi32(static_cast<int32_t>(value)); }
+                    NW_REDUCER_TARGET_AVX512 static void store(Ty* p, reg v) { _mm512_storeu_si512(p, v); }
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_AVX512 static reg pick(reg v, reg best) { return Max ? _mm512_max_epi32(v, best) : _mm512_min_epi32(v, best); }
+
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_zero() { return _mm512_setzero_si512(); }
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_add(sum_reg acc, reg v)
+                    {
+                        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 0)));
+                        return _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1)));
+                    }
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm512_add_epi64(a, b); }
+                    NW_REDUCER_TARGET_AVX512 static void sum_store(sum_type<Ty>* p, sum_reg v) { _mm512_storeu_si512(p, v); }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::u32> : traits<Ty, _kind::i32>
+                {
+                    using reg = __m512i;
+                    using sum_reg = __m512i;
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_AVX512 static reg pick(reg v, reg best) { return Max ? _mm512_max_epu32(v, best) : _mm512_min_epu32(v, best); }
+
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_add(sum_reg acc, reg v)
+                    {
+                        acc = _mm512_add_epi64(acc, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(v, 0)));
+                        return _mm512_add_epi64(acc, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(v, 1)));
+                    }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::i64>
+                {
+                    using value_type = Ty;
+                    using reg = __m512i;
+                    using sum_reg = __m512i;
+                    static constexpr size_t lanes = 8;
+                    static constexpr size_t sum_lanes = 8;
+
+                    NW_REDUCER_TARGET_AVX512 static reg load(const Ty* p) { return _mm512_loadu_si512(p); }
+                    NW_REDUCER_TARGET_AVX512 static reg set1(Ty value) { return _mm512_set1_epi64(static_cast<long long>(value)); }
+                    NW_REDUCER_TARGET_AVX512 static void store(Ty* p, reg v) { _mm512_storeu_si512(p, v); }
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_AVX512 static reg pick(reg v, reg best) { return Max ? _mm512_max_epi64(v, best) : _mm512_min_epi64(v, best); }
+
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_zero() { return _mm512_setzero_si512(); }
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_add(sum_reg acc, reg v) { return _mm512_add_epi64(acc, v); }
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm512_add_epi64(a, b); }
+                    NW_REDUCER_TARGET_AVX512 static void sum_store(sum_type<Ty>* p, sum_reg v) { _mm512_storeu_si512(p, v); }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::f32>
+                {
+                    using value_type = float;
+                    using reg = __m512;
+                    using sum_reg = __m512;
+                    static constexpr size_t lanes = 16;
+                    static constexpr size_t sum_lanes = 16;
+
+                    NW_REDUCER_TARGET_AVX512 static reg load(const float* p) { return _mm512_loadu_ps(p); }
+                    NW_REDUCER_TARGET_AVX512 static reg set1(float value) { return _mm512_set1_ps(value); }
+                    NW_REDUCER_TARGET_AVX512 static void store(float* p, reg v) { _mm512_storeu_ps(p, v); }
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_AVX512 static reg pick(reg v, reg best) { return Max ? _mm512_max_ps(v, best) : _mm512_min_ps(v, best); }
+
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_zero() { return _mm512_setzero_ps(); }
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_add(sum_reg acc, reg v) { return _mm512_add_ps(acc, v); }
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm512_add_ps(a, b); }
+                    NW_REDUCER_TARGET_AVX512 static void sum_store(float* p, sum_reg v) { _mm512_storeu_ps(p, v); }
+                };
+
+                template <class Ty>
+                struct traits<Ty, _kind::f64>
+                {
+                    using value_type = double;
+                    using reg = __m512d;
+                    using sum_reg = __m512d;
+                    static constexpr size_t lanes = 8;
+                    static constexpr size_t sum_lanes = 8;
+
+                    NW_REDUCER_TARGET_AVX512 static reg load(const double* p) { return _mm512_loadu_pd(p); }
+                    NW_REDUCER_TARGET_AVX512 static reg set1(double value) { return _mm512_set1_pd(value); }
+                    NW_REDUCER_TARGET_AVX512 static void store(double* p, reg v) { _mm512_storeu_pd(p, v); }
+
+                    template <bool Max>
+                    NW_REDUCER_TARGET_AVX512 static reg pick(reg v, reg best) { return Max ? _mm512_max_pd(v, best) : _mm512_min_pd(v, best); }
+
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_zero() { return _mm512_setzero_pd(); }
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_add(sum_reg acc, reg v) { return _mm512_add_pd(acc, v); }
+                    NW_REDUCER_TARGET_AVX512 static sum_reg sum_merge(sum_reg a, sum_reg b) { return _mm512_add_pd(a, b); }
+                    NW_REDUCER_TARGET_AVX512 static void sum_store(double* p, sum_reg v) { _mm512_storeu_pd(p, v); }
+                };
+
+                NW_REDUCER_SIMD_KERNELS(NW_REDUCER_TARGET_AVX512)
+
+            } // namespace _avx512
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#undef NW_REDUCER_SIMD_KERNELS
+
+#endif // NW_REDUCER_SIMD
+
+            //-------------------- dispatch --------------------//
+
+            /*
+             * @return The smaller of <init> and every element (NaN elements skipped)
+             */
+            template <class Ty>
+            [[nodiscard]] Ty min(const Ty* arr, size_t size, Ty init)
+            {
+#if defined(NW_REDUCER_SIMD)
+                if constexpr (vectorized<Ty>)
+                {
+                    switch (active())
+                    {
+                    case level::avx512: return _avx512::_extreme<_avx512::traits<Ty>, false>(arr, size, init);
+                    case level::avx2: return _avx2::_extreme<_avx2::traits<Ty>, false>(arr, size, init);
+                    case level::sse42: return _sse42::_extreme<_sse42::traits<Ty>, false>(arr, size, init);
+                    default: break;
+                    }
+                }
+#endif
+                return _extreme_scalar<false>(arr, size, init);
+            }
+
+            template <class Ty>
+            [[nodiscard]] Ty max(const Ty* arr, size_t size, Ty init)
+            {
+#if defined(NW_REDUCER_SIMD)
+                if constexpr (vectorized<Ty>)
+                {
+                    switch (active())
+                    {
+                    case level::avx512: return _avx512::_extreme<_avx512::traits<Ty>, true>(arr, size, init);
+                    case level::avx2: return _avx2::_extreme<_avx2::traits<Ty>, true>(arr, size, init);
+                    case level::sse42: return _sse42::_extreme<_sse42::traits<Ty>, true>(arr, size, init);
+                    default: break;
+                    }
+                }
+#endif
+                return _extreme_scalar<true>(arr, size, init);
+            }
+
+            /*
+             * Both bounds in one pass over <arr>.
+             *
+             * @return (min, max) of <lo>, <hi> and every element
+             */
+            template <class Ty>
+            [[nodiscard]] std::pair<Ty, Ty> minmax(const Ty* arr, size_t size, Ty lo, Ty hi)
+            {
+#if defined(NW_REDUCER_SIMD)
+                if constexpr (vectorized<Ty>)
+                {
+                    switch (active())
+                    {
+                    case level::avx512: return _avx512::_minmax<_avx512::traits<Ty>>(arr, size, lo, hi);
+                    case level::avx2: return _avx2::_minmax<_avx2::traits<Ty>>(arr, size, lo, hi);
+                    case level::sse42: return _sse42::_minmax<_sse42::traits<Ty>>(arr, size, lo, hi);
+                    default: break;
+                    }
+                }
+#endif
+                return _minmax_scalar(arr, size, lo, hi);
+            }
+
+            /*
+             * @return <init> plus every element, accumulated in sum_type<Ty>
+             *         (integers wrap like the scalar loop)
+             */
+            template <class Ty>
+            [[nodiscard]] sum_type<Ty> sum(const Ty* arr, size_t size, sum_type<Ty> init = sum_type<Ty>(0))
+            {
+#if defined(NW_REDUCER_SIMD)
+                if constexpr (vectorized<Ty>)
+                {
+                    switch (active())
+                    {
+                    case level::avx512: return _avx512::_sum<_avx512::traits<Ty>>(arr, size, init);
+                    case level::avx2: return _avx2::_sum<_avx2::traits<Ty>>(arr, size, init);
+                    case level::sse42: return _sse42::_sum<_sse42::traits<Ty>>(arr, size, init);
+                    default: break;
+                    }
+                }
+#endif
+                return _sum_scalar(arr, size, init);
+            }
+
+            //-------------------- argmin / argmax --------------------//
+
+            // Elements per block: each block is checked for a strictly better value
+            // with the vector kernel, and only the last block that had one is
+            // searched again for its index
+            constexpr size_t _arg_block = 4096;
+
+            template <bool Max, class Ty>
+            std::pair<Ty, size_t> _arg_extreme(const Ty* arr, size_t size)
+            {
+                if (size == 0) return std::pair<Ty, size_t>(Ty(), 0);
+
+                Ty best = arr[0];
+                size_t best_block = 0;
+                for (size_t begin = 0; begin < size; begin += _arg_block)
+                {
+                    const size_t count = size - begin < _arg_block ? size - begin : _arg_block;
+                    const Ty found = Max ? simd::max(arr + begin, count, best) : simd::min(arr + begin, count, best);
+                    if (Max ? best < found : found < best)
+                    {
+                        best = found;
+                        best_block = begin;
+                    }
+                }
+
+                // First position equal to the extremum; a NaN first element never compares equal and stays the answer
+                const size_t end = size - best_block < _arg_block ? size : best_block + _arg_block;
+                for (size_t idx = best_block; idx < end; idx++)
+                {
+                    if (arr[idx] == best) return std::pair<Ty, size_t>(arr[idx], idx);
+                }
+                return std::pair<Ty, size_t>(arr[0], 0);
+            }
+
+            /*
+             * Smallest element and its first index, in one pass over <arr>.
+             *
+             * @return (value, index); (Ty(), 0) if <size> is 0
+             */
+            template <class Ty>
+            [[nodiscard]] std::pair<Ty, size_t> argmin(const Ty* arr, size_t size)
+            {
+                return _arg_extreme<false>(arr, size);
+            }
+
+            template <class Ty>
+            [[nodiscard]] std::pair<Ty, size_t> argmax(const Ty* arr, size_t size)
+            {
+                return _arg_extreme<true>(arr, size);
+            }
+
+        } // namespace simd
+
+    } // namespace reducer
+
+} // namespace nw
@@ -0,0 +1,620 @@
+#pragma once
+
+#include <nowifi/math/reducer/reduce.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+
+namespace nw {
+
+    /*
+     * Single-pass statistics as mergeable reducers:
+     *
+     *   MomentsOf   - count, mean, variance, skewness, kurtosis
+     *   TDigestOf   - approximate quantiles in O(compression) memory
+     *   TopKOf      - exact k largest (BottomKOf: k smallest), bounded heap
+     *   HistogramOf - fixed-width buckets over [lo, hi)
+     *
+     * Each works with reduce(), parallel_reduce() and, through the
+     * Consumer_Reset aliases at the end, wherever a Consumer is expected.
+     * consume() is O(1) amortized for fixed parameters.
+     */
+    namespace reducer {
+
+        //-------------------- MomentsOf --------------------//
+
+        /*
+         * Central moments up to the 4th, with Welford/Terriberry updates per
+         * value and Chan/Pebay merges. Bulk consume() reads each block twice
+         * (mean, then centered powers, both vectorizable) and merges it in.
+         */
+        template <class Ty>
+        class MomentsOf : public Reducer<MomentsOf<Ty>, Ty>
+        {
+        public:
+            static constexpr size_t block = 1024;
+
+        protected:
+            double _count = 0;
+            double _mean = 0;
+            double _m2 = 0;
+            double _m3 = 0;
+            double _m4 = 0;
+
+        public:
+            MomentsOf() = default;
+
+            // State of <count> values with the given mean and central sums of powers
+            MomentsOf(size_t count, double mean, double m2, double m3, double m4)
+                : _count(static_cast<double>(count)), _mean(mean), _m2(m2), _m3(m3), _m4(m4) {}
+
+            void consume(const Ty& value)
+            {
+                const double n1 = _count;
+                const double n = ++_count;
+                const double delta = static_cast<double>(value) - _mean;
+                const double delta_n = delta / n;
+                const double delta_n2 = delta_n * delta_n;
+                const double term = delta * delta_n * n1;
+
+                _mean += delta_n;
+                _m4 += term * delta_n2 * (n * n - 3 * n + 3) + 6 * delta_n2 * _m2 - 4 * delta_n * _m3;
+                _m3 += term * delta_n * (n - 2) - 3 * delta_n * _m2;
+                _m2 += term;
+            }
+
+            MomentsOf& consume(const Ty* arr, size_t size)
+            {
+                for (size_t begin = 0; begin < size; begin += block)
+                {
+                    const size_t count = size - begin < block ? size - begin : block;
+                    const Ty* part = arr + begin;
+
+                    double sum = 0;
+                    for (size_t idx = 0; idx < count; idx++) sum += static_cast<double>(part[idx]);
+                    const double mean = sum / static_cast<double>(count);
+
+                    double m2 = 0, m3 = 0, m4 = 0;
+                    for (size_t idx = 0; idx < count; idx++)
+                    {
+                        const double delta = static_cast<double>(part[idx]) - mean;
+                        const double delta2 = delta * delta;
+                        m2 += delta2;
+                        m3 += delta2 * delta;
+                        m4 += delta2 * delta2;
+                    }
+                    this->merge(MomentsOf(count, mean, m2, m3, m4));
+                }
+                return *this;
+            }
+
+            MomentsOf& merge(const MomentsOf& other)
+            {
+                if (other._count == 0) return *this;
+                if (_count == 0) return *this = other;
+
+                const double na = _count, nb = other._count, n = na + nb;
+                const double delta = other._mean - _mean;
+                const double delta2 = delta * delta;
+
+                _m4 += other._m4 + delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n)
+                    + 6 * delta2 * (na * na * other._m2 + nb * nb * _m2) / (n * n)
+                    + 4 * delta * (na * other._m3 - nb * _m3) / n;
+                _m3 += other._m3 + delta2 * delta * na * nb * (na - nb) / (n * n)
+                    + 3 * delta * (na * other._m2 - nb * _m2) / n;
+                _m2 += other._m2 + delta2 * na * nb / n;
+                _mean += delta * nb / n;
+                _count = n;
+                return *this;
+            }
+
+            const MomentsOf& result() const
+            {
+                return *this;
+            }
+
+            size_t count() const
+            {
+                return static_cast<size_t>(_count);
+            }
+
+            // 0 if nothing was consumed
+            double mean() const
+            {
+                return _mean;
+            }
+
+            // Population variance (divides by n)
+            double variance() const
+            {
+                return _count == 0 ? 0.0 : _m2 / _count;
+            }
+
+            // Unbiased variance (divides by n - 1)
+            double sample_variance() const
+            {
+                return _count < 2 ? 0.0 : _m2 / (_count - 1);
+            }
+
+            double stddev() const
+            {
+                return std::sqrt(this->variance());
+            }
+
+            // 0 for constant input
+            double skewness() const
+            {
+                return _m2 == 0 ? 0.0 : std::sqrt(_count) * _m3 / std::pow(_m2, 1.5);
+            }
+
+            // Excess kurtosis (0 for a normal distribution); 0 for constant input
+            double kurtosis() const
+            {
+                return _m2 == 0 ? 0.0 : _count * _m4 / (_m2 * _m2) - 3;
+            }
+        };
+
+        //-------------------- TDigestOf --------------------//
+
+        /*
+         * Merging t-digest (Dunning) with the k1 (arcsine) scale: at most about
+         * <compression> centroids, small ones near the tails, so extreme
+         * quantiles stay accurate. Values go to a buffer that is sorted and
+         * folded in every ~5 * compression values, which is what makes
+         * consume() O(1) amortized. No randomness: equal input in equal order
+         * gives an equal digest.
+         *
+         * The buffer is also folded in by quantile() and merge(), which makes
+         * const reads of the same digest from several threads unsafe.
+         */
+        template <class Ty>
+        class TDigestOf : public Reducer<TDigestOf<Ty>, Ty>
+        {
+        public:
+            struct centroid
+            {
+                double mean;
+                double weight;
+            };
+
+        protected:
+            double _compression;
+            size_t _capacity;
+            mutable std::vector<centroid> _centroids;
+            mutable std::vector<double> _buffer;   // values not folded in yet
+            mutable std::vector<centroid> _merged; // scratch of _compress()
+            mutable double _total = 0;             // weight in _centroids
+            double _min = std::numeric_limits<double>::infinity();
+            double _max = -std::numeric_limits<double>::infinity();
+
+            // Weight limit of the next centroid after quantile <q>
+            double _next_limit(double q, double total) const
+            {
+                constexpr double pi = 3.14159265358979323846;
+                const double k = _compression / (2 * pi) * std::asin(2 * q - 1) + 1;
+                if (k >= _compression / 4) return total;
+                return total * (std::sin(k * 2 * pi / _compression) + 1) / 2;
+            }
+
+            static bool _less(const centroid& first, const centroid& second)
+            {
+                return first.mean < second.mean || (first.mean == second.mean && first.weight < second.weight);
+            }
+
+            // Folds sorted <pending> centroids (and the buffer) into _centroids
+            void _fold(const std::vector<centroid>& pending) const
+            {
+                if (_buffer.empty() && pending.empty()) return;
+
+                // Only the new values are sorted; _centroids already are
+                std::sort(_buffer.begin(), _buffer.end());
+                _merged.clear();
+                _merged.reserve(_centroids.size() + _buffer.size() + pending.size());
+                size_t left = 0, right = 0;
+                while (left < _centroids.size() || right < _buffer.size())
+                {
+                    if (right == _buffer.size() || (left < _centroids.size() && _centroids[left].mean <= _buffer[right])) _merged.push_back(_centroids[left++]);
+                    else _merged.push_back(centroid{ _buffer[right++], 1 });
+                }
+                if (!pending.empty())
+                {
+                    const size_t middle = _merged.size();
+                    _merged.insert(_merged.end(), pending.begin(), pending.end());
+                    std::inplace_merge(_merged.begin(), _merged.begin() + middle, _merged.end(), &TDigestOf::_less);
+                }
+                _buffer.clear();
+
+                double total = 0;
+                for (const centroid& each : _merged) total += each.weight;
+
+                _centroids.clear();
+                double done = 0;
+                double limit = this->_next_limit(0, total);
+                centroid current = _merged[0];
+                for (size_t idx = 1; idx < _merged.size(); idx++)
+                {
+                    const centroid& next = _merged[idx];
+                    if (done + current.weight + next.weight <= limit)
+                    {
+                        current.weight += next.weight;
+                        current.mean += (next.mean - current.mean) * next.weight / current.weight;
+                    }
+                    else
+                    {
+                        done += current.weight;
+                        _centroids.push_back(current);
+                        limit = this->_next_limit(done / total, total);
+                        current = next;
+                    }
+                }
+                _centroids.push_back(current);
+                _total = total;
+            }
+
+            void _compress() const
+            {
+                this->_fold(std::vector<centroid>());
+            }
+
+        public:
+            using Reducer<TDigestOf<Ty>, Ty>::consume;
+
+            /*
+             * @param <compression> - Centroid budget; error ~1/compression at the median, less at the tails
+             */
+            explicit TDigestOf(double compression = 100)
+                : _compression(compression < 20 ? 20 : compression), _capacity(static_cast<size_t>(5 * (compression < 20 ? 20 : compression)))
+            {
+                _buffer.reserve(_capacity);
+            }
+
+            TDigestOf empty() const
+            {
+                return TDigestOf(_compression);
+            }
+
+            // NaNs are skipped
+            void consume(const Ty& value)
+            {
+                const double x = static_cast<double>(value);
+                if (std::isnan(x)) return;
+                _min = x < _min ? x : _min;
+                _max = _max < x ? x : _max;
+                _buffer.push_back(x);
+                if (_buffer.size() >= _capacity) this->_compress();
+            }
+
+            TDigestOf& merge(const TDigestOf& other)
+            {
+                other._compress();
+                this->_fold(other._centroids);
+                _min = other._min < _min ? other._min : _min;
+                _max = _max < other._max ? other._max : _max;
+                return *this;
+            }
+
+            const TDigestOf& result() const
+            {
+                return *this;
+            }
+
+            size_t count() const
+            {
+                return static_cast<size_t>(_total) + _buffer.size();
+            }
+
+            /*
+             * Value below which a fraction <q> of the input lies, interpolated
+             * between centroid centers; exact min and max at the ends.
+             *
+             * @return NaN if nothing was consumed
+             */
+            double quantile(double q) const
+            {
+                this->_compress();
+                if (_centroids.empty()) return std::numeric_limits<double>::quiet_NaN();
+                if (q <= 0) return _min;
+                if (q >= 1) return _max;
+
+                const double index = q * _total;
+                double previous_x = 0, previous_value = _min;
+                double cumulative = 0;
+                for (const centroid& each : _centroids)
+                {
+                    const double x = cumulative + each.weight / 2;
+                    if (index < x)
+                    {
+                        const double t = (index - previous_x) / (x - previous_x);
+                        return previous_value + t * (each.mean - previous_value);
+                    }
+                    previous_x = x;
+                    previous_value = each.mean;
+                    cumulative += each.weight;
+                }
+                const double t = (index - previous_x) / (_total - previous_x);
+                return previous_value + t * (_max - previous_value);
+            }
+
+            double min() const
+            {
+                return _min;
+            }
+
+            double max() const
+            {
+                return _max;
+            }
+
+            const std::vector<centroid>& centroids() const
+            {
+                this->_compress();
+                return _centroids;
+            }
+        };
+
+        //-------------------- TopKOf --------------------//
+
+        /*
+         * The <k> best values under <Compare> (largest for std::less) in a
+         * heap with the worst kept value on top, so most values cost one
+         * comparison once the heap is full.
+         */
+        template <class Ty, class Compare = std::less<Ty>>
+        class TopKOf : public Reducer<TopKOf<Ty, Compare>, Ty>
+        {
+        protected:
+            std::vector<Ty> _heap;
+            size_t _k;
+            Compare _comp;
+
+            struct _worse
+            {
+                const Compare& comp;
+
+                bool operator()(const Ty& first, const Ty& second) const
+                {
+                    return comp(second, first);
+                }
+            };
+
+        public:
+            using Reducer<TopKOf<Ty, Compare>, Ty>::consume;
+
+            explicit TopKOf(size_t k = 10, const Compare& comp = Compare())
+                : _k(k), _comp(comp)
+            {
+                _heap.reserve(k);
+            }
+
+            TopKOf empty() const
+            {
+                return TopKOf(_k, _comp);
+            }
+
+            void consume(const Ty& value)
+            {
+                if (_heap.size() < _k)
+                {
+                    _heap.push_back(value);
+                    std::push_heap(_heap.begin(), _heap.end(), _worse{ _comp });
+                }
+                else if (_k != 0 && _comp(_heap.front(), value))
+                {
+                    std::pop_heap(_heap.begin(), _heap.end(), _worse{ _comp });
+                    _heap.back() = value;
+                    std::push_heap(_heap.begin(), _heap.end(), _worse{ _comp });
+                }
+            }
+
+            TopKOf& merge(const TopKOf& other)
+            {
+                for (const Ty& value : other._heap) this->consume(value);
+                return *this;
+            }
+
+            // Best first
+            std::vector<Ty> result() const
+            {
+                std::vector<Ty> sorted(_heap);
+                std::sort(sorted.begin(), sorted.end(), _worse{ _comp });
+                return sorted;
+            }
+
+            size_t k() const
+            {
+                return _k;
+            }
+        };
+
+        template <class Ty>
+        using BottomKOf = TopKOf<Ty, std::greater<Ty>>;
+
+        //-------------------- HistogramOf --------------------//
+
+        /*
+         * <buckets> equal-width buckets over [lo, hi), plus counts below,
+         * at or above, and NaN.
+         */
+        template <class Ty>
+        class HistogramOf : public Reducer<HistogramOf<Ty>, Ty>
+        {
+        protected:
+            double _lo;
+            double _hi;
+            double _scale;
+            std::vector<uint64_t> _counts;
+            uint64_t _underflow = 0;
+            uint64_t _overflow = 0;
+            uint64_t _nan = 0;
+
+        public:
+            using Reducer<HistogramOf<Ty>, Ty>::consume;
+
+            /*
+             * @exception std::invalid_argument if <lo> >= <hi> or <buckets> is 0
+             */
+            explicit HistogramOf(double lo = 0, double hi = 1, size_t buckets = 64)
+                : _lo(lo), _hi(hi), _scale(static_cast<double>(buckets) / (hi - lo)), _counts(buckets)
+            {
+                if (!(lo < hi) || buckets == 0) throw std::invalid_argument("HistogramOf: need lo < hi and buckets > 0");
+            }
+
+            HistogramOf empty() const
+            {
+                return HistogramOf(_lo, _hi, _counts.size());
+            }
+
+            void consume(const Ty& value)
+            {
+                const double x = static_cast<double>(value);
+                if (x < _lo) _underflow++;
+                else if (x >= _hi) _overflow++;
+                else if (std::isnan(x)) _nan++;
+                else
+                {
+                    // The product can round across an edge: settle on the bucket lower() reports
+                    size_t idx = static_cast<size_t>((x - _lo) * _scale);
+                    idx = idx < _counts.size() ? idx : _counts.size() - 1;
+                    if (x < this->lower(idx)) idx--;
+                    else if (idx + 1 < _counts.size() && x >= this->lower(idx + 1)) idx++;
+                    _counts[idx]++;
+                }
+            }
+
+            /*
+             * @exception std::invalid_argument if the bucket layouts differ
+             */
+            HistogramOf& merge(const HistogramOf& other)
+            {
+                if (_lo != other._lo || _hi != other._hi || _counts.size() != other._counts.size()) throw std::invalid_argument("HistogramOf::merge: different buckets");
+                for (size_t idx = 0; idx < _counts.size(); idx++) _counts[idx] += other._counts[idx];
+                _underflow += other._underflow;
+                _overflow += other._overflow;
+                _nan += other._nan;
+                return *this;
+            }
+
+            const HistogramOf& result() const
+            {
+                return *this;
+            }
+
+            size_t buckets() const
+            {
+                return _counts.size();
+            }
+
+            const std::vector<uint64_t>& counts() const
+            {
+                return _counts;
+            }
+
+            uint64_t count(size_t bucket) const
+            {
+                return _counts[bucket];
+            }
+
+            // Inclusive lower edge of <bucket>
+            double lower(size_t bucket) const
+            {
+                return _lo + static_cast<double>(bucket) / _scale;
+            }
+
+            // Exclusive upper edge of <bucket>
+            double upper(size_t bucket) const
+            {
+                return bucket + 1 == _counts.size() ? _hi : this->lower(bucket + 1);
+            }
+
+            uint64_t underflow() const
+            {
+                return _underflow;
+            }
+
+            uint64_t overflow() const
+            {
+                return _overflow;
+            }
+
+            uint64_t nan() const
+            {
+                return _nan;
+            }
+
+            // Every value consumed, NaNs included
+            uint64_t total() const
+            {
+                uint64_t result = _underflow + _overflow + _nan;
+                for (uint64_t each : _counts) result += each;
+                return result;
+            }
+        };
+
+        //-------------------- specs --------------------//
+
+        struct Moments
+        {
+            template <class Ty>
+            MomentsOf<Ty> bind() const { return MomentsOf<Ty>(); }
+        };
+
+        struct Quantiles
+        {
+            double compression = 100;
+
+            template <class Ty>
+            TDigestOf<Ty> bind() const { return TDigestOf<Ty>(compression); }
+        };
+
+        struct TopK
+        {
+            size_t k = 10;
+
+            template <class Ty>
+            TopKOf<Ty> bind() const { return TopKOf<Ty>(k); }
+        };
+
+        struct BottomK
+        {
+            size_t k = 10;
+
+            template <class Ty>
+            BottomKOf<Ty> bind() const { return BottomKOf<Ty>(k); }
+        };
+
+        struct Histogram
+        {
+            double lo = 0;
+            double hi = 1;
+            size_t buckets = 64;
+
+            template <class Ty>
+            HistogramOf<Ty> bind() const { return HistogramOf<Ty>(lo, hi, buckets); }
+        };
+
+    } // namespace reducer
+
+    //-------------------- Consumer_Reset --------------------//
+
+    // e.g. QuantileReducer<double> q(reducer::TDigestOf<double>(200)); ... q.reducer().quantile(0.99)
+    template <class Ty>
+    using MomentsReducer = reducer::Dynamic<reducer::MomentsOf<Ty>>;
+
+    template <class Ty>
+    using QuantileReducer = reducer::Dynamic<reducer::TDigestOf<Ty>>;
+
+    template <class Ty, class Compare = std::less<Ty>>
+    using TopKReducer = reducer::Dynamic<reducer::TopKOf<Ty, Compare>>;
+
+    template <class Ty>
+    using BottomKReducer = reducer::Dynamic<reducer::BottomKOf<Ty>>;
+
+    template <class Ty>
+    using HistogramReducer = reducer::Dynamic<reducer::HistogramOf<Ty>>;
+
+} // namespace nw
@@ -1,17 +1,29 @@
 #pragma once
 
+#include <nowifi/math/reducer/reduce.hpp>
+#include <nowifi/math/reducer/summation.hpp>
 #include <nowifi/pack/compare.hpp>
 #include <nowifi/util/consumer.hpp>
 
 #include <limits>
+#include <type_traits>
 
 namespace nw {
 
-    template <class Ty>
+    /*
+     * Running sum. <Mode> picks the accumulator for arithmetic types:
+     * naive (default), pairwise, kahan or exact; see math/reducer/summation.hpp.
+     * Naive sums and other types keep a plain Ty and only need operator+.
+     */
+    template <class Ty, reducer::sum_mode Mode = reducer::sum_mode::naive>
     class SumReducer : public Consumer_Reset<Ty>
     {
+        static_assert(Mode == reducer::sum_mode::naive || std::is_arithmetic<Ty>::value, "SumReducer: only arithmetic types take a sum_mode");
+
+        static constexpr bool _accumulated = Mode != reducer::sum_mode::naive;
+
     protected:
-        Ty _sum;
+        std::conditional_t<_accumulated, reducer::sum_of<Ty, Mode>, Ty> _sum;
 
     public:
         SumReducer(const Ty& value = Ty(0))
@@ -21,12 +33,33 @@ namespace nw {
 
         void reset(const Ty& value = Ty(0))
         {
-            _sum = value;
+            if constexpr (_accumulated) _sum = reducer::sum_of<Ty, Mode>(value);
+            else _sum = value;
         }
 
         void consume(const Ty& value)
         {
-            _sum = _sum + value;
+            if constexpr (_accumulated) _sum.consume(value);
+            else _sum = _sum + value;
+        }
+
+        void consume(const Ty* arr, size_t size)
+        {
+            if constexpr (_accumulated) _sum.consume(arr, size);
+            else if constexpr (std::is_arithmetic<Ty>::value) _sum = reducer::SumOf<Ty, Ty>(_sum).consume(arr, size).result();
+            else for (size_t idx = 0; idx < size; idx++) _sum = _sum + arr[idx];
+        }
+
+        void merge(const SumReducer& other)
+        {
+            if constexpr (_accumulated) _sum.merge(other._sum);
+            else _sum = _sum + other._sum;
+        }
+
+        Ty sum() const
+        {
+            if constexpr (_accumulated) return _sum.result();
+            else return _sum;
         }
     };
 
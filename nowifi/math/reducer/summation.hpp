@@ -0,0 +1,320 @@
+#pragma once
+
+#include <nowifi/math/reducer/reduce.hpp>
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+namespace nw {
+
+    /*
+     * Floating point sums with bounded error, as reducers:
+     *
+     *   PairwiseSum - error O(log n) ulps, close to naive speed
+     *   KahanSum    - Neumaier-compensated, error O(1) ulps for most inputs
+     *   ExactSum    - correctly rounded sum of every value, order independent
+     *
+     * Each assigns elements to its lanes by position, so consume(value) one
+     * by one and bulk consume() over any split give bit-identical results.
+     * All of them need strict IEEE arithmetic (no -ffast-math or /fp:fast).
+     */
+    namespace reducer {
+
+        enum class sum_mode : uint8_t
+        {
+            naive,
+            pairwise,
+            kahan,
+            exact,
+        };
+
+        //-------------------- PairwiseSumOf --------------------//
+
+        /*
+         * Blocks of 128 values are summed in 8 interleaved lanes, and block
+         * sums are combined as a binary tree, kept as one partial per level.
+         */
+        template <class Ty>
+        class PairwiseSumOf : public Reducer<PairwiseSumOf<Ty>, Ty>
+        {
+            static_assert(std::is_floating_point<Ty>::value, "PairwiseSumOf needs a floating point type");
+
+        public:
+            static constexpr size_t block = 128;
+            static constexpr size_t lanes = 8;
+
+        protected:
+            Ty _lanes[lanes] = {};
+            size_t _fill = 0;
+            Ty _levels[64] = {};
+            uint64_t _blocks = 0;
+            Ty _base;
+
+            Ty _block_sum() const
+            {
+                return ((_lanes[0] + _lanes[1]) + (_lanes[2] + _lanes[3])) + ((_lanes[4] + _lanes[5]) + (_lanes[6] + _lanes[7]));
+            }
+
+            void _push_block()
+            {
+                Ty carry = this->_block_sum();
+                size_t level = 0;
+                for (uint64_t count = _blocks; count & 1; count >>= 1) carry = _levels[level++] + carry;
+                _levels[level] = carry;
+                _blocks++;
+                for (size_t lane = 0; lane < lanes; lane++) _lanes[lane] = 0;
+                _fill = 0;
+            }
+
+        public:
+            using Reducer<PairwiseSumOf<Ty>, Ty>::consume;
+
+            explicit PairwiseSumOf(const Ty& value = Ty(0))
+                : _base(value) {}
+
+            void consume(const Ty& value)
+            {
+                _lanes[_fill % lanes] += value;
+                if (++_fill == block) this->_push_block();
+            }
+
+            PairwiseSumOf& consume(const Ty* arr, size_t size)
+            {
+                size_t idx = 0;
+                for (; idx < size && _fill != 0; idx++) this->consume(arr[idx]);
+                for (; idx + block <= size; idx += block)
+                {
+                    // Independent lanes; the compiler may keep them in one vector
+                    for (size_t step = 0; step < block; step += lanes)
+                    {
+                        for (size_t lane = 0; lane < lanes; lane++) _lanes[lane] += arr[idx + step + lane];
+                    }
+                    _fill = block;
+                    this->_push_block();
+                }
+                for (; idx < size; idx++) this->consume(arr[idx]);
+                return *this;
+            }
+
+            // The merged totals are added once more, as a two-leaf tree
+            PairwiseSumOf& merge(const PairwiseSumOf& other)
+            {
+                const Ty total = this->result() + other.result();
+                *this = PairwiseSumOf(total);
+                return *this;
+            }
+
+            Ty result() const
+            {
+                Ty total = this->_block_sum();
+                for (size_t level = 0; level < 64; level++)
+                {
+                    if ((_blocks >> level) & 1) total = _levels[level] + total;
+                }
+                return _base + total;
+            }
+        };
+
+        //-------------------- KahanSumOf --------------------//
+
+        /*
+         * Neumaier's variant of Kahan summation (also exact when a value is
+         * larger than the running sum), in 4 lanes to hide the add latency.
+         */
+        template <class Ty>
+        class KahanSumOf : public Reducer<KahanSumOf<Ty>, Ty>
+        {
+            static_assert(std::is_floating_point<Ty>::value, "KahanSumOf needs a floating point type");
+
+        public:
+            static constexpr size_t lanes = 4;
+
+        protected:
+            Ty _sum[lanes] = {};
+            Ty _compensation[lanes] = {};
+            size_t _count = 0;
+
+            static void _add(Ty& sum, Ty& compensation, const Ty& value)
+            {
+                const Ty total = sum + value;
+                compensation += std::fabs(sum) >= std::fabs(value) ? (sum - total) + value : (value - total) + sum;
+                sum = total;
+            }
+
+        public:
+            using Reducer<KahanSumOf<Ty>, Ty>::consume;
+
+            explicit KahanSumOf(const Ty& value = Ty(0))
+            {
+                _sum[0] = value;
+            }
+
+            void consume(const Ty& value)
+            {
+                const size_t lane = _count++ % lanes;
+                _add(_sum[lane], _compensation[lane], value);
+            }
+
+            KahanSumOf& consume(const Ty* arr, size_t size)
+            {
+                size_t idx = 0;
+                for (; idx < size && _count % lanes != 0; idx++) this->consume(arr[idx]);
+                const size_t aligned = idx;
+                const size_t end = aligned + (size - aligned) / lanes * lanes;
+                for (; idx < end; idx += lanes)
+                {
+                    for (size_t lane = 0; lane < lanes; lane++) _add(_sum[lane], _compensation[lane], arr[idx + lane]);
+                }
+                _count += end - aligned;
+                for (; idx < size; idx++) this->consume(arr[idx]);
+                return *this;
+            }
+
+            KahanSumOf& merge(const KahanSumOf& other)
+            {
+                for (size_t lane = 0; lane < lanes; lane++)
+                {
+                    _add(_sum[lane], _compensation[lane], other._sum[lane]);
+                    _compensation[lane] += other._compensation[lane];
+                }
+                _count += other._count;
+                return *this;
+            }
+
+            Ty result() const
+            {
+                Ty sum = 0, compensation = 0;
+                for (size_t lane = 0; lane < lanes; lane++)
+                {
+                    _add(sum, compensation, _sum[lane]);
+                    compensation += _compensation[lane];
+                }
+                return sum + compensation;
+            }
+        };
+
+        //-------------------- ExactSumOf --------------------//
+
+        /*
+         * Shewchuk's non-overlapping partials (Python's math.fsum): the exact
+         * sum is kept as a short list of floats and rounded once in result().
+         * consume() is O(partials), a handful for real data. Infinities and
+         * NaNs are summed apart; only an overflowing finite sum is not exact.
+         */
+        template <class Ty>
+        class ExactSumOf : public Reducer<ExactSumOf<Ty>, Ty>
+        {
+            static_assert(std::is_floating_point<Ty>::value, "ExactSumOf needs a floating point type");
+
+        protected:
+            std::vector<Ty> _partials;
+            Ty _special = 0;
+
+        public:
+            using Reducer<ExactSumOf<Ty>, Ty>::consume;
+
+            explicit ExactSumOf(const Ty& value = Ty(0))
+            {
+                if (value != 0) this->consume(value);
+            }
+
+            void consume(const Ty& value)
+            {
+                if (!std::isfinite(value))
+                {
+                    _special += value;
+                    return;
+                }
+
+                Ty x = value;
+                size_t used = 0;
+                for (size_t idx = 0; idx < _partials.size(); idx++)
+                {
+                    Ty y = _partials[idx];
+                    if (std::fabs(x) < std::fabs(y)) std::swap(x, y);
+                    const Ty high = x + y;
+                    const Ty low = y - (high - x);
+                    if (low != 0) _partials[used++] = low;
+                    x = high;
+                }
+                _partials.resize(used);
+                _partials.push_back(x);
+            }
+
+            ExactSumOf& merge(const ExactSumOf& other)
+            {
+                for (const Ty& partial : other._partials) this->consume(partial);
+                _special += other._special;
+                return *this;
+            }
+
+            Ty result() const
+            {
+                if (_special != 0) return _special; // also NaN
+
+                size_t size = _partials.size();
+                if (size == 0) return 0;
+
+                Ty high = _partials[--size];
+                Ty low = 0;
+                while (size > 0)
+                {
+                    const Ty x = high;
+                    const Ty y = _partials[--size];
+                    high = x + y;
+                    low = y - (high - x);
+                    if (low != 0) break;
+                }
+
+                // Round half-even across the rest of the partials
+                if (size > 0 && ((low < 0 && _partials[size - 1] < 0) || (low > 0 && _partials[size - 1] > 0)))
+                {
+                    const Ty y = low * 2;
+                    const Ty x = high + y;
+                    if (y == x - high) high = x;
+                }
+                return high;
+            }
+        };
+
+        //-------------------- specs --------------------//
+
+        struct PairwiseSum
+        {
+            template <class Ty>
+            PairwiseSumOf<Ty> bind() const { return PairwiseSumOf<Ty>(); }
+        };
+
+        struct KahanSum
+        {
+            template <class Ty>
+            KahanSumOf<Ty> bind() const { return KahanSumOf<Ty>(); }
+        };
+
+        struct ExactSum
+        {
+            template <class Ty>
+            ExactSumOf<Ty> bind() const { return ExactSumOf<Ty>(); }
+        };
+
+        template <class Ty, sum_mode Mode>
+        struct _sum_of { using type = SumOf<Ty, Ty>; };
+
+        template <class Ty>
+        struct _sum_of<Ty, sum_mode::pairwise> { using type = PairwiseSumOf<Ty>; };
+
+        template <class Ty>
+        struct _sum_of<Ty, sum_mode::kahan> { using type = KahanSumOf<Ty>; };
+
+        template <class Ty>
+        struct _sum_of<Ty, sum_mode::exact> { using type = ExactSumOf<Ty>; };
+
+        // Accumulator of <Mode> for Ty; naive is SumOf<Ty, Ty>
+        template <class Ty, sum_mode Mode>
+        using sum_of = typename _sum_of<Ty, Mode>::type;
+
+    } // namespace reducer
+
+} // namespace nw
@@ -0,0 +1,465 @@
+#pragma once
+
+#include <nowifi/util/consumer.hpp>
+#include <nowifi/util/ringBuffer.hpp>
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+namespace nw {
+
+    /*
+     * Sliding-window reducers: each consume() adds the newest value and
+     * drops the one that fell out of the last <window> values.
+     * Queries are O(1); consume() is O(1) amortized except WindowMedian.
+     *
+     * Until <window> values have been seen the window is the whole prefix.
+     */
+
+    //-------------------- WindowExtremum --------------------//
+
+    /*
+     * Monotonic deque: keeps only values that can still become the extremum,
+     * so each value is pushed and popped at most once.
+     * <Compare>(a, b) == true means a is preferred over b.
+     */
+    template <class Ty, class Compare>
+    class WindowExtremum : public Consumer<Ty>
+    {
+    protected:
+        ring_buffer<std::pair<size_t, Ty>> _candidates;
+        size_t _window;
+        size_t _count = 0;
+        Compare _comp;
+
+    public:
+        using Consumer<Ty>::consume;
+
+        explicit WindowExtremum(size_t window, Compare comp = Compare())
+            : _candidates(window == 0 ? 1 : window), _window(window == 0 ? 1 : window), _comp(comp) {}
+
+        void reset()
+        {
+            _candidates.clear();
+            _count = 0;
+        }
+
+        void consume(const Ty& value)
+        {
+            while (!_candidates.empty() && !_comp(_candidates.back().second, value)) _candidates.drop_back(1);
+            _candidates.push_back(std::pair<size_t, Ty>(_count, value));
+            if (_candidates.front().first + _window <= _count) _candidates.drop_front(1);
+            _count++;
+        }
+
+        // Undefined before the first consume()
+        const Ty& value() const
+        {
+            return _candidates.front().second;
+        }
+
+        // Position (0-based, in consume order) of the current extremum
+        size_t index() const
+        {
+            return _candidates.front().first;
+        }
+
+        size_t window() const
+        {
+            return _window;
+        }
+
+        size_t size() const
+        {
+            return std::min(_count, _window);
+        }
+
+        bool full() const
+        {
+            return _count >= _window;
+        }
+    };
+
+    template <class Ty>
+    class WindowMinReducer : public WindowExtremum<Ty, std::less<Ty>>
+    {
+    public:
+        explicit WindowMinReducer(size_t window)
+            : WindowExtremum<Ty, std::less<Ty>>(window) {}
+
+        const Ty& min() const
+        {
+            return this->value();
+        }
+    };
+
+    template <class Ty>
+    class WindowMaxReducer : public WindowExtremum<Ty, std::greater<Ty>>
+    {
+    public:
+        explicit WindowMaxReducer(size_t window)
+            : WindowExtremum<Ty, std::greater<Ty>>(window) {}
+
+        const Ty& max() const
+        {
+            return this->value();
+        }
+    };
+
+    //-------------------- WindowSumReducer --------------------//
+
+    /*
+     * Running sum over the window: add the newest, subtract the evicted one.
+     * Floating-point sums are recomputed from the window once every <window>
+     * values so cancellation error cannot build up.
+     */
+    template <class Ty, class Acc = Ty>
+    class WindowSumReducer : public Consumer<Ty>
+    {
+    protected:
+        ring_buffer<Ty> _values;
+        Acc _sum = Acc(0);
+        size_t _since_exact = 0;
+
+    public:
+        using Consumer<Ty>::consume;
+
+        explicit WindowSumReducer(size_t window)
+            : _values(window == 0 ? 1 : window) {}
+
+        void reset()
+        {
+            _values.clear();
+            _sum = Acc(0);
+            _since_exact = 0;
+        }
+
+        void consume(const Ty& value)
+        {
+            if (_values.full()) _sum -= static_cast<Acc>(_values.front());
+            _values.push_back(value);
+            _sum += static_cast<Acc>(value);
+
+            if constexpr (std::is_floating_point<Acc>::value)
+            {
+                if (++_since_exact >= _values.capacity())
+                {
+                    _since_exact = 0;
+                    Acc exact = Acc(0);
+                    _values.for_each([&exact](const Ty& item) { exact += static_cast<Acc>(item); });
+                    _sum = exact;
+                }
+            }
+        }
+
+        Acc sum() const
+        {
+            return _sum;
+        }
+
+        double mean() const
+        {
+            return _values.empty() ? 0.0 : static_cast<double>(_sum) / static_cast<double>(_values.size());
+        }
+
+        size_t window() const
+        {
+            return _values.capacity();
+        }
+
+        size_t size() const
+        {
+            return _values.size();
+        }
+
+        bool full() const
+        {
+            return _values.full();
+        }
+    };
+
+    //-------------------- WindowReducer --------------------//
+
+    /*
+     * Any associative <Op> (need not be commutative or invertible:
+     * gcd, matrix product, string concat, ...), two-stack algorithm.
+     *
+     * The back stack holds new values and their running aggregate; the
+     * front stack holds old values with suffix aggregates, rebuilt from
+     * the back stack when it runs dry. Each value is combined at most
+     * three times over its lifetime.
+     */
+    template <class Ty, class Op>
+    class WindowReducer : public Consumer<Ty>
+    {
+    protected:
+        std::vector<Ty> _front_agg; // top = oldest; aggregate of itself..newest-in-front
+        std::vector<Ty> _back;      // oldest..newest
+        Ty _back_agg{};
+        size_t _window;
+        Op _op;
+
+        void _flip()
+        {
+            // Back stack becomes the front: suffix aggregates, newest first
+            for (size_t idx = _back.size(); idx-- > 0;)
+            {
+                _front_agg.push_back(_front_agg.empty() ? _back[idx] : _op(_back[idx], _front_agg.back()));
+            }
+            _back.clear();
+        }
+
+    public:
+        using Consumer<Ty>::consume;
+
+        explicit WindowReducer(size_t window, Op op = Op())
+            : _window(window == 0 ? 1 : window), _op(op)
+        {
+            _front_agg.reserve(_window);
+            _back.reserve(_window);
+        }
+
+        void reset()
+        {
+            _front_agg.clear();
+            _back.clear();
+        }
+
+        void consume(const Ty& value)
+        {
+            if (_front_agg.size() + _back.size() == _window)
+            {
+                if (_front_agg.empty()) this->_flip();
+                _front_agg.pop_back();
+            }
+            _back_agg = _back.empty() ? value : _op(_back_agg, value);
+            _back.push_back(value);
+        }
+
+        // Aggregate of the window, oldest to newest. Undefined before the first consume()
+        Ty value() const
+        {
+            if (_front_agg.empty()) return _back_agg;
+            if (_back.empty()) return _front_agg.back();
+            return _op(_front_agg.back(), _back_agg);
+        }
+
+        size_t window() const
+        {
+            return _window;
+        }
+
+        size_t size() const
+        {
+            return _front_agg.size() + _back.size();
+        }
+
+        bool full() const
+        {
+            return this->size() == _window;
+        }
+    };
+
+    //-------------------- WindowMedian --------------------//
+
+    /*
+     * Order statistics over the window from a sorted copy of it.
+     * consume() is one binary search plus a memmove of at most <window>
+     * elements, which beats node-based multisets for windows up to
+     * several thousand values.
+     */
+    template <class Ty>
+    class WindowMedian : public Consumer<Ty>
+    {
+    protected:
+        ring_buffer<Ty> _values;
+        std::vector<Ty> _sorted;
+
+    public:
+        using Consumer<Ty>::consume;
+
+        explicit WindowMedian(size_t window)
+            : _values(window == 0 ? 1 : window)
+        {
+            _sorted.reserve(_values.capacity());
+        }
+
+        void reset()
+        {
+            _values.clear();
+            _sorted.clear();
+        }
+
+        void consume(const Ty& value)
+        {
+            if (_values.full())
+            {
+                const Ty& evicted = _values.front();
+                auto pos = std::lower_bound(_sorted.begin(), _sorted.end(), evicted);
+                auto target = std::upper_bound(_sorted.begin(), _sorted.end(), value);
+                // Slide the gap instead of erase + insert
+                if (target > pos)
+                {
+                    std::move(pos + 1, target, pos);
+                    *(target - 1) = value;
+                }
+                else
+                {
+                    std::move_backward(target, pos, pos + 1);
+                    *target = value;
+                }
+            }
+            else
+            {
+                _sorted.insert(std::upper_bound(_sorted.begin(), _sorted.end(), value), value);
+            }
+            _values.push_back(value);
+        }
+
+        const Ty& median_low() const
+        {
+            return _sorted[(_sorted.size() - 1) / 2];
+        }
+
+        const Ty& median_high() const
+        {
+            return _sorted[_sorted.size() / 2];
+        }
+
+        double median() const
+        {
+            return (static_cast<double>(this->median_low()) + static_cast<double>(this->median_high())) / 2.0;
+        }
+
+        /*
+         * @param <q> - Quantile in [0, 1] (nearest rank)
+         */
+        const Ty& quantile(double q) const
+        {
+            const double rank = q * static_cast<double>(_sorted.size() - 1) + 0.5;
+            return _sorted[std::min(_sorted.size() - 1, static_cast<size_t>(rank < 0.0 ? 0.0 : rank))];
+        }
+
+        size_t window() const
+        {
+            return _values.capacity();
+        }
+
+        size_t size() const
+        {
+            return _values.size();
+        }
+
+        bool full() const
+        {
+            return _values.full();
+        }
+    };
+
+    //-------------------- batch --------------------//
+
+    namespace window {
+
+        inline size_t _count(size_t size, size_t window)
+        {
+            if (window == 0 || window > size) throw std::invalid_argument("window: window must be in [1, size]");
+            return size - window + 1;
+        }
+
+        /*
+         * Each function below writes the aggregate of every full window of
+         * <arr> to <out>: out[idx] covers arr[idx .. idx + window - 1],
+         * size - window + 1 results.
+         *
+         * @exception std::invalid_argument - window is 0 or larger than size
+         */
+
+        // van Herk / Gil-Werman: block prefix and suffix extrema, three compares per element
+        template <class Ty, class Compare>
+        void extremum(const Ty* arr, size_t size, size_t window, Ty* out, Compare comp)
+        {
+            _count(size, window);
+            auto best = [&comp](const Ty& lhs, const Ty& rhs) -> const Ty& { return comp(rhs, lhs) ? rhs : lhs; };
+
+            std::vector<Ty> suffix(size);
+            for (size_t end = size; end > 0;)
+            {
+                const size_t begin = (end - 1) / window * window;
+                suffix[end - 1] = arr[end - 1];
+                for (size_t idx = end - 1; idx-- > begin;) suffix[idx] = best(arr[idx], suffix[idx + 1]);
+                end = begin;
+            }
+
+            Ty prefix = arr[0];
+            for (size_t idx = 0; idx < size; idx++)
+            {
+                prefix = idx % window == 0 ? arr[idx] : best(prefix, arr[idx]);
+                if (idx + 1 >= window) out[idx + 1 - window] = best(suffix[idx + 1 - window], prefix);
+            }
+        }
+
+        template <class Ty>
+        void min(const Ty* arr, size_t size, size_t window, Ty* out)
+        {
+            extremum(arr, size, window, out, std::less<Ty>());
+        }
+
+        template <class Ty>
+        void max(const Ty* arr, size_t size, size_t window, Ty* out)
+        {
+            extremum(arr, size, window, out, std::greater<Ty>());
+        }
+
+        template <class Ty, class Acc>
+        void sum(const Ty* arr, size_t size, size_t window, Acc* out)
+        {
+            const size_t count = _count(size, window);
+            Acc total = Acc(0);
+            for (size_t idx = 0; idx < window; idx++) total += static_cast<Acc>(arr[idx]);
+            out[0] = total;
+            for (size_t idx = 1; idx < count; idx++)
+            {
+                total += static_cast<Acc>(arr[idx + window - 1]) - static_cast<Acc>(arr[idx - 1]);
+                out[idx] = total;
+            }
+        }
+
+        template <class Ty>
+        void mean(const Ty* arr, size_t size, size_t window, double* out)
+        {
+            const size_t count = _count(size, window);
+            window::sum(arr, size, window, out);
+            for (size_t idx = 0; idx < count; idx++) out[idx] /= static_cast<double>(window);
+        }
+
+        template <class Ty, class Op>
+        void reduce(const Ty* arr, size_t size, size_t window, Ty* out, Op op)
+        {
+            _count(size, window);
+            WindowReducer<Ty, Op> reducer(window, op);
+            for (size_t idx = 0; idx < size; idx++)
+            {
+                reducer.consume(arr[idx]);
+                if (idx + 1 >= window) out[idx + 1 - window] = reducer.value();
+            }
+        }
+
+        template <class Ty>
+        void median(const Ty* arr, size_t size, size_t window, double* out)
+        {
+            _count(size, window);
+            WindowMedian<Ty> reducer(window);
+            for (size_t idx = 0; idx < size; idx++)
+            {
+                reducer.consume(arr[idx]);
+                if (idx + 1 >= window) out[idx + 1 - window] = reducer.median();
+            }
+        }
+
+    } // namespace window
+
+} // namespace nw
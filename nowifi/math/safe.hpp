@@ -1,26 +1,59 @@
 #pragma once
 
+#include <nowifi/util/expected.hpp>
+
 #include <stdexcept>
 #include <typeinfo>
 #include <string>
+#include <limits>
+#include <type_traits>
 
 namespace nw {
 
+	/*
+	 * Checked integer arithmetic. add/sub/mul_* throw std::overflow_error or
+	 * std::underflow_error; try_add/sub/mul_* return expected<Ty> with
+	 * errc::overflow or errc::underflow instead and never throw.
+	 */
 	namespace SafeMath {
 
+		template <typename baseTy>
+		[[noreturn]] void _throw(errc code, const char* operation)
+		{
+			const std::string what = (std::string) typeid(baseTy).name() + " " + operation + " " + message(code);
+			if (code == errc::underflow) throw std::underflow_error(what);
+			throw std::overflow_error(what);
+		}
+
 		//------------------------------     ------------------------------//
 		//------------------------------ ADD ------------------------------//
 		//------------------------------     ------------------------------//
 
-		template <typename baseTy> [[NODISCARD]]
-		constexpr baseTy _add_impl(baseTy val1, baseTy val2)
+		template <typename baseTy>
+		constexpr errc _add_check(baseTy val1, baseTy val2) noexcept
 		{
-			baseTy res = val1 + val2;
-			if ( res < val1 )
+			if (val2 > 0 && val1 > std::numeric_limits<baseTy>::max() - val2) return errc::overflow;
+			if constexpr (std::is_signed<baseTy>::value)
 			{
-				throw std::overflow_error((std::string) typeid(baseTy).name() + " addition overflow");
+				if (val2 < 0 && val1 < std::numeric_limits<baseTy>::min() - val2) return errc::underflow;
 			}
-			return res;
+			return errc::none;
+		}
+
+		template <typename baseTy> [[NODISCARD]]
+		constexpr baseTy _add_impl(baseTy val1, baseTy val2)
+		{
+			const errc code = _add_check<baseTy>(val1, val2);
+			if (code != errc::none) _throw<baseTy>(code, "addition");
+			return (baseTy)(val1 + val2);
+		}
+
+		template <typename baseTy>
+		[[nodiscard]] expected<baseTy> _try_add_impl(baseTy val1, baseTy val2) noexcept
+		{
+			const errc code = _add_check<baseTy>(val1, val2);
+			if (code != errc::none) return unexpected<errc>(code);
+			return (baseTy)(val1 + val2);
 		}
 
 		[[NODISCARD]]
@@ -71,19 +104,83 @@ namespace nw {
 			return _add_impl<unsigned long long>(val1, val2);
 		}
 
+		[[nodiscard]]
+		inline expected<char> try_add_int8(char val1, char val2) noexcept
+		{
+			return _try_add_impl<char>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<unsigned char> try_add_int8(unsigned char val1, unsigned char val2) noexcept
+		{
+			return _try_add_impl<unsigned char>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<short> try_add_int16(short val1, short val2) noexcept
+		{
+			return _try_add_impl<short>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<unsigned short> try_add_int16(unsigned short val1, unsigned short val2) noexcept
+		{
+			return _try_add_impl<unsigned short>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<int> try_add_int32(int val1, int val2) noexcept
+		{
+			return _try_add_impl<int>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<unsigned int> try_add_int32(unsigned int val1, unsigned int val2) noexcept
+		{
+			return _try_add_impl<unsigned int>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<long long> try_add_int64(long long val1, long long val2) noexcept
+		{
+			return _try_add_impl<long long>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<unsigned long long> try_add_int64(unsigned long long val1, unsigned long long val2) noexcept
+		{
+			return _try_add_impl<unsigned long long>(val1, val2);
+		}
+
 		//------------------------------          ------------------------------//
 		//------------------------------ SUBTRACT ------------------------------//
 		//------------------------------          ------------------------------//
 
-		template <typename baseTy> [[NODISCARD]]
-		constexpr baseTy _sub_impl(baseTy val1, baseTy val2)
+		template <typename baseTy>
+		constexpr errc _sub_check(baseTy val1, baseTy val2) noexcept
 		{
-			baseTy res = val1 - val2;
-			if (res > val1)
+			if (val2 > 0 && val1 < std::numeric_limits<baseTy>::min() + val2) return errc::underflow;
+			if constexpr (std::is_signed<baseTy>::value)
 			{
-				throw std::underflow_error((std::string) typeid(baseTy).name() + " subion underflow");
+				if (val2 < 0 && val1 > std::numeric_limits<baseTy>::max() + val2) return errc::overflow;
 			}
-			return res;
+			return errc::none;
+		}
+
+		template <typename baseTy> [[NODISCARD]]
+		constexpr baseTy _sub_impl(baseTy val1, baseTy val2)
+		{
+			const errc code = _sub_check<baseTy>(val1, val2);
+			if (code != errc::none) _throw<baseTy>(code, "subtraction");
+			return (baseTy)(val1 - val2);
+		}
+
+		template <typename baseTy>
+		[[nodiscard]] expected<baseTy> _try_sub_impl(baseTy val1, baseTy val2) noexcept
+		{
+			const errc code = _sub_check<baseTy>(val1, val2);
+			if (code != errc::none) return unexpected<errc>(code);
+			return (baseTy)(val1 - val2);
 		}
 
 		[[NODISCARD]]
@@ -134,19 +231,85 @@ namespace nw {
 			return _sub_impl<unsigned long long>(val1, val2);
 		}
 
+		[[nodiscard]]
+		inline expected<char> try_sub_int8(char val1, char val2) noexcept
+		{
+			return _try_sub_impl<char>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<unsigned char> try_sub_int8(unsigned char val1, unsigned char val2) noexcept
+		{
+			return _try_sub_impl<unsigned char>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<short> try_sub_int16(short val1, short val2) noexcept
+		{
+			return _try_sub_impl<short>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<unsigned short> try_sub_int16(unsigned short val1, unsigned short val2) noexcept
+		{
+			return _try_sub_impl<unsigned short>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<int> try_sub_int32(int val1, int val2) noexcept
+		{
+			return _try_sub_impl<int>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<unsigned int> try_sub_int32(unsigned int val1, unsigned int val2) noexcept
+		{
+			return _try_sub_impl<unsigned int>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<long long> try_sub_int64(long long val1, long long val2) noexcept
+		{
+			return _try_sub_impl<long long>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<unsigned long long> try_sub_int64(unsigned long long val1, unsigned long long val2) noexcept
+		{
+			return _try_sub_impl<unsigned long long>(val1, val2);
+		}
+
 		//------------------------------          ------------------------------//
 		//------------------------------ MULTIPLY ------------------------------//
 		//------------------------------          ------------------------------//
 	
-		template <typename baseTy, typename upTy> [[NODISCARD]]
-		constexpr baseTy _mul_impl(baseTy val1, baseTy val2)
+		// <upTy> holds any product of two <baseTy>
+		template <typename baseTy, typename upTy>
+		constexpr errc _mul_check(baseTy val1, baseTy val2) noexcept
 		{
-			upTy res = (upTy)val1 * val2;
-			if ( (baseTy) (res >> (sizeof(baseTy) * 8) ) )
+			const upTy res = (upTy)val1 * val2;
+			if (res > (upTy)std::numeric_limits<baseTy>::max()) return errc::overflow;
+			if constexpr (std::is_signed<baseTy>::value)
 			{
-				throw std::overflow_error((std::string) typeid(baseTy).name() + " multiplication overflow");
+				if (res < (upTy)std::numeric_limits<baseTy>::min()) return errc::underflow;
 			}
-			return (baseTy)res;
+			return errc::none;
+		}
+
+		template <typename baseTy, typename upTy> [[NODISCARD]]
+		constexpr baseTy _mul_impl(baseTy val1, baseTy val2)
+		{
+			const errc code = _mul_check<baseTy, upTy>(val1, val2);
+			if (code != errc::none) _throw<baseTy>(code, "multiplication");
+			return (baseTy)((upTy)val1 * val2);
+		}
+
+		template <typename baseTy, typename upTy>
+		[[nodiscard]] expected<baseTy> _try_mul_impl(baseTy val1, baseTy val2) noexcept
+		{
+			const errc code = _mul_check<baseTy, upTy>(val1, val2);
+			if (code != errc::none) return unexpected<errc>(code);
+			return (baseTy)((upTy)val1 * val2);
 		}
 
 		[[NODISCARD]]
@@ -185,6 +348,42 @@ namespace nw {
 			return _mul_impl<unsigned int, unsigned long long>(val1, val2);
 		}
 
+		[[nodiscard]]
+		inline expected<char> try_mul_int8(char val1, char val2) noexcept
+		{
+			return _try_mul_impl<char, short>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<unsigned char> try_mul_uint8(unsigned char val1, unsigned char val2) noexcept
+		{
+			return _try_mul_impl<unsigned char, unsigned short>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<short> try_mul_int16(short val1, short val2) noexcept
+		{
+			return _try_mul_impl<short, int>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<unsigned short> try_mul_uint16(unsigned short val1, unsigned short val2) noexcept
+		{
+			return _try_mul_impl<unsigned short, unsigned int>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<int> try_mul_int32(int val1, int val2) noexcept
+		{
+			return _try_mul_impl<int, long long>(val1, val2);
+		}
+
+		[[nodiscard]]
+		inline expected<unsigned int> try_mul_uint32(unsigned int val1, unsigned int val2) noexcept
+		{
+			return _try_mul_impl<unsigned int, unsigned long long>(val1, val2);
+		}
+
 	} // namespace SafeMath
 
 } // namespace nw
\ No newline at end of file
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <nowifi/compiler/class.hpp>
+#include <nowifi/util/expected.hpp>
 #include <string>
 #include <iomanip>
 #include <sstream>
 #include <stdexcept>
+#include <charconv>
+#include <type_traits>
+#include <new>
 
 namespace nw {
 
@@ -30,7 +34,7 @@ namespace nw {
 		static bool tryto(const string_type& str, Ty& var)
 		{
 			istringstream_type iss(str);
-			return _to<Ty>(iss, str, var);
+			return _tryto<Ty>(iss, str, var);
 		}
 		
 		template <class Ty>
@@ -48,6 +52,93 @@ namespace nw {
 			return _to<Ty>(iss, str);
 		}
 
+		//-------------------- NOEXCEPT --------------------//
+
+		// Types std::from_chars reads the way operator>> does (not the char types)
+		template <class Ty>
+		struct _chars_parsable : std::bool_constant<std::is_same<charTy, char>::value && (
+			std::is_same<Ty, short>::value || std::is_same<Ty, int>::value || std::is_same<Ty, long>::value || std::is_same<Ty, long long>::value ||
+			std::is_same<Ty, unsigned short>::value || std::is_same<Ty, unsigned int>::value || std::is_same<Ty, unsigned long>::value || std::is_same<Ty, unsigned long long>::value ||
+			std::is_same<Ty, float>::value || std::is_same<Ty, double>::value || std::is_same<Ty, long double>::value)> {};
+
+		// The bases std::setbase honours; the stream reads any other like base 0 (prefix decides)
+		static constexpr bool _chars_base(int base) noexcept
+		{
+			return base == 8 || base == 10 || base == 16;
+		}
+
+		/*
+		 * std::from_chars over the whole of [first, last), accepting what
+		 * operator>> accepts around it: leading whitespace, a '+' sign and a
+		 * "0x" prefix in base 16. Unlike operator>>, which wraps "-1" into an
+		 * unsigned type, a '-' on an unsigned type is errc::invalid_argument.
+		 * Integers take base 8, 10 or 16 only; any other is errc::invalid_argument.
+		 */
+		template <class Ty>
+		static expected<Ty> _try_chars(const char* first, const char* last, int base) noexcept
+		{
+			while (first != last && (*first == ' ' || (*first >= '\t' && *first <= '\r'))) first++;
+			if (last - first > 1 && *first == '+' && first[1] != '-' && first[1] != '+') first++;
+			if (first == last) return unexpected<errc>(errc::invalid_argument);
+
+			Ty var{};
+			std::from_chars_result res;
+			if constexpr (std::is_floating_point<Ty>::value)
+			{
+				res = std::from_chars(first, last, var);
+			}
+			else
+			{
+				if (!_chars_base(base)) return unexpected<errc>(errc::invalid_argument);
+				if (base == 16 && last - first > 2 && first[0] == '0' && (first[1] == 'x' || first[1] == 'X')) first += 2;
+				res = std::from_chars(first, last, var, base);
+			}
+
+			if (res.ec == std::errc::result_out_of_range) return unexpected<errc>(errc::out_of_range);
+			if (res.ec != std::errc() || res.ptr != last) return unexpected<errc>(errc::invalid_argument);
+			return var;
+		}
+
+		template <class Ty>
+		static expected<Ty> _try_stream(const string_type& str, int base) noexcept
+		{
+			try
+			{
+				istringstream_type iss(str);
+				iss >> std::setbase(base);
+				Ty var;
+				if (!_tryto<Ty>(iss, str, var)) return unexpected<errc>(errc::invalid_argument);
+				return var;
+			}
+			catch (const std::bad_alloc&)
+			{
+				return unexpected<errc>(errc::out_of_memory);
+			}
+			catch (...)
+			{
+				return unexpected<errc>(errc::io_error);
+			}
+		}
+
+		/*
+		 * Non-throwing to(): errc::invalid_argument where to() throws, and
+		 * errc::out_of_range for a number Ty can not hold. Integers and
+		 * floats of a char string skip the stream (std::from_chars).
+		 *
+		 * @param <str> - String to convert
+		 * @param <base> - Integer base (8, 10, 16 like std::setbase; any other reads a 0 or 0x prefix like to())
+		 * @return expected<Ty>
+		 */
+		template <class Ty>
+		static expected<Ty> try_to(const string_type& str, int base = 10) noexcept
+		{
+			if constexpr (_chars_parsable<Ty>::value)
+			{
+				if (std::is_floating_point<Ty>::value || _chars_base(base)) return _try_chars<Ty>(str.data(), str.data() + str.size(), base);
+			}
+			return _try_stream<Ty>(str, base);
+		}
+
 		//-------------------- PRIMITIVES --------------------//
 
 		//-------------------- short --------------------//
@@ -66,6 +157,11 @@ namespace nw {
 			return _to<short>(iss, str);
 		}
 
+		static expected<short> try_toShort(const string_type& str, int base = 10) noexcept
+		{
+			return try_to<short>(str, base);
+		}
+
 		//-------------------- int --------------------//
 
 		static bool trytoInt(const string_type& str, int& val, int base = 10)
@@ -82,6 +178,11 @@ namespace nw {
 			return _to<int>(iss, str);
 		}
 
+		static expected<int> try_toInt(const string_type& str, int base = 10) noexcept
+		{
+			return try_to<int>(str, base);
+		}
+
 		//-------------------- long --------------------//
 
 		static bool trytoLong(const string_type& str, long& val, int base = 10)
@@ -98,6 +199,11 @@ namespace nw {
 			return _to<long>(iss, str);
 		}
 
+		static expected<long> try_toLong(const string_type& str, int base = 10) noexcept
+		{
+			return try_to<long>(str, base);
+		}
+
 		//-------------------- long long --------------------//
 
 		static bool trytoLLong(const string_type& str, long long& val, int base = 10)
@@ -114,6 +220,11 @@ namespace nw {
 			return _to<long long>(iss, str);
 		}
 
+		static expected<long long> try_toLLong(const string_type& str, int base = 10) noexcept
+		{
+			return try_to<long long>(str, base);
+		}
+
 		//-------------------- unsigned short --------------------//
 
 		static bool trytoUShort(const string_type& str, unsigned short& val, int base = 10)
@@ -130,6 +241,11 @@ namespace nw {
 			return _to<unsigned short>(iss, str);
 		}
 
+		static expected<unsigned short> try_toUShort(const string_type& str, int base = 10) noexcept
+		{
+			return try_to<unsigned short>(str, base);
+		}
+
 		//-------------------- unsigned int --------------------//
 
 		static bool trytoUInt(const string_type& str, unsigned int& val, int base = 10)
@@ -146,6 +262,11 @@ namespace nw {
 			return _to<unsigned int>(iss, str);
 		}
 
+		static expected<unsigned int> try_toUInt(const string_type& str, int base = 10) noexcept
+		{
+			return try_to<unsigned int>(str, base);
+		}
+
 		//-------------------- unsigned long --------------------//
 
 		static bool trytoULong(const string_type& str, unsigned long& val, int base = 10)
@@ -162,6 +283,11 @@ namespace nw {
 			return _to<unsigned long>(iss, str);
 		}
 
+		static expected<unsigned long> try_toULong(const string_type& str, int base = 10) noexcept
+		{
+			return try_to<unsigned long>(str, base);
+		}
+
 		//-------------------- unsigned long long --------------------//
 
 		static bool trytoULLong(const string_type& str, unsigned long long& val, int base = 10)
@@ -178,6 +304,11 @@ namespace nw {
 			return _to<unsigned long long int>(iss, str);
 		}
 
+		static expected<unsigned long long> try_toULLong(const string_type& str, int base = 10) noexcept
+		{
+			return try_to<unsigned long long>(str, base);
+		}
+
 		//-------------------- float --------------------//
 
 		static bool trytoFloat(const string_type& str, float& val)
@@ -190,6 +321,11 @@ namespace nw {
 			return to<float>(str);
 		}
 
+		static expected<float> try_toFloat(const string_type& str) noexcept
+		{
+			return try_to<float>(str);
+		}
+
 		//-------------------- double --------------------//
 
 		static bool trytoDouble(const string_type& str, double& val)
@@ -202,6 +338,11 @@ namespace nw {
 			return to<double>(str);
 		}
 
+		static expected<double> try_toDouble(const string_type& str) noexcept
+		{
+			return try_to<double>(str);
+		}
+
 		//-------------------- long double --------------------//
 
 		static bool trytoLDouble(const string_type& str, long double& val)
@@ -214,6 +355,11 @@ namespace nw {
 			return to<long double>(str);
 		}
 
+		static expected<long double> try_toLDouble(const string_type& str) noexcept
+		{
+			return try_to<long double>(str);
+		}
+
 
 	}; // class basic_from_string
 
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <nowifi/util/hash.hpp>
+#include <nowifi/util/map/flatMap.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+
+namespace nw {
+
+	/*
+	 * Interning pool: every distinct string is stored once in a bump arena
+	 * and identified by a dense 32-bit id (0, 1, 2, ... in first-seen order).
+	 *
+	 * Views returned by the pool stay valid until clear() or destruction;
+	 * the arena never moves its blocks. id -> view is a vector index,
+	 * view -> id is a single flat_map probe.
+	 */
+	template <typename charTy>
+	class basic_StringPool
+	{
+	public:
+
+		using char_type = charTy;
+		using string_type = std::basic_string<charTy>;
+		using view_type = std::basic_string_view<charTy>;
+		using id_type = uint32_t;
+
+		static constexpr id_type npos = static_cast<id_type>(-1);
+		static constexpr size_t default_block_size = 64 * 1024;
+
+	protected:
+
+		std::vector<std::unique_ptr<charTy[]>> _blocks;
+		charTy* _cursor = nullptr;
+		size_t _left = 0;
+		size_t _block_size;
+		size_t _bytes = 0;
+
+		std::vector<view_type> _views;
+		flat_map<view_type, id_type, hash64::hasher<view_type>> _ids;
+
+		// Copies <str> into the arena and returns the stable copy.
+		view_type _store(view_type str)
+		{
+			if (str.size() > _left)
+			{
+				// Oversized strings get a dedicated block so the current one stays usable.
+				if (str.size() > _block_size / 4)
+				{
+					_blocks.emplace_back(new charTy[str.size() == 0 ? 1 : str.size()]);
+					std::copy(str.begin(), str.end(), _blocks.back().get());
+					_bytes += str.size() * sizeof(charTy);
+					return view_type(_blocks.back().get(), str.size());
+				}
+				_blocks.emplace_back(new charTy[_block_size]);
+				_cursor = _blocks.back().get();
+				_left = _block_size;
+			}
+			charTy* dst = _cursor;
+			std::copy(str.begin(), str.end(), dst);
+			_cursor += str.size();
+			_left -= str.size();
+			_bytes += str.size() * sizeof(charTy);
+			return view_type(dst, str.size());
+		}
+
+	public:
+
+		//-------------------- CONSTRUCTOR --------------------//
+
+		explicit basic_StringPool(size_t block_size = default_block_size)
+			: _block_size(block_size == 0 ? default_block_size : block_size) { }
+
+		basic_StringPool(const basic_StringPool&) = delete;
+		basic_StringPool& operator=(const basic_StringPool&) = delete;
+
+		basic_StringPool(basic_StringPool&&) noexcept = default;
+		basic_StringPool& operator=(basic_StringPool&&) noexcept = default;
+
+		//-------------------- intern --------------------//
+
+		/*
+		 * Returns the id of <str>, storing it on first sight.
+		 *
+		 * @exception std::length_error - More than 2^32 - 1 distinct strings
+		 */
+		id_type intern(view_type str)
+		{
+			const auto found = _ids.find(str);
+			if (found != _ids.end()) return found->second;
+
+			if (_views.size() >= static_cast<size_t>(npos)) throw std::length_error("StringPool: id space exhausted");
+			const id_type id = static_cast<id_type>(_views.size());
+			const view_type stored = this->_store(str);
+			_views.push_back(stored);
+			_ids.try_emplace(stored, id);
+			return id;
+		}
+
+		/*
+		 * Returns the pooled copy of <str>, storing it on first sight.
+		 */
+		view_type intern_view(view_type str)
+		{
+			return _views[this->intern(str)];
+		}
+
+		/*
+		 * Interns every element of [first, last) into <out>.
+		 */
+		template <class _Iter, class _OutIt>
+		_OutIt intern_range(_Iter _First, _Iter _Last, _OutIt _Dest)
+		{
+			for (; _First != _Last; ++_First, ++_Dest) *_Dest = this->intern(*_First);
+			return _Dest;
+		}
+
+		//-------------------- lookup --------------------//
+
+		/*
+		 * Returns the id of <str>, or npos if it was never interned.
+		 */
+		[[nodiscard]] id_type find(view_type str) const
+		{
+			const auto found = _ids.find(str);
+			return found == _ids.end() ? npos : found->second;
+		}
+
+		[[nodiscard]] bool contains(view_type str) const
+		{
+			return _ids.contains(str);
+		}
+
+		[[nodiscard]] view_type view(id_type id) const noexcept
+		{
+			return _views[id];
+		}
+
+		[[nodiscard]] view_type operator[](id_type id) const noexcept
+		{
+			return _views[id];
+		}
+
+		[[nodiscard]] view_type at(id_type id) const
+		{
+			if (id >= _views.size()) throw std::out_of_range("StringPool: id out of range");
+			return _views[id];
+		}
+
+		[[nodiscard]] string_type str(id_type id) const
+		{
+			return string_type(_views[id]);
+		}
+
+		//-------------------- capacity --------------------//
+
+		[[nodiscard]] size_t size() const noexcept
+		{
+			return _views.size();
+		}
+
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return _views.empty();
+		}
+
+		// Bytes of string data held in the arena
+		[[nodiscard]] size_t bytes() const noexcept
+		{
+			return _bytes;
+		}
+
+		void reserve(size_t count)
+		{
+			_views.reserve(count);
+			_ids.reserve(count);
+		}
+
+		// Invalidates every id and view handed out so far.
+		void clear() noexcept
+		{
+			_ids.clear();
+			_views.clear();
+			_blocks.clear();
+			_cursor = nullptr;
+			_left = 0;
+			_bytes = 0;
+		}
+
+		//-------------------- iteration (id order) --------------------//
+
+		[[nodiscard]] typename std::vector<view_type>::const_iterator begin() const noexcept
+		{
+			return _views.begin();
+		}
+
+		[[nodiscard]] typename std::vector<view_type>::const_iterator end() const noexcept
+		{
+			return _views.end();
+		}
+
+	}; // class basic_StringPool
+
+	using StringPool = basic_StringPool<char>;
+	using WStringPool = basic_StringPool<wchar_t>;
+
+} // namespace nw
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <nowifi/string/pool.hpp>
+
 #include <sstream>
+#include <string_view>
 #include <vector>
 
 namespace nw {
@@ -12,10 +15,14 @@ namespace nw {
 
 		std::basic_istringstream<charTy> stream;
 		const char sep;
+		std::basic_string<charTy> token_buffer;
 
 	public:
 
 		using string_type = std::basic_string<charTy>;
+		using view_type = std::basic_string_view<charTy>;
+		using pool_type = basic_StringPool<charTy>;
+		using pool_id_type = typename pool_type::id_type;
 
 		basic_StringSplitter(const string_type& str, charTy sep)
 			: stream(str), sep(sep) {}
@@ -28,6 +35,14 @@ namespace nw {
 			return std::getline<charTy>(stream, token, sep) ? true : false;
 		}
 
+		// Interns the next token; the token buffer is reused between calls.
+		bool cut(pool_type& pool, pool_id_type& id)
+		{
+			if (!this->cut(token_buffer)) return false;
+			id = pool.intern(token_buffer);
+			return true;
+		}
+
 		string_type cut_return()
 		{
 			string_type token;
@@ -57,6 +72,21 @@ namespace nw {
 			}
 			return tokens;
 		}
+
+		// Interns tokens straight from <str> without copying them out first.
+		static std::vector<pool_id_type> split_intern(view_type str, charTy sep, pool_type& pool)
+		{
+			std::vector<pool_id_type> ids;
+			size_t begin = 0;
+			while (begin < str.size())
+			{
+				size_t end = str.find(sep, begin);
+				if (end == view_type::npos) end = str.size();
+				ids.push_back(pool.intern(str.substr(begin, end - begin)));
+				begin = end + 1;
+			}
+			return ids;
+		}
 	
 	}; // class basic_StringSplitter
 
@@ -0,0 +1,444 @@
+#pragma once
+
+#include <nowifi/util/perf.hpp>
+#include <nowifi/util/time.hpp>
+
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <type_traits>
+#include <cmath>
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace nw {
+
+	/*
+	 * Micro-benchmark harness on SteadyClock.
+	 *
+	 * Each case is warmed up while the batch size doubles, which also gives
+	 * a per-op estimate; every repetition then runs enough ops to fill
+	 * Options::min_time, and the per-op times of the repetitions are reduced
+	 * to median and MAD (median absolute deviation), which, unlike mean and
+	 * stddev, ignore the odd repetition hit by a context switch.
+	 * With Options::counters the repetitions also count hardware events
+	 * (perf.hpp), reported per op; without PMU access only times are kept.
+	 *
+	 *   bench::Suite suite;
+	 *   suite.add("hash/short", [&]() { bench::do_not_optimize(hash64::hash(key)); }, key.size());
+	 *   bench::write_json(file, suite.run(filter, bench::Options(), std::cout));
+	 */
+	namespace bench {
+
+		//-------------------- barriers --------------------//
+
+		/*
+		 * Makes the compiler assume <value> is read, so the computation that
+		 * produced it can neither be dropped nor hoisted out of the timed loop.
+		 */
+		template <class Ty>
+		inline void do_not_optimize(const Ty& value) noexcept
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			static_cast<void>(*reinterpret_cast<const volatile char*>(&value));
+			_ReadWriteBarrier();
+#else
+			asm volatile("" : : "r,m"(value) : "memory");
+#endif
+		}
+
+		/*
+		 * Also makes the compiler assume <value> is modified, hiding a known
+		 * input so constant folding cannot precompute the benchmarked call.
+		 */
+		template <class Ty>
+		inline void do_not_optimize(Ty& value) noexcept
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			static_cast<void>(*reinterpret_cast<volatile char*>(&value));
+			_ReadWriteBarrier();
+#else
+			if constexpr (std::is_trivially_copyable_v<Ty> && sizeof(Ty) <= sizeof(void*))
+			{
+				asm volatile("" : "+r"(value) : : "memory");
+			}
+			else
+			{
+				asm volatile("" : "+m"(value) : : "memory");
+			}
+#endif
+		}
+
+		// Makes the compiler assume all memory is read and written here
+		inline void clobber_memory() noexcept
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			_ReadWriteBarrier();
+#else
+			asm volatile("" : : : "memory");
+#endif
+		}
+
+		//-------------------- measure --------------------//
+
+		struct Options
+		{
+			std::chrono::nanoseconds warmup = std::chrono::milliseconds(50);
+			std::chrono::nanoseconds min_time = std::chrono::milliseconds(20); // per repetition
+			size_t repetitions = 9;
+			uint64_t max_iterations = uint64_t(1) << 32; // per repetition
+			bool counters = false; // also count hardware events (perf.hpp), if available
+		};
+
+		struct Result
+		{
+			std::string name;
+			std::string param; // sweep value, empty outside sweeps
+			uint64_t iterations = 0; // ops per repetition
+			size_t repetitions = 0;
+
+			// per op, over repetitions
+			double median_ns = 0;
+			double mad_ns = 0;
+			double min_ns = 0;
+			double mean_ns = 0;
+
+			double bytes_per_op = 0;
+			double items_per_op = 0;
+
+			// summed over all repetitions; empty unless Options::counters and supported
+			perf::sample counters;
+
+			[[nodiscard]] std::string full_name() const
+			{
+				return param.empty() ? name : name + '/' + param;
+			}
+
+			[[nodiscard]] double bytes_per_second() const noexcept
+			{
+				return median_ns > 0 ? bytes_per_op * 1e9 / median_ns : 0;
+			}
+
+			[[nodiscard]] double items_per_second() const noexcept
+			{
+				return median_ns > 0 ? items_per_op * 1e9 / median_ns : 0;
+			}
+
+			[[nodiscard]] double per_op(perf::event type) const noexcept
+			{
+				const double ops = static_cast<double>(iterations) * static_cast<double>(repetitions);
+				return ops > 0 ? static_cast<double>(counters[type]) / ops : 0;
+			}
+		};
+
+		template <class Function>
+		inline long long _time(Function& fn, uint64_t iterations)
+		{
+			const long long start = SteadyClock::nowNano();
+			for (uint64_t it = 0; it < iterations; it++) fn();
+			clobber_memory();
+			return SteadyClock::nowNano() - start;
+		}
+
+		// Median of <values>; reorders them
+		inline double _median(std::vector<double>& values)
+		{
+			if (values.empty()) return 0;
+			const size_t half = values.size() / 2;
+			std::nth_element(values.begin(), values.begin() + half, values.end());
+			const double upper = values[half];
+			if (values.size() % 2) return upper;
+			return (*std::max_element(values.begin(), values.begin() + half) + upper) / 2;
+		}
+
+		/*
+		 * Times <fn> (one op per call) as described above.
+		 *
+		 * @param <name> - Case name stored in the result
+		 * @param <fn> - Callable with no arguments; keep its output alive with do_not_optimize
+		 * @param <opt> - Warmup, repetition time and count
+		 * @return Per-op statistics; bytes/items per op are left to the caller
+		 */
+		template <class Function>
+		Result measure(const std::string& name, Function&& fn, const Options& opt = Options())
+		{
+			const long long warmup = static_cast<long long>(opt.warmup.count());
+			const long long min_time = static_cast<long long>(opt.min_time.count());
+
+			uint64_t batch = 1;
+			long long spent = 0;
+			double per_op = 0;
+			for (;;)
+			{
+				const long long elapsed = _time(fn, batch);
+				spent += elapsed;
+				per_op = static_cast<double>(elapsed) / static_cast<double>(batch);
+				if (spent >= warmup || batch >= opt.max_iterations) break;
+				// Grow until one batch is long enough to time reliably
+				if (elapsed < 1000000 || elapsed < min_time / 4) batch = std::min(batch * 2, opt.max_iterations);
+			}
+
+			Result result;
+			result.name = name;
+			result.repetitions = std::max<size_t>(opt.repetitions, 1);
+			result.iterations = per_op > 0 ? static_cast<uint64_t>(std::ceil(static_cast<double>(min_time) / per_op)) : opt.max_iterations;
+			result.iterations = std::min(std::max<uint64_t>(result.iterations, 1), opt.max_iterations);
+
+			// Opened before the loop; start/stop stay outside the timed region
+			std::unique_ptr<perf::Counters> group;
+			if (opt.counters) group = std::make_unique<perf::Counters>();
+			if (group && !group->available()) group.reset();
+
+			std::vector<double> samples(result.repetitions);
+			for (double& sample : samples)
+			{
+				if (group) group->start();
+				sample = static_cast<double>(_time(fn, result.iterations)) / static_cast<double>(result.iterations);
+				if (group) result.counters += group->stop();
+			}
+
+			result.min_ns = *std::min_element(samples.begin(), samples.end());
+			double total = 0;
+			for (double sample : samples) total += sample;
+			result.mean_ns = total / static_cast<double>(samples.size());
+
+			std::vector<double> deviations(samples);
+			result.median_ns = _median(samples);
+			for (double& deviation : deviations) deviation = std::abs(deviation - result.median_ns);
+			result.mad_ns = _median(deviations);
+			return result;
+		}
+
+		//-------------------- Suite --------------------//
+
+		/*
+		 * One registered case once its input is built.
+		 * <run> is called through std::function, so an op should do at least
+		 * ~100 ns of work (loop over a batch and report items_per_op).
+		 */
+		struct Case
+		{
+			std::function<void()> run;
+			double bytes_per_op = 0;
+			double items_per_op = 0;
+		};
+
+		class Suite
+		{
+		protected:
+
+			struct _entry
+			{
+				std::string name;
+				std::string param;
+				std::function<Case()> setup;
+			};
+
+			std::vector<_entry> _entries;
+
+			template <class Param>
+			static std::string _param_name(const Param& value)
+			{
+				std::ostringstream os;
+				os << value;
+				return os.str();
+			}
+
+		public:
+
+			/*
+			 * @param <fn> - One op, see Case
+			 */
+			template <class Function>
+			Suite& add(const std::string& name, Function fn, double bytes_per_op = 0, double items_per_op = 0)
+			{
+				_entries.push_back(_entry{ name, std::string(), [fn, bytes_per_op, items_per_op]() {
+					return Case{ fn, bytes_per_op, items_per_op };
+				} });
+				return *this;
+			}
+
+			/*
+			 * Registers one case per value, named "<name>/<value>".
+			 *
+			 * @param <factory> - Called as factory(value) -> Case right before the
+			 *                    point runs, so sweep inputs are never all alive at once
+			 */
+			template <class Param, class Factory>
+			Suite& add_sweep(const std::string& name, const std::vector<Param>& values, Factory factory)
+			{
+				for (const Param& value : values)
+				{
+					_entries.push_back(_entry{ name, _param_name(value), [factory, value]() {
+						return Case(factory(value));
+					} });
+				}
+				return *this;
+			}
+
+			[[nodiscard]] size_t size() const noexcept
+			{
+				return _entries.size();
+			}
+
+			/*
+			 * Runs every case whose "<name>/<param>" contains <filter> (all if empty),
+			 * printing each result to <progress> as it completes.
+			 */
+			std::vector<Result> run(const std::string& filter, const Options& opt, std::ostream& progress) const
+			{
+				std::vector<Result> results;
+				for (const _entry& entry : _entries)
+				{
+					const std::string full = entry.param.empty() ? entry.name : entry.name + '/' + entry.param;
+					if (!filter.empty() && full.find(filter) == std::string::npos) continue;
+
+					const Case item = entry.setup();
+					Result result = measure(entry.name, item.run, opt);
+					result.param = entry.param;
+					result.bytes_per_op = item.bytes_per_op;
+					result.items_per_op = item.items_per_op;
+					print(progress, result);
+					results.push_back(std::move(result));
+				}
+				return results;
+			}
+
+			//-------------------- output --------------------//
+
+			static void print_header(std::ostream& os)
+			{
+				os << std::left << std::setw(40) << "benchmark" << std::right
+					<< std::setw(14) << "median ns" << std::setw(10) << "mad %"
+					<< std::setw(14) << "items/s" << std::setw(12) << "MB/s" << '\n';
+			}
+
+			static void print(std::ostream& os, const Result& result)
+			{
+				const std::ios_base::fmtflags flags = os.flags();
+				const std::streamsize precision = os.precision();
+				os << std::left << std::setw(40) << result.full_name() << std::right << std::fixed << std::setprecision(1)
+					<< std::setw(14) << result.median_ns
+					<< std::setw(10) << (result.median_ns > 0 ? 100 * result.mad_ns / result.median_ns : 0.0)
+					<< std::setprecision(0)
+					<< std::setw(14) << result.items_per_second()
+					<< std::setw(12) << result.bytes_per_second() / 1e6 << '\n';
+
+				if (result.counters.valid != 0)
+				{
+					os << "    ipc " << std::setprecision(2) << result.counters.ipc() << " per op:";
+					for (size_t idx = 0; idx < perf::event_count; idx++)
+					{
+						const perf::event type = static_cast<perf::event>(idx);
+						if (result.counters.has(type)) os << ' ' << perf::name(type) << ' ' << result.per_op(type);
+					}
+					os << '\n';
+				}
+				os.flush();
+				os.flags(flags);
+				os.precision(precision);
+			}
+
+		}; // class Suite
+
+		//-------------------- JSON --------------------//
+
+		inline std::string _json_escape(const std::string& str)
+		{
+			std::string result;
+			result.reserve(str.size());
+			for (char ch : str)
+			{
+				if (ch == '"' || ch == '\\') result += '\\';
+				if (static_cast<unsigned char>(ch) < 0x20) ch = ' ';
+				result += ch;
+			}
+			return result;
+		}
+
+		inline const char* _compiler()
+		{
+#if defined(__clang__)
+			return "clang " __clang_version__;
+#elif defined(__GNUC__)
+			return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+#define NW_BENCH_STR2(x) #x
+#define NW_BENCH_STR(x) NW_BENCH_STR2(x)
+			return "msvc " NW_BENCH_STR(_MSC_FULL_VER);
+#undef NW_BENCH_STR
+#undef NW_BENCH_STR2
+#else
+			return "unknown";
+#endif
+		}
+
+		/*
+		 * One JSON document: run context plus one object per result, all
+		 * times in ns per op. Stable keys, meant to be diffed across runs.
+		 */
+		inline void write_json(std::ostream& os, const std::vector<Result>& results, const Options& opt)
+		{
+			const std::ios_base::fmtflags flags = os.flags();
+			const std::streamsize precision = os.precision();
+			os << std::setprecision(6) << std::defaultfloat;
+
+			os << "{\n  \"context\": {"
+				<< "\"timestamp_ms\": " << SystemTime::nowMilli()
+				<< ", \"compiler\": \"" << _json_escape(_compiler()) << '"'
+#if defined(NDEBUG)
+				<< ", \"build\": \"release\""
+#else
+				<< ", \"build\": \"debug\""
+#endif
+				<< ", \"min_time_ns\": " << opt.min_time.count()
+				<< ", \"repetitions\": " << opt.repetitions
+				<< ", \"counters\": " << (opt.counters && perf::supported() ? "true" : "false")
+				<< "},\n  \"benchmarks\": [";
+
+			for (size_t idx = 0; idx < results.size(); idx++)
+			{
+				const Result& result = results[idx];
+				os << (idx ? ",\n" : "\n") << "    {"
+					<< "\"name\": \"" << _json_escape(result.full_name()) << '"'
+					<< ", \"case\": \"" << _json_escape(result.name) << '"'
+					<< ", \"param\": \"" << _json_escape(result.param) << '"'
+					<< ", \"iterations\": " << result.iterations
+					<< ", \"repetitions\": " << result.repetitions
+					<< ", \"median_ns\": " << result.median_ns
+					<< ", \"mad_ns\": " << result.mad_ns
+					<< ", \"min_ns\": " << result.min_ns
+					<< ", \"mean_ns\": " << result.mean_ns
+					<< ", \"bytes_per_second\": " << result.bytes_per_second()
+					<< ", \"items_per_second\": " << result.items_per_second();
+
+				if (result.counters.valid != 0)
+				{
+					os << ", \"counters\": {\"ipc\": " << result.counters.ipc();
+					for (size_t idx = 0; idx < perf::event_count; idx++)
+					{
+						const perf::event type = static_cast<perf::event>(idx);
+						if (result.counters.has(type)) os << ", \"" << perf::name(type) << "_per_op\": " << result.per_op(type);
+					}
+					os << '}';
+				}
+				os << '}';
+			}
+			os << "\n  ]\n}\n";
+
+			os.flags(flags);
+			os.precision(precision);
+		}
+
+	} // namespace bench
+
+} // namespace nw
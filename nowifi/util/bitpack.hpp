@@ -0,0 +1,570 @@
+#pragma once
+
+#include <nowifi/array/span.hpp>
+#include <nowifi/io/binary.hpp>
+#include <nowifi/math/bitwise.hpp>
+
+#include <vector>
+#include <array>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(NW_BITPACK_NO_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NW_BITPACK_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NW_BITPACK_SSE2
+#endif
+#endif
+
+namespace nw {
+
+	/*
+	 * Frame-of-reference bit-packing (SIMD-BP128 layout, Lemire & Boytsov).
+	 *
+	 * A block of 32 * Lanes integers (128 for SSE, 256 for AVX2) is stored as
+	 * (value - min) in <width> bits each, width = bits needed for max - min.
+	 * Element i lives in lane i % Lanes at bit (i / Lanes) * width of that
+	 * lane's stream, so one vector shift/or handles Lanes values at once and
+	 * a block takes exactly width * Lanes 32-bit words.
+	 */
+	namespace bitpack {
+
+		[[nodiscard]] inline uint32_t width(uint32_t range) noexcept
+		{
+			return range == 0 ? 0 : static_cast<uint32_t>(64 - Bitwise::countl_zero(static_cast<uint64_t>(range)));
+		}
+
+		//-------------------- vector backends --------------------//
+
+		template <size_t Lanes>
+		struct _scalar
+		{
+			static constexpr size_t lanes = Lanes;
+			struct type { uint32_t v[Lanes]; };
+
+			static type load(const uint32_t* ptr) noexcept { type r; std::memcpy(r.v, ptr, sizeof r.v); return r; }
+			static void store(uint32_t* ptr, const type& a) noexcept { std::memcpy(ptr, a.v, sizeof a.v); }
+			static type set1(uint32_t x) noexcept { type r; for (size_t l = 0; l < Lanes; l++) r.v[l] = x; return r; }
+			static type add(type a, const type& b) noexcept { for (size_t l = 0; l < Lanes; l++) a.v[l] += b.v[l]; return a; }
+			static type sub(type a, const type& b) noexcept { for (size_t l = 0; l < Lanes; l++) a.v[l] -= b.v[l]; return a; }
+			static type or_(type a, const type& b) noexcept { for (size_t l = 0; l < Lanes; l++) a.v[l] |= b.v[l]; return a; }
+			static type and_(type a, const type& b) noexcept { for (size_t l = 0; l < Lanes; l++) a.v[l] &= b.v[l]; return a; }
+			template <int N> static type sll(type a) noexcept { for (size_t l = 0; l < Lanes; l++) a.v[l] <<= N; return a; }
+			template <int N> static type srl(type a) noexcept { for (size_t l = 0; l < Lanes; l++) a.v[l] >>= N; return a; }
+		};
+
+#if defined(NW_BITPACK_SSE2)
+		struct _sse2
+		{
+			static constexpr size_t lanes = 4;
+			using type = __m128i;
+
+			static type load(const uint32_t* ptr) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+			static void store(uint32_t* ptr, type a) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), a); }
+			static type set1(uint32_t x) noexcept { return _mm_set1_epi32(static_cast<int>(x)); }
+			static type add(type a, type b) noexcept { return _mm_add_epi32(a, b); }
+			static type sub(type a, type b) noexcept { return _mm_sub_epi32(a, b); }
+			static type or_(type a, type b) noexcept { return _mm_or_si128(a, b); }
+			static type and_(type a, type b) noexcept { return _mm_and_si128(a, b); }
+			template <int N> static type sll(type a) noexcept { return _mm_slli_epi32(a, N); }
+			template <int N> static type srl(type a) noexcept { return _mm_srli_epi32(a, N); }
+		};
+#endif
+
+#if defined(NW_BITPACK_AVX2)
+		struct _avx2
+		{
+			static constexpr size_t lanes = 8;
+			using type = __m256i;
+
+			static type load(const uint32_t* ptr) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)); }
+			static void store(uint32_t* ptr, type a) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), a); }
+			static type set1(uint32_t x) noexcept { return _mm256_set1_epi32(static_cast<int>(x)); }
+			static type add(type a, type b) noexcept { return _mm256_add_epi32(a, b); }
+			static type sub(type a, type b) noexcept { return _mm256_sub_epi32(a, b); }
+			static type or_(type a, type b) noexcept { return _mm256_or_si256(a, b); }
+			static type and_(type a, type b) noexcept { return _mm256_and_si256(a, b); }
+			template <int N> static type sll(type a) noexcept { return _mm256_slli_epi32(a, N); }
+			template <int N> static type srl(type a) noexcept { return _mm256_srli_epi32(a, N); }
+		};
+#endif
+
+		template <size_t Lanes>
+		struct _backend { using type = _scalar<Lanes>; };
+
+#if defined(NW_BITPACK_SSE2)
+		template <>
+		struct _backend<4> { using type = _sse2; };
+#endif
+
+#if defined(NW_BITPACK_AVX2)
+		template <>
+		struct _backend<8> { using type = _avx2; };
+#endif
+
+		//-------------------- kernels --------------------//
+
+		// Fully unrolled per width: every shift is an immediate.
+		template <class V, int Width>
+		struct _kernel
+		{
+			static constexpr size_t L = V::lanes;
+
+			struct state
+			{
+				typename V::type acc;
+				typename V::type base;
+				typename V::type mask;
+			};
+
+			template <int J>
+			static void _pack_step(const uint32_t* in, uint32_t* out, state& st) noexcept
+			{
+				constexpr int bit = J * Width;
+				constexpr int word = bit / 32, shift = bit % 32;
+				const typename V::type value = V::sub(V::load(in + J * L), st.base);
+				if constexpr (shift == 0) st.acc = value;
+				else st.acc = V::or_(st.acc, V::template sll<shift>(value));
+				if constexpr (shift + Width >= 32)
+				{
+					V::store(out + word * L, st.acc);
+					if constexpr (shift + Width > 32) st.acc = V::template srl<32 - shift>(value);
+				}
+			}
+
+			template <int J>
+			static void _unpack_step(const uint32_t* in, uint32_t* out, state& st) noexcept
+			{
+				constexpr int bit = J * Width;
+				constexpr int word = bit / 32, shift = bit % 32;
+				if constexpr (shift == 0) st.acc = V::load(in + word * L);
+				typename V::type value = V::template srl<shift>(st.acc);
+				if constexpr (shift + Width > 32)
+				{
+					st.acc = V::load(in + (word + 1) * L);
+					value = V::or_(value, V::template sll<32 - shift>(st.acc));
+				}
+				if constexpr (Width < 32) value = V::and_(value, st.mask);
+				V::store(out + J * L, V::add(value, st.base));
+			}
+
+			template <int... J>
+			static void _pack(const uint32_t* in, uint32_t base, uint32_t* out, std::integer_sequence<int, J...>) noexcept
+			{
+				state st{ V::set1(0), V::set1(base), V::set1(0) };
+				(_pack_step<J>(in, out, st), ...);
+			}
+
+			template <int... J>
+			static void _unpack(const uint32_t* in, uint32_t base, uint32_t* out, std::integer_sequence<int, J...>) noexcept
+			{
+				state st{ V::set1(0), V::set1(base), V::set1(Width == 32 ? ~0u : (1u << Width) - 1) };
+				(_unpack_step<J>(in, out, st), ...);
+			}
+
+			static void pack(const uint32_t* in, uint32_t base, uint32_t* out) noexcept
+			{
+				_pack(in, base, out, std::make_integer_sequence<int, 32>());
+			}
+
+			static void unpack(const uint32_t* in, uint32_t base, uint32_t* out) noexcept
+			{
+				_unpack(in, base, out, std::make_integer_sequence<int, 32>());
+			}
+		};
+
+		template <class V>
+		struct _kernel<V, 0>
+		{
+			static void pack(const uint32_t*, uint32_t, uint32_t*) noexcept { }
+
+			static void unpack(const uint32_t*, uint32_t base, uint32_t* out) noexcept
+			{
+				std::fill(out, out + 32 * V::lanes, base);
+			}
+		};
+
+		using _fn = void (*)(const uint32_t*, uint32_t, uint32_t*) noexcept;
+
+		template <class V, int... W>
+		constexpr std::array<_fn, 33> _pack_table(std::integer_sequence<int, W...>) noexcept
+		{
+			return { { &_kernel<V, W>::pack... } };
+		}
+
+		template <class V, int... W>
+		constexpr std::array<_fn, 33> _unpack_table(std::integer_sequence<int, W...>) noexcept
+		{
+			return { { &_kernel<V, W>::unpack... } };
+		}
+
+		//-------------------- block API --------------------//
+
+		/*
+		 * Packs 32 * Lanes values of <in> into width * Lanes words of <out>.
+		 * Every value must lie in [base, base + 2^width).
+		 */
+		template <size_t Lanes>
+		void pack(const uint32_t* in, uint32_t base, uint32_t width, uint32_t* out) noexcept
+		{
+			using V = typename _backend<Lanes>::type;
+			static constexpr std::array<_fn, 33> table = _pack_table<V>(std::make_integer_sequence<int, 33>());
+			table[width](in, base, out);
+		}
+
+		template <size_t Lanes>
+		void unpack(const uint32_t* in, uint32_t base, uint32_t width, uint32_t* out) noexcept
+		{
+			using V = typename _backend<Lanes>::type;
+			static constexpr std::array<_fn, 33> table = _unpack_table<V>(std::make_integer_sequence<int, 33>());
+			table[width](in, base, out);
+		}
+
+		// Element <idx> of a packed block without unpacking the rest
+		template <size_t Lanes>
+		[[nodiscard]] inline uint32_t get(const uint32_t* in, uint32_t base, uint32_t width, size_t idx) noexcept
+		{
+			if (width == 0) return base;
+			const size_t lane = idx % Lanes;
+			const size_t bit = (idx / Lanes) * width;
+			const size_t word = bit / 32, shift = bit % 32;
+			uint64_t value = in[word * Lanes + lane] >> shift;
+			if (shift + width > 32) value |= static_cast<uint64_t>(in[(word + 1) * Lanes + lane]) << (32 - shift);
+			const uint32_t mask = width == 32 ? ~0u : (1u << width) - 1;
+			return (static_cast<uint32_t>(value) & mask) + base;
+		}
+
+		////////////////////////////////            ////////////////////////////////
+		//------------------------------            ------------------------------//
+		//------------------------------ PackedView ------------------------------//
+		//------------------------------            ------------------------------//
+		////////////////////////////////            ////////////////////////////////
+
+		/*
+		 * Read-only packed array over memory it does not own (a PackedArray,
+		 * or a buffer read with BinaryReader::view). 32-bit integers only.
+		 */
+		template <class Ty = uint32_t, size_t BlockSize = 128>
+		class PackedView
+		{
+		public:
+
+			static_assert(sizeof(Ty) == 4 && std::is_integral<Ty>::value, "bitpack: 32-bit integers only");
+			static_assert(BlockSize == 128 || BlockSize == 256, "bitpack: BlockSize is 128 or 256");
+
+			using value_type = Ty;
+
+			static constexpr size_t block_size = BlockSize;
+			static constexpr size_t lanes = BlockSize / 32;
+
+			// Signed values are biased by 2^31 so unsigned order matches signed order
+			static constexpr uint32_t bias = std::is_signed<Ty>::value ? 0x80000000u : 0u;
+
+		protected:
+
+			size_t _size = 0;
+			span<const uint32_t> _bases; // biased block minimum
+			span<const uint8_t> _widths;
+			span<const uint64_t> _offsets; // word offset of each block
+			span<const uint32_t> _words;
+
+		public:
+
+			PackedView() = default;
+
+			PackedView(size_t size, span<const uint32_t> bases, span<const uint8_t> widths, span<const uint64_t> offsets, span<const uint32_t> words) noexcept
+				: _size(size), _bases(bases), _widths(widths), _offsets(offsets), _words(words) { }
+
+			[[nodiscard]] size_t size() const noexcept { return _size; }
+			[[nodiscard]] size_t block_count() const noexcept { return _bases.size(); }
+
+			// Packed payload in bytes (headers excluded)
+			[[nodiscard]] size_t payload_bytes() const noexcept { return _words.size_bytes(); }
+
+			[[nodiscard]] Ty operator[](size_t idx) const noexcept
+			{
+				const size_t block = idx / BlockSize;
+				const uint32_t raw = get<lanes>(_words.data() + _offsets[block], _bases[block], _widths[block], idx % BlockSize);
+				return static_cast<Ty>(raw + bias);
+			}
+
+			[[nodiscard]] Ty at(size_t idx) const
+			{
+				if (idx >= _size) throw std::out_of_range("PackedView: index out of range");
+				return (*this)[idx];
+			}
+
+			/*
+			 * Unpacks block <block> into <out> (BlockSize values, padding included).
+			 */
+			void decode_block(size_t block, Ty* out) const noexcept
+			{
+				unpack<lanes>(_words.data() + _offsets[block], _bases[block] + bias, _widths[block], reinterpret_cast<uint32_t*>(out));
+			}
+
+			/*
+			 * Unpacks all size() values into <out>.
+			 *
+			 * @exception #pragma omp parallel for
+			 */
+			void decode(Ty* out) const
+			{
+				const long long full = static_cast<long long>(_size / BlockSize);
+#pragma omp parallel for schedule(static)
+				for (long long block = 0; block < full; block++)
+				{
+					this->decode_block(static_cast<size_t>(block), out + block * BlockSize);
+				}
+				if (_size % BlockSize != 0)
+				{
+					Ty tail[BlockSize];
+					this->decode_block(static_cast<size_t>(full), tail);
+					std::copy(tail, tail + _size % BlockSize, out + full * BlockSize);
+				}
+			}
+
+			[[nodiscard]] std::vector<Ty> decode() const
+			{
+				std::vector<Ty> result(_size);
+				this->decode(result.data());
+				return result;
+			}
+
+			/*
+			 * Sequential reader: next(out, n) hands out the next n values,
+			 * unpacking whole blocks straight into <out> where possible.
+			 */
+			class reader
+			{
+			protected:
+
+				const PackedView* _view;
+				size_t _pos = 0;
+				Ty _block[BlockSize];
+
+			public:
+
+				explicit reader(const PackedView& view) noexcept
+					: _view(&view) { }
+
+				size_t next(Ty* out, size_t count) noexcept
+				{
+					count = std::min(count, _view->size() - _pos);
+					size_t done = 0;
+					while (done < count)
+					{
+						const size_t block = _pos / BlockSize, offset = _pos % BlockSize;
+						const size_t take = std::min(count - done, BlockSize - offset);
+						if (offset == 0 && take == BlockSize)
+						{
+							_view->decode_block(block, out + done);
+						}
+						else
+						{
+							_view->decode_block(block, _block);
+							std::copy(_block + offset, _block + offset + take, out + done);
+						}
+						done += take;
+						_pos += take;
+					}
+					return count;
+				}
+
+				[[nodiscard]] bool eof() const noexcept
+				{
+					return _pos >= _view->size();
+				}
+			};
+
+			[[nodiscard]] reader read() const noexcept
+			{
+				return reader(*this);
+			}
+
+		}; // class PackedView
+
+		////////////////////////////////             ////////////////////////////////
+		//------------------------------             ------------------------------//
+		//------------------------------ PackedArray ------------------------------//
+		//------------------------------             ------------------------------//
+		////////////////////////////////             ////////////////////////////////
+
+		/*
+		 * Owning, append-only packed array.
+		 *
+		 *   bitpack::PackedArray<int32_t> packed;
+		 *   packed.put(arr, size);              // any chunking; blocks close every 128 values
+		 *   packed.flush();
+		 *   int32_t x = packed.view()[12345];   // random access, no block decode
+		 *
+		 * Serialized layout (native byte order, arrays 8-byte aligned), so a
+		 * BinaryReader over a mapped file can view() it without copying:
+		 *
+		 *   u32 magic, u32 block size, u64 size, u64 blocks, u64 words,
+		 *   bases[blocks], widths[blocks], offsets[blocks], words[words]
+		 */
+		template <class Ty = uint32_t, size_t BlockSize = 128>
+		class PackedArray
+		{
+		public:
+
+			using view_type = PackedView<Ty, BlockSize>;
+			using value_type = Ty;
+
+			static constexpr size_t block_size = BlockSize;
+			static constexpr size_t lanes = view_type::lanes;
+			static constexpr uint32_t bias = view_type::bias;
+			static constexpr uint32_t magic = 0x5042574e; // "NWBP"
+
+		protected:
+
+			size_t _size = 0;
+			std::vector<uint32_t> _bases;
+			std::vector<uint8_t> _widths;
+			std::vector<uint64_t> _offsets;
+			std::vector<uint32_t> _words;
+			std::vector<uint32_t> _pending;
+
+			void _close_block()
+			{
+				// Pad the last block with its first value (no effect on width)
+				const size_t used = _pending.size();
+				_pending.resize(BlockSize, _pending.front());
+
+				uint32_t lo = ~0u, hi = 0;
+				for (uint32_t& value : _pending)
+				{
+					value += bias;
+					lo = std::min(lo, value);
+					hi = std::max(hi, value);
+				}
+				const uint32_t bits = width(hi - lo);
+
+				const size_t offset = _words.size();
+				_words.resize(offset + bits * lanes);
+				pack<lanes>(_pending.data(), lo, bits, _words.data() + offset);
+
+				_bases.push_back(lo);
+				_widths.push_back(static_cast<uint8_t>(bits));
+				_offsets.push_back(offset);
+				_size += used;
+				_pending.clear();
+			}
+
+		public:
+
+			PackedArray()
+			{
+				_pending.reserve(BlockSize);
+			}
+
+			PackedArray(const Ty* arr, size_t size)
+				: PackedArray()
+			{
+				this->put(arr, size);
+				this->flush();
+			}
+
+			//-------------------- building --------------------//
+
+			void put(Ty value)
+			{
+				if (_size % BlockSize != 0) throw std::logic_error("PackedArray: put after a partial flush");
+				_pending.push_back(static_cast<uint32_t>(value));
+				if (_pending.size() == BlockSize) this->_close_block();
+			}
+
+			void put(const Ty* arr, size_t size)
+			{
+				for (size_t idx = 0; idx < size; idx++) this->put(arr[idx]);
+			}
+
+			// Closes a partial last block; the array is complete afterwards
+			void flush()
+			{
+				if (!_pending.empty()) this->_close_block();
+			}
+
+			//-------------------- access --------------------//
+
+			// Flushed values only
+			[[nodiscard]] view_type view() const noexcept
+			{
+				return view_type(_size,
+					span<const uint32_t>(_bases.data(), _bases.size()),
+					span<const uint8_t>(_widths.data(), _widths.size()),
+					span<const uint64_t>(_offsets.data(), _offsets.size()),
+					span<const uint32_t>(_words.data(), _words.size()));
+			}
+
+			[[nodiscard]] size_t size() const noexcept { return _size; }
+
+			// Total heap bytes of the packed form
+			[[nodiscard]] size_t memory() const noexcept
+			{
+				return _bases.size() * (sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint64_t)) + _words.size() * sizeof(uint32_t);
+			}
+
+			//-------------------- binary I/O --------------------//
+
+			/*
+			 * @param <writer> - BinarySizer or basic_BinaryWriter<endian::native>
+			 */
+			template <class WriterTy>
+			void write(WriterTy& writer) const
+			{
+				writer.write(magic);
+				writer.write(static_cast<uint32_t>(BlockSize));
+				writer.write(static_cast<uint64_t>(_size));
+				writer.write(static_cast<uint64_t>(_bases.size()));
+				writer.write(static_cast<uint64_t>(_words.size()));
+				writer.write_array(_bases.data(), _bases.size(), 8);
+				writer.write_array(_widths.data(), _widths.size(), 8);
+				writer.write_array(_offsets.data(), _offsets.size(), 8);
+				writer.write_array(_words.data(), _words.size(), 8);
+			}
+
+			[[nodiscard]] bin::buffer serialize() const
+			{
+				BinarySizer sizer;
+				this->write(sizer);
+				bin::buffer result(sizer.size());
+				basic_BinaryWriter<endian::native> writer(result);
+				this->write(writer);
+				return result;
+			}
+
+			/*
+			 * Views a serialized array in place.
+			 *
+			 * @exception std::invalid_argument - Wrong magic or block size
+			 */
+			[[nodiscard]] static view_type view(basic_BinaryReader<endian::native>& reader)
+			{
+				if (reader.template read<uint32_t>() != magic || reader.template read<uint32_t>() != BlockSize)
+				{
+					throw std::invalid_argument("PackedArray: bad header");
+				}
+				const size_t size = static_cast<size_t>(reader.template read<uint64_t>());
+				const size_t blocks = static_cast<size_t>(reader.template read<uint64_t>());
+				const size_t words = static_cast<size_t>(reader.template read<uint64_t>());
+				const auto bases = reader.template view<uint32_t>(blocks, 8);
+				const auto widths = reader.template view<uint8_t>(blocks, 8);
+				const auto offsets = reader.template view<uint64_t>(blocks, 8);
+				const auto payload = reader.template view<uint32_t>(words, 8);
+				return view_type(size, bases, widths, offsets, payload);
+			}
+
+		}; // class PackedArray
+
+	} // namespace bitpack
+
+} // namespace nw
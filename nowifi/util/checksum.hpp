@@ -0,0 +1,262 @@
+#pragma once
+
+#include <nowifi/util/hash.hpp>
+
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(NW_CHECKSUM_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64)) && (defined(__SSE4_2__) || defined(__AVX__))
+#include <nmmintrin.h>
+#define NW_CHECKSUM_SSE42
+#endif
+
+namespace nw {
+
+	/*
+	 * CRC-32C (Castagnoli, as in iSCSI / ext4 / SCTP).
+	 *
+	 * SSE4.2 builds run the crc32 instruction over three interleaved streams
+	 * (it has 3-cycle latency but 1-cycle throughput) and fold them together
+	 * with a carry-less shift; other builds use slicing-by-8 tables.
+	 * Both paths give identical values.
+	 */
+	namespace crc32c {
+
+		constexpr uint32_t polynomial = 0x82F63B78; // reflected 0x1EDC6F41
+
+		struct _tables
+		{
+			uint32_t slice[8][256] = {};
+			uint32_t x2n[72] = {}; // x^(2^n) mod P, n up to 3 + 64 (byte lengths)
+
+			constexpr _tables() noexcept
+			{
+				for (uint32_t idx = 0; idx < 256; idx++)
+				{
+					uint32_t crc = idx;
+					for (int bit = 0; bit < 8; bit++) crc = crc & 1 ? (crc >> 1) ^ polynomial : crc >> 1;
+					slice[0][idx] = crc;
+				}
+				for (uint32_t idx = 0; idx < 256; idx++)
+				{
+					for (int k = 1; k < 8; k++) slice[k][idx] = (slice[k - 1][idx] >> 8) ^ slice[0][slice[k - 1][idx] & 0xFF];
+				}
+
+				uint32_t power = 1u << 30; // x^1
+				x2n[0] = power;
+				for (int n = 1; n < 72; n++) x2n[n] = power = _multiply(power, power);
+			}
+
+			// a * b mod P, bit-reflected (bit 31 is x^0)
+			static constexpr uint32_t _multiply(uint32_t a, uint32_t b) noexcept
+			{
+				uint32_t product = 0;
+				for (uint32_t mask = 1u << 31; mask != 0; mask >>= 1)
+				{
+					if (a & mask) product ^= b;
+					b = b & 1 ? (b >> 1) ^ polynomial : b >> 1;
+				}
+				return product;
+			}
+		};
+
+		inline constexpr _tables _table{};
+
+		// x^(8 * len) mod P: multiplying a CRC register by it appends <len> zero bytes
+		[[nodiscard]] constexpr inline uint32_t _shift_bytes(size_t len) noexcept
+		{
+			uint32_t power = 1u << 31; // x^0
+			for (unsigned k = 3; len != 0; len >>= 1, k++)
+			{
+				if (len & 1) power = _tables::_multiply(_table.x2n[k], power);
+			}
+			return power;
+		}
+
+		inline uint32_t _update_table(uint32_t crc, const unsigned char* p, size_t len) noexcept
+		{
+			const auto& t = _table.slice;
+			for (; len >= 8; p += 8, len -= 8)
+			{
+				uint32_t lo, hi;
+				std::memcpy(&lo, p, 4);
+				std::memcpy(&hi, p + 4, 4);
+				lo ^= crc;
+				crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+					^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+			}
+			for (; len > 0; p++, len--) crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xFF];
+			return crc;
+		}
+
+#if defined(NW_CHECKSUM_SSE42)
+		inline uint32_t _update_hw(uint32_t crc, const unsigned char* p, size_t len) noexcept
+		{
+			constexpr size_t lane = 1024; // bytes per stream per round
+			static constexpr uint32_t shift = _shift_bytes(lane);
+
+			for (; len > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0; p++, len--) crc = _mm_crc32_u8(crc, *p);
+
+			for (; len >= 3 * lane; p += 3 * lane, len -= 3 * lane)
+			{
+				uint64_t c0 = crc, c1 = 0, c2 = 0;
+				for (size_t idx = 0; idx < lane; idx += 8)
+				{
+					uint64_t w0, w1, w2;
+					std::memcpy(&w0, p + idx, 8);
+					std::memcpy(&w1, p + lane + idx, 8);
+					std::memcpy(&w2, p + 2 * lane + idx, 8);
+					c0 = _mm_crc32_u64(c0, w0);
+					c1 = _mm_crc32_u64(c1, w1);
+					c2 = _mm_crc32_u64(c2, w2);
+				}
+				// Linear in the register: crc(s, A B) = shift(crc(s, A), |B|) ^ crc(0, B)
+				crc = _tables::_multiply(shift, _tables::_multiply(shift, static_cast<uint32_t>(c0)) ^ static_cast<uint32_t>(c1)) ^ static_cast<uint32_t>(c2);
+			}
+
+			uint64_t c64 = crc;
+			for (; len >= 8; p += 8, len -= 8)
+			{
+				uint64_t word;
+				std::memcpy(&word, p, 8);
+				c64 = _mm_crc32_u64(c64, word);
+			}
+			crc = static_cast<uint32_t>(c64);
+			for (; len > 0; p++, len--) crc = _mm_crc32_u8(crc, *p);
+			return crc;
+		}
+#endif
+
+		/*
+		 * Continues <crc> (the value of the bytes so far, 0 for none) over <len> more bytes.
+		 */
+		[[nodiscard]] inline uint32_t extend(uint32_t crc, const void* data, size_t len) noexcept
+		{
+			const unsigned char* p = static_cast<const unsigned char*>(data);
+#if defined(NW_CHECKSUM_SSE42)
+			return ~_update_hw(~crc, p, len);
+#else
+			return ~_update_table(~crc, p, len);
+#endif
+		}
+
+		[[nodiscard]] inline uint32_t compute(const void* data, size_t len) noexcept
+		{
+			return extend(0, data, len);
+		}
+
+		[[nodiscard]] inline uint32_t compute(std::string_view str) noexcept
+		{
+			return extend(0, str.data(), str.size());
+		}
+
+		/*
+		 * CRC of A followed by B from crc(A), crc(B) and |B|, in O(log |B|).
+		 * Lets independently checksummed chunks (threads, file blocks) be joined.
+		 */
+		[[nodiscard]] inline uint32_t combine(uint32_t crc1, uint32_t crc2, size_t len2) noexcept
+		{
+			return _tables::_multiply(_shift_bytes(len2), crc1) ^ crc2;
+		}
+
+		//-------------------- streaming --------------------//
+
+		class stream
+		{
+		protected:
+
+			uint32_t _crc = 0;
+			uint64_t _size = 0;
+
+		public:
+
+			using value_type = uint32_t;
+
+			stream& reset() noexcept
+			{
+				_crc = 0;
+				_size = 0;
+				return *this;
+			}
+
+			stream& update(const void* data, size_t len) noexcept
+			{
+				_crc = extend(_crc, data, len);
+				_size += len;
+				return *this;
+			}
+
+			stream& update(std::string_view str) noexcept
+			{
+				return this->update(str.data(), str.size());
+			}
+
+			// Appends a stream that covered the bytes right after this one
+			stream& append(const stream& second) noexcept
+			{
+				_crc = combine(_crc, second._crc, static_cast<size_t>(second._size));
+				_size += second._size;
+				return *this;
+			}
+
+			[[nodiscard]] uint32_t value() const noexcept { return _crc; }
+			[[nodiscard]] uint64_t size() const noexcept { return _size; }
+
+		}; // class stream
+
+	} // namespace crc32c
+
+	//-------------------- checksum64 --------------------//
+
+	/*
+	 * Fast 64-bit non-cryptographic checksum: hash64 over the byte stream,
+	 * so chunking does not change the value and checksum64 of a buffer
+	 * equals hash64::hash(buffer, len, seed).
+	 * Catches the same corruption as CRC with far lower collision odds,
+	 * but cannot be combined across independently hashed chunks.
+	 */
+	class checksum64
+	{
+	protected:
+
+		hash64::stream _state;
+		uint64_t _size = 0;
+
+	public:
+
+		using value_type = uint64_t;
+
+		explicit checksum64(uint64_t seed = 0) noexcept
+			: _state(seed) { }
+
+		checksum64& reset(uint64_t seed = 0) noexcept
+		{
+			_state.reset(seed);
+			_size = 0;
+			return *this;
+		}
+
+		checksum64& update(const void* data, size_t len) noexcept
+		{
+			_state.update(data, len);
+			_size += len;
+			return *this;
+		}
+
+		checksum64& update(std::string_view str) noexcept
+		{
+			return this->update(str.data(), str.size());
+		}
+
+		[[nodiscard]] uint64_t value() const noexcept { return _state.digest(); }
+		[[nodiscard]] uint64_t size() const noexcept { return _size; }
+
+		[[nodiscard]] static uint64_t compute(const void* data, size_t len, uint64_t seed = 0) noexcept
+		{
+			return hash64::hash(data, len, seed);
+		}
+
+	}; // class checksum64
+
+} // namespace nw
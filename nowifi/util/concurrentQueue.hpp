@@ -0,0 +1,633 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <climits>
+
+#if defined(__cpp_lib_atomic_wait)
+	// std::atomic::wait / notify
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "Synchronization.lib")
+#endif
+#endif
+
+namespace nw {
+
+	namespace _wait {
+
+		static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+
+		// Sleeps while <word> == <old>; may return spuriously.
+		inline void wait(std::atomic<uint32_t>& word, uint32_t old) noexcept
+		{
+#if defined(__cpp_lib_atomic_wait)
+			word.wait(old, std::memory_order_acquire);
+#elif defined(__linux__)
+			syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, old, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+			WaitOnAddress(reinterpret_cast<volatile VOID*>(&word), &old, sizeof old, INFINITE);
+#else
+			if (word.load(std::memory_order_acquire) == old) std::this_thread::yield();
+#endif
+		}
+
+		inline void notify_one(std::atomic<uint32_t>& word) noexcept
+		{
+#if defined(__cpp_lib_atomic_wait)
+			word.notify_one();
+#elif defined(__linux__)
+			syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+			WakeByAddressSingle(reinterpret_cast<PVOID>(&word));
+#else
+			(void)word;
+#endif
+		}
+
+		inline void notify_all(std::atomic<uint32_t>& word) noexcept
+		{
+#if defined(__cpp_lib_atomic_wait)
+			word.notify_all();
+#elif defined(__linux__)
+			syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+			WakeByAddressAll(reinterpret_cast<PVOID>(&word));
+#else
+			(void)word;
+#endif
+		}
+
+	} // namespace _wait
+
+	////////////////////////////////             ////////////////////////////////
+	//------------------------------             ------------------------------//
+	//------------------------------ event_count ------------------------------//
+	//------------------------------             ------------------------------//
+	////////////////////////////////             ////////////////////////////////
+
+	/*
+	 * Lets threads sleep until some lock-free condition may have changed,
+	 * without a mutex and without a syscall when nobody is sleeping.
+	 *
+	 *   for (;;)
+	 *   {
+	 *       if (ready()) break;
+	 *       const uint32_t key = ec.prepare_wait();
+	 *       if (ready()) { ec.cancel_wait(); break; }
+	 *       ec.wait(key);
+	 *   }
+	 *
+	 * Writers change the state first, then call notify_one()/notify_all().
+	 */
+	class event_count
+	{
+	protected:
+
+		std::atomic<uint32_t> _seq{ 0 };
+		std::atomic<uint32_t> _waiters{ 0 };
+
+	public:
+
+		[[nodiscard]] uint32_t prepare_wait() noexcept
+		{
+			_waiters.fetch_add(1, std::memory_order_seq_cst);
+			return _seq.load(std::memory_order_seq_cst);
+		}
+
+		void cancel_wait() noexcept
+		{
+			_waiters.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		void wait(uint32_t key) noexcept
+		{
+			while (_seq.load(std::memory_order_acquire) == key) _wait::wait(_seq, key);
+			_waiters.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		void notify_one() noexcept
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (_waiters.load(std::memory_order_relaxed) == 0) return;
+			_seq.fetch_add(1, std::memory_order_seq_cst);
+			_wait::notify_one(_seq);
+		}
+
+		void notify_all() noexcept
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (_waiters.load(std::memory_order_relaxed) == 0) return;
+			_seq.fetch_add(1, std::memory_order_seq_cst);
+			_wait::notify_all(_seq);
+		}
+
+	}; // class event_count
+
+	////////////////////////////////            ////////////////////////////////
+	//------------------------------            ------------------------------//
+	//------------------------------ spsc_queue ------------------------------//
+	//------------------------------            ------------------------------//
+	////////////////////////////////            ////////////////////////////////
+
+	/*
+	 * Wait-free single-producer / single-consumer bounded queue.
+	 *
+	 * Head and tail live on separate cache lines, and each side keeps a
+	 * cached copy of the other side's index. The shared line is only read
+	 * when the cached copy says "full" or "empty".
+	 *
+	 * Exactly one thread may push and exactly one thread may pop.
+	 * Ty must be default-constructible (slots are assigned, not constructed).
+	 */
+	template <class Ty>
+	class spsc_queue
+	{
+	public:
+
+		using value_type = Ty;
+
+	protected:
+
+		std::unique_ptr<Ty[]> _data;
+		size_t _mask;
+
+		struct alignas(64) consumer_side
+		{
+			std::atomic<size_t> head{ 0 };
+			size_t tail_cache = 0;
+		} _consumer;
+
+		struct alignas(64) producer_side
+		{
+			std::atomic<size_t> tail{ 0 };
+			size_t head_cache = 0;
+		} _producer;
+
+		// Free slots as seen by the producer, refreshed when fewer than <wanted>
+		[[nodiscard]] size_t _free(size_t tail, size_t wanted) noexcept
+		{
+			size_t free = _mask + 1 - (tail - _producer.head_cache);
+			if (free < wanted)
+			{
+				_producer.head_cache = _consumer.head.load(std::memory_order_acquire);
+				free = _mask + 1 - (tail - _producer.head_cache);
+			}
+			return free;
+		}
+
+		// Filled slots as seen by the consumer, refreshed when fewer than <wanted>
+		[[nodiscard]] size_t _filled(size_t head, size_t wanted) noexcept
+		{
+			size_t filled = _consumer.tail_cache - head;
+			if (filled < wanted)
+			{
+				_consumer.tail_cache = _producer.tail.load(std::memory_order_acquire);
+				filled = _consumer.tail_cache - head;
+			}
+			return filled;
+		}
+
+	public:
+
+		/*
+		 * @param <capacity> - Minimum number of slots, rounded up to a power of two
+		 */
+		explicit spsc_queue(size_t capacity)
+		{
+			size_t count = 2;
+			while (count < capacity) count <<= 1;
+			_data.reset(new Ty[count]());
+			_mask = count - 1;
+		}
+
+		spsc_queue(const spsc_queue&) = delete;
+		spsc_queue& operator=(const spsc_queue&) = delete;
+
+		//-------------------- producer --------------------//
+
+		template <class ValTy>
+		bool try_push(ValTy&& val)
+		{
+			const size_t tail = _producer.tail.load(std::memory_order_relaxed);
+			if (this->_free(tail, 1) == 0) return false;
+			_data[tail & _mask] = std::forward<ValTy>(val);
+			_producer.tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		/*
+		 * Pushes as many of the <size> elements of <arr> as fit,
+		 * publishing them with a single store.
+		 *
+		 * @return Number of elements pushed
+		 */
+		size_t push_n(const Ty* arr, size_t size)
+		{
+			const size_t tail = _producer.tail.load(std::memory_order_relaxed);
+			const size_t count = std::min(size, this->_free(tail, size));
+			for (size_t idx = 0; idx < count; idx++) _data[(tail + idx) & _mask] = arr[idx];
+			if (count != 0) _producer.tail.store(tail + count, std::memory_order_release);
+			return count;
+		}
+
+		//-------------------- consumer --------------------//
+
+		bool try_pop(Ty& out)
+		{
+			const size_t head = _consumer.head.load(std::memory_order_relaxed);
+			if (this->_filled(head, 1) == 0) return false;
+			out = std::move(_data[head & _mask]);
+			_consumer.head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		/*
+		 * Pops up to <size> elements into <arr>, releasing them with a single store.
+		 *
+		 * @return Number of elements popped
+		 */
+		size_t pop_n(Ty* arr, size_t size)
+		{
+			const size_t head = _consumer.head.load(std::memory_order_relaxed);
+			const size_t count = std::min(size, this->_filled(head, size));
+			for (size_t idx = 0; idx < count; idx++) arr[idx] = std::move(_data[(head + idx) & _mask]);
+			if (count != 0) _consumer.head.store(head + count, std::memory_order_release);
+			return count;
+		}
+
+		//-------------------- state --------------------//
+
+		// Exact only when called from the producer or consumer thread.
+
+		[[nodiscard]] size_t size() const noexcept
+		{
+			const size_t head = _consumer.head.load(std::memory_order_acquire);
+			return _producer.tail.load(std::memory_order_acquire) - head;
+		}
+
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return this->size() == 0;
+		}
+
+		[[nodiscard]] bool full() const noexcept
+		{
+			return this->size() > _mask;
+		}
+
+		[[nodiscard]] size_t capacity() const noexcept
+		{
+			return _mask + 1;
+		}
+
+	}; // class spsc_queue
+
+	////////////////////////////////            ////////////////////////////////
+	//------------------------------            ------------------------------//
+	//------------------------------ mpmc_queue ------------------------------//
+	//------------------------------            ------------------------------//
+	////////////////////////////////            ////////////////////////////////
+
+	/*
+	 * Bounded multi-producer / multi-consumer queue (Vyukov).
+	 *
+	 * Every cell carries a sequence number: a producer may fill cell
+	 * pos & mask when its sequence equals pos, and a consumer may empty it
+	 * when its sequence equals pos + 1. Claiming a position is one CAS;
+	 * batches claim a whole run of ready cells with that one CAS.
+	 *
+	 * Lock-free, not wait-free: a stalled producer holds up consumers of
+	 * its cell only.
+	 */
+	template <class Ty>
+	class mpmc_queue
+	{
+	public:
+
+		using value_type = Ty;
+
+	protected:
+
+		struct cell
+		{
+			std::atomic<size_t> seq;
+			Ty data;
+		};
+
+		struct alignas(64) padded_index
+		{
+			std::atomic<size_t> value{ 0 };
+		};
+
+		std::unique_ptr<cell[]> _cells;
+		size_t _mask;
+
+		padded_index _enqueue;
+		padded_index _dequeue;
+
+		// Claims up to <wanted> consecutive cells whose sequence equals pos + <lag>.
+		[[nodiscard]] size_t _claim(padded_index& index, size_t wanted, size_t lag, size_t& pos) noexcept
+		{
+			pos = index.value.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				size_t count = 0;
+				while (count < wanted && _cells[(pos + count) & _mask].seq.load(std::memory_order_acquire) == pos + count + lag) count++;
+
+				if (count != 0)
+				{
+					// On failure <pos> is reloaded and the run is rescanned
+					if (index.value.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) return count;
+					continue;
+				}
+
+				const size_t seq = _cells[pos & _mask].seq.load(std::memory_order_acquire);
+				if (static_cast<intptr_t>(seq - (pos + lag)) < 0) return 0; // full (push) or empty (pop)
+				pos = index.value.load(std::memory_order_relaxed);
+			}
+		}
+
+	public:
+
+		/*
+		 * @param <capacity> - Minimum number of slots, rounded up to a power of two (at least 2)
+		 */
+		explicit mpmc_queue(size_t capacity)
+		{
+			size_t count = 2;
+			while (count < capacity) count <<= 1;
+			_cells.reset(new cell[count]());
+			_mask = count - 1;
+			for (size_t idx = 0; idx < count; idx++) _cells[idx].seq.store(idx, std::memory_order_relaxed);
+		}
+
+		mpmc_queue(const mpmc_queue&) = delete;
+		mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+		//-------------------- producers --------------------//
+
+		template <class ValTy>
+		bool try_push(ValTy&& val)
+		{
+			size_t pos;
+			if (this->_claim(_enqueue, 1, 0, pos) == 0) return false;
+			cell& target = _cells[pos & _mask];
+			target.data = std::forward<ValTy>(val);
+			target.seq.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		/*
+		 * Pushes up to <size> elements of <arr> with one claim.
+		 *
+		 * @return Number of elements pushed (a prefix of <arr>)
+		 */
+		size_t push_n(const Ty* arr, size_t size)
+		{
+			size_t pos;
+			const size_t count = size == 0 ? 0 : this->_claim(_enqueue, size, 0, pos);
+			for (size_t idx = 0; idx < count; idx++)
+			{
+				cell& target = _cells[(pos + idx) & _mask];
+				target.data = arr[idx];
+				target.seq.store(pos + idx + 1, std::memory_order_release);
+			}
+			return count;
+		}
+
+		//-------------------- consumers --------------------//
+
+		bool try_pop(Ty& out)
+		{
+			size_t pos;
+			if (this->_claim(_dequeue, 1, 1, pos) == 0) return false;
+			cell& target = _cells[pos & _mask];
+			out = std::move(target.data);
+			target.seq.store(pos + _mask + 1, std::memory_order_release);
+			return true;
+		}
+
+		/*
+		 * Pops up to <size> elements into <arr> with one claim.
+		 *
+		 * @return Number of elements popped
+		 */
+		size_t pop_n(Ty* arr, size_t size)
+		{
+			size_t pos;
+			const size_t count = size == 0 ? 0 : this->_claim(_dequeue, size, 1, pos);
+			for (size_t idx = 0; idx < count; idx++)
+			{
+				cell& target = _cells[(pos + idx) & _mask];
+				arr[idx] = std::move(target.data);
+				target.seq.store(pos + idx + _mask + 1, std::memory_order_release);
+			}
+			return count;
+		}
+
+		//-------------------- state --------------------//
+
+		// Approximate while other threads are pushing or popping.
+
+		[[nodiscard]] size_t size() const noexcept
+		{
+			const size_t head = _dequeue.value.load(std::memory_order_acquire);
+			const size_t tail = _enqueue.value.load(std::memory_order_acquire);
+			return tail > head ? tail - head : 0;
+		}
+
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return this->size() == 0;
+		}
+
+		[[nodiscard]] bool full() const noexcept
+		{
+			return this->size() > _mask;
+		}
+
+		[[nodiscard]] size_t capacity() const noexcept
+		{
+			return _mask + 1;
+		}
+
+	}; // class mpmc_queue
+
+	////////////////////////////////                ////////////////////////////////
+	//------------------------------                ------------------------------//
+	//------------------------------ blocking_queue ------------------------------//
+	//------------------------------                ------------------------------//
+	////////////////////////////////                ////////////////////////////////
+
+	/*
+	 * Adds sleeping push()/pop() and close() to spsc_queue or mpmc_queue.
+	 *
+	 * Threads sleep on a futex (WaitOnAddress on Windows, atomic::wait when
+	 * C++20 is available). When nobody sleeps, a successful operation costs
+	 * one extra fence and load. try_* calls also wake sleepers, so blocking
+	 * and non-blocking calls can be mixed.
+	 *
+	 *   nw::blocking_spsc_queue<Line> lines(1024);
+	 *   // parser:  lines.push(std::move(line)); ... lines.close();
+	 *   // worker:  Line line; while (lines.pop(line)) process(line);
+	 */
+	template <class QueueTy>
+	class blocking_queue : public QueueTy
+	{
+	public:
+
+		using base_type = QueueTy;
+		using value_type = typename QueueTy::value_type;
+
+	protected:
+
+		event_count _not_empty;
+		event_count _not_full;
+		std::atomic<bool> _closed{ false };
+
+	public:
+
+		using QueueTy::QueueTy;
+
+		//-------------------- non-blocking --------------------//
+
+		template <class ValTy>
+		bool try_push(ValTy&& val)
+		{
+			if (!base_type::try_push(std::forward<ValTy>(val))) return false;
+			_not_empty.notify_one();
+			return true;
+		}
+
+		bool try_pop(value_type& out)
+		{
+			if (!base_type::try_pop(out)) return false;
+			_not_full.notify_one();
+			return true;
+		}
+
+		size_t push_n(const value_type* arr, size_t size)
+		{
+			const size_t count = base_type::push_n(arr, size);
+			if (count != 0) _not_empty.notify_all();
+			return count;
+		}
+
+		size_t pop_n(value_type* arr, size_t size)
+		{
+			const size_t count = base_type::pop_n(arr, size);
+			if (count != 0) _not_full.notify_all();
+			return count;
+		}
+
+		//-------------------- blocking --------------------//
+
+		/*
+		 * Waits for a free slot, then pushes <val>.
+		 *
+		 * @return false if the queue was closed (<val> is not consumed)
+		 */
+		template <class ValTy>
+		bool push(ValTy&& val)
+		{
+			for (;;)
+			{
+				if (_closed.load(std::memory_order_acquire)) return false;
+				if (this->try_push(std::forward<ValTy>(val))) return true;
+				const uint32_t key = _not_full.prepare_wait();
+				if (!base_type::full() || _closed.load(std::memory_order_acquire))
+				{
+					_not_full.cancel_wait();
+					continue;
+				}
+				_not_full.wait(key);
+			}
+		}
+
+		/*
+		 * Waits for an element and pops it into <out>.
+		 *
+		 * @return false once the queue is closed and drained
+		 */
+		bool pop(value_type& out)
+		{
+			for (;;)
+			{
+				if (this->try_pop(out)) return true;
+				const uint32_t key = _not_empty.prepare_wait();
+				if (!base_type::empty())
+				{
+					_not_empty.cancel_wait();
+					continue;
+				}
+				if (_closed.load(std::memory_order_acquire))
+				{
+					_not_empty.cancel_wait();
+					if (this->try_pop(out)) return true;
+					return false;
+				}
+				_not_empty.wait(key);
+			}
+		}
+
+		/*
+		 * Waits until at least one element is available, then pops up to <size>.
+		 *
+		 * @return Number of elements popped; 0 once closed and drained
+		 */
+		size_t pop_n_wait(value_type* arr, size_t size)
+		{
+			for (;;)
+			{
+				const size_t count = this->pop_n(arr, size);
+				if (count != 0 || size == 0) return count;
+				const uint32_t key = _not_empty.prepare_wait();
+				if (!base_type::empty())
+				{
+					_not_empty.cancel_wait();
+					continue;
+				}
+				if (_closed.load(std::memory_order_acquire))
+				{
+					_not_empty.cancel_wait();
+					return this->pop_n(arr, size);
+				}
+				_not_empty.wait(key);
+			}
+		}
+
+		/*
+		 * Rejects further pushes and wakes every sleeper; pop() drains what is left.
+		 */
+		void close() noexcept
+		{
+			_closed.store(true, std::memory_order_release);
+			_not_empty.notify_all();
+			_not_full.notify_all();
+		}
+
+		[[nodiscard]] bool closed() const noexcept
+		{
+			return _closed.load(std::memory_order_acquire);
+		}
+
+	}; // class blocking_queue
+
+	template <class Ty>
+	using blocking_spsc_queue = blocking_queue<spsc_queue<Ty>>;
+
+	template <class Ty>
+	using blocking_mpmc_queue = blocking_queue<mpmc_queue<Ty>>;
+
+} // namespace nw
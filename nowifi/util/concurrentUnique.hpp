@@ -0,0 +1,370 @@
+#pragma once
+
+#include <nowifi/util/unique.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <stdexcept>
+
+namespace nw {
+
+	namespace unique {
+
+		template <class Ty, class _Hasher, class _Keyeq>
+		class local_map;
+
+		////////////////////////////////             ////////////////////////////////
+		//------------------------------             ------------------------------//
+		//------------------------------ sharded_map ------------------------------//
+		//------------------------------             ------------------------------//
+		////////////////////////////////             ////////////////////////////////
+
+		/*
+		 * Thread-safe counting map: keys are split by hash over a power-of-two
+		 * number of shards, each a unique::map behind its own mutex on its own
+		 * cache line.
+		 *
+		 * Direct add()/inc() lock one shard per call. For hot loops use local():
+		 * each thread counts into a private map and merges once per shard at
+		 * the end, which keeps skewed (hot-key) workloads from contending.
+		 *
+		 *   nw::unique::sharded_map<std::string> counts;
+		 *   #pragma omp parallel
+		 *   {
+		 *       auto local = counts.local();
+		 *       #pragma omp for
+		 *       for (int idx = 0; idx < size; idx++) local.inc(tokens[idx]);
+		 *   }
+		 */
+		template <
+			class Ty,
+			class _Hasher = hash64::hasher<Ty>,
+			class _Keyeq = std::equal_to<>
+		>
+		class sharded_map
+		{
+		public:
+
+			using key_type = Ty;
+			using map_type = map<Ty, _Hasher, _Keyeq>;
+			using local_type = local_map<Ty, _Hasher, _Keyeq>;
+
+			friend local_type;
+
+		protected:
+
+			struct alignas(64) shard
+			{
+				std::mutex lock;
+				map_type counts;
+			};
+
+			std::unique_ptr<shard[]> _shards;
+			size_t _mask;
+			_Hasher _hash;
+
+			// Bits 32..47: flat_map takes its home slot from the low bits and its
+			// fingerprint from the top 16, so keys of one shard still differ in both.
+			[[nodiscard]] size_t _shard_index(uint64_t h) const noexcept
+			{
+				return static_cast<size_t>(h >> 32) & _mask;
+			}
+
+			template <class Key>
+			[[nodiscard]] shard& _shard_of(const Key& val) const
+			{
+				return _shards[this->_shard_index(static_cast<uint64_t>(_hash(val)))];
+			}
+
+		public:
+
+			static constexpr size_t max_shards = size_t(1) << 16;
+
+			/*
+			 * @param <shards> - Number of shards, rounded up to a power of two (at most max_shards)
+			 */
+			explicit sharded_map(size_t shards = 64)
+			{
+				size_t count = 1;
+				while (count < shards && count < max_shards) count <<= 1;
+				_shards.reset(new shard[count]);
+				_mask = count - 1;
+			}
+
+			sharded_map(const sharded_map&) = delete;
+			sharded_map& operator=(const sharded_map&) = delete;
+
+			[[nodiscard]] size_t shard_count() const noexcept
+			{
+				return _mask + 1;
+			}
+
+			//-------------------- locked operations --------------------//
+
+			template <class Key>
+			void add(const Key& val, int num)
+			{
+				shard& target = this->_shard_of(val);
+				std::lock_guard<std::mutex> guard(target.lock);
+				target.counts.try_emplace(val, 0).first->second += num;
+			}
+
+			template <class Key>
+			void set(const Key& val, int num)
+			{
+				shard& target = this->_shard_of(val);
+				std::lock_guard<std::mutex> guard(target.lock);
+				target.counts[val] = num;
+			}
+
+			template <class Key>
+			[[nodiscard]] int get(const Key& val) const
+			{
+				shard& target = this->_shard_of(val);
+				std::lock_guard<std::mutex> guard(target.lock);
+				return target.counts.get(val, 0);
+			}
+
+			template <class Key>
+			void inc(const Key& val)
+			{
+				this->add(val, 1);
+			}
+
+			template <class Key>
+			void dec(const Key& val)
+			{
+				this->add(val, -1);
+			}
+
+			/*
+			 * Adds every count of <counts>, locking each shard once.
+			 */
+			template <class _OtherHasher, class _OtherKeyeq, class _OtherAlloc>
+			void merge(const map<Ty, _OtherHasher, _OtherKeyeq, _OtherAlloc>& counts)
+			{
+				std::vector<std::vector<const std::pair<const Ty, int>*>> grouped(this->shard_count());
+				for (const auto& item : counts)
+				{
+					grouped[this->_shard_index(static_cast<uint64_t>(_hash(item.first)))].push_back(&item);
+				}
+				for (size_t idx = 0; idx < grouped.size(); idx++)
+				{
+					if (grouped[idx].empty()) continue;
+					shard& target = _shards[idx];
+					std::lock_guard<std::mutex> guard(target.lock);
+					target.counts.reserve(target.counts.size() + grouped[idx].size());
+					for (const std::pair<const Ty, int>* item : grouped[idx])
+					{
+						target.counts.try_emplace(item->first, 0).first->second += item->second;
+					}
+				}
+			}
+
+			//-------------------- whole-map operations --------------------//
+
+			// Not synchronized with concurrent writers: call after the parallel region.
+
+			[[nodiscard]] size_t size() const
+			{
+				size_t total = 0;
+				for (size_t idx = 0; idx <= _mask; idx++) total += _shards[idx].counts.size();
+				return total;
+			}
+
+			template <class Function>
+			void for_each(Function fn) const
+			{
+				for (size_t idx = 0; idx <= _mask; idx++)
+				{
+					for (const auto& item : _shards[idx].counts) fn(item);
+				}
+			}
+
+			[[nodiscard]] map_type collect() const
+			{
+				map_type result(this->size());
+				this->for_each([&result](const std::pair<const Ty, int>& item)
+				{
+					result.try_emplace(item.first, item.second);
+				});
+				return result;
+			}
+
+			void clear()
+			{
+				for (size_t idx = 0; idx <= _mask; idx++) _shards[idx].counts.clear();
+			}
+
+			//-------------------- thread-local fast path --------------------//
+
+			/*
+			 * Returns a private counter that merges into this map on flush()
+			 * or destruction.
+			 *
+			 * @param <flush_limit> - Merge automatically once the local map
+			 *                        holds this many keys (0 = never)
+			 */
+			[[nodiscard]] local_type local(size_t flush_limit = 0)
+			{
+				return local_type(*this, flush_limit);
+			}
+
+		}; // class sharded_map
+
+		////////////////////////////////           ////////////////////////////////
+		//------------------------------           ------------------------------//
+		//------------------------------ local_map ------------------------------//
+		//------------------------------           ------------------------------//
+		////////////////////////////////           ////////////////////////////////
+
+		template <class Ty, class _Hasher, class _Keyeq>
+		class local_map
+		{
+		public:
+
+			using parent_type = sharded_map<Ty, _Hasher, _Keyeq>;
+			using map_type = typename parent_type::map_type;
+
+		protected:
+
+			parent_type* _parent;
+			map_type _counts;
+			size_t _flush_limit;
+
+		public:
+
+			local_map(parent_type& parent, size_t flush_limit)
+				: _parent(&parent), _flush_limit(flush_limit) { }
+
+			local_map(const local_map&) = delete;
+			local_map& operator=(const local_map&) = delete;
+
+			local_map(local_map&& second) noexcept
+				: _parent(second._parent), _counts(std::move(second._counts)), _flush_limit(second._flush_limit)
+			{
+				second._parent = nullptr;
+			}
+
+			~local_map()
+			{
+				this->flush();
+			}
+
+			template <class Key>
+			void add(const Key& val, int num)
+			{
+				_counts.try_emplace(val, 0).first->second += num;
+				if (_flush_limit != 0 && _counts.size() >= _flush_limit) this->flush();
+			}
+
+			template <class Key>
+			void inc(const Key& val)
+			{
+				this->add(val, 1);
+			}
+
+			template <class Key>
+			void dec(const Key& val)
+			{
+				this->add(val, -1);
+			}
+
+			/*
+			 * Returns the not-yet-merged local count of <val>.
+			 */
+			template <class Key>
+			[[nodiscard]] int get(const Key& val) const
+			{
+				return _counts.get(val, 0);
+			}
+
+			void flush()
+			{
+				if (_parent == nullptr || _counts.empty()) return;
+				_parent->merge(_counts);
+				_counts.clear();
+			}
+
+		}; // class local_map
+
+		//-------------------- unique:: API --------------------//
+
+		template <class Ty, class _Hasher, class _Keyeq, class Key>
+		int get(const sharded_map<Ty, _Hasher, _Keyeq>& unique, const Key& val)
+		{
+			return unique.get(val);
+		}
+
+		template <class Ty, class _Hasher, class _Keyeq, class Key>
+		void set(sharded_map<Ty, _Hasher, _Keyeq>& unique, const Key& val, int num)
+		{
+			unique.set(val, num);
+		}
+
+		template <class Ty, class _Hasher, class _Keyeq, class Key>
+		void add(sharded_map<Ty, _Hasher, _Keyeq>& unique, const Key& val, int num)
+		{
+			unique.add(val, num);
+		}
+
+		template <class Ty, class _Hasher, class _Keyeq, class Key>
+		void inc(sharded_map<Ty, _Hasher, _Keyeq>& unique, const Key& val)
+		{
+			unique.add(val, 1);
+		}
+
+		template <class Ty, class _Hasher, class _Keyeq, class Key>
+		void dec(sharded_map<Ty, _Hasher, _Keyeq>& unique, const Key& val)
+		{
+			unique.add(val, -1);
+		}
+
+		template <class Ty, class _Hasher, class _Keyeq, class Key>
+		void add(local_map<Ty, _Hasher, _Keyeq>& unique, const Key& val, int num)
+		{
+			unique.add(val, num);
+		}
+
+		template <class Ty, class _Hasher, class _Keyeq, class Key>
+		void inc(local_map<Ty, _Hasher, _Keyeq>& unique, const Key& val)
+		{
+			unique.add(val, 1);
+		}
+
+		template <class Ty, class _Hasher, class _Keyeq, class Key>
+		void dec(local_map<Ty, _Hasher, _Keyeq>& unique, const Key& val)
+		{
+			unique.add(val, -1);
+		}
+
+		//-------------------- parallel counting --------------------//
+
+		/*
+		 * Counts every element of <arr> into <unique> using per-thread
+		 * local maps.
+		 *
+		 * @param <unique> - Target map
+		 * @param <arr> - Pointer to array
+		 * @param <size> - Size of array
+		 *
+		 * @exception #pragma omp parallel
+		 */
+		template <class Ty, class _Hasher, class _Keyeq, class Key>
+		void count_parallel(sharded_map<Ty, _Hasher, _Keyeq>& unique, const Key* arr, size_t size)
+		{
+#pragma omp parallel
+			{
+				auto local = unique.local();
+#pragma omp for schedule(static)
+				for (long long idx = 0; idx < static_cast<long long>(size); idx++)
+				{
+					local.add(arr[idx], 1);
+				}
+			}
+		}
+
+	} // namespace unique
+
+} // namespace nw
@@ -1,14 +1,21 @@
 #pragma once
 
 #include <algorithm>
-#include <xutility>
+#include <iterator>
 
 namespace nw {
 
+    /*
+     * Dynamic consumer interface. The bulk overload is virtual too, so
+     * implementations can replace the per-element virtual call with one
+     * static loop per array (see reducer::Dynamic in math/reducer/reduce.hpp).
+     */
     template <class Ty>
     class Consumer
     {
     public:
+        virtual ~Consumer() = default;
+
         virtual void consume(const Ty& value) = 0;
 
         template <class _Iter>
@@ -20,7 +27,7 @@ namespace nw {
             });
         }
 
-        void consume(const Ty* arr, size_t size)
+        virtual void consume(const Ty* arr, size_t size)
         {
             stl_consume(arr, arr + size);
         }
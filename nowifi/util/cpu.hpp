@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NW_CPU_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace nw {
+
+	/*
+	 * Instruction set extensions of the running CPU, for runtime dispatch.
+	 * A vector extension counts only if the OS also saves its registers
+	 * (XGETBV), so AVX is off under kernels or hypervisors that hide it.
+	 */
+	namespace cpu {
+
+		struct features
+		{
+			bool sse2 = false;
+			bool sse41 = false;
+			bool sse42 = false;
+			bool popcnt = false;
+			bool avx = false;
+			bool avx2 = false;
+			bool bmi2 = false;
+			bool avx512f = false;
+			bool avx512bw = false;
+			bool avx512dq = false;
+			bool avx512vl = false;
+		};
+
+#if defined(NW_CPU_X86)
+		inline void _cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) noexcept
+		{
+#if defined(_MSC_VER)
+			int out[4];
+			__cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+			for (int idx = 0; idx < 4; idx++) regs[idx] = static_cast<uint32_t>(out[idx]);
+#else
+			__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+		}
+
+		inline uint64_t _xcr0() noexcept
+		{
+#if defined(_MSC_VER)
+			return _xgetbv(0);
+#else
+			uint32_t eax, edx;
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+		}
+
+		inline features _detect() noexcept
+		{
+			features result;
+			uint32_t regs[4];
+			_cpuid(0, 0, regs);
+			const uint32_t max_leaf = regs[0];
+			if (max_leaf < 1) return result;
+
+			_cpuid(1, 0, regs);
+			result.sse2 = (regs[3] >> 26) & 1;
+			result.sse41 = (regs[2] >> 19) & 1;
+			result.sse42 = (regs[2] >> 20) & 1;
+			result.popcnt = (regs[2] >> 23) & 1;
+
+			const bool osxsave = (regs[2] >> 27) & 1;
+			const bool has_avx = (regs[2] >> 28) & 1;
+			const uint64_t xcr0 = osxsave ? _xcr0() : 0;
+			const bool ymm_saved = (xcr0 & 0x6) == 0x6;    // SSE + AVX state
+			const bool zmm_saved = (xcr0 & 0xE6) == 0xE6;  // + opmask, ZMM hi256, hi16 ZMM
+			result.avx = has_avx && ymm_saved;
+
+			if (max_leaf < 7) return result;
+			_cpuid(7, 0, regs);
+			result.avx2 = result.avx && ((regs[1] >> 5) & 1);
+			result.bmi2 = (regs[1] >> 8) & 1;
+			result.avx512f = zmm_saved && ((regs[1] >> 16) & 1);
+			result.avx512dq = result.avx512f && ((regs[1] >> 17) & 1);
+			result.avx512bw = result.avx512f && ((regs[1] >> 30) & 1);
+			result.avx512vl = result.avx512f && ((regs[1] >> 31) & 1);
+			return result;
+		}
+#else
+		inline features _detect() noexcept
+		{
+			return features();
+		}
+#endif
+
+		// Detected once, on first use
+		[[nodiscard]] inline const features& get() noexcept
+		{
+			static const features detected = _detect();
+			return detected;
+		}
+
+	} // namespace cpu
+
+} // namespace nw
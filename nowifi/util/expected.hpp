@@ -0,0 +1,248 @@
+#pragma once
+
+#include <exception>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+
+namespace nw {
+
+	/*
+	 * Error codes of the non-throwing try_* entry points (from_string,
+	 * Scanner, SafeMath). errc::none is success.
+	 */
+	enum class errc : uint8_t
+	{
+		none,
+		invalid_argument, // not a value of the requested type
+		out_of_range,     // a value, but not representable
+		overflow,
+		underflow,
+		end_of_stream,
+		io_error,         // stream failure other than a bad token, or a stream exception
+		out_of_memory,
+	};
+
+	[[nodiscard]] inline const char* message(errc code) noexcept
+	{
+		switch (code)
+		{
+		case errc::none: return "none";
+		case errc::invalid_argument: return "invalid argument";
+		case errc::out_of_range: return "out of range";
+		case errc::overflow: return "overflow";
+		case errc::underflow: return "underflow";
+		case errc::end_of_stream: return "end of stream";
+		case errc::io_error: return "io error";
+		case errc::out_of_memory: return "out of memory";
+		}
+		return "unknown";
+	}
+
+	//-------------------- unexpected --------------------//
+
+	template <class E>
+	class unexpected
+	{
+	protected:
+
+		E _error;
+
+	public:
+
+		constexpr explicit unexpected(const E& error) noexcept
+			: _error(error) { }
+
+		[[nodiscard]] constexpr const E& error() const noexcept
+		{
+			return _error;
+		}
+
+	}; // class unexpected
+
+	template <class E>
+	class bad_expected_access : public std::exception
+	{
+	protected:
+
+		E _error;
+
+	public:
+
+		explicit bad_expected_access(const E& error) noexcept
+			: _error(error) { }
+
+		const char* what() const noexcept override
+		{
+			return "bad_expected_access";
+		}
+
+		[[nodiscard]] const E& error() const noexcept
+		{
+			return _error;
+		}
+
+	}; // class bad_expected_access
+
+	//-------------------- expected --------------------//
+
+	/*
+	 * A value of <Ty> or an error of <E>: the C++17 subset of std::expected
+	 * the try_* functions need. Checking has_value() and reading the value
+	 * or error never throws; only value() on an error does.
+	 *
+	 *   auto parsed = from_string::try_toInt(token);
+	 *   if (!parsed) skipped[message(parsed.error())]++;
+	 *   else total += *parsed;
+	 */
+	template <class Ty, class E = errc>
+	class expected
+	{
+	public:
+
+		using value_type = Ty;
+		using error_type = E;
+
+	protected:
+
+		union
+		{
+			Ty _value;
+			E _error;
+		};
+		bool _has;
+
+		void _destroy() noexcept
+		{
+			if (_has) _value.~Ty();
+			else _error.~E();
+		}
+
+		template <class Other>
+		void _construct(Other&& other)
+		{
+			if (other._has) new (&_value) Ty(std::forward<Other>(other)._value);
+			else new (&_error) E(std::forward<Other>(other)._error);
+			_has = other._has;
+		}
+
+	public:
+
+		expected() noexcept(std::is_nothrow_default_constructible<Ty>::value)
+			: _value(), _has(true) { }
+
+		expected(const Ty& value) noexcept(std::is_nothrow_copy_constructible<Ty>::value)
+			: _value(value), _has(true) { }
+
+		expected(Ty&& value) noexcept(std::is_nothrow_move_constructible<Ty>::value)
+			: _value(std::move(value)), _has(true) { }
+
+		expected(const unexpected<E>& error) noexcept
+			: _error(error.error()), _has(false) { }
+
+		expected(const expected& second) noexcept(std::is_nothrow_copy_constructible<Ty>::value)
+		{
+			this->_construct(second);
+		}
+
+		expected(expected&& second) noexcept(std::is_nothrow_move_constructible<Ty>::value)
+		{
+			this->_construct(std::move(second));
+		}
+
+		expected& operator=(const expected& second) noexcept(std::is_nothrow_copy_constructible<Ty>::value)
+		{
+			if (this != &second)
+			{
+				this->_destroy();
+				this->_construct(second);
+			}
+			return *this;
+		}
+
+		expected& operator=(expected&& second) noexcept(std::is_nothrow_move_constructible<Ty>::value)
+		{
+			if (this != &second)
+			{
+				this->_destroy();
+				this->_construct(std::move(second));
+			}
+			return *this;
+		}
+
+		~expected()
+		{
+			this->_destroy();
+		}
+
+		//-------------------- state --------------------//
+
+		[[nodiscard]] bool has_value() const noexcept
+		{
+			return _has;
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return _has;
+		}
+
+		// Undefined if !has_value()
+		[[nodiscard]] const E& error() const noexcept
+		{
+			return _error;
+		}
+
+		//-------------------- value --------------------//
+
+		// Undefined if !has_value()
+		[[nodiscard]] Ty& operator*() & noexcept
+		{
+			return _value;
+		}
+
+		[[nodiscard]] const Ty& operator*() const& noexcept
+		{
+			return _value;
+		}
+
+		[[nodiscard]] Ty&& operator*() && noexcept
+		{
+			return std::move(_value);
+		}
+
+		Ty* operator->() noexcept
+		{
+			return &_value;
+		}
+
+		const Ty* operator->() const noexcept
+		{
+			return &_value;
+		}
+
+		/*
+		 * @exception bad_expected_access<E> if !has_value()
+		 */
+		[[nodiscard]] const Ty& value() const&
+		{
+			if (!_has) throw bad_expected_access<E>(_error);
+			return _value;
+		}
+
+		[[nodiscard]] Ty&& value() &&
+		{
+			if (!_has) throw bad_expected_access<E>(_error);
+			return std::move(_value);
+		}
+
+		template <class Other>
+		[[nodiscard]] Ty value_or(Other&& fallback) const&
+		{
+			return _has ? _value : static_cast<Ty>(std::forward<Other>(fallback));
+		}
+
+	}; // class expected
+
+} // namespace nw
@@ -0,0 +1,670 @@
+#pragma once
+
+#include <nowifi/util/hash.hpp>
+#include <nowifi/io/writer.hpp>
+#include <nowifi/io/scanner.hpp>
+
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(NW_HASH_NO_SIMD) && defined(__AVX2__)
+#define NW_FILTER_AVX2
+#endif
+
+namespace nw {
+
+	namespace filter {
+
+		// Bytes read per step when a stored count is not yet backed by data
+		constexpr size_t read_batch_bytes = size_t(4) << 20;
+
+		/*
+		 * Reads <count> elements into <out>, growing it only as the data
+		 * arrives: a corrupt count can not force a huge allocation.
+		 *
+		 * @return Whether all <count> elements were read
+		 */
+		template <class Ty>
+		bool _read_bounded(std::vector<Ty>& out, uint64_t count, std::istream& in, const Scanner::Error_type& err)
+		{
+			const size_t batch = std::max<size_t>(read_batch_bytes / sizeof(Ty), 1);
+			out.clear();
+			while (out.size() < count)
+			{
+				const size_t first = out.size();
+				const size_t step = static_cast<size_t>(std::min<uint64_t>(count - first, batch));
+				out.resize(first + step);
+				Scanner_readBinaryArray(out.data() + first, step, in, err);
+				if (in.fail()) return false;
+			}
+			return true;
+		}
+
+	} // namespace filter
+
+	////////////////////////////////             ////////////////////////////////
+	//------------------------------             ------------------------------//
+	//------------------------------ BloomFilter ------------------------------//
+	//------------------------------             ------------------------------//
+	////////////////////////////////             ////////////////////////////////
+
+	/*
+	 * Cache-line blocked Bloom filter (split-block layout).
+	 *
+	 * The high half of the key hash picks one 64-byte block; the low half
+	 * sets exactly one bit in each of the block's eight 64-bit words.
+	 * A query therefore touches a single cache line, and with AVX2 the
+	 * whole probe is two mask builds and two vptest.
+	 *
+	 * add_hash()/contains_hash() take a precomputed hash64 value so one
+	 * hash can serve several filters, sketches and maps.
+	 */
+	template <class Ty, class _Hasher = hash64::hasher<Ty>>
+	class BloomFilter
+	{
+	public:
+
+		using key_type = Ty;
+
+		static constexpr size_t words_per_block = 8;
+		static constexpr size_t block_bits = words_per_block * 64;
+		static constexpr uint32_t magic = 0x4642574e; // "NWBF"
+
+	protected:
+
+		struct alignas(64) block
+		{
+			uint64_t words[words_per_block];
+		};
+
+		static constexpr uint32_t _salt[words_per_block] = {
+			0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+			0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+		};
+
+		std::vector<block> _blocks;
+		_Hasher _hash;
+
+		[[nodiscard]] size_t _block_of(uint64_t h) const noexcept
+		{
+			// Multiply-shift range reduction instead of a modulo
+			return static_cast<size_t>(((h >> 32) * static_cast<uint64_t>(_blocks.size())) >> 32);
+		}
+
+		static void _mask(uint64_t h, uint64_t (&mask)[words_per_block]) noexcept
+		{
+			const uint32_t low = static_cast<uint32_t>(h);
+			for (size_t idx = 0; idx < words_per_block; idx++)
+			{
+				mask[idx] = uint64_t(1) << ((low * _salt[idx]) >> 26);
+			}
+		}
+
+#if defined(NW_FILTER_AVX2)
+		static void _mask_simd(uint64_t h, __m256i& lo, __m256i& hi) noexcept
+		{
+			const __m256i salt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_salt));
+			const __m256i pos = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(h))), salt), 26);
+			const __m256i ones = _mm256_set1_epi64x(1);
+			lo = _mm256_sllv_epi64(ones, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(pos)));
+			hi = _mm256_sllv_epi64(ones, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(pos, 1)));
+		}
+#endif
+
+		static void _atomic_or(uint64_t* word, uint64_t bits) noexcept
+		{
+#if defined(_MSC_VER)
+			_InterlockedOr64(reinterpret_cast<volatile long long*>(word), static_cast<long long>(bits));
+#else
+			__atomic_fetch_or(word, bits, __ATOMIC_RELAXED);
+#endif
+		}
+
+		// False-positive rate at <lambda> keys per block on average
+		[[nodiscard]] static double _model(double lambda)
+		{
+			double result = 0.0, poisson = std::exp(-lambda);
+			for (size_t load = 0; load < 4 * static_cast<size_t>(lambda) + 32; load++)
+			{
+				result += poisson * std::pow(1.0 - std::pow(1.0 - 1.0 / 64.0, static_cast<double>(load)), static_cast<double>(words_per_block));
+				poisson *= lambda / static_cast<double>(load + 1);
+			}
+			return result;
+		}
+
+	public:
+
+		//-------------------- CONSTRUCTOR --------------------//
+
+		/*
+		 * @param <blocks> - Number of 64-byte blocks (at least 1)
+		 */
+		explicit BloomFilter(size_t blocks = 1)
+			: _blocks(std::max<size_t>(blocks, 1), block{}) { }
+
+		/*
+		 * Sizes the filter for <expected_items> keys at false-positive rate <fpr>.
+		 *
+		 * Starts from the classic m = -n ln p / ln^2 2 bit count and grows it
+		 * until the blocked model (see fpr()) meets the target.
+		 *
+		 * @exception std::invalid_argument - fpr outside (0, 1)
+		 */
+		[[nodiscard]] static BloomFilter from_error(size_t expected_items, double fpr)
+		{
+			if (!(fpr > 0.0 && fpr < 1.0)) throw std::invalid_argument("BloomFilter: fpr must be in (0, 1)");
+			const double ln2 = 0.6931471805599453;
+			const double items = static_cast<double>(std::max<size_t>(expected_items, 1));
+			size_t blocks = static_cast<size_t>(std::ceil(items * -std::log(fpr) / (ln2 * ln2) / block_bits));
+			while (_model(items / static_cast<double>(std::max<size_t>(blocks, 1))) > fpr) blocks += blocks / 32 + 1;
+			return BloomFilter(blocks);
+		}
+
+		//-------------------- single key --------------------//
+
+		void add_hash(uint64_t h) noexcept
+		{
+			block& target = _blocks[this->_block_of(h)];
+#if defined(NW_FILTER_AVX2)
+			__m256i lo, hi;
+			_mask_simd(h, lo, hi);
+			__m256i* words = reinterpret_cast<__m256i*>(target.words);
+			_mm256_store_si256(words, _mm256_or_si256(_mm256_load_si256(words), lo));
+			_mm256_store_si256(words + 1, _mm256_or_si256(_mm256_load_si256(words + 1), hi));
+#else
+			uint64_t mask[words_per_block];
+			_mask(h, mask);
+			for (size_t idx = 0; idx < words_per_block; idx++) target.words[idx] |= mask[idx];
+#endif
+		}
+
+		[[nodiscard]] bool contains_hash(uint64_t h) const noexcept
+		{
+			const block& target = _blocks[this->_block_of(h)];
+#if defined(NW_FILTER_AVX2)
+			__m256i lo, hi;
+			_mask_simd(h, lo, hi);
+			const __m256i* words = reinterpret_cast<const __m256i*>(target.words);
+			return _mm256_testc_si256(_mm256_load_si256(words), lo) & _mm256_testc_si256(_mm256_load_si256(words + 1), hi);
+#else
+			uint64_t mask[words_per_block];
+			_mask(h, mask);
+			uint64_t missing = 0;
+			for (size_t idx = 0; idx < words_per_block; idx++) missing |= mask[idx] & ~target.words[idx];
+			return missing == 0;
+#endif
+		}
+
+		template <class Key>
+		void add(const Key& val)
+		{
+			this->add_hash(static_cast<uint64_t>(_hash(val)));
+		}
+
+		template <class Key>
+		[[nodiscard]] bool contains(const Key& val) const
+		{
+			return this->contains_hash(static_cast<uint64_t>(_hash(val)));
+		}
+
+		//-------------------- bulk --------------------//
+
+		/*
+		 * Adds every element of <arr>.
+		 *
+		 * @param <arr> - Pointer to array
+		 * @param <size> - Size of array
+		 * @param <parallel> - Build with all threads (bits are set with atomic OR)
+		 *
+		 * @exception #pragma omp parallel for
+		 */
+		template <class Key>
+		void insert(const Key* arr, size_t size, bool parallel = false)
+		{
+			if (!parallel)
+			{
+				for (size_t idx = 0; idx < size; idx++) this->add(arr[idx]);
+				return;
+			}
+
+#pragma omp parallel for schedule(static)
+			for (long long idx = 0; idx < static_cast<long long>(size); idx++)
+			{
+				const uint64_t h = static_cast<uint64_t>(_hash(arr[idx]));
+				uint64_t mask[words_per_block];
+				_mask(h, mask);
+				block& target = _blocks[this->_block_of(h)];
+				for (size_t w = 0; w < words_per_block; w++) _atomic_or(&target.words[w], mask[w]);
+			}
+		}
+
+		/*
+		 * Tests every element of <arr>, writing the answers to <result>.
+		 *
+		 * @param <arr> - Pointer to array
+		 * @param <size> - Size of array
+		 * @param <result> - Pointer to <size> bools
+		 *
+		 * @return Number of elements that may be present
+		 *
+		 * @exception #pragma omp parallel for
+		 */
+		template <class Key>
+		size_t query(const Key* arr, size_t size, bool* result) const
+		{
+			long long found = 0;
+#pragma omp parallel for schedule(static) reduction(+:found)
+			for (long long idx = 0; idx < static_cast<long long>(size); idx++)
+			{
+				result[idx] = this->contains(arr[idx]);
+				found += result[idx];
+			}
+			return static_cast<size_t>(found);
+		}
+
+		//-------------------- state --------------------//
+
+		[[nodiscard]] size_t block_count() const noexcept
+		{
+			return _blocks.size();
+		}
+
+		[[nodiscard]] size_t memory() const noexcept
+		{
+			return _blocks.size() * sizeof(block);
+		}
+
+		/*
+		 * Expected false-positive rate after <items> distinct insertions
+		 * (Poisson mixture over block loads).
+		 */
+		[[nodiscard]] double fpr(size_t items) const
+		{
+			return _model(static_cast<double>(items) / static_cast<double>(_blocks.size()));
+		}
+
+		/*
+		 * Union with a filter of the same geometry.
+		 *
+		 * @exception std::invalid_argument - Different block counts
+		 */
+		void merge(const BloomFilter& second)
+		{
+			if (second._blocks.size() != _blocks.size()) throw std::invalid_argument("BloomFilter: geometry mismatch");
+			for (size_t idx = 0; idx < _blocks.size(); idx++)
+			{
+				for (size_t w = 0; w < words_per_block; w++) _blocks[idx].words[w] |= second._blocks[idx].words[w];
+			}
+		}
+
+		void reset() noexcept
+		{
+			std::fill(_blocks.begin(), _blocks.end(), block{});
+		}
+
+		//-------------------- binary I/O --------------------//
+
+		std::ostream& writeBinary(std::ostream& os, const Writer::Error_type& err = global::Error_Throw<std::string>) const
+		{
+			Writer_writeBinary(magic, os, err);
+			Writer_writeBinary(static_cast<uint64_t>(_blocks.size()), os, err);
+			return Writer_writeBinaryArray(_blocks.data(), _blocks.size(), os, err);
+		}
+
+		std::istream& readBinary(std::istream& in, const Scanner::Error_type& err = global::Error_Throw<std::string>)
+		{
+			uint32_t header = 0;
+			uint64_t blocks = 0;
+			Scanner_readBinary(header, in, err);
+			Scanner_readBinary(blocks, in, err);
+			if (header != magic || blocks == 0)
+			{
+				err.execute("BloomFilter: bad header");
+				return in;
+			}
+			// The filter is replaced only once every block has been read
+			std::vector<block> loaded;
+			if (filter::_read_bounded(loaded, blocks, in, err)) _blocks.swap(loaded);
+			return in;
+		}
+
+	}; // class BloomFilter
+
+	////////////////////////////////              ////////////////////////////////
+	//------------------------------              ------------------------------//
+	//------------------------------ CuckooFilter ------------------------------//
+	//------------------------------              ------------------------------//
+	////////////////////////////////              ////////////////////////////////
+
+	/*
+	 * Cuckoo filter (Fan et al.): 4-way buckets of <Fingerprint> tags,
+	 * partial-key cuckoo hashing, deletion supported.
+	 *
+	 * False-positive rate is about 8 / 2^bits(Fingerprint) at 95% load:
+	 * uint8_t ~3%, uint16_t ~0.012%, uint32_t ~2e-9.
+	 *
+	 * Only remove() keys that were added; removing a never-added key can
+	 * evict another key's fingerprint.
+	 */
+	template <class Ty, class Fingerprint = uint16_t, class _Hasher = hash64::hasher<Ty>>
+	class CuckooFilter
+	{
+	public:
+
+		static_assert(std::is_unsigned<Fingerprint>::value && sizeof(Fingerprint) <= 4, "CuckooFilter: Fingerprint must be uint8_t, uint16_t or uint32_t");
+
+		using key_type = Ty;
+		using fingerprint_type = Fingerprint;
+
+		static constexpr size_t bucket_size = 4;
+		static constexpr size_t max_kicks = 500;
+		static constexpr uint32_t magic = 0x4643574e; // "NWCF"
+
+	protected:
+
+		struct bucket
+		{
+			Fingerprint tags[bucket_size];
+		};
+
+		std::vector<bucket> _buckets;
+		size_t _mask;
+		size_t _size = 0;
+		uint64_t _kick_state = 0x9e3779b97f4a7c15ull;
+
+		// Fingerprint that could not be placed after max_kicks; the filter is full.
+		Fingerprint _victim = 0;
+		size_t _victim_index = 0;
+
+		_Hasher _hash;
+
+		[[nodiscard]] static Fingerprint _tag(uint64_t h) noexcept
+		{
+			const Fingerprint tag = static_cast<Fingerprint>(h >> (64 - 8 * sizeof(Fingerprint)));
+			return tag == 0 ? Fingerprint(1) : tag; // 0 marks an empty slot
+		}
+
+		[[nodiscard]] size_t _alt(size_t index, Fingerprint tag) const noexcept
+		{
+			return (index ^ static_cast<size_t>(hash64::hash_int(tag))) & _mask;
+		}
+
+		[[nodiscard]] static bool _has(const bucket& target, Fingerprint tag) noexcept
+		{
+			if constexpr (sizeof(Fingerprint) * bucket_size == 8)
+			{
+				// SWAR: all four 16-bit tags in one register
+				uint64_t word;
+				std::memcpy(&word, target.tags, sizeof word);
+				const uint64_t diff = word ^ (0x0001000100010001ull * tag);
+				return ((diff - 0x0001000100010001ull) & ~diff & 0x8000800080008000ull) != 0;
+			}
+			else
+			{
+				bool found = false;
+				for (size_t slot = 0; slot < bucket_size; slot++) found |= target.tags[slot] == tag;
+				return found;
+			}
+		}
+
+		[[nodiscard]] static bool _put(bucket& target, Fingerprint tag) noexcept
+		{
+			for (size_t slot = 0; slot < bucket_size; slot++)
+			{
+				if (target.tags[slot] == 0)
+				{
+					target.tags[slot] = tag;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		[[nodiscard]] static bool _take(bucket& target, Fingerprint tag) noexcept
+		{
+			for (size_t slot = 0; slot < bucket_size; slot++)
+			{
+				if (target.tags[slot] == tag)
+				{
+					target.tags[slot] = 0;
+					return true;
+				}
+			}
+			return false;
+		}
+
+	public:
+
+		//-------------------- CONSTRUCTOR --------------------//
+
+		/*
+		 * @param <expected_items> - Capacity target; buckets are sized for 95% load
+		 * @param <fpr> - Required false-positive rate (0 = don't check)
+		 *
+		 * @exception std::invalid_argument - <fpr> unreachable with this Fingerprint width
+		 */
+		explicit CuckooFilter(size_t expected_items = 1, double fpr = 0.0)
+		{
+			if (fpr != 0.0 && 2.0 * bucket_size / std::ldexp(1.0, 8 * sizeof(Fingerprint)) > fpr)
+			{
+				throw std::invalid_argument("CuckooFilter: fpr needs a wider Fingerprint");
+			}
+			const size_t wanted = static_cast<size_t>(std::ceil(static_cast<double>(std::max<size_t>(expected_items, 1)) / (0.95 * bucket_size)));
+			size_t count = 1;
+			while (count < wanted) count <<= 1;
+			_buckets.assign(count, bucket{});
+			_mask = count - 1;
+		}
+
+		//-------------------- single key --------------------//
+
+		/*
+		 * @return false if the filter is full (the key is still reported present)
+		 */
+		bool add_hash(uint64_t h)
+		{
+			if (_victim != 0) return false;
+
+			Fingerprint tag = _tag(h);
+			size_t index = static_cast<size_t>(h) & _mask;
+			if (_put(_buckets[index], tag) || _put(_buckets[index = this->_alt(index, tag)], tag))
+			{
+				_size++;
+				return true;
+			}
+
+			for (size_t kick = 0; kick < max_kicks; kick++)
+			{
+				_kick_state ^= _kick_state << 13;
+				_kick_state ^= _kick_state >> 7;
+				_kick_state ^= _kick_state << 17;
+				std::swap(tag, _buckets[index].tags[_kick_state % bucket_size]);
+				index = this->_alt(index, tag);
+				if (_put(_buckets[index], tag))
+				{
+					_size++;
+					return true;
+				}
+			}
+
+			_victim = tag;
+			_victim_index = index;
+			_size++;
+			return false;
+		}
+
+		[[nodiscard]] bool contains_hash(uint64_t h) const noexcept
+		{
+			const Fingerprint tag = _tag(h);
+			const size_t first = static_cast<size_t>(h) & _mask;
+			const size_t second = this->_alt(first, tag);
+			return _has(_buckets[first], tag) | _has(_buckets[second], tag)
+				| (_victim == tag && (_victim_index == first || _victim_index == second));
+		}
+
+		bool remove_hash(uint64_t h) noexcept
+		{
+			const Fingerprint tag = _tag(h);
+			const size_t first = static_cast<size_t>(h) & _mask;
+			const size_t second = this->_alt(first, tag);
+			if (_victim == tag && (_victim_index == first || _victim_index == second))
+			{
+				_victim = 0;
+				_size--;
+				return true;
+			}
+			if (!_take(_buckets[first], tag) && !_take(_buckets[second], tag)) return false;
+			_size--;
+
+			// A slot opened up: give the victim another chance.
+			if (_victim != 0)
+			{
+				const Fingerprint pending = _victim;
+				_victim = 0;
+				if (!_put(_buckets[_victim_index], pending) && !_put(_buckets[this->_alt(_victim_index, pending)], pending))
+				{
+					_victim = pending;
+				}
+			}
+			return true;
+		}
+
+		template <class Key>
+		bool add(const Key& val)
+		{
+			return this->add_hash(static_cast<uint64_t>(_hash(val)));
+		}
+
+		template <class Key>
+		[[nodiscard]] bool contains(const Key& val) const
+		{
+			return this->contains_hash(static_cast<uint64_t>(_hash(val)));
+		}
+
+		template <class Key>
+		bool remove(const Key& val)
+		{
+			return this->remove_hash(static_cast<uint64_t>(_hash(val)));
+		}
+
+		//-------------------- bulk --------------------//
+
+		/*
+		 * Adds every element of <arr> (sequential: cuckoo kicks are not thread-safe).
+		 *
+		 * @return Number of elements added before the filter filled up. The
+		 *         element that fills it is kept as the victim and counted.
+		 */
+		template <class Key>
+		size_t insert(const Key* arr, size_t size)
+		{
+			for (size_t idx = 0; idx < size; idx++)
+			{
+				if (this->full()) return idx;
+				if (!this->add(arr[idx])) return idx + 1;
+			}
+			return size;
+		}
+
+		/*
+		 * Tests every element of <arr>, writing the answers to <result>.
+		 *
+		 * @return Number of elements that may be present
+		 *
+		 * @exception #pragma omp parallel for
+		 */
+		template <class Key>
+		size_t query(const Key* arr, size_t size, bool* result) const
+		{
+			long long found = 0;
+#pragma omp parallel for schedule(static) reduction(+:found)
+			for (long long idx = 0; idx < static_cast<long long>(size); idx++)
+			{
+				result[idx] = this->contains(arr[idx]);
+				found += result[idx];
+			}
+			return static_cast<size_t>(found);
+		}
+
+		//-------------------- state --------------------//
+
+		[[nodiscard]] size_t size() const noexcept
+		{
+			return _size;
+		}
+
+		[[nodiscard]] size_t capacity() const noexcept
+		{
+			return _buckets.size() * bucket_size;
+		}
+
+		[[nodiscard]] double load_factor() const noexcept
+		{
+			return static_cast<double>(_size) / static_cast<double>(this->capacity());
+		}
+
+		[[nodiscard]] bool full() const noexcept
+		{
+			return _victim != 0;
+		}
+
+		[[nodiscard]] size_t memory() const noexcept
+		{
+			return _buckets.size() * sizeof(bucket);
+		}
+
+		void reset() noexcept
+		{
+			std::fill(_buckets.begin(), _buckets.end(), bucket{});
+			_size = 0;
+			_victim = 0;
+		}
+
+		//-------------------- binary I/O --------------------//
+
+		std::ostream& writeBinary(std::ostream& os, const Writer::Error_type& err = global::Error_Throw<std::string>) const
+		{
+			Writer_writeBinary(magic, os, err);
+			Writer_writeBinary(static_cast<uint32_t>(sizeof(Fingerprint)), os, err);
+			Writer_writeBinary(static_cast<uint64_t>(_buckets.size()), os, err);
+			Writer_writeBinary(static_cast<uint64_t>(_size), os, err);
+			Writer_writeBinary(static_cast<uint64_t>(_victim_index), os, err);
+			Writer_writeBinary(_victim, os, err);
+			return Writer_writeBinaryArray(_buckets.data(), _buckets.size(), os, err);
+		}
+
+		std::istream& readBinary(std::istream& in, const Scanner::Error_type& err = global::Error_Throw<std::string>)
+		{
+			uint32_t header = 0, width = 0;
+			uint64_t buckets = 0, size = 0, victim_index = 0;
+			Scanner_readBinary(header, in, err);
+			Scanner_readBinary(width, in, err);
+			Scanner_readBinary(buckets, in, err);
+			if (header != magic || width != sizeof(Fingerprint) || buckets == 0 || (buckets & (buckets - 1)) != 0)
+			{
+				err.execute("CuckooFilter: bad header");
+				return in;
+			}
+			Fingerprint victim = 0;
+			Scanner_readBinary(size, in, err);
+			Scanner_readBinary(victim_index, in, err);
+			Scanner_readBinary(victim, in, err);
+			// The filter is replaced only once every bucket has been read
+			std::vector<bucket> loaded;
+			if (in.fail() || !filter::_read_bounded(loaded, buckets, in, err)) return in;
+			_buckets.swap(loaded);
+			_mask = _buckets.size() - 1;
+			_size = static_cast<size_t>(size);
+			_victim = victim;
+			_victim_index = static_cast<size_t>(victim_index) & _mask;
+			return in;
+		}
+
+	}; // class CuckooFilter
+
+} // namespace nw
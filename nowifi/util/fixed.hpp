@@ -1,8 +1,11 @@
 #pragma once
 
 #include <nowifi/compiler/class.hpp>
+#include <nowifi/util/ringBuffer.hpp>
+
 #include <deque>
 #include <stack>
+#include <utility>
 
 namespace nw {
 
@@ -55,6 +58,34 @@ namespace nw {
 				fixed.push_front(std::move(val));
 				fixsize_back(fixed, size);
 			}
+
+			//-------------------- ring_buffer --------------------//
+
+			// Capacity is the buffer's own; nothing is allocated or freed.
+
+			template <class Ty, size_t N, class ValTy>
+			void push_back(ring_buffer<Ty, N>& fixed, ValTy&& val)
+			{
+				fixed.push_back(std::forward<ValTy>(val));
+			}
+
+			template <class Ty, size_t N, class ValTy>
+			void push_front(ring_buffer<Ty, N>& fixed, ValTy&& val)
+			{
+				fixed.push_front(std::forward<ValTy>(val));
+			}
+
+			template <class Ty, size_t N>
+			void fixsize_back(ring_buffer<Ty, N>& fixed, size_t size)
+			{
+				if (fixed.size() > size) fixed.drop_back(fixed.size() - size);
+			}
+
+			template <class Ty, size_t N>
+			void fixsize_front(ring_buffer<Ty, N>& fixed, size_t size)
+			{
+				if (fixed.size() > size) fixed.drop_front(fixed.size() - size);
+			}
 		
 		} // namespace deque
 	
@@ -82,6 +113,40 @@ namespace nw {
 				fixed.push(std::move(val));
 				fixsize(fixed, size);
 			}
+
+			//-------------------- ring_buffer --------------------//
+
+			// Top is back(). As with std::stack, pushing onto a full buffer drops
+			// the pushed element; push_evict() drops the bottom element instead.
+
+			template <class Ty, size_t N, class ValTy>
+			void push(ring_buffer<Ty, N>& fixed, ValTy&& val)
+			{
+				if (!fixed.full()) fixed.push_back(std::forward<ValTy>(val));
+			}
+
+			/*
+			 * Pushes <val>, evicting the bottom (oldest) element when full.
+			 *
+			 * @return true if an element was evicted
+			 */
+			template <class Ty, size_t N, class ValTy>
+			bool push_evict(ring_buffer<Ty, N>& fixed, ValTy&& val)
+			{
+				return fixed.push_back(std::forward<ValTy>(val));
+			}
+
+			template <class Ty, size_t N>
+			Ty pop(ring_buffer<Ty, N>& fixed)
+			{
+				return fixed.pop_back();
+			}
+
+			template <class Ty, size_t N>
+			void fixsize(ring_buffer<Ty, N>& fixed, size_t size)
+			{
+				if (fixed.size() > size) fixed.drop_back(fixed.size() - size);
+			}
 		
 		}
 	
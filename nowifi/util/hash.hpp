@@ -1,18 +1,549 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <functional>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if !defined(NW_HASH_NO_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NW_HASH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NW_HASH_SSE2
+#endif
+#endif
 
 namespace nw {
 
+    // Legacy 32-bit djb2 (right-to-left), kept for existing switch tables.
+    // Iterative, so long strings no longer consume one stack frame per char.
+    unsigned inline _CONSTEXPR17 Hash(std::string_view str) {
+        unsigned result = 5381;
+        for (size_t idx = str.size(); idx-- > 0;)
+        {
+            result = static_cast<unsigned int>(str[idx]) + 33 * result;
+        }
+        return result;
+    }
+
     unsigned inline _CONSTEXPR17 Hash(char const* input) {
-        return *input ? /*!= '\0'*/
-            static_cast<unsigned int>(*input) + 33 * Hash(input + 1) :
-            5381;
+        return Hash(std::string_view(input));
     }
 
     unsigned inline Hash(const std::string& str) {
-        return Hash(str.c_str());
+        return Hash(std::string_view(str));
     }
 
-} // namespace nw
\ No newline at end of file
+    /*
+     * 64-bit hash family.
+     *
+     * Inputs up to <short_limit> bytes use a wyhash-style 128-bit multiply mix;
+     * longer inputs use 8 independent 64-bit lanes over 64-byte stripes
+     * (SSE2/AVX2 when available), scrambled every <stripes_per_block> stripes.
+     *
+     * hash_constexpr(), hash() and stream produce identical values for the same
+     * bytes and seed, so keys computed at compile time match runtime lookups.
+     * Multi-byte reads are little-endian.
+     */
+    namespace hash64 {
+
+        constexpr size_t short_limit = 256;
+        constexpr size_t stripe_size = 64;
+        constexpr size_t stripes_per_block = 16;
+
+        constexpr uint64_t _p0 = 0xa0761d6478bd642full;
+        constexpr uint64_t _p1 = 0xe7037ed1a0b428dbull;
+        constexpr uint64_t _p2 = 0x8ebc6af09c88c6e3ull;
+        constexpr uint64_t _p3 = 0x589965cc75374cc3ull;
+        constexpr uint32_t _prime32 = 0x9E3779B1u;
+
+        //-------------------- 128-bit multiply --------------------//
+
+        constexpr inline void _mum(uint64_t& a, uint64_t& b) noexcept
+        {
+            const uint64_t a_lo = a & 0xffffffffull, a_hi = a >> 32;
+            const uint64_t b_lo = b & 0xffffffffull, b_hi = b >> 32;
+            const uint64_t lo_lo = a_lo * b_lo;
+            const uint64_t hi_lo = a_hi * b_lo;
+            const uint64_t lo_hi = a_lo * b_hi;
+            const uint64_t hi_hi = a_hi * b_hi;
+            const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffull) + lo_hi;
+            a = (cross << 32) | (lo_lo & 0xffffffffull);
+            b = hi_hi + (hi_lo >> 32) + (cross >> 32);
+        }
+
+        inline void _mum_fast(uint64_t& a, uint64_t& b) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+            a = static_cast<uint64_t>(r);
+            b = static_cast<uint64_t>(r >> 64);
+#elif defined(_M_X64) && defined(_MSC_VER)
+            a = _umul128(a, b, &b);
+#else
+            _mum(a, b);
+#endif
+        }
+
+        [[nodiscard]] constexpr inline uint64_t mix(uint64_t a, uint64_t b) noexcept
+        {
+            _mum(a, b);
+            return a ^ b;
+        }
+
+        template <class CharT>
+        [[nodiscard]] constexpr inline uint64_t _mix(uint64_t a, uint64_t b) noexcept
+        {
+            if constexpr (std::is_same_v<CharT, unsigned char>) _mum_fast(a, b);
+            else _mum(a, b);
+            return a ^ b;
+        }
+
+        [[nodiscard]] constexpr inline uint64_t _avalanche(uint64_t h) noexcept
+        {
+            h ^= h >> 37;
+            h *= 0x165667919E3779F9ull;
+            return h ^ (h >> 32);
+        }
+
+        //-------------------- readers --------------------//
+
+        // Byte-composing readers work in constant expressions;
+        // the unsigned char overloads are the runtime fast path.
+
+        template <class CharT>
+        constexpr inline uint64_t _read64(const CharT* p) noexcept
+        {
+            uint64_t v = 0;
+            for (int idx = 7; idx >= 0; idx--) v = (v << 8) | static_cast<unsigned char>(p[idx]);
+            return v;
+        }
+
+        template <class CharT>
+        constexpr inline uint64_t _read32(const CharT* p) noexcept
+        {
+            uint64_t v = 0;
+            for (int idx = 3; idx >= 0; idx--) v = (v << 8) | static_cast<unsigned char>(p[idx]);
+            return v;
+        }
+
+        inline uint64_t _read64(const unsigned char* p) noexcept
+        {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline uint64_t _read32(const unsigned char* p) noexcept
+        {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        template <class CharT>
+        constexpr inline uint64_t _read3(const CharT* p, size_t len) noexcept
+        {
+            return (static_cast<uint64_t>(static_cast<unsigned char>(p[0])) << 16)
+                | (static_cast<uint64_t>(static_cast<unsigned char>(p[len >> 1])) << 8)
+                | static_cast<unsigned char>(p[len - 1]);
+        }
+
+        //-------------------- short path --------------------//
+
+        template <class CharT>
+        [[nodiscard]] constexpr uint64_t _short(const CharT* p, size_t len, uint64_t seed) noexcept
+        {
+            seed ^= _mix<CharT>(seed ^ _p0, _p1);
+            uint64_t a = 0, b = 0;
+            if (len <= 16)
+            {
+                if (len >= 4)
+                {
+                    a = (_read32(p) << 32) | _read32(p + ((len >> 3) << 2));
+                    b = (_read32(p + len - 4) << 32) | _read32(p + len - 4 - ((len >> 3) << 2));
+                }
+                else if (len > 0)
+                {
+                    a = _read3(p, len);
+                }
+            }
+            else
+            {
+                size_t left = len;
+                if (left > 48)
+                {
+                    uint64_t see1 = seed, see2 = seed;
+                    do
+                    {
+                        seed = _mix<CharT>(_read64(p) ^ _p1, _read64(p + 8) ^ seed);
+                        see1 = _mix<CharT>(_read64(p + 16) ^ _p2, _read64(p + 24) ^ see1);
+                        see2 = _mix<CharT>(_read64(p + 32) ^ _p3, _read64(p + 40) ^ see2);
+                        p += 48;
+                        left -= 48;
+                    } while (left > 48);
+                    seed ^= see1 ^ see2;
+                }
+                while (left > 16)
+                {
+                    seed = _mix<CharT>(_read64(p) ^ _p1, _read64(p + 8) ^ seed);
+                    p += 16;
+                    left -= 16;
+                }
+                a = _read64(p + left - 16);
+                b = _read64(p + left - 8);
+            }
+            a ^= _p1;
+            b ^= seed;
+            if constexpr (std::is_same_v<CharT, unsigned char>) _mum_fast(a, b);
+            else _mum(a, b);
+            return _mix<CharT>(a ^ _p0 ^ len, b ^ _p1);
+        }
+
+        //-------------------- long path --------------------//
+
+        struct _secret
+        {
+            uint64_t key[8] = {};
+            uint64_t scramble[8] = {};
+
+            constexpr _secret() noexcept = default;
+
+            constexpr explicit _secret(uint64_t seed) noexcept
+            {
+                constexpr uint64_t primes[4] = { _p0, _p1, _p2, _p3 };
+                for (size_t idx = 0; idx < 8; idx++)
+                {
+                    key[idx] = mix(primes[idx & 3] ^ seed, primes[(idx + 1) & 3] + idx);
+                    scramble[idx] = mix(primes[(idx + 2) & 3] + seed, primes[(idx + 3) & 3] ^ (idx << 32));
+                }
+            }
+        };
+
+        constexpr inline void _init_acc(uint64_t* acc) noexcept
+        {
+            constexpr uint64_t primes[4] = { _p0, _p1, _p2, _p3 };
+            for (size_t idx = 0; idx < 8; idx++) acc[idx] = primes[idx & 3];
+        }
+
+        template <class CharT>
+        constexpr inline void _stripe_scalar(uint64_t* acc, const CharT* p, const uint64_t* key) noexcept
+        {
+            for (size_t idx = 0; idx < 8; idx++)
+            {
+                const uint64_t data = _read64(p + 8 * idx);
+                const uint64_t data_key = data ^ key[idx];
+                acc[idx ^ 1] += data;
+                acc[idx] += (data_key & 0xffffffffull) * (data_key >> 32);
+            }
+        }
+
+        constexpr inline void _scramble_scalar(uint64_t* acc, const uint64_t* scramble) noexcept
+        {
+            for (size_t idx = 0; idx < 8; idx++)
+            {
+                uint64_t v = acc[idx];
+                v ^= v >> 47;
+                v ^= scramble[idx];
+                acc[idx] = v * _prime32;
+            }
+        }
+
+        inline void _stripe_simd(uint64_t* acc, const unsigned char* p, const uint64_t* key) noexcept
+        {
+#if defined(NW_HASH_AVX2)
+            for (size_t idx = 0; idx < 2; idx++)
+            {
+                __m256i* lane = reinterpret_cast<__m256i*>(acc) + idx;
+                const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p) + idx);
+                const __m256i data_key = _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key) + idx));
+                const __m256i product = _mm256_mul_epu32(data_key, _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+                const __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                _mm256_storeu_si256(lane, _mm256_add_epi64(_mm256_loadu_si256(lane), _mm256_add_epi64(product, swapped)));
+            }
+#elif defined(NW_HASH_SSE2)
+            for (size_t idx = 0; idx < 4; idx++)
+            {
+                __m128i* lane = reinterpret_cast<__m128i*>(acc) + idx;
+                const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p) + idx);
+                const __m128i data_key = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(key) + idx));
+                const __m128i product = _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+                const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                _mm_storeu_si128(lane, _mm_add_epi64(_mm_loadu_si128(lane), _mm_add_epi64(product, swapped)));
+            }
+#else
+            _stripe_scalar(acc, p, key);
+#endif
+        }
+
+        template <class CharT>
+        constexpr void _accumulate(uint64_t* acc, const CharT* p, size_t stripes, size_t& counter, const _secret& secret) noexcept
+        {
+            for (size_t idx = 0; idx < stripes; idx++, p += stripe_size)
+            {
+                if constexpr (std::is_same_v<CharT, unsigned char>) _stripe_simd(acc, p, secret.key);
+                else _stripe_scalar(acc, p, secret.key);
+
+                if (++counter % stripes_per_block == 0) _scramble_scalar(acc, secret.scramble);
+            }
+        }
+
+        [[nodiscard]] constexpr inline uint64_t _merge(const uint64_t* acc, uint64_t len, uint64_t seed, const _secret& secret) noexcept
+        {
+            uint64_t h = (len * 0x9E3779B185EBCA87ull) ^ seed;
+            for (size_t idx = 0; idx < 8; idx += 2)
+            {
+                h += mix(acc[idx] ^ secret.key[idx], acc[idx + 1] ^ secret.key[idx + 1]);
+            }
+            return _avalanche(h);
+        }
+
+        template <class CharT>
+        [[nodiscard]] constexpr uint64_t _long(const CharT* p, size_t len, uint64_t seed) noexcept
+        {
+            const _secret secret(seed);
+            uint64_t acc[8] = {};
+            _init_acc(acc);
+            size_t counter = 0;
+            const size_t stripes = len / stripe_size;
+            _accumulate(acc, p, stripes, counter, secret);
+
+            const size_t rest = len % stripe_size;
+            if (rest != 0)
+            {
+                CharT last[stripe_size] = {};
+                for (size_t idx = 0; idx < rest; idx++) last[idx] = p[stripes * stripe_size + idx];
+                _accumulate(acc, static_cast<const CharT*>(last), 1, counter, secret);
+            }
+            return _merge(acc, len, seed, secret);
+        }
+
+        //-------------------- one-shot --------------------//
+
+        [[nodiscard]] constexpr inline uint64_t hash_constexpr(std::string_view str, uint64_t seed = 0) noexcept
+        {
+            return str.size() <= short_limit ?
+                _short(str.data(), str.size(), seed) :
+                _long(str.data(), str.size(), seed);
+        }
+
+        [[nodiscard]] inline uint64_t hash(const void* data, size_t len, uint64_t seed = 0) noexcept
+        {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            return len <= short_limit ? _short(p, len, seed) : _long(p, len, seed);
+        }
+
+        [[nodiscard]] inline uint64_t hash(std::string_view str, uint64_t seed = 0) noexcept
+        {
+            return hash(str.data(), str.size(), seed);
+        }
+
+        [[nodiscard]] constexpr inline uint64_t hash_int(uint64_t value, uint64_t seed = 0) noexcept
+        {
+            uint64_t a = value ^ _p0, b = seed ^ _p1;
+            _mum(a, b);
+            return mix(a ^ _p0, b ^ _p1);
+        }
+
+        //-------------------- streaming --------------------//
+
+        class stream
+        {
+        protected:
+
+            _secret secret;
+            uint64_t acc[8];
+            uint64_t seed;
+            uint64_t total;
+            size_t counter;
+            size_t buffered;
+            unsigned char buffer[short_limit];
+
+        public:
+
+            explicit stream(uint64_t seed = 0) noexcept
+                : secret()
+            {
+                this->reset(seed);
+            }
+
+            stream& reset(uint64_t seed = 0) noexcept
+            {
+                this->seed = seed;
+                _init_acc(acc);
+                total = 0;
+                counter = 0;
+                buffered = 0;
+                return *this;
+            }
+
+            stream& update(const void* data, size_t len) noexcept
+            {
+                const unsigned char* p = static_cast<const unsigned char*>(data);
+                total += len;
+                while (len > 0)
+                {
+                    // A full buffer followed by more input proves the long path.
+                    if (buffered == short_limit)
+                    {
+                        // The key schedule is only needed once the input turns long.
+                        if (counter == 0) secret = _secret(seed);
+                        _accumulate(acc, buffer, short_limit / stripe_size, counter, secret);
+                        buffered = 0;
+                    }
+                    const size_t chunk = (std::min)(len, short_limit - buffered);
+                    std::memcpy(buffer + buffered, p, chunk);
+                    buffered += chunk;
+                    p += chunk;
+                    len -= chunk;
+                }
+                return *this;
+            }
+
+            stream& update(std::string_view str) noexcept
+            {
+                return this->update(str.data(), str.size());
+            }
+
+            [[nodiscard]] uint64_t digest() const noexcept
+            {
+                if (total <= short_limit) return _short(static_cast<const unsigned char*>(buffer), buffered, seed);
+
+                uint64_t tail_acc[8];
+                std::memcpy(tail_acc, acc, sizeof(acc));
+                size_t tail_counter = counter;
+                const size_t stripes = buffered / stripe_size;
+                _accumulate(tail_acc, static_cast<const unsigned char*>(buffer), stripes, tail_counter, secret);
+
+                const size_t rest = buffered % stripe_size;
+                if (rest != 0)
+                {
+                    unsigned char last[stripe_size] = {};
+                    std::memcpy(last, buffer + stripes * stripe_size, rest);
+                    _accumulate(tail_acc, static_cast<const unsigned char*>(last), 1, tail_counter, secret);
+                }
+                return _merge(tail_acc, total, seed, secret);
+            }
+
+        }; // class stream
+
+        //-------------------- std::hash-compatible functors --------------------//
+
+        // std::hash<Ty> is enabled
+        template <class Ty>
+        constexpr bool _std_hashable = std::is_default_constructible_v<std::hash<Ty>>;
+
+        /*
+         * Types whose equal values have equal bytes (no padding, no float
+         * members) hash their bytes; other types go to std::hash or need a
+         * specialization.
+         */
+        template <class Ty, class = void>
+        struct hasher
+        {
+            static_assert(std::has_unique_object_representations_v<Ty> || _std_hashable<Ty>, "hash64::hasher: type must have unique object representations, a std::hash or a specialization");
+
+            [[nodiscard]] size_t operator()(const Ty& value) const noexcept(std::has_unique_object_representations_v<Ty>)
+            {
+                if constexpr (std::has_unique_object_representations_v<Ty>) return static_cast<size_t>(hash(&value, sizeof(Ty)));
+                else return std::hash<Ty>()(value);
+            }
+        };
+
+        template <class Ty>
+        struct hasher<Ty, std::enable_if_t<std::is_integral_v<Ty> || std::is_enum_v<Ty>>>
+        {
+            [[nodiscard]] size_t operator()(const Ty& value) const noexcept
+            {
+                return static_cast<size_t>(hash_int(static_cast<uint64_t>(value)));
+            }
+        };
+
+        // Values that compare equal hash equal: -0.0 as 0.0, every NaN as one
+        template <class Ty>
+        struct hasher<Ty, std::enable_if_t<std::is_floating_point_v<Ty>>>
+        {
+            [[nodiscard]] size_t operator()(Ty value) const noexcept
+            {
+                if (value == Ty(0)) value = Ty(0);
+                if (value != value) value = std::numeric_limits<Ty>::quiet_NaN();
+
+                if constexpr (sizeof(Ty) == sizeof(uint64_t) || sizeof(Ty) == sizeof(uint32_t))
+                {
+                    std::conditional_t<sizeof(Ty) == sizeof(uint64_t), uint64_t, uint32_t> bits;
+                    std::memcpy(&bits, &value, sizeof(Ty));
+                    return static_cast<size_t>(hash_int(bits));
+                }
+                else
+                {
+                    // long double has padding bytes: hash sign, exponent and leading 64 mantissa bits
+                    if (std::isnan(value)) return static_cast<size_t>(hash_int(1, 1));
+                    if (std::isinf(value)) return static_cast<size_t>(hash_int(value > 0 ? 2 : 3, 1));
+                    int exponent = 0;
+                    const Ty mantissa = std::frexp(std::fabs(value), &exponent);
+                    const uint64_t high = static_cast<uint64_t>(std::ldexp(mantissa, 64));
+                    return static_cast<size_t>(hash_int(high, (static_cast<uint64_t>(exponent) << 1) | (value < 0 ? 1 : 0)));
+                }
+            }
+        };
+
+        template <class Ty>
+        struct hasher<Ty*>
+        {
+            [[nodiscard]] size_t operator()(Ty* value) const noexcept
+            {
+                return static_cast<size_t>(hash_int(reinterpret_cast<uintptr_t>(value)));
+            }
+        };
+
+        // Transparent: std::string, std::string_view and const char* hash equal.
+        struct string_hasher
+        {
+            using is_transparent = void;
+
+            [[nodiscard]] size_t operator()(std::string_view str) const noexcept
+            {
+                return static_cast<size_t>(hash(str));
+            }
+        };
+
+        // Transparent: a basic_string hasher also accepts views and C strings.
+        template <class charTy, class Traits, class Alloc>
+        struct hasher<std::basic_string<charTy, Traits, Alloc>>
+        {
+            using is_transparent = void;
+
+            [[nodiscard]] size_t operator()(std::basic_string_view<charTy, Traits> str) const noexcept
+            {
+                return static_cast<size_t>(hash(str.data(), str.size() * sizeof(charTy)));
+            }
+        };
+
+        template <class charTy, class Traits>
+        struct hasher<std::basic_string_view<charTy, Traits>> : hasher<std::basic_string<charTy, Traits>>
+        {
+        };
+
+        namespace literals {
+
+            [[nodiscard]] constexpr inline uint64_t operator""_h64(const char* str, size_t len) noexcept
+            {
+                return hash_constexpr(std::string_view(str, len));
+            }
+
+        } // namespace literals
+
+    } // namespace hash64
+
+} // namespace nw
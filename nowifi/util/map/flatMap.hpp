@@ -0,0 +1,443 @@
+#pragma once
+
+#include <nowifi/util/hash.hpp>
+
+#include <vector>
+#include <utility>
+#include <functional>
+#include <stdexcept>
+#include <memory>
+#include <algorithm>
+#include <initializer_list>
+#include <tuple>
+#include <cstdint>
+
+namespace nw {
+
+	////////////////////////////////          ////////////////////////////////
+	//------------------------------          ------------------------------//
+	//------------------------------ flat_map ------------------------------//
+	//------------------------------          ------------------------------//
+	////////////////////////////////          ////////////////////////////////
+
+	/*
+	 * Open-addressing hash map with robin-hood probing.
+	 *
+	 * Entries live contiguously in insertion order; the probe table holds only
+	 * 8-byte slots (entry index + 16-bit hash fingerprint + 16-bit probe
+	 * distance), so a miss rarely touches the entries at all. More than
+	 * max_distance keys on one home slot (a degenerate hash) is
+	 * std::length_error.
+	 *
+	 * Lookups are templated on the key type: with a transparent hasher and
+	 * key_equal (the default for std::string) a string_view probes without
+	 * building a std::string.
+	 *
+	 * erase() moves the last entry into the hole, so insertion order is kept
+	 * only as long as nothing is erased. Iterators and references are
+	 * invalidated by any insertion that grows the map.
+	 *
+	 * Entries are std::pair<const Key, Value>: values can be changed in place
+	 * through an iterator, keys can not. As the key can not be moved out of
+	 * an entry, growing the entry storage copies keys; reserve() ahead of
+	 * bulk insertion avoids it.
+	 */
+	template <
+		class Key,
+		class Value,
+		class _Hasher = hash64::hasher<Key>,
+		class _Keyeq = std::equal_to<>,
+		class _Alloc = std::allocator<std::pair<const Key, Value>>
+	>
+	class flat_map
+	{
+	public:
+
+		using key_type = Key;
+		using mapped_type = Value;
+		using value_type = std::pair<const Key, Value>;
+		using size_type = size_t;
+		using hasher = _Hasher;
+		using key_equal = _Keyeq;
+		using allocator_type = _Alloc;
+
+		using container_type = std::vector<value_type, typename std::allocator_traits<_Alloc>::template rebind_alloc<value_type>>;
+		using const_iterator = typename container_type::const_iterator;
+		using iterator = typename container_type::iterator;
+
+	protected:
+
+		struct slot
+		{
+			uint32_t index;
+			uint32_t meta; // (fingerprint << 16) | distance, 0 when empty
+		};
+
+		using slot_allocator = typename std::allocator_traits<_Alloc>::template rebind_alloc<slot>;
+
+		static constexpr uint32_t max_distance = 0xffff;
+		static constexpr size_t min_capacity = 16;
+
+		container_type _values;
+		std::vector<slot, slot_allocator> _slots;
+		size_t _mask = 0;
+		float _max_load = 0.875f;
+		_Hasher _hash;
+		_Keyeq _equal;
+
+		[[nodiscard]] static constexpr uint32_t _distance(uint32_t meta) noexcept
+		{
+			return meta & 0xffff;
+		}
+
+		[[nodiscard]] static constexpr uint32_t _fingerprint(uint64_t h) noexcept
+		{
+			return static_cast<uint32_t>(h >> 48) << 16;
+		}
+
+		template <class K>
+		[[nodiscard]] uint64_t _hash_of(const K& key) const
+		{
+			return static_cast<uint64_t>(_hash(key));
+		}
+
+		[[nodiscard]] size_t _capacity_for(size_t count) const noexcept
+		{
+			size_t capacity = min_capacity;
+			while (static_cast<float>(capacity) * _max_load < static_cast<float>(count)) capacity <<= 1;
+			return capacity;
+		}
+
+		/*
+		 * Locates <key>.
+		 *
+		 * @return Slot position holding <key>, or ~0 if absent. On a miss
+		 *         <pos>/<meta> hold the robin-hood insertion point.
+		 */
+		template <class K>
+		[[nodiscard]] size_t _probe(const K& key, uint64_t h, size_t& pos, uint32_t& meta) const
+		{
+			pos = static_cast<size_t>(h) & _mask;
+			meta = _fingerprint(h) | 1;
+			if (_slots.empty()) return ~size_t(0);
+			for (;;)
+			{
+				const slot& current = _slots[pos];
+				if (current.meta == 0 || _distance(current.meta) < _distance(meta)) return ~size_t(0);
+				if (current.meta == meta && _equal(_values[current.index].first, key)) return pos;
+				// Nothing is placed further than max_distance from its home slot
+				if (_distance(meta) == max_distance) return ~size_t(0);
+				pos = (pos + 1) & _mask;
+				meta++;
+			}
+		}
+
+		// Places <index> starting at <pos>/<meta>; false if a chain grew too long,
+		// leaving the slots to be rebuilt by _rehash().
+		bool _place(uint32_t index, size_t pos, uint32_t meta) noexcept
+		{
+			slot carry{ index, meta };
+			for (;;)
+			{
+				slot& current = _slots[pos];
+				if (current.meta == 0)
+				{
+					current = carry;
+					return true;
+				}
+				if (_distance(current.meta) < _distance(carry.meta)) std::swap(current, carry);
+				if (_distance(carry.meta) == max_distance) return false;
+				pos = (pos + 1) & _mask;
+				carry.meta++;
+			}
+		}
+
+		void _rehash(size_t capacity)
+		{
+			for (;;)
+			{
+				_slots.assign(capacity, slot{ 0, 0 });
+				_mask = capacity - 1;
+				bool ok = true;
+				for (size_t idx = 0; idx < _values.size() && ok; idx++)
+				{
+					const uint64_t h = this->_hash_of(_values[idx].first);
+					ok = this->_place(static_cast<uint32_t>(idx), static_cast<size_t>(h) & _mask, _fingerprint(h) | 1);
+				}
+				if (ok) return;
+				// Growing spreads long chains unless the hashes themselves collide
+				if (capacity >= (this->_capacity_for(_values.size()) << 4)) throw std::length_error("flat_map: too many keys with colliding hashes");
+				capacity <<= 1;
+			}
+		}
+
+		template <class K, class... Args>
+		std::pair<iterator, bool> _emplace(const K& key, Args&&... args)
+		{
+			const uint64_t h = this->_hash_of(key);
+			size_t pos;
+			uint32_t meta;
+			const size_t found = this->_probe(key, h, pos, meta);
+			if (found != ~size_t(0)) return { _values.begin() + _slots[found].index, false };
+
+			const size_t index = _values.size();
+			_values.emplace_back(std::piecewise_construct,
+				std::forward_as_tuple(key),
+				std::forward_as_tuple(std::forward<Args>(args)...));
+
+			const size_t capacity = _slots.size();
+			try
+			{
+				if (_slots.empty() || static_cast<float>(index + 1) > static_cast<float>(_slots.size()) * _max_load)
+				{
+					this->_rehash(_slots.empty() ? this->_capacity_for(index + 1) : _slots.size() * 2);
+				}
+				else if (!this->_place(static_cast<uint32_t>(index), pos, meta))
+				{
+					this->_rehash(_slots.size() * 2);
+				}
+			}
+			catch (...)
+			{
+				_values.pop_back();
+				this->_rehash(capacity != 0 ? capacity : this->_capacity_for(index));
+				throw;
+			}
+			return { _values.begin() + index, true };
+		}
+
+	public:
+
+		//-------------------- CONSTRUCTOR --------------------//
+
+		flat_map() = default;
+
+		explicit flat_map(size_t count, const _Hasher& hash = _Hasher(), const _Keyeq& equal = _Keyeq())
+			: _hash(hash), _equal(equal)
+		{
+			this->reserve(count);
+		}
+
+		flat_map(std::initializer_list<value_type> items)
+		{
+			this->reserve(items.size());
+			for (const value_type& item : items) this->_emplace(item.first, item.second);
+		}
+
+		//-------------------- capacity --------------------//
+
+		[[nodiscard]] size_t size() const noexcept
+		{
+			return _values.size();
+		}
+
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return _values.empty();
+		}
+
+		[[nodiscard]] size_t bucket_count() const noexcept
+		{
+			return _slots.size();
+		}
+
+		[[nodiscard]] float load_factor() const noexcept
+		{
+			return _slots.empty() ? 0.0f : static_cast<float>(_values.size()) / static_cast<float>(_slots.size());
+		}
+
+		[[nodiscard]] float max_load_factor() const noexcept
+		{
+			return _max_load;
+		}
+
+		void max_load_factor(float value)
+		{
+			if (!(value > 0.0f && value < 1.0f)) throw std::invalid_argument("flat_map: max_load_factor must be in (0, 1)");
+			_max_load = value;
+			if (!_slots.empty() && this->load_factor() > _max_load) this->_rehash(this->_capacity_for(_values.size()));
+		}
+
+		/*
+		 * Makes room for <count> entries without further rehashing.
+		 */
+		void reserve(size_t count)
+		{
+			_values.reserve(count);
+			const size_t capacity = this->_capacity_for(count);
+			if (capacity > _slots.size()) this->_rehash(capacity);
+		}
+
+		/*
+		 * Shrinks both the entry storage and the probe table to fit size().
+		 */
+		void shrink_to_fit()
+		{
+			_values.shrink_to_fit();
+			const size_t capacity = this->_capacity_for(_values.size());
+			if (capacity < _slots.size()) this->_rehash(capacity);
+		}
+
+		void clear() noexcept
+		{
+			_values.clear();
+			std::fill(_slots.begin(), _slots.end(), slot{ 0, 0 });
+		}
+
+		//-------------------- lookup --------------------//
+
+		template <class K = Key>
+		[[nodiscard]] iterator find(const K& key)
+		{
+			size_t pos;
+			uint32_t meta;
+			const size_t found = this->_probe(key, this->_hash_of(key), pos, meta);
+			return found == ~size_t(0) ? _values.end() : _values.begin() + _slots[found].index;
+		}
+
+		template <class K = Key>
+		[[nodiscard]] const_iterator find(const K& key) const
+		{
+			size_t pos;
+			uint32_t meta;
+			const size_t found = this->_probe(key, this->_hash_of(key), pos, meta);
+			return found == ~size_t(0) ? _values.end() : _values.begin() + _slots[found].index;
+		}
+
+		template <class K = Key>
+		[[nodiscard]] bool contains(const K& key) const
+		{
+			return this->find(key) != _values.end();
+		}
+
+		template <class K = Key>
+		[[nodiscard]] size_t count(const K& key) const
+		{
+			return this->contains(key) ? 1 : 0;
+		}
+
+		template <class K = Key>
+		[[nodiscard]] Value& at(const K& key)
+		{
+			const iterator it = this->find(key);
+			if (it == this->end()) throw std::out_of_range("flat_map: key not found");
+			return it->second;
+		}
+
+		template <class K = Key>
+		[[nodiscard]] const Value& at(const K& key) const
+		{
+			const const_iterator it = this->find(key);
+			if (it == _values.end()) throw std::out_of_range("flat_map: key not found");
+			return it->second;
+		}
+
+		/*
+		 * Returns the value of <key>, or <fallback> if absent. Never throws.
+		 */
+		template <class K = Key>
+		[[nodiscard]] Value get(const K& key, const Value& fallback = Value()) const
+		{
+			const const_iterator it = this->find(key);
+			return it == _values.end() ? fallback : it->second;
+		}
+
+		//-------------------- modifiers --------------------//
+
+		/*
+		 * Inserts <key> with a value built from <args> unless present.
+		 * Costs a single probe either way.
+		 */
+		template <class K, class... Args>
+		std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+		{
+			return this->_emplace(key, std::forward<Args>(args)...);
+		}
+
+		std::pair<iterator, bool> insert(const value_type& item)
+		{
+			return this->_emplace(item.first, item.second);
+		}
+
+		template <class K = Key>
+		Value& operator[](const K& key)
+		{
+			return this->_emplace(key).first->second;
+		}
+
+		template <class K = Key>
+		size_t erase(const K& key)
+		{
+			size_t pos;
+			uint32_t meta;
+			const size_t found = this->_probe(key, this->_hash_of(key), pos, meta);
+			if (found == ~size_t(0)) return 0;
+
+			const uint32_t index = _slots[found].index;
+
+			// Backward-shift deletion
+			pos = found;
+			size_t next = (pos + 1) & _mask;
+			while (_slots[next].meta != 0 && _distance(_slots[next].meta) > 1)
+			{
+				_slots[pos] = _slots[next];
+				_slots[pos].meta--;
+				pos = next;
+				next = (next + 1) & _mask;
+			}
+			_slots[pos] = slot{ 0, 0 };
+
+			// Move the last entry into the hole and repoint its slot
+			const uint32_t last = static_cast<uint32_t>(_values.size() - 1);
+			if (index != last)
+			{
+				size_t moved = static_cast<size_t>(this->_hash_of(_values[last].first)) & _mask;
+				while (_slots[moved].index != last || _slots[moved].meta == 0) moved = (moved + 1) & _mask;
+				_slots[moved].index = index;
+				// The const key rules out assignment: rebuild the entry in place
+				using traits = std::allocator_traits<typename container_type::allocator_type>;
+				typename container_type::allocator_type alloc = _values.get_allocator();
+				traits::destroy(alloc, &_values[index]);
+				traits::construct(alloc, &_values[index], std::move(_values[last]));
+			}
+			_values.pop_back();
+			return 1;
+		}
+
+		//-------------------- iteration --------------------//
+
+		// Insertion order (see class comment about erase)
+
+		[[nodiscard]] iterator begin() noexcept { return _values.begin(); }
+		[[nodiscard]] iterator end() noexcept { return _values.end(); }
+		[[nodiscard]] const_iterator begin() const noexcept { return _values.begin(); }
+		[[nodiscard]] const_iterator end() const noexcept { return _values.end(); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return _values.cbegin(); }
+		[[nodiscard]] const_iterator cend() const noexcept { return _values.cend(); }
+
+		/*
+		 * Applies <fn> to each entry in probe-table (bucket) order.
+		 *
+		 * @param <fn> - Unary function that accepts a value_type& (const value_type& if const)
+		 */
+		template <class Function>
+		void for_each_bucket(Function fn)
+		{
+			for (const slot& current : _slots)
+			{
+				if (current.meta != 0) fn(_values[current.index]);
+			}
+		}
+
+		template <class Function>
+		void for_each_bucket(Function fn) const
+		{
+			for (const slot& current : _slots)
+			{
+				if (current.meta != 0) fn(_values[current.index]);
+			}
+		}
+
+	}; // class flat_map
+
+} // namespace nw
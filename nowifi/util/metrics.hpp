@@ -0,0 +1,382 @@
+#pragma once
+
+#include <nowifi/util/time.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+/*
+ * Hot-path hooks. Each call site registers its metric once (function-local
+ * static) and then costs one thread-local add. Hooks are compiled out
+ * unless NW_METRICS is defined.
+ *
+ *   NW_METRIC_ADD("parser.rows", 1);
+ *   NW_METRIC_GAUGE_ADD("pool.live_bytes", size);
+ */
+#if defined(NW_METRICS)
+#define NW_METRIC_ADD(name, value) \
+	do { static const ::nw::metrics::Counter _nw_metric(name); _nw_metric.add(static_cast<int64_t>(value)); } while (0)
+#define NW_METRIC_GAUGE_ADD(name, value) \
+	do { static const ::nw::metrics::Gauge _nw_metric(name); _nw_metric.add(static_cast<int64_t>(value)); } while (0)
+#define NW_METRIC_GAUGE_SET(name, value) \
+	do { static const ::nw::metrics::Gauge _nw_metric(name); _nw_metric.set(static_cast<int64_t>(value)); } while (0)
+#else
+#define NW_METRIC_ADD(name, value) static_cast<void>(0)
+#define NW_METRIC_GAUGE_ADD(name, value) static_cast<void>(0)
+#define NW_METRIC_GAUGE_SET(name, value) static_cast<void>(0)
+#endif
+
+namespace nw {
+
+	namespace metrics {
+
+		enum class kind : uint8_t
+		{
+			counter, // monotonic, summed over threads when read
+			gauge,   // current level, set or adjusted from any thread
+		};
+
+		struct sample
+		{
+			std::string name;
+			kind type;
+			int64_t value;
+		};
+
+		//-------------------- Registry --------------------//
+
+		/*
+		 * Counters live in one cache-line-aligned slot table per thread, so
+		 * add() is a plain single-writer store that never bounces a line
+		 * between cores; reading sums the tables. Tables are owned by the
+		 * registry and outlive their threads. Gauges are shared padded
+		 * atomics: one per line.
+		 */
+		class Registry
+		{
+		public:
+
+			static constexpr size_t max_metrics = 512;
+
+		protected:
+
+			struct alignas(64) _thread_slots
+			{
+				std::atomic<int64_t> values[max_metrics];
+
+				_thread_slots() noexcept
+				{
+					for (std::atomic<int64_t>& value : values) value.store(0, std::memory_order_relaxed);
+				}
+			};
+
+			struct alignas(64) _gauge
+			{
+				std::atomic<int64_t> value{ 0 };
+			};
+
+			mutable std::mutex _mutex;
+			std::vector<std::string> _names;
+			std::vector<kind> _kinds;
+			std::vector<std::unique_ptr<_thread_slots>> _threads;
+			std::unique_ptr<_gauge[]> _gauges;
+
+			Registry()
+				: _gauges(new _gauge[max_metrics]) { }
+
+			_thread_slots& _local()
+			{
+				thread_local _thread_slots* local = nullptr;
+				if (local == nullptr)
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					_threads.push_back(std::make_unique<_thread_slots>());
+					local = _threads.back().get();
+				}
+				return *local;
+			}
+
+			int64_t _value(size_t id) const
+			{
+				if (_kinds[id] == kind::gauge) return _gauges[id].value.load(std::memory_order_relaxed);
+				int64_t total = 0;
+				for (const auto& thread : _threads) total += thread->values[id].load(std::memory_order_relaxed);
+				return total;
+			}
+
+		public:
+
+			Registry(const Registry&) = delete;
+			Registry& operator=(const Registry&) = delete;
+
+			static Registry& instance()
+			{
+				static Registry registry;
+				return registry;
+			}
+
+			/*
+			 * Id of metric <name>, registering it on first use.
+			 *
+			 * @exception std::invalid_argument - <name> already registered as the other kind
+			 * @exception std::length_error - More than max_metrics names
+			 */
+			size_t metric(const std::string& name, kind type)
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				const auto found = std::find(_names.begin(), _names.end(), name);
+				if (found != _names.end())
+				{
+					const size_t id = static_cast<size_t>(found - _names.begin());
+					if (_kinds[id] != type) throw std::invalid_argument("metrics: " + name + " registered as another kind");
+					return id;
+				}
+				if (_names.size() == max_metrics) throw std::length_error("metrics: too many metrics");
+				_names.push_back(name);
+				_kinds.push_back(type);
+				return _names.size() - 1;
+			}
+
+			void add(size_t id, int64_t value)
+			{
+				std::atomic<int64_t>& slot = this->_local().values[id];
+				slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+			}
+
+			void gauge_add(size_t id, int64_t value) noexcept
+			{
+				_gauges[id].value.fetch_add(value, std::memory_order_relaxed);
+			}
+
+			void gauge_set(size_t id, int64_t value) noexcept
+			{
+				_gauges[id].value.store(value, std::memory_order_relaxed);
+			}
+
+			[[nodiscard]] int64_t value(size_t id) const
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				return this->_value(id);
+			}
+
+			/*
+			 * Every metric, sorted by name. Each value is read atomically,
+			 * but the set is not one point in time while writers run.
+			 */
+			[[nodiscard]] std::vector<sample> snapshot() const
+			{
+				std::vector<sample> result;
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					result.reserve(_names.size());
+					for (size_t id = 0; id < _names.size(); id++) result.push_back(sample{ _names[id], _kinds[id], this->_value(id) });
+				}
+				std::sort(result.begin(), result.end(), [](const sample& lhs, const sample& rhs) { return lhs.name < rhs.name; });
+				return result;
+			}
+
+			/*
+			 * Zeroes counters and gauges; counters of running threads may keep a
+			 * concurrent in-flight increment.
+			 */
+			void reset()
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				for (const auto& thread : _threads)
+				{
+					for (std::atomic<int64_t>& value : thread->values) value.store(0, std::memory_order_relaxed);
+				}
+				for (size_t id = 0; id < max_metrics; id++) _gauges[id].value.store(0, std::memory_order_relaxed);
+			}
+
+		}; // class Registry
+
+		//-------------------- handles --------------------//
+
+		class Counter
+		{
+		protected:
+
+			size_t _id;
+
+		public:
+
+			explicit Counter(const std::string& name)
+				: _id(Registry::instance().metric(name, kind::counter)) { }
+
+			void add(int64_t value = 1) const
+			{
+				Registry::instance().add(_id, value);
+			}
+
+			[[nodiscard]] int64_t value() const
+			{
+				return Registry::instance().value(_id);
+			}
+
+		}; // class Counter
+
+		class Gauge
+		{
+		protected:
+
+			size_t _id;
+
+		public:
+
+			explicit Gauge(const std::string& name)
+				: _id(Registry::instance().metric(name, kind::gauge)) { }
+
+			void add(int64_t value) const noexcept
+			{
+				Registry::instance().gauge_add(_id, value);
+			}
+
+			void set(int64_t value) const noexcept
+			{
+				Registry::instance().gauge_set(_id, value);
+			}
+
+			[[nodiscard]] int64_t value() const
+			{
+				return Registry::instance().value(_id);
+			}
+
+		}; // class Gauge
+
+		//-------------------- export --------------------//
+
+		enum class format : uint8_t
+		{
+			text, // "name value" per line, blank line after each snapshot
+			json, // one object per line (JSON Lines)
+		};
+
+		// JSON string contents: quotes, backslashes and control characters escaped
+		inline std::string _json_escape(const std::string& str)
+		{
+			static const char hex[] = "0123456789abcdef";
+			std::string result;
+			result.reserve(str.size());
+			for (char ch : str)
+			{
+				const unsigned char byte = static_cast<unsigned char>(ch);
+				if (byte < 0x20)
+				{
+					const char escaped[] = { '\\', 'u', '0', '0', hex[byte >> 4], hex[byte & 0xF] };
+					result.append(escaped, sizeof(escaped));
+					continue;
+				}
+				if (ch == '"' || ch == '\\') result += '\\';
+				result += ch;
+			}
+			return result;
+		}
+
+		/*
+		 * Writes <samples> through <writer> (nw::Writer or anything with the same write()).
+		 */
+		template <class WriterTy>
+		void write(WriterTy& writer, const std::vector<sample>& samples, format type, long long timestamp_ms)
+		{
+			if (type == format::text)
+			{
+				for (const sample& item : samples) writer.write(item.name, ' ', item.value, '\n');
+				writer.write('\n');
+				return;
+			}
+
+			writer.write("{\"timestamp_ms\":", timestamp_ms);
+			for (kind group : { kind::counter, kind::gauge })
+			{
+				writer.write(group == kind::counter ? ",\"counters\":{" : ",\"gauges\":{");
+				bool first = true;
+				for (const sample& item : samples)
+				{
+					if (item.type != group) continue;
+					writer.write(first ? "\"" : ",\"", _json_escape(item.name), "\":", item.value);
+					first = false;
+				}
+				writer.write('}');
+			}
+			writer.write("}\n");
+		}
+
+		template <class WriterTy>
+		void write(WriterTy& writer, format type = format::text)
+		{
+			write(writer, Registry::instance().snapshot(), type, SystemTime::nowMilli());
+		}
+
+		/*
+		 * Writes a snapshot through <writer> every <interval> from a
+		 * background thread, and once more on stop() / destruction.
+		 * <writer> must outlive the exporter and not be used elsewhere meanwhile.
+		 */
+		template <class WriterTy>
+		class SnapshotExporter
+		{
+		protected:
+
+			WriterTy& _writer;
+			format _format;
+			std::chrono::milliseconds _interval;
+
+			std::mutex _mutex;
+			std::condition_variable _wake;
+			bool _stopping = false;
+			std::thread _thread;
+
+			void _run()
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				while (!_wake.wait_for(lock, _interval, [this]() { return _stopping; }))
+				{
+					lock.unlock();
+					metrics::write(_writer, _format);
+					lock.lock();
+				}
+			}
+
+		public:
+
+			SnapshotExporter(WriterTy& writer, std::chrono::milliseconds interval, format type = format::text)
+				: _writer(writer), _format(type), _interval(interval)
+			{
+				_thread = std::thread(&SnapshotExporter::_run, this);
+			}
+
+			SnapshotExporter(const SnapshotExporter&) = delete;
+			SnapshotExporter& operator=(const SnapshotExporter&) = delete;
+
+			~SnapshotExporter()
+			{
+				this->stop();
+			}
+
+			void stop()
+			{
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					if (_stopping) return;
+					_stopping = true;
+				}
+				_wake.notify_one();
+				_thread.join();
+				metrics::write(_writer, _format);
+			}
+
+		}; // class SnapshotExporter
+
+	} // namespace metrics
+
+} // namespace nw
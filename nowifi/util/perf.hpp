@@ -0,0 +1,253 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(NW_PERF_DISABLE) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define NW_PERF_LINUX
+#endif
+
+namespace nw {
+
+	/*
+	 * Hardware performance counters of the calling thread through Linux
+	 * perf_event_open (user space only).
+	 *
+	 * Counters are optional everywhere: other systems, NW_PERF_DISABLE,
+	 * perf_event_paranoid, seccomp in containers and VMs without a virtual
+	 * PMU all leave Counters::available() false and every sample empty,
+	 * so callers fall back to timing alone. Events the CPU lacks (TLB
+	 * misses on some PMUs) are skipped one by one.
+	 */
+	namespace perf {
+
+		enum class event : uint8_t
+		{
+			cycles,
+			instructions,
+			cache_misses,  // last-level cache
+			branch_misses,
+			dtlb_misses,   // data TLB read misses
+			itlb_misses,
+		};
+
+		constexpr size_t event_count = 6;
+
+		[[nodiscard]] inline const char* name(event type) noexcept
+		{
+			static const char* const names[event_count] = { "cycles", "instructions", "cache_misses", "branch_misses", "dtlb_misses", "itlb_misses" };
+			return names[static_cast<size_t>(type)];
+		}
+
+		//-------------------- sample --------------------//
+
+		struct sample
+		{
+			std::array<uint64_t, event_count> values{};
+			uint32_t valid = 0; // bit per event that was counted
+
+			[[nodiscard]] bool has(event type) const noexcept
+			{
+				return (valid >> static_cast<size_t>(type)) & 1;
+			}
+
+			[[nodiscard]] uint64_t operator[](event type) const noexcept
+			{
+				return values[static_cast<size_t>(type)];
+			}
+
+			[[nodiscard]] double ipc() const noexcept
+			{
+				if (!this->has(event::cycles) || !this->has(event::instructions) || values[0] == 0) return 0;
+				return static_cast<double>(values[1]) / static_cast<double>(values[0]);
+			}
+
+			sample& operator+=(const sample& second) noexcept
+			{
+				for (size_t idx = 0; idx < event_count; idx++) values[idx] += second.values[idx];
+				valid |= second.valid;
+				return *this;
+			}
+
+			// Counts between two reads of the same Counters
+			[[nodiscard]] friend sample operator-(const sample& end, const sample& begin) noexcept
+			{
+				sample result;
+				result.valid = end.valid & begin.valid;
+				for (size_t idx = 0; idx < event_count; idx++)
+				{
+					result.values[idx] = end.values[idx] >= begin.values[idx] ? end.values[idx] - begin.values[idx] : 0;
+				}
+				return result;
+			}
+		};
+
+		//-------------------- Counters --------------------//
+
+		/*
+		 * One event group on the thread that constructs it (counts only that
+		 * thread, on any CPU). Counts are scaled by enabled / running time
+		 * when the kernel multiplexes the PMU; a group that never got
+		 * scheduled reads as an empty sample.
+		 */
+		class Counters
+		{
+#if defined(NW_PERF_LINUX)
+		protected:
+
+			int _fds[event_count];
+			uint64_t _ids[event_count] = {};
+			int _leader = -1;
+			uint32_t _opened = 0;
+
+			static perf_event_attr _attr(event type) noexcept
+			{
+				perf_event_attr attr;
+				std::memset(&attr, 0, sizeof(attr));
+				attr.size = sizeof(attr);
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+				const uint64_t tlb_read_miss = (uint64_t(PERF_COUNT_HW_CACHE_OP_READ) << 8) | (uint64_t(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16);
+				switch (type)
+				{
+				case event::cycles: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+				case event::instructions: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+				case event::cache_misses: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+				case event::branch_misses: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+				case event::dtlb_misses: attr.type = PERF_TYPE_HW_CACHE; attr.config = PERF_COUNT_HW_CACHE_DTLB | tlb_read_miss; break;
+				case event::itlb_misses: attr.type = PERF_TYPE_HW_CACHE; attr.config = PERF_COUNT_HW_CACHE_ITLB | tlb_read_miss; break;
+				}
+				return attr;
+			}
+
+		public:
+
+			Counters() noexcept
+			{
+				for (size_t idx = 0; idx < event_count; idx++)
+				{
+					perf_event_attr attr = _attr(static_cast<event>(idx));
+					attr.disabled = _leader == -1 ? 1 : 0; // the leader gates the group
+					const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, _leader, 0);
+					_fds[idx] = static_cast<int>(fd);
+					if (fd < 0) continue;
+
+					if (_leader == -1) _leader = _fds[idx];
+					if (ioctl(_fds[idx], PERF_EVENT_IOC_ID, &_ids[idx]) != 0)
+					{
+						if (_leader == _fds[idx]) _leader = -1;
+						close(_fds[idx]);
+						_fds[idx] = -1;
+						continue;
+					}
+					_opened |= uint32_t(1) << idx;
+				}
+			}
+
+			~Counters()
+			{
+				// Members before the leader, which owns the group
+				for (size_t idx = event_count; idx-- > 0;)
+				{
+					if (_fds[idx] >= 0 && _fds[idx] != _leader) close(_fds[idx]);
+				}
+				if (_leader >= 0) close(_leader);
+			}
+
+			[[nodiscard]] bool available() const noexcept
+			{
+				return _opened != 0;
+			}
+
+			// Events that opened, one bit per event
+			[[nodiscard]] uint32_t events() const noexcept
+			{
+				return _opened;
+			}
+
+			// Zeroes and starts the group
+			void start() noexcept
+			{
+				if (_leader < 0) return;
+				ioctl(_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+				ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+			}
+
+			// Stops the group and returns the counts since start()
+			sample stop() noexcept
+			{
+				if (_leader < 0) return sample();
+				ioctl(_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+				return this->read();
+			}
+
+			/*
+			 * Counts since start(), without stopping; difference two reads to
+			 * count a region while the group keeps running. One syscall.
+			 */
+			[[nodiscard]] sample read() const noexcept
+			{
+				sample result;
+				if (_leader < 0) return result;
+
+				uint64_t buffer[3 + 2 * event_count];
+				const ssize_t size = ::read(_leader, buffer, sizeof(buffer));
+				if (size < static_cast<ssize_t>(3 * sizeof(uint64_t))) return result;
+
+				const uint64_t count = std::min<uint64_t>(buffer[0], event_count);
+				const uint64_t enabled = buffer[1];
+				const uint64_t running = buffer[2];
+				if (running == 0) return result;
+
+				for (uint64_t item = 0; item < count; item++)
+				{
+					const uint64_t value = buffer[3 + 2 * item];
+					const uint64_t id = buffer[4 + 2 * item];
+					for (size_t idx = 0; idx < event_count; idx++)
+					{
+						if (!((_opened >> idx) & 1) || _ids[idx] != id) continue;
+						result.values[idx] = running == enabled ? value
+							: static_cast<uint64_t>(static_cast<double>(value) * static_cast<double>(enabled) / static_cast<double>(running));
+						result.valid |= uint32_t(1) << idx;
+					}
+				}
+				return result;
+			}
+#else
+		public:
+
+			Counters() noexcept = default;
+
+			[[nodiscard]] bool available() const noexcept { return false; }
+			[[nodiscard]] uint32_t events() const noexcept { return 0; }
+
+			void start() noexcept { }
+			sample stop() noexcept { return sample(); }
+			[[nodiscard]] sample read() const noexcept { return sample(); }
+#endif
+
+			Counters(const Counters&) = delete;
+			Counters& operator=(const Counters&) = delete;
+
+		}; // class Counters
+
+		/*
+		 * Whether counters can be opened here, probed once.
+		 */
+		[[nodiscard]] inline bool supported() noexcept
+		{
+			static const bool result = Counters().available();
+			return result;
+		}
+
+	} // namespace perf
+
+} // namespace nw
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <nowifi/util/hash.hpp>
+
+#include <array>
+#include <string_view>
+#include <utility>
+#include <stdexcept>
+#include <cstdint>
+
+namespace nw {
+
+	////////////////////////////////              ////////////////////////////////
+	//------------------------------              ------------------------------//
+	//------------------------------ perfect_hash ------------------------------//
+	//------------------------------              ------------------------------//
+	////////////////////////////////              ////////////////////////////////
+
+	/*
+	 * Minimal perfect hash over <N> string keys, built at compile time
+	 * (hash-and-displace, PTHash-style pilots).
+	 *
+	 * Keys are spread over ~N/3 buckets; largest buckets are placed first,
+	 * each with the first pilot that maps all its keys to free slots.
+	 * Lookup is one hash64::hash, one pilot read, one slot and one compare.
+	 *
+	 * Keys must outlive the table (string literals are the intended use).
+	 */
+	template <size_t N>
+	class perfect_hash
+	{
+	public:
+
+		static_assert(N > 0, "perfect_hash: at least one key required");
+
+		static constexpr size_t npos = static_cast<size_t>(-1);
+		static constexpr size_t bucket_count = (N + 2) / 3;
+		static constexpr uint32_t max_pilot = 1u << 16;
+		static constexpr uint64_t max_seed = 64;
+
+	protected:
+
+		uint64_t _seed = 0;
+		std::array<uint64_t, bucket_count> _displace{};
+		std::array<std::string_view, N> _keys{};
+		std::array<size_t, N> _index{};
+
+		[[nodiscard]] static constexpr size_t _bucket(uint64_t h) noexcept
+		{
+			return static_cast<size_t>((h >> 32) % bucket_count);
+		}
+
+		[[nodiscard]] static constexpr size_t _slot(uint64_t h, uint64_t displace) noexcept
+		{
+			return static_cast<size_t>((h ^ displace) % N);
+		}
+
+		// Returns false when some bucket cannot be placed with this seed.
+		constexpr bool _build(const std::array<std::string_view, N>& keys, uint64_t seed)
+		{
+			std::array<uint64_t, N> hashes{};
+			std::array<size_t, bucket_count + 1> offset{};
+			for (size_t idx = 0; idx < N; idx++)
+			{
+				hashes[idx] = hash64::hash_constexpr(keys[idx], seed);
+				offset[_bucket(hashes[idx]) + 1]++;
+			}
+
+			// Group keys by bucket
+			for (size_t b = 0; b < bucket_count; b++) offset[b + 1] += offset[b];
+			std::array<size_t, N> members{};
+			std::array<size_t, bucket_count> fill{};
+			for (size_t idx = 0; idx < N; idx++)
+			{
+				const size_t b = _bucket(hashes[idx]);
+				members[offset[b] + fill[b]++] = idx;
+			}
+
+			// Buckets by size, largest first (counting sort, sizes are small)
+			std::array<size_t, bucket_count> order{};
+			size_t ordered = 0;
+			for (size_t size = N; size > 0; size--)
+			{
+				for (size_t b = 0; b < bucket_count; b++)
+				{
+					if (offset[b + 1] - offset[b] == size) order[ordered++] = b;
+				}
+			}
+
+			std::array<bool, N> taken{};
+			std::array<size_t, N> slots{};
+			for (size_t ob = 0; ob < ordered; ob++)
+			{
+				const size_t b = order[ob];
+				const size_t first = offset[b], last = offset[b + 1];
+
+				for (size_t lhs = first; lhs < last; lhs++)
+				{
+					for (size_t rhs = lhs + 1; rhs < last; rhs++)
+					{
+						if (keys[members[lhs]] == keys[members[rhs]]) throw std::invalid_argument("perfect_hash: duplicate key");
+					}
+				}
+
+				bool placed = false;
+				for (uint32_t pilot = 0; pilot < max_pilot && !placed; pilot++)
+				{
+					const uint64_t displace = hash64::hash_int(pilot, seed);
+					placed = true;
+					for (size_t idx = first; idx < last && placed; idx++)
+					{
+						const size_t slot = _slot(hashes[members[idx]], displace);
+						if (taken[slot]) placed = false;
+						for (size_t prev = first; prev < idx && placed; prev++)
+						{
+							if (slots[prev - first] == slot) placed = false;
+						}
+						slots[idx - first] = slot;
+					}
+					if (placed)
+					{
+						_displace[b] = displace;
+						for (size_t idx = first; idx < last; idx++)
+						{
+							const size_t slot = slots[idx - first];
+							taken[slot] = true;
+							_keys[slot] = keys[members[idx]];
+							_index[slot] = members[idx];
+						}
+					}
+				}
+				if (!placed) return false;
+			}
+
+			_seed = seed;
+			return true;
+		}
+
+	public:
+
+		/*
+		 * Builds the table for <keys>.
+		 *
+		 * @param <keys> - Distinct keys; a key's position is its index
+		 *
+		 * @exception std::invalid_argument - Duplicate keys, or no seed found
+		 */
+		constexpr explicit perfect_hash(const std::array<std::string_view, N>& keys)
+		{
+			for (uint64_t seed = 0; seed < max_seed; seed++)
+			{
+				*this = perfect_hash();
+				if (this->_build(keys, seed)) return;
+			}
+			throw std::invalid_argument("perfect_hash: construction failed");
+		}
+
+		constexpr perfect_hash() noexcept = default;
+
+		[[nodiscard]] static constexpr size_t size() noexcept
+		{
+			return N;
+		}
+
+		/*
+		 * Returns the slot <key> would occupy (always < N).
+		 * Only meaningful for keys that are in the set.
+		 */
+		[[nodiscard]] size_t slot(std::string_view key) const noexcept
+		{
+			const uint64_t h = hash64::hash(key, _seed);
+			return _slot(h, _displace[_bucket(h)]);
+		}
+
+		[[nodiscard]] constexpr size_t slot_constexpr(std::string_view key) const noexcept
+		{
+			const uint64_t h = hash64::hash_constexpr(key, _seed);
+			return _slot(h, _displace[_bucket(h)]);
+		}
+
+		/*
+		 * Returns the slot of <key>, or npos if <key> is not in the set.
+		 */
+		[[nodiscard]] size_t find_slot(std::string_view key) const noexcept
+		{
+			const size_t s = this->slot(key);
+			return _keys[s] == key ? s : npos;
+		}
+
+		/*
+		 * Returns the index of <key> in the construction list,
+		 * or npos if <key> is not in the set.
+		 */
+		[[nodiscard]] size_t find(std::string_view key) const noexcept
+		{
+			const size_t s = this->slot(key);
+			return _keys[s] == key ? _index[s] : npos;
+		}
+
+		[[nodiscard]] constexpr size_t find_constexpr(std::string_view key) const noexcept
+		{
+			const size_t s = this->slot_constexpr(key);
+			return _keys[s] == key ? _index[s] : npos;
+		}
+
+		[[nodiscard]] bool contains(std::string_view key) const noexcept
+		{
+			return this->find_slot(key) != npos;
+		}
+
+		[[nodiscard]] constexpr std::string_view key_at(size_t slot) const noexcept
+		{
+			return _keys[slot];
+		}
+
+		[[nodiscard]] constexpr size_t index_at(size_t slot) const noexcept
+		{
+			return _index[slot];
+		}
+
+	}; // class perfect_hash
+
+	////////////////////////////////             ////////////////////////////////
+	//------------------------------             ------------------------------//
+	//------------------------------ perfect_map ------------------------------//
+	//------------------------------             ------------------------------//
+	////////////////////////////////             ////////////////////////////////
+
+	/*
+	 * Compile-time string_view -> Value map on top of perfect_hash.
+	 * Values are stored in slot order, so a hit is a single array access.
+	 */
+	template <class Value, size_t N>
+	class perfect_map
+	{
+	public:
+
+		using key_type = std::string_view;
+		using mapped_type = Value;
+		using value_type = std::pair<std::string_view, Value>;
+		using hash_type = perfect_hash<N>;
+
+	protected:
+
+		hash_type _hash;
+		std::array<Value, N> _values{};
+
+		[[nodiscard]] static constexpr std::array<std::string_view, N> _keys_of(const std::array<value_type, N>& items) noexcept
+		{
+			std::array<std::string_view, N> keys{};
+			for (size_t idx = 0; idx < N; idx++) keys[idx] = items[idx].first;
+			return keys;
+		}
+
+	public:
+
+		constexpr explicit perfect_map(const std::array<value_type, N>& items)
+			: _hash(_keys_of(items))
+		{
+			for (size_t slot = 0; slot < N; slot++)
+			{
+				_values[slot] = items[_hash.index_at(slot)].second;
+			}
+		}
+
+		[[nodiscard]] static constexpr size_t size() noexcept
+		{
+			return N;
+		}
+
+		[[nodiscard]] constexpr const hash_type& hash() const noexcept
+		{
+			return _hash;
+		}
+
+		/*
+		 * Returns a pointer to the value of <key>, or nullptr if absent.
+		 */
+		[[nodiscard]] const Value* find(std::string_view key) const noexcept
+		{
+			const size_t slot = _hash.find_slot(key);
+			return slot != hash_type::npos ? &_values[slot] : nullptr;
+		}
+
+		[[nodiscard]] bool contains(std::string_view key) const noexcept
+		{
+			return _hash.contains(key);
+		}
+
+		[[nodiscard]] Value get(std::string_view key, const Value& fallback) const noexcept
+		{
+			const Value* value = this->find(key);
+			return value != nullptr ? *value : fallback;
+		}
+
+		[[nodiscard]] const Value& at(std::string_view key) const
+		{
+			const Value* value = this->find(key);
+			if (value == nullptr) throw std::out_of_range("perfect_map: key not found");
+			return *value;
+		}
+
+		[[nodiscard]] constexpr const Value& at_constexpr(std::string_view key) const
+		{
+			const size_t slot = _hash.slot_constexpr(key);
+			if (_hash.key_at(slot) != key) throw std::out_of_range("perfect_map: key not found");
+			return _values[slot];
+		}
+
+		//-------------------- slot iteration --------------------//
+
+		[[nodiscard]] constexpr std::string_view key_at(size_t slot) const noexcept
+		{
+			return _hash.key_at(slot);
+		}
+
+		[[nodiscard]] constexpr const Value& value_at(size_t slot) const noexcept
+		{
+			return _values[slot];
+		}
+
+	}; // class perfect_map
+
+	//-------------------- factories --------------------//
+
+	/*
+	 * constexpr auto keywords = nw::make_perfect_hash({ "let", "if", "else" });
+	 * switch (keywords.find(token)) { case 0: ...; case perfect_hash<3>::npos: ... }
+	 */
+	template <size_t N>
+	[[nodiscard]] constexpr perfect_hash<N> make_perfect_hash(const std::string_view (&keys)[N])
+	{
+		std::array<std::string_view, N> list{};
+		for (size_t idx = 0; idx < N; idx++) list[idx] = keys[idx];
+		return perfect_hash<N>(list);
+	}
+
+	/*
+	 * constexpr auto commands = nw::make_perfect_map<int>({ { "add", 1 }, { "del", 2 } });
+	 */
+	template <class Value, size_t N>
+	[[nodiscard]] constexpr perfect_map<Value, N> make_perfect_map(const std::pair<std::string_view, Value> (&items)[N])
+	{
+		std::array<std::pair<std::string_view, Value>, N> list{};
+		for (size_t idx = 0; idx < N; idx++)
+		{
+			list[idx].first = items[idx].first;
+			list[idx].second = items[idx].second;
+		}
+		return perfect_map<Value, N>(list);
+	}
+
+} // namespace nw
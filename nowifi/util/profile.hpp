@@ -0,0 +1,543 @@
+#pragma once
+
+#include <nowifi/util/perf.hpp>
+#include <nowifi/util/time.hpp>
+#include <nowifi/math/bitwise.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+/*
+ * NW_PROFILE_SCOPE("name") times the rest of the enclosing block into the
+ * per-thread histogram of scope "name". Define NW_PROFILE_DISABLE to
+ * compile every scope out.
+ *
+ *   void parse(...)
+ *   {
+ *       NW_PROFILE_SCOPE("parse");
+ *       ...
+ *   }
+ *   nw::profile::Registry::instance().print(std::cout);
+ *
+ * Registry::enable_counters() adds hardware counts (IPC, cache, branch
+ * and TLB misses) per scope where perf_event_open is usable.
+ */
+#define NW_PROFILE_CONCAT_IMPL(a, b) a##b
+#define NW_PROFILE_CONCAT(a, b) NW_PROFILE_CONCAT_IMPL(a, b)
+
+#if defined(NW_PROFILE_DISABLE)
+#define NW_PROFILE_SCOPE(name) static_cast<void>(0)
+#else
+#define NW_PROFILE_SCOPE(name) \
+	static const size_t NW_PROFILE_CONCAT(_nw_profile_id_, __LINE__) = ::nw::profile::Registry::instance().scope(name); \
+	const ::nw::profile::ScopedTimer NW_PROFILE_CONCAT(_nw_profile_timer_, __LINE__)(NW_PROFILE_CONCAT(_nw_profile_id_, __LINE__))
+#endif
+
+namespace nw {
+
+	namespace profile {
+
+		////////////////////////////////                  ////////////////////////////////
+		//------------------------------                  ------------------------------//
+		//------------------------------ LatencyHistogram ------------------------------//
+		//------------------------------                  ------------------------------//
+		////////////////////////////////                  ////////////////////////////////
+
+		/*
+		 * Log-linear (HDR-style) histogram of tick counts: exact below 32,
+		 * then 32 linear sub-buckets per power of two, so any reported
+		 * quantile is within 1/32 (~3%) of the true value over the full
+		 * 64-bit range with a fixed 1920 buckets.
+		 *
+		 * record() has a single writer (the owning thread); counters are
+		 * relaxed atomics so readers may merge concurrently without locks.
+		 */
+		class LatencyHistogram
+		{
+		public:
+
+			static constexpr int sub_bits = 5;
+			static constexpr size_t sub_count = size_t(1) << sub_bits;
+			static constexpr size_t bucket_count = (64 - sub_bits + 1) * sub_count;
+
+			static size_t bucket(uint64_t value) noexcept
+			{
+				if (value < sub_count) return static_cast<size_t>(value);
+				const int msb = 63 - Bitwise::countl_zero(value);
+				const int shift = msb - sub_bits;
+				return static_cast<size_t>(shift + 1) * sub_count + static_cast<size_t>((value >> shift) - sub_count);
+			}
+
+			static uint64_t bucket_low(size_t idx) noexcept
+			{
+				if (idx < sub_count) return idx;
+				const int shift = static_cast<int>(idx / sub_count) - 1;
+				return (sub_count + idx % sub_count) << shift;
+			}
+
+			static uint64_t bucket_high(size_t idx) noexcept
+			{
+				if (idx < sub_count) return idx;
+				const int shift = static_cast<int>(idx / sub_count) - 1;
+				return bucket_low(idx) + ((uint64_t(1) << shift) - 1);
+			}
+
+		protected:
+
+			std::atomic<uint64_t> _counts[bucket_count];
+			std::atomic<uint64_t> _count;
+			std::atomic<uint64_t> _sum;
+			std::atomic<uint64_t> _min;
+			std::atomic<uint64_t> _max;
+
+			// Single-writer increment: plain load/add/store, no locked instruction
+			static void _add(std::atomic<uint64_t>& counter, uint64_t value) noexcept
+			{
+				counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+			}
+
+		public:
+
+			LatencyHistogram() noexcept
+			{
+				this->reset();
+			}
+
+			LatencyHistogram(const LatencyHistogram&) = delete;
+			LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+			void reset() noexcept
+			{
+				for (std::atomic<uint64_t>& counter : _counts) counter.store(0, std::memory_order_relaxed);
+				_count.store(0, std::memory_order_relaxed);
+				_sum.store(0, std::memory_order_relaxed);
+				_min.store(UINT64_MAX, std::memory_order_relaxed);
+				_max.store(0, std::memory_order_relaxed);
+			}
+
+			void record(uint64_t value) noexcept
+			{
+				_add(_counts[bucket(value)], 1);
+				_add(_count, 1);
+				_add(_sum, value);
+				if (value < _min.load(std::memory_order_relaxed)) _min.store(value, std::memory_order_relaxed);
+				if (value > _max.load(std::memory_order_relaxed)) _max.store(value, std::memory_order_relaxed);
+			}
+
+			/*
+			 * Adds <second> into this histogram (this one must not be
+			 * written by another thread meanwhile).
+			 */
+			void merge(const LatencyHistogram& second) noexcept
+			{
+				for (size_t idx = 0; idx < bucket_count; idx++) _add(_counts[idx], second._counts[idx].load(std::memory_order_relaxed));
+				_add(_count, second._count.load(std::memory_order_relaxed));
+				_add(_sum, second._sum.load(std::memory_order_relaxed));
+				_min.store(std::min(this->min(), second.min()), std::memory_order_relaxed);
+				_max.store(std::max(this->max(), second.max()), std::memory_order_relaxed);
+			}
+
+			[[nodiscard]] uint64_t count() const noexcept { return _count.load(std::memory_order_relaxed); }
+			[[nodiscard]] uint64_t sum() const noexcept { return _sum.load(std::memory_order_relaxed); }
+			[[nodiscard]] uint64_t min() const noexcept { return _min.load(std::memory_order_relaxed); }
+			[[nodiscard]] uint64_t max() const noexcept { return _max.load(std::memory_order_relaxed); }
+
+			[[nodiscard]] double mean() const noexcept
+			{
+				const uint64_t items = this->count();
+				return items == 0 ? 0.0 : static_cast<double>(this->sum()) / static_cast<double>(items);
+			}
+
+			/*
+			 * @param <q> - Quantile in [0, 1]
+			 * @return Midpoint of the bucket holding the q-th value, clamped to [min, max]; 0 if empty
+			 */
+			[[nodiscard]] uint64_t quantile(double q) const noexcept
+			{
+				const uint64_t items = this->count();
+				if (items == 0) return 0;
+				const double wanted = q * static_cast<double>(items);
+				const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(wanted) + (wanted > static_cast<double>(static_cast<uint64_t>(wanted)) ? 1 : 0));
+
+				uint64_t seen = 0;
+				for (size_t idx = 0; idx < bucket_count; idx++)
+				{
+					seen += _counts[idx].load(std::memory_order_relaxed);
+					if (seen >= rank)
+					{
+						const uint64_t middle = bucket_low(idx) + (bucket_high(idx) - bucket_low(idx)) / 2;
+						return std::min(std::max(middle, this->min()), this->max());
+					}
+				}
+				return this->max();
+			}
+
+		}; // class LatencyHistogram
+
+		//-------------------- Registry --------------------//
+
+		struct scope_report
+		{
+			std::string name;
+			uint64_t count;
+			double total_ns;
+			double mean_ns;
+			double min_ns;
+			double p50_ns;
+			double p90_ns;
+			double p99_ns;
+			double p999_ns;
+			double max_ns;
+			perf::sample counters; // summed over calls, empty unless counting
+
+			[[nodiscard]] double per_call(perf::event type) const noexcept
+			{
+				return count == 0 ? 0 : static_cast<double>(counters[type]) / static_cast<double>(count);
+			}
+		};
+
+		/*
+		 * Named scopes and the per-thread histograms behind them.
+		 *
+		 * Each thread owns one slot table; record() touches only the
+		 * calling thread's histogram, so the hot path takes no lock and
+		 * shares no cache line. Tables are owned by the registry and
+		 * outlive their threads, so report() includes finished workers.
+		 */
+		class Registry
+		{
+		public:
+
+			static constexpr size_t max_scopes = 1024;
+
+		protected:
+
+			// Single-writer event totals of one scope on one thread
+			struct _scope_counters
+			{
+				std::atomic<uint64_t> values[perf::event_count];
+				std::atomic<uint32_t> valid;
+
+				_scope_counters() noexcept
+				{
+					this->reset();
+				}
+
+				void reset() noexcept
+				{
+					for (std::atomic<uint64_t>& value : values) value.store(0, std::memory_order_relaxed);
+					valid.store(0, std::memory_order_relaxed);
+				}
+			};
+
+			struct _thread_slots
+			{
+				std::atomic<LatencyHistogram*> slots[max_scopes];
+				std::atomic<_scope_counters*> counter_slots[max_scopes];
+				std::unique_ptr<perf::Counters> counters; // opened by the owning thread on first counted scope
+
+				_thread_slots() noexcept
+				{
+					for (std::atomic<LatencyHistogram*>& slot : slots) slot.store(nullptr, std::memory_order_relaxed);
+					for (std::atomic<_scope_counters*>& slot : counter_slots) slot.store(nullptr, std::memory_order_relaxed);
+				}
+
+				~_thread_slots()
+				{
+					for (std::atomic<LatencyHistogram*>& slot : slots) delete slot.load(std::memory_order_relaxed);
+					for (std::atomic<_scope_counters*>& slot : counter_slots) delete slot.load(std::memory_order_relaxed);
+				}
+			};
+
+			mutable std::mutex _mutex;
+			std::vector<std::string> _names;
+			std::vector<std::unique_ptr<_thread_slots>> _threads;
+			std::atomic<bool> _counting{ false };
+
+			Registry() = default;
+
+			_thread_slots& _local()
+			{
+				thread_local _thread_slots* local = nullptr;
+				if (local == nullptr)
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					_threads.push_back(std::make_unique<_thread_slots>());
+					local = _threads.back().get();
+				}
+				return *local;
+			}
+
+		public:
+
+			Registry(const Registry&) = delete;
+			Registry& operator=(const Registry&) = delete;
+
+			static Registry& instance()
+			{
+				static Registry registry;
+				return registry;
+			}
+
+			/*
+			 * Id of scope <name>, registering it on first use.
+			 *
+			 * @exception std::length_error - More than max_scopes names
+			 */
+			size_t scope(const std::string& name)
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				const auto found = std::find(_names.begin(), _names.end(), name);
+				if (found != _names.end()) return static_cast<size_t>(found - _names.begin());
+				if (_names.size() == max_scopes) throw std::length_error("profile::Registry: too many scopes");
+				_names.push_back(name);
+				return _names.size() - 1;
+			}
+
+			/*
+			 * Records <ticks> (tsc::read() units) for scope <id> on the calling thread.
+			 */
+			void record(size_t id, uint64_t ticks)
+			{
+				std::atomic<LatencyHistogram*>& slot = this->_local().slots[id];
+				LatencyHistogram* histogram = slot.load(std::memory_order_relaxed);
+				if (histogram == nullptr)
+				{
+					histogram = new LatencyHistogram();
+					slot.store(histogram, std::memory_order_release);
+				}
+				histogram->record(ticks);
+			}
+
+			/*
+			 * Counts hardware events in every scope from now on (or stops, for
+			 * <enable> false). Each counted scope costs two extra read()
+			 * syscalls, so expect around a microsecond per scope instead of tens of ns.
+			 *
+			 * @return Whether counters are available; if not, scopes stay timing-only
+			 */
+			bool enable_counters(bool enable = true)
+			{
+				const bool available = perf::supported();
+				_counting.store(enable && available, std::memory_order_relaxed);
+				return available;
+			}
+
+			[[nodiscard]] bool counting() const noexcept
+			{
+				return _counting.load(std::memory_order_relaxed);
+			}
+
+			/*
+			 * Counter group of the calling thread, started on first use and left
+			 * running; nullptr if it could not be opened.
+			 */
+			perf::Counters* thread_counters()
+			{
+				_thread_slots& local = this->_local();
+				if (!local.counters)
+				{
+					local.counters = std::make_unique<perf::Counters>();
+					local.counters->start();
+				}
+				return local.counters->available() ? local.counters.get() : nullptr;
+			}
+
+			/*
+			 * Adds event counts <delta> to scope <id> on the calling thread.
+			 */
+			void record_counters(size_t id, const perf::sample& delta)
+			{
+				std::atomic<_scope_counters*>& slot = this->_local().counter_slots[id];
+				_scope_counters* totals = slot.load(std::memory_order_relaxed);
+				if (totals == nullptr)
+				{
+					totals = new _scope_counters();
+					slot.store(totals, std::memory_order_release);
+				}
+				for (size_t idx = 0; idx < perf::event_count; idx++)
+				{
+					totals->values[idx].store(totals->values[idx].load(std::memory_order_relaxed) + delta.values[idx], std::memory_order_relaxed);
+				}
+				totals->valid.store(totals->valid.load(std::memory_order_relaxed) | delta.valid, std::memory_order_relaxed);
+			}
+
+			/*
+			 * Merges every thread's histogram of scope <id> into <out> (ticks).
+			 */
+			void collect(size_t id, LatencyHistogram& out) const
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				for (const auto& thread : _threads)
+				{
+					const LatencyHistogram* histogram = thread->slots[id].load(std::memory_order_acquire);
+					if (histogram != nullptr) out.merge(*histogram);
+				}
+			}
+
+			/*
+			 * Sum of every thread's event counts for scope <id>.
+			 */
+			[[nodiscard]] perf::sample collect_counters(size_t id) const
+			{
+				perf::sample result;
+				std::lock_guard<std::mutex> lock(_mutex);
+				for (const auto& thread : _threads)
+				{
+					const _scope_counters* totals = thread->counter_slots[id].load(std::memory_order_acquire);
+					if (totals == nullptr) continue;
+					for (size_t idx = 0; idx < perf::event_count; idx++) result.values[idx] += totals->values[idx].load(std::memory_order_relaxed);
+					result.valid |= totals->valid.load(std::memory_order_relaxed);
+				}
+				return result;
+			}
+
+			/*
+			 * Per-scope totals and quantiles in nanoseconds, scopes that never ran skipped.
+			 */
+			[[nodiscard]] std::vector<scope_report> report() const
+			{
+				std::vector<std::string> names;
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					names = _names;
+				}
+
+				std::vector<scope_report> result;
+				const auto merged = std::make_unique<LatencyHistogram>();
+				for (size_t id = 0; id < names.size(); id++)
+				{
+					merged->reset();
+					this->collect(id, *merged);
+					if (merged->count() == 0) continue;
+					result.push_back(scope_report{ names[id], merged->count(),
+						tsc::to_ns(merged->sum()), merged->mean() * tsc::ns_per_tick(), tsc::to_ns(merged->min()),
+						tsc::to_ns(merged->quantile(0.5)), tsc::to_ns(merged->quantile(0.9)), tsc::to_ns(merged->quantile(0.99)),
+						tsc::to_ns(merged->quantile(0.999)), tsc::to_ns(merged->max()), this->collect_counters(id) });
+				}
+				return result;
+			}
+
+			/*
+			 * One aligned row per scope, slowest total first.
+			 */
+			void print(std::ostream& os) const
+			{
+				std::vector<scope_report> rows = this->report();
+				std::sort(rows.begin(), rows.end(), [](const scope_report& lhs, const scope_report& rhs) { return lhs.total_ns > rhs.total_ns; });
+
+				size_t width = 5;
+				bool counted = false;
+				for (const scope_report& row : rows)
+				{
+					width = std::max(width, row.name.size());
+					counted = counted || row.counters.valid != 0;
+				}
+
+				// Misses per call, after IPC
+				constexpr perf::event events[] = { perf::event::cache_misses, perf::event::branch_misses, perf::event::dtlb_misses, perf::event::itlb_misses };
+				constexpr const char* headers[] = { "llc miss", "br miss", "dtlb miss", "itlb miss" };
+
+				const std::ios_base::fmtflags flags = os.flags();
+				os << std::left << std::setw(static_cast<int>(width)) << "scope" << std::right
+					<< std::setw(12) << "count" << std::setw(12) << "total ms" << std::setw(10) << "mean ns"
+					<< std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << std::setw(10) << "p999 ns" << std::setw(12) << "max ns";
+				if (counted)
+				{
+					os << std::setw(8) << "ipc";
+					for (const char* header : headers) os << std::setw(11) << header;
+				}
+				os << '\n';
+				os << std::fixed << std::setprecision(1);
+				for (const scope_report& row : rows)
+				{
+					os << std::left << std::setw(static_cast<int>(width)) << row.name << std::right
+						<< std::setw(12) << row.count << std::setw(12) << row.total_ns / 1e6 << std::setw(10) << row.mean_ns
+						<< std::setw(10) << row.p50_ns << std::setw(10) << row.p99_ns << std::setw(10) << row.p999_ns << std::setw(12) << row.max_ns;
+					if (counted)
+					{
+						os << std::setprecision(2) << std::setw(8) << row.counters.ipc();
+						for (perf::event type : events)
+						{
+							if (row.counters.has(type)) os << std::setw(11) << row.per_call(type);
+							else os << std::setw(11) << '-';
+						}
+						os << std::setprecision(1);
+					}
+					os << '\n';
+				}
+				os.flags(flags);
+			}
+
+			/*
+			 * Clears all histograms and event counts; call while no scope is running.
+			 */
+			void reset()
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				for (const auto& thread : _threads)
+				{
+					for (std::atomic<LatencyHistogram*>& slot : thread->slots)
+					{
+						LatencyHistogram* histogram = slot.load(std::memory_order_acquire);
+						if (histogram != nullptr) histogram->reset();
+					}
+					for (std::atomic<_scope_counters*>& slot : thread->counter_slots)
+					{
+						_scope_counters* totals = slot.load(std::memory_order_acquire);
+						if (totals != nullptr) totals->reset();
+					}
+				}
+			}
+
+		}; // class Registry
+
+		//-------------------- ScopedTimer --------------------//
+
+		class ScopedTimer
+		{
+		protected:
+
+			size_t _id;
+			perf::Counters* _counters = nullptr;
+			perf::sample _begin;
+			uint64_t _start;
+
+		public:
+
+			explicit ScopedTimer(size_t id)
+				: _id(id)
+			{
+				Registry& registry = Registry::instance();
+				if (registry.counting())
+				{
+					_counters = registry.thread_counters();
+					if (_counters != nullptr) _begin = _counters->read();
+				}
+				_start = tsc::read();
+			}
+
+			ScopedTimer(const ScopedTimer&) = delete;
+			ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+			~ScopedTimer()
+			{
+				const uint64_t ticks = tsc::read_ordered() - _start;
+				Registry& registry = Registry::instance();
+				registry.record(_id, ticks);
+				if (_counters != nullptr) registry.record_counters(_id, _counters->read() - _begin);
+			}
+
+		}; // class ScopedTimer
+
+	} // namespace profile
+
+} // namespace nw
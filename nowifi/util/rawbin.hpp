@@ -1,37 +1,48 @@
 #pragma once
 
+#include <nowifi/io/binary.hpp>
+
 #include <memory>
 #include <string>
+#include <cstring>
 
 using BYTE = unsigned char;
 
+/*
+ * Raw native-order copies of trivially copyable values.
+ * Kept for existing callers; new code should use nw::BinaryWriter /
+ * nw::BinaryReader (nowifi/io/binary.hpp), which add byte order,
+ * alignment, bounds checks and in-place views.
+ */
 template <class Ty>
 class RawBin {
 
+	static_assert(std::is_trivially_copyable<Ty>::value, "RawBin: trivially copyable types only");
+
 public:
 
 	RawBin() = delete;
 	RawBin(const RawBin&) = delete;
 
 	static void arr_to_byte(BYTE* dst, const Ty* data, const size_t size) {
-		memcpy(dst, data, sizeof data * size);
+		memcpy(dst, data, sizeof(Ty) * size);
 	}
 
-	static std::unique_ptr<BYTE> arr_to_byte(const Ty* data, const size_t size) {
-		BYTE* result = new BYTE[size];
-		arr_to_byte(result, data, size);
-		return std::make_unique<BYTE>(result);
+	static std::unique_ptr<BYTE[]> arr_to_byte(const Ty* data, const size_t size) {
+		std::unique_ptr<BYTE[]> result(new BYTE[sizeof(Ty) * size]);
+		arr_to_byte(result.get(), data, size);
+		return result;
 	}
 
 	static std::string arr_to_string(const Ty* data, const size_t size) {
-		return std::string(RawBin::arr_to_byte(data, size).get(), sizeof data[0] * size);
+		return std::string(reinterpret_cast<const char*>(data), sizeof(Ty) * size);
 	}
 
 	static void to_byte(BYTE* dst, const Ty& data) {
 		arr_to_byte(dst, &data, 1);
 	}
 
-	static std::unique_ptr<BYTE> to_byte(const Ty& data) {
+	static std::unique_ptr<BYTE[]> to_byte(const Ty& data) {
 		return arr_to_byte(&data, 1);
 	}
 
@@ -42,17 +53,17 @@ public:
 
 
 	static void arr_from_byte(Ty* dst, const BYTE* bytes, const size_t size) {
-		memcpy(dst, bytes, size * sizeof size);
+		memcpy(dst, bytes, sizeof(Ty) * size);
 	}
 
-	static std::unique_ptr<Ty> arr_from_byte(const BYTE* bytes, const size_t size) {
-		Ty* result = new Ty[size];
-		arr_from_byte(result, bytes, size);
-		return std::make_unique<Ty>(result);
+	static std::unique_ptr<Ty[]> arr_from_byte(const BYTE* bytes, const size_t size) {
+		std::unique_ptr<Ty[]> result(new Ty[size]);
+		arr_from_byte(result.get(), bytes, size);
+		return result;
 	}
 
 	static void arr_from_string(Ty* dst, const std::string& bytes, const size_t size) {
-		arr_from_byte(dst, bytes.c_str(), size);
+		arr_from_byte(dst, reinterpret_cast<const BYTE*>(bytes.data()), size);
 	}
 
 	static void from_byte(Ty& dst, const BYTE* bytes) {
@@ -60,6 +71,6 @@ public:
 	}
 
 	static void from_string(Ty& dst, const std::string& bytes) {
-		from_byte(dst, bytes.c_str());
+		from_byte(dst, reinterpret_cast<const BYTE*>(bytes.data()));
 	}
-};
\ No newline at end of file
+};
@@ -0,0 +1,387 @@
+#pragma once
+
+#include <nowifi/math/bitwise.hpp>
+
+#include <array>
+#include <algorithm>
+#include <memory>
+#include <iterator>
+#include <utility>
+#include <stdexcept>
+#include <cstdint>
+
+namespace nw {
+
+	namespace _ring {
+
+		[[nodiscard]] constexpr size_t storage_size(size_t capacity) noexcept
+		{
+			size_t result = 1;
+			while (result < capacity) result <<= 1;
+			return result;
+		}
+
+		// Compile-time capacity: inline power-of-two array
+		template <class Ty, size_t N>
+		struct storage
+		{
+			static constexpr size_t _mask = storage_size(N) - 1;
+			std::array<Ty, storage_size(N)> _data{};
+
+			storage() = default;
+
+			[[nodiscard]] static constexpr size_t capacity() noexcept { return N; }
+			[[nodiscard]] static constexpr size_t mask() noexcept { return _mask; }
+			[[nodiscard]] Ty* data() noexcept { return _data.data(); }
+			[[nodiscard]] const Ty* data() const noexcept { return _data.data(); }
+		};
+
+		// Runtime capacity: heap power-of-two array
+		template <class Ty>
+		struct storage<Ty, 0>
+		{
+			std::unique_ptr<Ty[]> _data;
+			size_t _capacity = 0;
+			size_t _mask = 0;
+
+			storage() = default;
+
+			explicit storage(size_t capacity)
+				: _data(new Ty[Bitwise::bit_ceil(capacity == 0 ? 1 : capacity)]()),
+				  _capacity(capacity == 0 ? 1 : capacity),
+				  _mask(Bitwise::bit_ceil(_capacity) - 1) { }
+
+			storage(const storage& second)
+				: storage(second._capacity)
+			{
+				std::copy(second._data.get(), second._data.get() + _mask + 1, _data.get());
+			}
+
+			storage& operator=(const storage& second)
+			{
+				if (this != &second) *this = storage(second);
+				return *this;
+			}
+
+			storage(storage&&) noexcept = default;
+			storage& operator=(storage&&) noexcept = default;
+
+			[[nodiscard]] size_t capacity() const noexcept { return _capacity; }
+			[[nodiscard]] size_t mask() const noexcept { return _mask; }
+			[[nodiscard]] Ty* data() noexcept { return _data.get(); }
+			[[nodiscard]] const Ty* data() const noexcept { return _data.get(); }
+		};
+
+	} // namespace _ring
+
+	////////////////////////////////             ////////////////////////////////
+	//------------------------------             ------------------------------//
+	//------------------------------ ring_buffer ------------------------------//
+	//------------------------------             ------------------------------//
+	////////////////////////////////             ////////////////////////////////
+
+	/*
+	 * Fixed-capacity circular buffer over contiguous power-of-two storage.
+	 *
+	 *   ring_buffer<int, 16> last16;      // capacity fixed at compile time
+	 *   ring_buffer<int> lastN(n);        // capacity fixed at construction
+	 *
+	 * push_back() on a full buffer overwrites the oldest element, so the
+	 * buffer always holds the latest capacity() values; nothing allocates
+	 * after construction. Index 0 is the oldest element.
+	 *
+	 * Ty must be default-constructible: slots are constructed once and
+	 * assigned on every push. Popped slots keep their moved-from value.
+	 */
+	template <class Ty, size_t N = 0>
+	class ring_buffer
+	{
+	public:
+
+		using value_type = Ty;
+		using size_type = size_t;
+		using reference = Ty&;
+		using const_reference = const Ty&;
+
+		// Contiguous run of elements, oldest first
+		template <class ValTy>
+		struct basic_segment
+		{
+			ValTy* data;
+			size_t size;
+
+			[[nodiscard]] ValTy* begin() const noexcept { return data; }
+			[[nodiscard]] ValTy* end() const noexcept { return data + size; }
+			[[nodiscard]] bool empty() const noexcept { return size == 0; }
+			[[nodiscard]] ValTy& operator[](size_t idx) const noexcept { return data[idx]; }
+		};
+
+		using segment = basic_segment<Ty>;
+		using const_segment = basic_segment<const Ty>;
+
+		template <class ValTy, class RingTy>
+		class basic_iterator
+		{
+		public:
+
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = std::remove_const_t<ValTy>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = ValTy*;
+			using reference = ValTy&;
+
+			basic_iterator() = default;
+			basic_iterator(RingTy* ring, size_t idx) noexcept : _ring(ring), _idx(idx) { }
+
+			[[nodiscard]] reference operator*() const noexcept { return (*_ring)[_idx]; }
+			[[nodiscard]] pointer operator->() const noexcept { return &(*_ring)[_idx]; }
+			[[nodiscard]] reference operator[](difference_type off) const noexcept { return (*_ring)[_idx + off]; }
+
+			basic_iterator& operator++() noexcept { ++_idx; return *this; }
+			basic_iterator& operator--() noexcept { --_idx; return *this; }
+			basic_iterator operator++(int) noexcept { basic_iterator prev = *this; ++_idx; return prev; }
+			basic_iterator operator--(int) noexcept { basic_iterator prev = *this; --_idx; return prev; }
+			basic_iterator& operator+=(difference_type off) noexcept { _idx += off; return *this; }
+			basic_iterator& operator-=(difference_type off) noexcept { _idx -= off; return *this; }
+
+			[[nodiscard]] basic_iterator operator+(difference_type off) const noexcept { return basic_iterator(_ring, _idx + off); }
+			[[nodiscard]] basic_iterator operator-(difference_type off) const noexcept { return basic_iterator(_ring, _idx - off); }
+			[[nodiscard]] difference_type operator-(const basic_iterator& second) const noexcept
+			{
+				return static_cast<difference_type>(_idx) - static_cast<difference_type>(second._idx);
+			}
+
+			[[nodiscard]] bool operator==(const basic_iterator& second) const noexcept { return _idx == second._idx; }
+			[[nodiscard]] bool operator!=(const basic_iterator& second) const noexcept { return _idx != second._idx; }
+			[[nodiscard]] bool operator<(const basic_iterator& second) const noexcept { return _idx < second._idx; }
+			[[nodiscard]] bool operator>(const basic_iterator& second) const noexcept { return _idx > second._idx; }
+			[[nodiscard]] bool operator<=(const basic_iterator& second) const noexcept { return _idx <= second._idx; }
+			[[nodiscard]] bool operator>=(const basic_iterator& second) const noexcept { return _idx >= second._idx; }
+
+		protected:
+
+			RingTy* _ring = nullptr;
+			size_t _idx = 0;
+		};
+
+		using iterator = basic_iterator<Ty, ring_buffer>;
+		using const_iterator = basic_iterator<const Ty, const ring_buffer>;
+
+	protected:
+
+		_ring::storage<Ty, N> _storage;
+		size_t _head = 0; // storage index of the oldest element
+		size_t _size = 0;
+
+		[[nodiscard]] size_t _pos(size_t idx) const noexcept
+		{
+			return (_head + idx) & _storage.mask();
+		}
+
+	public:
+
+		//-------------------- CONSTRUCTOR --------------------//
+
+		ring_buffer() = default;
+
+		/*
+		 * @param <capacity> - Number of elements kept (runtime-capacity buffers only)
+		 */
+		template <size_t M = N, std::enable_if_t<M == 0, int> = 0>
+		explicit ring_buffer(size_t capacity)
+			: _storage(capacity) { }
+
+		//-------------------- capacity --------------------//
+
+		[[nodiscard]] size_t capacity() const noexcept
+		{
+			return _storage.capacity();
+		}
+
+		[[nodiscard]] size_t size() const noexcept
+		{
+			return _size;
+		}
+
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return _size == 0;
+		}
+
+		[[nodiscard]] bool full() const noexcept
+		{
+			return _size == _storage.capacity();
+		}
+
+		void clear() noexcept
+		{
+			_head = 0;
+			_size = 0;
+		}
+
+		//-------------------- push / pop --------------------//
+
+		/*
+		 * Appends <val>; when full, the oldest element is overwritten.
+		 *
+		 * @return true if an element was overwritten
+		 */
+		template <class ValTy>
+		bool push_back(ValTy&& val)
+		{
+			if (this->full())
+			{
+				if (_size == 0) return true; // default-constructed runtime buffer
+				_storage.data()[this->_pos(_size)] = std::forward<ValTy>(val);
+				_head = (_head + 1) & _storage.mask();
+				return true;
+			}
+			_storage.data()[this->_pos(_size++)] = std::forward<ValTy>(val);
+			return false;
+		}
+
+		/*
+		 * Prepends <val>; when full, the newest element is overwritten.
+		 *
+		 * @return true if an element was overwritten
+		 */
+		template <class ValTy>
+		bool push_front(ValTy&& val)
+		{
+			const bool overwrite = this->full();
+			if (_storage.capacity() == 0) return true;
+			_head = (_head - 1) & _storage.mask();
+			_storage.data()[_head] = std::forward<ValTy>(val);
+			if (!overwrite) _size++;
+			return overwrite;
+		}
+
+		/*
+		 * Removes and returns the oldest element.
+		 *
+		 * @exception std::out_of_range - Empty buffer
+		 */
+		Ty pop_front()
+		{
+			if (_size == 0) throw std::out_of_range("ring_buffer: pop from empty buffer");
+			Ty result = std::move(_storage.data()[_head]);
+			_head = (_head + 1) & _storage.mask();
+			_size--;
+			return result;
+		}
+
+		/*
+		 * Removes and returns the newest element.
+		 *
+		 * @exception std::out_of_range - Empty buffer
+		 */
+		Ty pop_back()
+		{
+			if (_size == 0) throw std::out_of_range("ring_buffer: pop from empty buffer");
+			return std::move(_storage.data()[this->_pos(--_size)]);
+		}
+
+		// Drops the <count> oldest elements
+		void drop_front(size_t count) noexcept
+		{
+			if (count > _size) count = _size;
+			_head = (_head + count) & _storage.mask();
+			_size -= count;
+		}
+
+		// Drops the <count> newest elements
+		void drop_back(size_t count) noexcept
+		{
+			_size -= count > _size ? _size : count;
+		}
+
+		//-------------------- access --------------------//
+
+		[[nodiscard]] Ty& operator[](size_t idx) noexcept
+		{
+			return _storage.data()[this->_pos(idx)];
+		}
+
+		[[nodiscard]] const Ty& operator[](size_t idx) const noexcept
+		{
+			return _storage.data()[this->_pos(idx)];
+		}
+
+		[[nodiscard]] Ty& at(size_t idx)
+		{
+			if (idx >= _size) throw std::out_of_range("ring_buffer: index out of range");
+			return (*this)[idx];
+		}
+
+		[[nodiscard]] const Ty& at(size_t idx) const
+		{
+			if (idx >= _size) throw std::out_of_range("ring_buffer: index out of range");
+			return (*this)[idx];
+		}
+
+		[[nodiscard]] Ty& front() noexcept { return (*this)[0]; }
+		[[nodiscard]] const Ty& front() const noexcept { return (*this)[0]; }
+		[[nodiscard]] Ty& back() noexcept { return (*this)[_size - 1]; }
+		[[nodiscard]] const Ty& back() const noexcept { return (*this)[_size - 1]; }
+
+		//-------------------- contiguous views --------------------//
+
+		/*
+		 * Returns the contents as at most two contiguous runs, oldest first:
+		 * first.size + second.size == size(), second is empty unless the
+		 * elements wrap around the end of storage.
+		 *
+		 *   auto [first, second] = ring.spans();
+		 *   sum = std::accumulate(first.begin(), first.end(), 0);
+		 *   sum = std::accumulate(second.begin(), second.end(), sum);
+		 */
+		[[nodiscard]] std::pair<segment, segment> spans() noexcept
+		{
+			const size_t tail = _storage.mask() + 1 - _head;
+			Ty* data = _storage.data();
+			if (_size <= tail) return { segment{ data + _head, _size }, segment{ data, 0 } };
+			return { segment{ data + _head, tail }, segment{ data, _size - tail } };
+		}
+
+		[[nodiscard]] std::pair<const_segment, const_segment> spans() const noexcept
+		{
+			const size_t tail = _storage.mask() + 1 - _head;
+			const Ty* data = _storage.data();
+			if (_size <= tail) return { const_segment{ data + _head, _size }, const_segment{ data, 0 } };
+			return { const_segment{ data + _head, tail }, const_segment{ data, _size - tail } };
+		}
+
+		/*
+		 * Calls <fn> on every element, oldest first, without per-element masking.
+		 */
+		template <class Function>
+		void for_each(Function fn) const
+		{
+			const auto views = this->spans();
+			for (const Ty& val : views.first) fn(val);
+			for (const Ty& val : views.second) fn(val);
+		}
+
+		/*
+		 * Copies the elements, oldest first, to <dest>.
+		 */
+		template <class _OutIt>
+		_OutIt copy_to(_OutIt dest) const
+		{
+			const auto views = this->spans();
+			dest = std::copy(views.first.begin(), views.first.end(), dest);
+			return std::copy(views.second.begin(), views.second.end(), dest);
+		}
+
+		//-------------------- iteration --------------------//
+
+		[[nodiscard]] iterator begin() noexcept { return iterator(this, 0); }
+		[[nodiscard]] iterator end() noexcept { return iterator(this, _size); }
+		[[nodiscard]] const_iterator begin() const noexcept { return const_iterator(this, 0); }
+		[[nodiscard]] const_iterator end() const noexcept { return const_iterator(this, _size); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+		[[nodiscard]] const_iterator cend() const noexcept { return const_iterator(this, _size); }
+
+	}; // class ring_buffer
+
+} // namespace nw
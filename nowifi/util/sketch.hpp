@@ -0,0 +1,545 @@
+#pragma once
+
+#include <nowifi/math/bitwise.hpp>
+#include <nowifi/util/hash.hpp>
+#include <nowifi/util/map/flatMap.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cstdint>
+
+namespace nw {
+
+	////////////////////////////////             ////////////////////////////////
+	//------------------------------             ------------------------------//
+	//------------------------------ HyperLogLog ------------------------------//
+	//------------------------------             ------------------------------//
+	////////////////////////////////             ////////////////////////////////
+
+	/*
+	 * Distinct-count estimator: 2^precision one-byte registers,
+	 * relative standard error ~1.04 / sqrt(2^precision).
+	 */
+	template <class Ty, class _Hasher = hash64::hasher<Ty>>
+	class HyperLogLog
+	{
+	protected:
+
+		std::vector<uint8_t> _registers;
+		unsigned _precision;
+		_Hasher _hash;
+
+	public:
+
+		/*
+		 * @param <precision> - log2 of the register count, 4..18
+		 */
+		explicit HyperLogLog(unsigned precision = 14)
+			: _registers(size_t(1) << precision), _precision(precision)
+		{
+			if (precision < 4 || precision > 18) throw std::invalid_argument("HyperLogLog: precision must be in [4, 18]");
+		}
+
+		/*
+		 * Smallest sketch whose standard error is at most <error> (e.g. 0.01).
+		 */
+		[[nodiscard]] static HyperLogLog from_error(double error)
+		{
+			const double registers = std::ceil((1.04 / error) * (1.04 / error));
+			unsigned precision = 4;
+			while (precision < 18 && static_cast<double>(size_t(1) << precision) < registers) precision++;
+			return HyperLogLog(precision);
+		}
+
+		[[nodiscard]] unsigned precision() const noexcept
+		{
+			return _precision;
+		}
+
+		[[nodiscard]] size_t memory() const noexcept
+		{
+			return _registers.size();
+		}
+
+		void reset() noexcept
+		{
+			std::fill(_registers.begin(), _registers.end(), uint8_t(0));
+		}
+
+		//-------------------- add --------------------//
+
+		void add_hash(uint64_t h) noexcept
+		{
+			const size_t idx = static_cast<size_t>(h >> (64 - _precision));
+			const uint64_t rest = (h << _precision) | (uint64_t(1) << (_precision - 1));
+			const uint8_t rank = static_cast<uint8_t>(Bitwise::countl_zero(rest) + 1);
+			if (_registers[idx] < rank) _registers[idx] = rank;
+		}
+
+		template <class Key>
+		void inc(const Key& val)
+		{
+			this->add_hash(static_cast<uint64_t>(_hash(val)));
+		}
+
+		template <class Key>
+		void add(const Key& val)
+		{
+			this->inc(val);
+		}
+
+		//-------------------- estimate --------------------//
+
+		[[nodiscard]] double estimate() const noexcept
+		{
+			const double m = static_cast<double>(_registers.size());
+			double sum = 0;
+			size_t zeros = 0;
+			for (const uint8_t reg : _registers)
+			{
+				sum += std::ldexp(1.0, -static_cast<int>(reg));
+				if (reg == 0) zeros++;
+			}
+
+			const double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+			const double raw = alpha * m * m / sum;
+
+			// Small-range correction: linear counting
+			if (raw <= 2.5 * m && zeros != 0) return m * std::log(m / static_cast<double>(zeros));
+			return raw;
+		}
+
+		[[nodiscard]] unsigned long long count() const noexcept
+		{
+			return static_cast<unsigned long long>(std::llround(this->estimate()));
+		}
+
+		//-------------------- merge --------------------//
+
+		HyperLogLog& merge(const HyperLogLog& second)
+		{
+			if (second._precision != _precision) throw std::invalid_argument("HyperLogLog: precision mismatch");
+			for (size_t idx = 0; idx < _registers.size(); idx++)
+			{
+				_registers[idx] = (std::max)(_registers[idx], second._registers[idx]);
+			}
+			return *this;
+		}
+
+	}; // class HyperLogLog
+
+	////////////////////////////////                ////////////////////////////////
+	//------------------------------                ------------------------------//
+	//------------------------------ CountMinSketch ------------------------------//
+	//------------------------------                ------------------------------//
+	////////////////////////////////                ////////////////////////////////
+
+	/*
+	 * Frequency estimator with conservative update.
+	 *
+	 * get() never underestimates; with width >= e / epsilon and
+	 * depth >= ln(1 / delta) it overestimates by more than epsilon * total()
+	 * with probability at most delta. Counts must be non-negative.
+	 */
+	template <class Ty, class Counter = uint32_t, class _Hasher = hash64::hasher<Ty>>
+	class CountMinSketch
+	{
+	public:
+
+		using key_type = Ty;
+		using counter_type = Counter;
+		using hasher = _Hasher;
+
+	protected:
+
+		std::vector<Counter> _table;
+		size_t _width;
+		size_t _depth;
+		unsigned long long _total = 0;
+		_Hasher _hash;
+
+		// Kirsch-Mitzenmacher double hashing: row i probes h + i * step
+		[[nodiscard]] static uint64_t _step(uint64_t h) noexcept
+		{
+			return hash64::hash_int(h) | 1;
+		}
+
+		[[nodiscard]] size_t _cell(uint64_t h, uint64_t step, size_t row) const noexcept
+		{
+			return row * _width + static_cast<size_t>((h + row * step) & (_width - 1));
+		}
+
+	public:
+
+		/*
+		 * @param <width> - Counters per row, rounded up to a power of two
+		 * @param <depth> - Number of rows
+		 */
+		CountMinSketch(size_t width, size_t depth)
+			: _width(static_cast<size_t>(Bitwise::bit_ceil(width))), _depth(depth)
+		{
+			if (width == 0 || depth == 0) throw std::invalid_argument("CountMinSketch: empty dimensions");
+			_table.assign(_width * _depth, Counter(0));
+		}
+
+		/*
+		 * @param <epsilon> - Relative overestimate bound (fraction of total())
+		 * @param <delta> - Probability the bound is exceeded
+		 */
+		[[nodiscard]] static CountMinSketch from_error(double epsilon, double delta)
+		{
+			const size_t width = static_cast<size_t>(std::ceil(2.718281828459045 / epsilon));
+			const size_t depth = static_cast<size_t>(std::ceil(std::log(1.0 / delta)));
+			return CountMinSketch(width, (std::max)(depth, size_t(1)));
+		}
+
+		[[nodiscard]] size_t width() const noexcept { return _width; }
+		[[nodiscard]] size_t depth() const noexcept { return _depth; }
+		[[nodiscard]] unsigned long long total() const noexcept { return _total; }
+
+		[[nodiscard]] size_t memory() const noexcept
+		{
+			return _table.size() * sizeof(Counter);
+		}
+
+		void reset() noexcept
+		{
+			std::fill(_table.begin(), _table.end(), Counter(0));
+			_total = 0;
+		}
+
+		//-------------------- add / get --------------------//
+
+		[[nodiscard]] Counter get_hash(uint64_t h) const noexcept
+		{
+			const uint64_t step = _step(h);
+			Counter result = _table[this->_cell(h, step, 0)];
+			for (size_t row = 1; row < _depth; row++)
+			{
+				result = (std::min)(result, _table[this->_cell(h, step, row)]);
+			}
+			return result;
+		}
+
+		void add_hash(uint64_t h, Counter num = 1) noexcept
+		{
+			// Conservative update: raise each row only up to the new estimate
+			const uint64_t step = _step(h);
+			const Counter target = this->get_hash(h) + num;
+			for (size_t row = 0; row < _depth; row++)
+			{
+				Counter& cell = _table[this->_cell(h, step, row)];
+				if (cell < target) cell = target;
+			}
+			_total += num;
+		}
+
+		template <class Key>
+		[[nodiscard]] Counter get(const Key& val) const
+		{
+			return this->get_hash(static_cast<uint64_t>(_hash(val)));
+		}
+
+		template <class Key>
+		void add(const Key& val, Counter num)
+		{
+			this->add_hash(static_cast<uint64_t>(_hash(val)), num);
+		}
+
+		template <class Key>
+		void inc(const Key& val)
+		{
+			this->add(val, Counter(1));
+		}
+
+		//-------------------- merge --------------------//
+
+		// Cell-wise sum: still an upper bound for every key.
+		CountMinSketch& merge(const CountMinSketch& second)
+		{
+			if (second._width != _width || second._depth != _depth) throw std::invalid_argument("CountMinSketch: dimension mismatch");
+			for (size_t idx = 0; idx < _table.size(); idx++) _table[idx] += second._table[idx];
+			_total += second._total;
+			return *this;
+		}
+
+	}; // class CountMinSketch
+
+	////////////////////////////////             ////////////////////////////////
+	//------------------------------             ------------------------------//
+	//------------------------------ SpaceSaving ------------------------------//
+	//------------------------------             ------------------------------//
+	////////////////////////////////             ////////////////////////////////
+
+	/*
+	 * Top-k heavy hitters with at most <capacity> monitored keys.
+	 *
+	 * Every key with true frequency > total() / capacity is monitored;
+	 * a monitored count overestimates by at most its error field.
+	 * The counters form a min-heap so eviction is O(log capacity).
+	 */
+	template <class Ty, class _Hasher = hash64::hasher<Ty>>
+	class SpaceSaving
+	{
+	public:
+
+		struct entry
+		{
+			Ty key;
+			unsigned long long count;
+			unsigned long long error;
+		};
+
+	protected:
+
+		std::vector<entry> _heap;
+		flat_map<Ty, size_t, _Hasher> _position;
+		size_t _capacity;
+		unsigned long long _total = 0;
+
+		void _swap(size_t lhs, size_t rhs)
+		{
+			std::swap(_heap[lhs], _heap[rhs]);
+			_position[_heap[lhs].key] = lhs;
+			_position[_heap[rhs].key] = rhs;
+		}
+
+		void _sift_down(size_t idx)
+		{
+			for (;;)
+			{
+				const size_t left = 2 * idx + 1, right = left + 1;
+				size_t smallest = idx;
+				if (left < _heap.size() && _heap[left].count < _heap[smallest].count) smallest = left;
+				if (right < _heap.size() && _heap[right].count < _heap[smallest].count) smallest = right;
+				if (smallest == idx) return;
+				this->_swap(idx, smallest);
+				idx = smallest;
+			}
+		}
+
+		void _sift_up(size_t idx)
+		{
+			while (idx > 0)
+			{
+				const size_t parent = (idx - 1) / 2;
+				if (_heap[parent].count <= _heap[idx].count) return;
+				this->_swap(idx, parent);
+				idx = parent;
+			}
+		}
+
+	public:
+
+		explicit SpaceSaving(size_t capacity)
+			: _position(capacity), _capacity(capacity)
+		{
+			if (capacity == 0) throw std::invalid_argument("SpaceSaving: capacity must be positive");
+			_heap.reserve(capacity);
+		}
+
+		/*
+		 * Sketch whose per-key overestimate is at most <epsilon> * total().
+		 */
+		[[nodiscard]] static SpaceSaving from_error(double epsilon)
+		{
+			return SpaceSaving(static_cast<size_t>(std::ceil(1.0 / epsilon)));
+		}
+
+		[[nodiscard]] size_t capacity() const noexcept { return _capacity; }
+		[[nodiscard]] size_t size() const noexcept { return _heap.size(); }
+		[[nodiscard]] unsigned long long total() const noexcept { return _total; }
+
+		/*
+		 * Smallest monitored count once full (0 before): the frequency
+		 * bound for any key that is not monitored.
+		 */
+		[[nodiscard]] unsigned long long min_count() const noexcept
+		{
+			return _heap.size() < _capacity || _heap.empty() ? 0 : _heap.front().count;
+		}
+
+		void reset()
+		{
+			_heap.clear();
+			_position.clear();
+			_total = 0;
+		}
+
+		//-------------------- add / get --------------------//
+
+		template <class Key>
+		void add(const Key& val, unsigned long long num)
+		{
+			_total += num;
+			const auto it = _position.find(val);
+			if (it != _position.end())
+			{
+				const size_t idx = it->second;
+				_heap[idx].count += num;
+				this->_sift_down(idx);
+				return;
+			}
+			if (_heap.size() < _capacity)
+			{
+				_heap.push_back(entry{ Ty(val), num, 0 });
+				_position[_heap.back().key] = _heap.size() - 1;
+				this->_sift_up(_heap.size() - 1);
+				return;
+			}
+
+			// Replace the minimum: the newcomer inherits its count as error
+			entry& root = _heap.front();
+			_position.erase(root.key);
+			root.error = root.count;
+			root.count += num;
+			root.key = Ty(val);
+			_position[root.key] = 0;
+			this->_sift_down(0);
+		}
+
+		template <class Key>
+		void inc(const Key& val)
+		{
+			this->add(val, 1);
+		}
+
+		/*
+		 * Returns the estimated count of <val>, or 0 if not monitored.
+		 */
+		template <class Key>
+		[[nodiscard]] unsigned long long get(const Key& val) const
+		{
+			const auto it = _position.find(val);
+			return it == _position.end() ? 0 : _heap[it->second].count;
+		}
+
+		/*
+		 * Returns an upper bound on the true count of <val>.
+		 */
+		template <class Key>
+		[[nodiscard]] unsigned long long upper_bound(const Key& val) const
+		{
+			const auto it = _position.find(val);
+			return it == _position.end() ? this->min_count() : _heap[it->second].count;
+		}
+
+		/*
+		 * Returns up to <num> entries by descending count.
+		 */
+		[[nodiscard]] std::vector<entry> top(size_t num) const
+		{
+			std::vector<entry> result(_heap);
+			std::sort(result.begin(), result.end(), [](const entry& lhs, const entry& rhs)
+			{
+				return lhs.count > rhs.count;
+			});
+			if (result.size() > num) result.resize(num);
+			return result;
+		}
+
+		//-------------------- merge --------------------//
+
+		/*
+		 * Combines two summaries (Cafaro et al.): a key missing from one side
+		 * is charged that side's min_count(), then the largest <capacity>
+		 * counters are kept.
+		 */
+		SpaceSaving& merge(const SpaceSaving& second)
+		{
+			const unsigned long long min_first = this->min_count();
+			const unsigned long long min_second = second.min_count();
+
+			std::vector<entry> combined;
+			combined.reserve(_heap.size() + second._heap.size());
+			for (const entry& item : _heap)
+			{
+				const auto it = second._position.find(item.key);
+				if (it != second._position.end())
+				{
+					const entry& other = second._heap[it->second];
+					combined.push_back(entry{ item.key, item.count + other.count, item.error + other.error });
+				}
+				else
+				{
+					combined.push_back(entry{ item.key, item.count + min_second, item.error + min_second });
+				}
+			}
+			for (const entry& item : second._heap)
+			{
+				if (_position.contains(item.key)) continue;
+				combined.push_back(entry{ item.key, item.count + min_first, item.error + min_first });
+			}
+
+			if (combined.size() > _capacity)
+			{
+				std::nth_element(combined.begin(), combined.begin() + (_capacity - 1), combined.end(), [](const entry& lhs, const entry& rhs)
+				{
+					return lhs.count > rhs.count;
+				});
+				combined.resize(_capacity);
+			}
+
+			const unsigned long long total = _total + second._total;
+			this->reset();
+			_total = total;
+			_heap = std::move(combined);
+			for (size_t idx = 0; idx < _heap.size(); idx++) _position[_heap[idx].key] = idx;
+			for (size_t idx = _heap.size() / 2; idx-- > 0;) this->_sift_down(idx);
+			return *this;
+		}
+
+	}; // class SpaceSaving
+
+	//-------------------- unique:: API --------------------//
+
+	namespace unique {
+
+		template <class Ty, class _Hasher, class Key>
+		void inc(HyperLogLog<Ty, _Hasher>& sketch, const Key& val)
+		{
+			sketch.inc(val);
+		}
+
+		template <class Ty, class Counter, class _Hasher, class Key>
+		Counter get(const CountMinSketch<Ty, Counter, _Hasher>& sketch, const Key& val)
+		{
+			return sketch.get(val);
+		}
+
+		// <num> is not deduced, so literals convert to the sketch's Counter
+		template <class Ty, class Counter, class _Hasher, class Key>
+		void add(CountMinSketch<Ty, Counter, _Hasher>& sketch, const Key& val, typename CountMinSketch<Ty, Counter, _Hasher>::counter_type num)
+		{
+			sketch.add(val, num);
+		}
+
+		template <class Ty, class Counter, class _Hasher, class Key>
+		void inc(CountMinSketch<Ty, Counter, _Hasher>& sketch, const Key& val)
+		{
+			sketch.inc(val);
+		}
+
+		template <class Ty, class _Hasher, class Key>
+		unsigned long long get(const SpaceSaving<Ty, _Hasher>& sketch, const Key& val)
+		{
+			return sketch.get(val);
+		}
+
+		template <class Ty, class _Hasher, class Key>
+		void add(SpaceSaving<Ty, _Hasher>& sketch, const Key& val, unsigned long long num)
+		{
+			sketch.add(val, num);
+		}
+
+		template <class Ty, class _Hasher, class Key>
+		void inc(SpaceSaving<Ty, _Hasher>& sketch, const Key& val)
+		{
+			sketch.inc(val);
+		}
+
+	} // namespace unique
+
+} // namespace nw
@@ -2,6 +2,17 @@
 
 #include <time.h>
 #include <chrono>
+#include <cstdint>
+
+#if !defined(NW_TIME_NO_TSC) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+#define NW_TIME_TSC
+#endif
 
 namespace nw {
 
@@ -27,6 +38,10 @@ namespace nw {
 			return std::chrono::duration_cast<std::chrono::microseconds>(now()).count();
 		}
 
+		static inline long long nowNano() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(now()).count();
+		}
+
 		static inline long long nowMilli() {
 			return std::chrono::duration_cast<std::chrono::milliseconds>(now()).count();
 		}
@@ -36,4 +51,94 @@ namespace nw {
 	using HighresClock = Time<std::chrono::high_resolution_clock>;
 	using SteadyClock = Time<std::chrono::steady_clock>;
 
+	/*
+	 * Time stamp counter: a few ns per read versus tens for Clock::now().
+	 * Used only where CPUID reports an invariant TSC (constant rate through
+	 * frequency and sleep states), checked once at run time; ticks are
+	 * converted with a one-time calibration against steady_clock.
+	 * Without one, on other targets or with NW_TIME_NO_TSC, ticks are
+	 * steady_clock nanoseconds.
+	 */
+	namespace tsc {
+
+		inline uint64_t _steady_ns() noexcept
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+		}
+
+#if defined(NW_TIME_TSC)
+		// CPUID 0x80000007, EDX bit 8
+		inline bool _invariant() noexcept
+		{
+#if defined(_MSC_VER)
+			int regs[4];
+			__cpuid(regs, static_cast<int>(0x80000000u));
+			if (static_cast<unsigned int>(regs[0]) < 0x80000007u) return false;
+			__cpuid(regs, static_cast<int>(0x80000007u));
+			return ((regs[3] >> 8) & 1) != 0;
+#else
+			unsigned int eax, ebx, ecx, edx;
+			if (!__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx)) return false;
+			return ((edx >> 8) & 1) != 0;
+#endif
+		}
+
+		// Whether read() counts TSC ticks
+		inline bool hardware() noexcept
+		{
+			static const bool invariant = _invariant();
+			return invariant;
+		}
+
+		inline uint64_t read() noexcept
+		{
+			return hardware() ? __rdtsc() : _steady_ns();
+		}
+
+		// Waits for earlier instructions to finish; use to end a measurement
+		inline uint64_t read_ordered() noexcept
+		{
+			unsigned int aux;
+			return hardware() ? __rdtscp(&aux) : _steady_ns();
+		}
+#else
+		inline bool hardware() noexcept
+		{
+			return false;
+		}
+
+		inline uint64_t read() noexcept
+		{
+			return _steady_ns();
+		}
+
+		inline uint64_t read_ordered() noexcept
+		{
+			return _steady_ns();
+		}
+#endif
+
+		// Nanoseconds per tick, measured once over ~10 ms on first use
+		inline double ns_per_tick() noexcept
+		{
+			static const double ratio = []() {
+				if (!hardware()) return 1.0;
+				const auto start = std::chrono::steady_clock::now();
+				const uint64_t first = read_ordered();
+				auto now = start;
+				while (now - start < std::chrono::milliseconds(10)) now = std::chrono::steady_clock::now();
+				const uint64_t last = read_ordered();
+				const double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count());
+				return last > first ? elapsed / static_cast<double>(last - first) : 1.0;
+			}();
+			return ratio;
+		}
+
+		inline double to_ns(uint64_t ticks) noexcept
+		{
+			return static_cast<double>(ticks) * ns_per_tick();
+		}
+
+	} // namespace tsc
+
 } // namespace nw
\ No newline at end of file
@@ -1,8 +1,9 @@
 #pragma once
 
 #include <nowifi/compiler/class.hpp>
-#include <unordered_map>
-#include <stdexcept>
+#include <nowifi/util/hash.hpp>
+#include <nowifi/util/metrics.hpp>
+#include <nowifi/util/map/flatMap.hpp>
 
 
 namespace nw {
@@ -11,50 +12,45 @@ namespace nw {
 	
 		template <
 			class Ty,
-			class _Hasher = std::hash<Ty>,
-			class _Keyeq = std::equal_to<Ty>,
+			class _Hasher = hash64::hasher<Ty>,
+			class _Keyeq = std::equal_to<>,
 			class _Alloc = std::allocator<std::pair<const Ty, int>>
 		>
-			using map = std::unordered_map<Ty, int, _Hasher, _Keyeq, _Alloc>;
+			using map = flat_map<Ty, int, _Hasher, _Keyeq, _Alloc>;
 
 
-		template <class Ty>
-		int get(const map<Ty>& unique, const Ty& val)
+		template <class Ty, class _Hasher, class _Keyeq, class _Alloc, class Key>
+		int get(const map<Ty, _Hasher, _Keyeq, _Alloc>& unique, const Key& val)
 		{
-			try 
-			{
-				return unique.at(val);
-			}
-			catch (const std::out_of_range& err)
-			{
-				return 0;
-			}
+			return unique.get(val, 0);
 		}
 
-		template <class Ty>
-		void set(map<Ty>& unique, const Ty& val, int num)
+		template <class Ty, class _Hasher, class _Keyeq, class _Alloc, class Key>
+		void set(map<Ty, _Hasher, _Keyeq, _Alloc>& unique, const Key& val, int num)
 		{
+			NW_METRIC_ADD("unique.updates", 1);
 			unique[val] = num;
 		}
 
-		template <class Ty>
-		void add(map<Ty>& unique, const Ty& val, int num)
+		template <class Ty, class _Hasher, class _Keyeq, class _Alloc, class Key>
+		void add(map<Ty, _Hasher, _Keyeq, _Alloc>& unique, const Key& val, int num)
 		{
-			unique[val] = get(unique, val) + num;
+			NW_METRIC_ADD("unique.updates", 1);
+			unique.try_emplace(val, 0).first->second += num;
 		}
 
-		template <class Ty>
-		void inc(map<Ty>& unique, const Ty& val)
+		template <class Ty, class _Hasher, class _Keyeq, class _Alloc, class Key>
+		void inc(map<Ty, _Hasher, _Keyeq, _Alloc>& unique, const Key& val)
 		{
-			set<Ty>(unique, val, 1);
+			add(unique, val, 1);
 		}
 
-		template <class Ty>
-		void dec(map<Ty>& unique, const Ty& val)
+		template <class Ty, class _Hasher, class _Keyeq, class _Alloc, class Key>
+		void dec(map<Ty, _Hasher, _Keyeq, _Alloc>& unique, const Key& val)
 		{
-			set<Ty>(unique, val, -1);
+			add(unique, val, -1);
 		}
 	
 	} // namespace unique
 
-} // namespace nw
\ No newline at end of file
+} // namespace nw
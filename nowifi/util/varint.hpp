@@ -0,0 +1,751 @@
+#pragma once
+
+#include <nowifi/array/span.hpp>
+
+#include <vector>
+#include <type_traits>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(NW_VARINT_NO_SIMD) && (defined(__SSSE3__) || defined(__AVX__))
+#include <tmmintrin.h>
+#define NW_VARINT_SSSE3
+#endif
+
+namespace nw {
+
+	////////////////////////////////        ////////////////////////////////
+	//------------------------------        ------------------------------//
+	//------------------------------ zigzag ------------------------------//
+	//------------------------------        ------------------------------//
+	////////////////////////////////        ////////////////////////////////
+
+	namespace zigzag {
+
+		// 0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ...
+		template <class Ty>
+		[[nodiscard]] constexpr std::make_unsigned_t<Ty> encode(Ty value) noexcept
+		{
+			static_assert(std::is_signed<Ty>::value && std::is_integral<Ty>::value, "zigzag: signed integers only");
+			using uTy = std::make_unsigned_t<Ty>;
+			return static_cast<uTy>(static_cast<uTy>(value) << 1) ^ static_cast<uTy>(value >> (sizeof(Ty) * 8 - 1));
+		}
+
+		template <class uTy>
+		[[nodiscard]] constexpr std::make_signed_t<uTy> decode(uTy value) noexcept
+		{
+			static_assert(std::is_unsigned<uTy>::value, "zigzag: unsigned integers only");
+			return static_cast<std::make_signed_t<uTy>>((value >> 1) ^ (~(value & 1) + 1));
+		}
+
+		template <class Ty>
+		void encode(const Ty* arr, size_t size, std::make_unsigned_t<Ty>* out) noexcept
+		{
+			for (size_t idx = 0; idx < size; idx++) out[idx] = encode(arr[idx]);
+		}
+
+		template <class uTy>
+		void decode(const uTy* arr, size_t size, std::make_signed_t<uTy>* out) noexcept
+		{
+			for (size_t idx = 0; idx < size; idx++) out[idx] = decode(arr[idx]);
+		}
+
+	} // namespace zigzag
+
+	////////////////////////////////       ////////////////////////////////
+	//------------------------------       ------------------------------//
+	//------------------------------ delta ------------------------------//
+	//------------------------------       ------------------------------//
+	////////////////////////////////       ////////////////////////////////
+
+	/*
+	 * out[i] = arr[i] - arr[i - 1] (arr[-1] = <prev>), wrapping on overflow,
+	 * so decode(encode(x)) == x for every integer sequence. <arr> and <out>
+	 * may be the same array.
+	 */
+	namespace delta {
+
+		template <class Ty>
+		void encode(const Ty* arr, size_t size, Ty* out, Ty prev = Ty(0)) noexcept
+		{
+			using uTy = std::make_unsigned_t<Ty>;
+			for (size_t idx = 0; idx < size; idx++)
+			{
+				const Ty cur = arr[idx];
+				out[idx] = static_cast<Ty>(static_cast<uTy>(cur) - static_cast<uTy>(prev));
+				prev = cur;
+			}
+		}
+
+		template <class Ty>
+		void decode(const Ty* arr, size_t size, Ty* out, Ty prev = Ty(0)) noexcept
+		{
+			using uTy = std::make_unsigned_t<Ty>;
+			for (size_t idx = 0; idx < size; idx++)
+			{
+				prev = static_cast<Ty>(static_cast<uTy>(prev) + static_cast<uTy>(arr[idx]));
+				out[idx] = prev;
+			}
+		}
+
+		// Delta of delta: near-zero for evenly spaced sequences (timestamps, offsets)
+		template <class Ty>
+		void encode2(const Ty* arr, size_t size, Ty* out) noexcept
+		{
+			delta::encode(arr, size, out);
+			delta::encode(out, size, out);
+		}
+
+		template <class Ty>
+		void decode2(const Ty* arr, size_t size, Ty* out) noexcept
+		{
+			delta::decode(arr, size, out);
+			delta::decode(out, size, out);
+		}
+
+	} // namespace delta
+
+	////////////////////////////////        ////////////////////////////////
+	//------------------------------        ------------------------------//
+	//------------------------------ varint ------------------------------//
+	//------------------------------        ------------------------------//
+	////////////////////////////////        ////////////////////////////////
+
+	/*
+	 * LEB128: 7 bits per byte, high bit set on every byte but the last.
+	 * Self-delimiting, any length of unsigned integer up to 64 bits.
+	 */
+	namespace varint {
+
+		using byte_type = uint8_t;
+
+		static constexpr size_t max_bytes = 10;
+
+		[[nodiscard]] constexpr size_t max_encoded_size(size_t count) noexcept
+		{
+			return count * max_bytes;
+		}
+
+		[[nodiscard]] constexpr size_t encoded_size(uint64_t value) noexcept
+		{
+			size_t size = 1;
+			while (value >= 0x80)
+			{
+				value >>= 7;
+				size++;
+			}
+			return size;
+		}
+
+		/*
+		 * @return Number of bytes written (1..10)
+		 */
+		inline size_t encode(uint64_t value, byte_type* out) noexcept
+		{
+			byte_type* cursor = out;
+			while (value >= 0x80)
+			{
+				*cursor++ = static_cast<byte_type>(value | 0x80);
+				value >>= 7;
+			}
+			*cursor++ = static_cast<byte_type>(value);
+			return static_cast<size_t>(cursor - out);
+		}
+
+		/*
+		 * @return Number of bytes read, 0 if the input is truncated, longer
+		 *         than 10 bytes or does not fit in 64 bits
+		 */
+		inline size_t decode(const byte_type* in, const byte_type* end, uint64_t& value) noexcept
+		{
+			if (in < end && *in < 0x80)
+			{
+				value = *in;
+				return 1;
+			}
+			uint64_t result = 0;
+			for (size_t idx = 0; idx < max_bytes && in + idx < end; idx++)
+			{
+				const byte_type byte = in[idx];
+				// The 10th byte holds bit 63 only
+				if (idx == max_bytes - 1 && byte > 1) return 0;
+				result |= static_cast<uint64_t>(byte & 0x7f) << (7 * idx);
+				if (byte < 0x80)
+				{
+					value = result;
+					return idx + 1;
+				}
+			}
+			return 0;
+		}
+
+		/*
+		 * Encodes <size> unsigned values back to back.
+		 *
+		 * @param <out> - At least max_encoded_size(size) bytes
+		 *
+		 * @return Number of bytes written
+		 */
+		template <class Ty>
+		size_t encode(const Ty* arr, size_t size, byte_type* out) noexcept
+		{
+			static_assert(std::is_unsigned<Ty>::value, "varint: unsigned integers only (see zigzag)");
+			byte_type* cursor = out;
+			for (size_t idx = 0; idx < size; idx++) cursor += encode(static_cast<uint64_t>(arr[idx]), cursor);
+			return static_cast<size_t>(cursor - out);
+		}
+
+		/*
+		 * Decodes <size> values from <in_size> bytes.
+		 *
+		 * @return Number of bytes read, 0 on truncated or malformed input
+		 */
+		template <class Ty>
+		size_t decode(const byte_type* in, size_t in_size, Ty* out, size_t size) noexcept
+		{
+			static_assert(std::is_unsigned<Ty>::value, "varint: unsigned integers only (see zigzag)");
+			const byte_type* cursor = in;
+			const byte_type* end = in + in_size;
+			for (size_t idx = 0; idx < size; idx++)
+			{
+				// Single-byte values are the common case for deltas and small counts
+				if (cursor < end && *cursor < 0x80)
+				{
+					out[idx] = static_cast<Ty>(*cursor++);
+					continue;
+				}
+				uint64_t value;
+				const size_t used = decode(cursor, end, value);
+				if (used == 0) return 0;
+				out[idx] = static_cast<Ty>(value);
+				cursor += used;
+			}
+			return static_cast<size_t>(cursor - in);
+		}
+
+	} // namespace varint
+
+	////////////////////////////////             ////////////////////////////////
+	//------------------------------             ------------------------------//
+	//------------------------------ streamvbyte ------------------------------//
+	//------------------------------             ------------------------------//
+	////////////////////////////////             ////////////////////////////////
+
+	/*
+	 * Stream VByte (Lemire et al.): 32-bit values, lengths (1-4 bytes) kept
+	 * apart from the data as 2-bit codes, four per control byte.
+	 *
+	 *   [ (size + 3) / 4 control bytes ][ data bytes ]
+	 *
+	 * Decoding is one table lookup and one pshufb per four values, with
+	 * no data-dependent branches. The count is not stored.
+	 */
+	namespace streamvbyte {
+
+		using byte_type = uint8_t;
+
+		[[nodiscard]] constexpr size_t control_size(size_t count) noexcept
+		{
+			return (count + 3) / 4;
+		}
+
+		[[nodiscard]] constexpr size_t max_encoded_size(size_t count) noexcept
+		{
+			return control_size(count) + 4 * count;
+		}
+
+		struct _tables
+		{
+			byte_type length[256]{};
+			byte_type shuffle[256][16]{};
+
+			constexpr _tables()
+			{
+				for (size_t control = 0; control < 256; control++)
+				{
+					size_t offset = 0;
+					for (size_t lane = 0; lane < 4; lane++)
+					{
+						const size_t bytes = ((control >> (2 * lane)) & 3) + 1;
+						for (size_t b = 0; b < 4; b++)
+						{
+							shuffle[control][4 * lane + b] = b < bytes ? static_cast<byte_type>(offset + b) : byte_type(0xff);
+						}
+						offset += bytes;
+					}
+					length[control] = static_cast<byte_type>(offset);
+				}
+			}
+		};
+
+		inline constexpr _tables tables{};
+
+		[[nodiscard]] inline size_t _code(uint32_t value) noexcept
+		{
+			return (value > 0xff) + (value > 0xffff) + (value > 0xffffff);
+		}
+
+		/*
+		 * @param <out> - At least max_encoded_size(size) bytes
+		 *
+		 * @return Number of bytes written
+		 */
+		inline size_t encode(const uint32_t* arr, size_t size, byte_type* out) noexcept
+		{
+			byte_type* control = out;
+			byte_type* data = out + control_size(size);
+			for (size_t idx = 0; idx < size; idx += 4)
+			{
+				byte_type key = 0;
+				const size_t lanes = size - idx < 4 ? size - idx : 4;
+				for (size_t lane = 0; lane < lanes; lane++)
+				{
+					const uint32_t value = arr[idx + lane];
+					const size_t code = _code(value);
+					key |= static_cast<byte_type>(code << (2 * lane));
+					// Little-endian store, then advance by the used length
+					std::memcpy(data, &value, 4);
+					data += code + 1;
+				}
+				*control++ = key;
+			}
+			return static_cast<size_t>(data - out);
+		}
+
+		/*
+		 * Decodes <size> values from <in_size> bytes.
+		 *
+		 * @return Number of bytes read, 0 if the input is truncated
+		 */
+		inline size_t decode(const byte_type* in, size_t in_size, uint32_t* out, size_t size) noexcept
+		{
+			const size_t controls = control_size(size);
+			if (in_size < controls) return 0;
+			const byte_type* control = in;
+			const byte_type* data = in + controls;
+			const byte_type* end = in + in_size;
+			size_t idx = 0;
+
+#if defined(NW_VARINT_SSSE3)
+			// 16-byte loads: stop while a full load still fits in the input
+			for (; idx + 4 <= size && data + 16 <= end; idx += 4)
+			{
+				const byte_type key = *control++;
+				const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+				const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.shuffle[key]));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + idx), _mm_shuffle_epi8(raw, mask));
+				data += tables.length[key];
+			}
+#else
+			// Branch-free scalar: full 4-byte loads masked to the coded length
+			for (; idx + 4 <= size && data + 16 <= end; idx += 4)
+			{
+				const byte_type key = *control++;
+				for (size_t lane = 0; lane < 4; lane++)
+				{
+					const size_t code = (key >> (2 * lane)) & 3;
+					uint32_t value;
+					std::memcpy(&value, data, 4);
+					out[idx + lane] = value & (0xffffffffu >> (8 * (3 - code)));
+					data += code + 1;
+				}
+			}
+#endif
+
+			for (; idx < size; idx += 4)
+			{
+				const byte_type key = *control++;
+				const size_t lanes = size - idx < 4 ? size - idx : 4;
+				for (size_t lane = 0; lane < lanes; lane++)
+				{
+					const size_t bytes = ((key >> (2 * lane)) & 3) + 1;
+					if (data + bytes > end) return 0;
+					uint32_t value = 0;
+					std::memcpy(&value, data, bytes);
+					out[idx + lane] = value;
+					data += bytes;
+				}
+			}
+			return static_cast<size_t>(data - in);
+		}
+
+		/*
+		 * Delta + Stream VByte for non-decreasing sequences: deltas are
+		 * encoded, decode() rebuilds the prefix sum in the same pass.
+		 */
+		inline size_t encode_delta(const uint32_t* arr, size_t size, byte_type* out, uint32_t prev = 0)
+		{
+			std::vector<uint32_t> deltas(size);
+			delta::encode(arr, size, deltas.data(), prev);
+			return encode(deltas.data(), size, out);
+		}
+
+		inline size_t decode_delta(const byte_type* in, size_t in_size, uint32_t* out, size_t size, uint32_t prev = 0) noexcept
+		{
+			const size_t controls = control_size(size);
+			if (in_size < controls) return 0;
+			const byte_type* control = in;
+			const byte_type* data = in + controls;
+			const byte_type* end = in + in_size;
+			size_t idx = 0;
+
+#if defined(NW_VARINT_SSSE3)
+			__m128i running = _mm_set1_epi32(static_cast<int>(prev));
+			for (; idx + 4 <= size && data + 16 <= end; idx += 4)
+			{
+				const byte_type key = *control++;
+				const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+				__m128i values = _mm_shuffle_epi8(raw, _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.shuffle[key])));
+				// In-register prefix sum of four lanes
+				values = _mm_add_epi32(values, _mm_slli_si128(values, 4));
+				values = _mm_add_epi32(values, _mm_slli_si128(values, 8));
+				values = _mm_add_epi32(values, running);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + idx), values);
+				running = _mm_shuffle_epi32(values, 0xff);
+				data += tables.length[key];
+			}
+			prev = static_cast<uint32_t>(_mm_cvtsi128_si32(running));
+#endif
+
+			for (; idx < size; idx += 4)
+			{
+				const byte_type key = *control++;
+				const size_t lanes = size - idx < 4 ? size - idx : 4;
+				for (size_t lane = 0; lane < lanes; lane++)
+				{
+					const size_t bytes = ((key >> (2 * lane)) & 3) + 1;
+					if (data + bytes > end) return 0;
+					uint32_t value = 0;
+					std::memcpy(&value, data, bytes);
+					prev += value;
+					out[idx + lane] = prev;
+					data += bytes;
+				}
+			}
+			return static_cast<size_t>(data - in);
+		}
+
+	} // namespace streamvbyte
+
+	////////////////////////////////                ////////////////////////////////
+	//------------------------------                ------------------------------//
+	//------------------------------ stream objects ------------------------------//
+	//------------------------------                ------------------------------//
+	////////////////////////////////                ////////////////////////////////
+
+	/*
+	 * Appends LEB128 values to a growing byte buffer.
+	 *
+	 * <Order> 0 stores values as given, 1 stores deltas, 2 stores deltas of
+	 * deltas. Signed types are zigzag-encoded after differencing.
+	 */
+	template <class Ty = uint64_t, int Order = 0>
+	class VarintEncoder
+	{
+	public:
+
+		static_assert(std::is_integral<Ty>::value && sizeof(Ty) <= 8, "VarintEncoder: integers up to 64 bits");
+		static_assert(Order >= 0 && Order <= 2, "VarintEncoder: Order is 0, 1 or 2");
+
+		using value_type = Ty;
+		using byte_type = varint::byte_type;
+
+	protected:
+
+		std::vector<byte_type> _bytes;
+		Ty _prev = Ty(0);
+		Ty _prev_delta = Ty(0);
+		size_t _count = 0;
+
+	public:
+
+		void put(Ty value)
+		{
+			using uTy = std::make_unsigned_t<Ty>;
+			Ty stored = value;
+			if constexpr (Order >= 1)
+			{
+				const Ty diff = static_cast<Ty>(static_cast<uTy>(value) - static_cast<uTy>(_prev));
+				_prev = value;
+				stored = diff;
+				if constexpr (Order == 2)
+				{
+					stored = static_cast<Ty>(static_cast<uTy>(diff) - static_cast<uTy>(_prev_delta));
+					_prev_delta = diff;
+				}
+			}
+
+			const size_t used = _bytes.size();
+			_bytes.resize(used + varint::max_bytes);
+			uint64_t raw;
+			if constexpr (std::is_signed<Ty>::value) raw = static_cast<uint64_t>(zigzag::encode(stored));
+			else raw = static_cast<uint64_t>(stored);
+			_bytes.resize(used + varint::encode(raw, _bytes.data() + used));
+			_count++;
+		}
+
+		void put(const Ty* arr, size_t size)
+		{
+			_bytes.reserve(_bytes.size() + size * 2);
+			for (size_t idx = 0; idx < size; idx++) this->put(arr[idx]);
+		}
+
+		[[nodiscard]] span<const byte_type> bytes() const noexcept
+		{
+			return span<const byte_type>(_bytes.data(), _bytes.size());
+		}
+
+		// Number of values written
+		[[nodiscard]] size_t count() const noexcept
+		{
+			return _count;
+		}
+
+		void clear() noexcept
+		{
+			_bytes.clear();
+			_prev = Ty(0);
+			_prev_delta = Ty(0);
+			_count = 0;
+		}
+
+	}; // class VarintEncoder
+
+	/*
+	 * Reads values written by VarintEncoder<Ty, Order> from a buffer it does not own.
+	 */
+	template <class Ty = uint64_t, int Order = 0>
+	class VarintDecoder
+	{
+	public:
+
+		using value_type = Ty;
+		using byte_type = varint::byte_type;
+
+	protected:
+
+		const byte_type* _cursor;
+		const byte_type* _end;
+		Ty _prev = Ty(0);
+		Ty _prev_delta = Ty(0);
+
+	public:
+
+		VarintDecoder(const void* data, size_t size) noexcept
+			: _cursor(static_cast<const byte_type*>(data)), _end(_cursor + size) { }
+
+		explicit VarintDecoder(span<const byte_type> bytes) noexcept
+			: VarintDecoder(bytes.data(), bytes.size()) { }
+
+		/*
+		 * @return false at the end of input or on malformed input
+		 */
+		bool next(Ty& value) noexcept
+		{
+			using uTy = std::make_unsigned_t<Ty>;
+			uint64_t raw;
+			const size_t used = varint::decode(_cursor, _end, raw);
+			if (used == 0) return false;
+			_cursor += used;
+
+			Ty stored;
+			if constexpr (std::is_signed<Ty>::value) stored = static_cast<Ty>(zigzag::decode(raw));
+			else stored = static_cast<Ty>(raw);
+
+			if constexpr (Order == 2)
+			{
+				_prev_delta = static_cast<Ty>(static_cast<uTy>(_prev_delta) + static_cast<uTy>(stored));
+				stored = _prev_delta;
+			}
+			if constexpr (Order >= 1)
+			{
+				_prev = static_cast<Ty>(static_cast<uTy>(_prev) + static_cast<uTy>(stored));
+				stored = _prev;
+			}
+			value = stored;
+			return true;
+		}
+
+		/*
+		 * @return Number of values decoded (less than <size> at the end of input)
+		 */
+		size_t next(Ty* arr, size_t size) noexcept
+		{
+			size_t idx = 0;
+			while (idx < size && this->next(arr[idx])) idx++;
+			return idx;
+		}
+
+		[[nodiscard]] bool eof() const noexcept
+		{
+			return _cursor >= _end;
+		}
+
+		[[nodiscard]] size_t remaining() const noexcept
+		{
+			return static_cast<size_t>(_end - _cursor);
+		}
+
+	}; // class VarintDecoder
+
+	/*
+	 * Buffers uint32 values and emits Stream VByte blocks:
+	 *
+	 *   [ uint32 count ][ uint32 encoded bytes ][ streamvbyte payload ]
+	 *
+	 * With <Delta> the payload holds deltas (for sorted input); the running
+	 * value carries across blocks.
+	 */
+	template <bool Delta = false>
+	class StreamVByteEncoder
+	{
+	public:
+
+		using byte_type = streamvbyte::byte_type;
+
+		static constexpr size_t default_block = 4096;
+
+	protected:
+
+		std::vector<byte_type> _bytes;
+		std::vector<uint32_t> _pending;
+		size_t _block;
+		uint32_t _prev = 0;
+
+	public:
+
+		explicit StreamVByteEncoder(size_t block = default_block)
+			: _block(block == 0 ? default_block : block)
+		{
+			_pending.reserve(_block);
+		}
+
+		void put(uint32_t value)
+		{
+			_pending.push_back(value);
+			if (_pending.size() == _block) this->flush();
+		}
+
+		void put(const uint32_t* arr, size_t size)
+		{
+			for (size_t idx = 0; idx < size; idx++) this->put(arr[idx]);
+		}
+
+		// Emits the buffered values as one block
+		void flush()
+		{
+			if (_pending.empty()) return;
+			const uint32_t count = static_cast<uint32_t>(_pending.size());
+			const size_t header = _bytes.size();
+			_bytes.resize(header + 8 + streamvbyte::max_encoded_size(count));
+
+			uint32_t used;
+			if constexpr (Delta)
+			{
+				used = static_cast<uint32_t>(streamvbyte::encode_delta(_pending.data(), count, _bytes.data() + header + 8, _prev));
+				_prev = _pending.back();
+			}
+			else
+			{
+				used = static_cast<uint32_t>(streamvbyte::encode(_pending.data(), count, _bytes.data() + header + 8));
+			}
+
+			std::memcpy(_bytes.data() + header, &count, 4);
+			std::memcpy(_bytes.data() + header + 4, &used, 4);
+			_bytes.resize(header + 8 + used);
+			_pending.clear();
+		}
+
+		// Call flush() first to include buffered values
+		[[nodiscard]] span<const byte_type> bytes() const noexcept
+		{
+			return span<const byte_type>(_bytes.data(), _bytes.size());
+		}
+
+		void clear() noexcept
+		{
+			_bytes.clear();
+			_pending.clear();
+			_prev = 0;
+		}
+
+	}; // class StreamVByteEncoder
+
+	template <bool Delta = false>
+	class StreamVByteDecoder
+	{
+	public:
+
+		using byte_type = streamvbyte::byte_type;
+
+	protected:
+
+		const byte_type* _cursor;
+		const byte_type* _end;
+		uint32_t _prev = 0;
+
+	public:
+
+		StreamVByteDecoder(const void* data, size_t size) noexcept
+			: _cursor(static_cast<const byte_type*>(data)), _end(_cursor + size) { }
+
+		explicit StreamVByteDecoder(span<const byte_type> bytes) noexcept
+			: StreamVByteDecoder(bytes.data(), bytes.size()) { }
+
+		// Value count of the next block, 0 at the end of input
+		[[nodiscard]] size_t peek() const noexcept
+		{
+			if (_end - _cursor < 8) return 0;
+			uint32_t count;
+			std::memcpy(&count, _cursor, 4);
+			return count;
+		}
+
+		/*
+		 * Decodes the next block into <out> (at least peek() values).
+		 *
+		 * @return Number of values decoded, 0 at the end of input
+		 *
+		 * @exception std::invalid_argument - Truncated or malformed block
+		 */
+		size_t next_block(uint32_t* out)
+		{
+			if (_cursor == _end) return 0;
+			if (_end - _cursor < 8) throw std::invalid_argument("StreamVByteDecoder: truncated header");
+			uint32_t count, used;
+			std::memcpy(&count, _cursor, 4);
+			std::memcpy(&used, _cursor + 4, 4);
+			if (static_cast<size_t>(_end - _cursor - 8) < used) throw std::invalid_argument("StreamVByteDecoder: truncated block");
+
+			size_t read;
+			if constexpr (Delta)
+			{
+				read = streamvbyte::decode_delta(_cursor + 8, used, out, count, _prev);
+				if (count != 0) _prev = out[count - 1];
+			}
+			else
+			{
+				read = streamvbyte::decode(_cursor + 8, used, out, count);
+			}
+			if (read != used) throw std::invalid_argument("StreamVByteDecoder: malformed block");
+			_cursor += 8 + used;
+			return count;
+		}
+
+		// Decodes every remaining block
+		[[nodiscard]] std::vector<uint32_t> read_all()
+		{
+			std::vector<uint32_t> result;
+			for (size_t count = this->peek(); count != 0; count = this->peek())
+			{
+				const size_t used = result.size();
+				result.resize(used + count);
+				this->next_block(result.data() + used);
+			}
+			return result;
+		}
+
+	}; // class StreamVByteDecoder
+
+} // namespace nw
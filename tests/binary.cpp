@@ -0,0 +1,142 @@
+#include "test.hpp"
+
+#include <nowifi/io/binary.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template <nw::endian Order>
+void check_round_trip()
+{
+	const std::vector<double> values = { 1.5, -2.25, 1e300, 0.0 };
+	const std::vector<uint16_t> shorts = { 1, 2, 3, 0xabcd, 0xffff };
+	const std::vector<uint8_t> bytes = { 7, 8, 9 };
+
+	// write_array() pads: a byte, then doubles at 8 and shorts at 64
+	auto write = [&](auto& writer)
+	{
+		writer.write(uint8_t(42));
+		writer.write_array(values.data(), values.size());
+		writer.write(uint32_t(0x4e57));
+		writer.write(int16_t(-3));
+		writer.write_array(bytes.data(), bytes.size());
+		writer.write_array(shorts.data(), shorts.size(), 64);
+		writer.align(16);
+	};
+
+	nw::BinarySizer sizer;
+	write(sizer);
+	nw::bin::buffer buffer(sizer.size());
+	nw::basic_BinaryWriter<Order> writer(buffer);
+	write(writer);
+	NW_CHECK(writer.size() == sizer.size() && writer.remaining() == 0);
+	NW_CHECK(sizer.size() % 16 == 0);
+
+	nw::basic_BinaryReader<Order> reader(buffer);
+	NW_CHECK(reader.template read<uint8_t>() == 42);
+	std::vector<double> read_values(values.size());
+	reader.read_array(read_values.data(), read_values.size());
+	NW_CHECK(read_values == values);
+	NW_CHECK(reader.position() == 8 + values.size() * sizeof(double));
+
+	NW_CHECK(reader.template read<uint32_t>() == 0x4e57);
+	NW_CHECK(reader.template read<int16_t>() == -3);
+	std::vector<uint8_t> read_bytes(bytes.size());
+	reader.read_array(read_bytes.data(), read_bytes.size());
+	NW_CHECK(read_bytes == bytes);
+
+	std::vector<uint16_t> read_shorts(shorts.size());
+	reader.read_array(read_shorts.data(), read_shorts.size(), 64);
+	NW_CHECK(read_shorts == shorts);
+	reader.align(16);
+	NW_CHECK(reader.eof());
+}
+
+void test_round_trip()
+{
+	check_round_trip<nw::endian::little>();
+	check_round_trip<nw::endian::big>();
+
+	// Native order views the aligned arrays in place
+	const std::vector<double> values = { 1.0, 2.0, 3.0 };
+	const std::vector<uint32_t> words = { 5, 6 };
+	nw::bin::buffer data = nw::bin::pack<nw::endian::native>(uint8_t(1), values, words);
+	nw::basic_BinaryReader<nw::endian::native> reader(data);
+	NW_CHECK(reader.read<uint8_t>() == 1);
+	NW_CHECK(reader.read<uint64_t>() == values.size());
+	const nw::span<const double> view = reader.view<double>(values.size());
+	NW_CHECK(view.data() == reinterpret_cast<const double*>(data.data() + 16));
+	NW_CHECK(view[0] == 1.0 && view[2] == 3.0);
+	NW_CHECK(reader.read<uint64_t>() == words.size());
+	const nw::span<const uint32_t> word_view = reader.view<uint32_t>(words.size());
+	NW_CHECK(word_view[0] == 5 && word_view[1] == 6);
+	NW_CHECK(reader.eof());
+}
+
+void test_truncated()
+{
+	const std::vector<uint32_t> words = { 1, 2, 3, 4, 5 };
+	nw::bin::buffer data = nw::bin::pack(words);
+	for (size_t size = 0; size < data.size(); size++)
+	{
+		nw::BinaryReader reader(data.data(), size);
+		std::vector<uint32_t> read(words.size());
+		bool thrown = false;
+		try
+		{
+			const size_t count = static_cast<size_t>(reader.read<uint64_t>());
+			reader.read_array(read.data(), count);
+		}
+		catch (const std::out_of_range&)
+		{
+			thrown = true;
+		}
+		NW_CHECK(thrown);
+	}
+
+	// A corrupt count can not wrap count * sizeof(Ty) into a small read
+	const uint64_t huge = std::numeric_limits<uint64_t>::max() / 4 + 2;
+	nw::bin::buffer corrupt = nw::bin::pack(huge, uint32_t(0));
+	nw::basic_BinaryReader<nw::endian::native> reader(corrupt);
+	const size_t count = static_cast<size_t>(reader.read<uint64_t>());
+	NW_CHECK_THROWS(reader.view<uint32_t>(count), std::out_of_range);
+	NW_CHECK(reader.position() == sizeof(uint64_t));
+
+	// Writing past the end
+	uint8_t small[6];
+	nw::BinaryWriter writer(small, sizeof(small));
+	NW_CHECK_THROWS(writer.write_array(words.data(), words.size()), std::out_of_range);
+	NW_CHECK_THROWS(writer.write_array(words.data(), count), std::out_of_range);
+	NW_CHECK(writer.size() == 0);
+}
+
+void test_bad_alignment()
+{
+	NW_CHECK(nw::bin::is_alignment(1) && nw::bin::is_alignment(64));
+	NW_CHECK(!nw::bin::is_alignment(0) && !nw::bin::is_alignment(3) && !nw::bin::is_alignment(24));
+	NW_CHECK(nw::bin::align_up(13, 8) == 16 && nw::bin::align_up(16, 8) == 16 && nw::bin::align_up(0, 64) == 0);
+
+	NW_CHECK_THROWS(nw::BinarySizer().align(0), std::invalid_argument);
+	NW_CHECK_THROWS(nw::BinarySizer().align(12), std::invalid_argument);
+	NW_CHECK_THROWS(nw::bin::buffer(16, 0), std::invalid_argument);
+	NW_CHECK_THROWS(nw::bin::buffer(16, 48), std::invalid_argument);
+
+	uint8_t bytes[16] = {};
+	nw::BinaryWriter writer(bytes, sizeof(bytes));
+	NW_CHECK_THROWS(writer.align(0), std::invalid_argument);
+	NW_CHECK_THROWS(writer.write_array(bytes, 1, 6), std::invalid_argument);
+	nw::BinaryReader reader(bytes, sizeof(bytes));
+	NW_CHECK_THROWS(reader.align(0), std::invalid_argument);
+	NW_CHECK_THROWS(reader.read_array(bytes, 1, 3), std::invalid_argument);
+}
+
+int main()
+{
+	test_round_trip();
+	test_truncated();
+	test_bad_alignment();
+	return nw_test::result();
+}
@@ -0,0 +1,131 @@
+#include "test.hpp"
+
+#include <nowifi/util/bitpack.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Values in [base, base + 2^width) with both ends present
+std::vector<uint32_t> in_width(size_t size, uint32_t base, uint32_t width, uint32_t seed)
+{
+	const uint32_t span = width == 32 ? ~0u : (width == 0 ? 0u : (1u << width) - 1);
+	std::mt19937 gen(seed);
+	std::vector<uint32_t> values(size);
+	for (uint32_t& value : values) value = base + (width == 0 ? 0 : static_cast<uint32_t>(gen() & span));
+	values[0] = base;
+	values[size / 2] = base + span;
+	return values;
+}
+
+template <size_t Lanes>
+void check_blocks()
+{
+	constexpr size_t block = 32 * Lanes;
+	const uint32_t sentinel = 0xdeadbeef;
+	for (uint32_t width = 0; width <= 32; width++)
+	{
+		const uint32_t base = width == 32 ? 0 : 1000;
+		const std::vector<uint32_t> values = in_width(block, base, width, width);
+
+		// A block takes exactly width * Lanes words
+		std::vector<uint32_t> packed(width * Lanes + 1, sentinel);
+		nw::bitpack::pack<Lanes>(values.data(), base, width, packed.data());
+		NW_CHECK(packed.back() == sentinel);
+		NW_CHECK(nw::bitpack::width(values[block / 2] - base) == width);
+
+		std::vector<uint32_t> out(block);
+		nw::bitpack::unpack<Lanes>(packed.data(), base, width, out.data());
+		NW_CHECK(out == values);
+		for (size_t idx = 0; idx < block; idx++) NW_CHECK(nw::bitpack::get<Lanes>(packed.data(), base, width, idx) == values[idx]);
+	}
+}
+
+void test_blocks()
+{
+	check_blocks<4>();
+	check_blocks<8>();
+}
+
+template <class Ty, size_t BlockSize>
+void check_array(uint32_t width)
+{
+	using array_type = nw::bitpack::PackedArray<Ty, BlockSize>;
+	const uint32_t base = width == 32 ? 0 : (std::is_signed<Ty>::value ? 0x80000000u - 77 : 77);
+	for (size_t size : { size_t(1), BlockSize - 1, BlockSize + 1, 3 * BlockSize + 5 })
+	{
+		const std::vector<uint32_t> raw = in_width(size, base, width, width * 7 + static_cast<uint32_t>(size));
+		const std::vector<Ty> values(reinterpret_cast<const Ty*>(raw.data()), reinterpret_cast<const Ty*>(raw.data()) + size);
+
+		// Chunked puts close blocks at the same points as one bulk put
+		array_type packed;
+		for (size_t first = 0; first < size; first += 50) packed.put(values.data() + first, std::min<size_t>(50, size - first));
+		packed.flush();
+		NW_CHECK(packed.size() == size);
+		NW_CHECK_THROWS(packed.put(values[0]), std::logic_error);
+
+		const auto view = packed.view();
+		NW_CHECK(view.decode() == values);
+		for (size_t idx = 0; idx < size; idx += 3) NW_CHECK(view[idx] == values[idx]);
+		NW_CHECK(view.at(size - 1) == values.back());
+		NW_CHECK_THROWS(view.at(size), std::out_of_range);
+
+		// Sequential reads across block boundaries
+		std::vector<Ty> read(size);
+		auto reader = view.read();
+		size_t done = 0;
+		for (size_t step : { size_t(37), BlockSize, size_t(1) }) done += reader.next(read.data() + done, std::min(step, size - done));
+		done += reader.next(read.data() + done, size);
+		NW_CHECK(done == size && reader.eof() && read == values);
+
+		// Serialized and viewed in place
+		const nw::bin::buffer data = packed.serialize();
+		nw::basic_BinaryReader<nw::endian::native> in(data);
+		NW_CHECK(array_type::view(in).decode() == values);
+		NW_CHECK(in.eof());
+	}
+}
+
+void test_arrays()
+{
+	for (uint32_t width = 0; width <= 32; width++)
+	{
+		check_array<uint32_t, 128>(width);
+		check_array<uint32_t, 256>(width);
+		check_array<int32_t, 128>(width);
+	}
+
+	// Signed extremes share one block
+	const std::vector<int32_t> extremes = { std::numeric_limits<int32_t>::min(), -1, 0, 1, std::numeric_limits<int32_t>::max() };
+	const nw::bitpack::PackedArray<int32_t> packed(extremes.data(), extremes.size());
+	NW_CHECK(packed.view().decode() == extremes);
+}
+
+void test_bad_input()
+{
+	std::vector<uint32_t> values(300);
+	for (size_t idx = 0; idx < values.size(); idx++) values[idx] = static_cast<uint32_t>(idx * idx);
+	const nw::bitpack::PackedArray<uint32_t> packed(values.data(), values.size());
+	const nw::bin::buffer data = packed.serialize();
+
+	// Every truncation runs out of input
+	for (size_t size = 0; size < data.size(); size += 7)
+	{
+		nw::basic_BinaryReader<nw::endian::native> in(data.data(), size);
+		NW_CHECK_THROWS(nw::bitpack::PackedArray<uint32_t>::view(in), std::out_of_range);
+	}
+
+	// Block size mismatch
+	nw::basic_BinaryReader<nw::endian::native> other(data);
+	NW_CHECK_THROWS((nw::bitpack::PackedArray<uint32_t, 256>::view(other)), std::invalid_argument);
+}
+
+int main()
+{
+	test_blocks();
+	test_arrays();
+	test_bad_input();
+	return nw_test::result();
+}
@@ -0,0 +1,102 @@
+#include "test.hpp"
+
+#include <nowifi/util/checksum.hpp>
+#include <nowifi/util/cpu.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Bit-at-a-time CRC-32C, the definition the fast paths must match
+uint32_t reference_crc32c(const unsigned char* p, size_t len)
+{
+	uint32_t crc = ~uint32_t(0);
+	for (size_t idx = 0; idx < len; idx++)
+	{
+		crc ^= p[idx];
+		for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (nw::crc32c::polynomial & (0u - (crc & 1)));
+	}
+	return ~crc;
+}
+
+void test_known_values()
+{
+	// RFC 3720 B.4
+	unsigned char buffer[32];
+	for (unsigned char& byte : buffer) byte = 0;
+	NW_CHECK(nw::crc32c::compute(buffer, 32) == 0x8A9136AA);
+	for (unsigned char& byte : buffer) byte = 0xFF;
+	NW_CHECK(nw::crc32c::compute(buffer, 32) == 0x62A8AB43);
+	for (int idx = 0; idx < 32; idx++) buffer[idx] = static_cast<unsigned char>(idx);
+	NW_CHECK(nw::crc32c::compute(buffer, 32) == 0x46DD794E);
+
+	NW_CHECK(nw::crc32c::compute("123456789") == 0xE3069283);
+	NW_CHECK(nw::crc32c::compute("") == 0);
+}
+
+void test_against_reference()
+{
+	std::mt19937 gen(3);
+	std::vector<unsigned char> data(20000);
+	for (unsigned char& byte : data) byte = static_cast<unsigned char>(gen());
+
+	// Unaligned starts and lengths around the 3 x 1024 interleaved rounds
+	for (size_t len : { 0, 1, 7, 8, 9, 1023, 3071, 3072, 3073, 6151, 19990 })
+	{
+		for (size_t offset : { 0, 1, 3, 5 })
+		{
+			NW_CHECK(nw::crc32c::compute(data.data() + offset, len) == reference_crc32c(data.data() + offset, len));
+		}
+	}
+}
+
+void test_combine()
+{
+	std::mt19937 gen(5);
+	std::vector<unsigned char> data(10000);
+	for (unsigned char& byte : data) byte = static_cast<unsigned char>(gen());
+	const uint32_t whole = nw::crc32c::compute(data.data(), data.size());
+
+	for (size_t split : { 0, 1, 4096, 9999, 10000 })
+	{
+		const uint32_t first = nw::crc32c::compute(data.data(), split);
+		const uint32_t second = nw::crc32c::compute(data.data() + split, data.size() - split);
+		NW_CHECK(nw::crc32c::extend(first, data.data() + split, data.size() - split) == whole);
+		NW_CHECK(nw::crc32c::combine(first, second, data.size() - split) == whole);
+
+		nw::crc32c::stream head, tail;
+		head.update(data.data(), split);
+		tail.update(data.data() + split, data.size() - split);
+		NW_CHECK(head.append(tail).value() == whole && head.size() == data.size());
+	}
+}
+
+void test_checksum64()
+{
+	std::string data(5000, '\0');
+	for (size_t idx = 0; idx < data.size(); idx++) data[idx] = static_cast<char>(idx * 31);
+
+	nw::checksum64 chunked(9);
+	for (size_t idx = 0; idx < data.size(); idx += 333) chunked.update(data.data() + idx, std::min<size_t>(333, data.size() - idx));
+	NW_CHECK(chunked.value() == nw::checksum64::compute(data.data(), data.size(), 9));
+	NW_CHECK(chunked.value() == nw::hash64::hash(data.data(), data.size(), 9));
+	NW_CHECK(chunked.value() != nw::checksum64::compute(data.data(), data.size(), 10));
+}
+
+int main()
+{
+#if defined(NW_CHECKSUM_SSE42)
+	if (!nw::cpu::get().sse42)
+	{
+		std::printf("skipped: no SSE4.2\n");
+		return 0;
+	}
+#endif
+	test_known_values();
+	test_against_reference();
+	test_combine();
+	test_checksum64();
+	return nw_test::result();
+}
@@ -0,0 +1,152 @@
+#include "test.hpp"
+
+#include <nowifi/io/compress.hpp>
+
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+std::vector<char> text_data(size_t size)
+{
+	const char words[] = "the quick brown fox jumps over the lazy dog 0123456789\n";
+	std::vector<char> data(size);
+	for (size_t idx = 0; idx < size; idx++) data[idx] = words[idx % (sizeof(words) - 1)];
+	return data;
+}
+
+std::vector<char> random_data(size_t size, unsigned seed)
+{
+	std::mt19937 gen(seed);
+	std::vector<char> data(size);
+	for (char& byte : data) byte = static_cast<char>(gen());
+	return data;
+}
+
+std::string pack(const std::vector<char>& data, size_t block_size)
+{
+	std::ostringstream os(std::ios::binary);
+	nw::CompressedWriter writer(os, nw::codec::lz, block_size);
+	writer.write(data.data(), data.size());
+	writer.close();
+	NW_CHECK(writer.raw_size() == data.size());
+	return os.str();
+}
+
+std::vector<char> unpack(const std::string& frame)
+{
+	std::istringstream is(frame, std::ios::binary);
+	nw::CompressedReader reader(is);
+	std::vector<char> result;
+	char buffer[3000];
+	for (size_t got = reader.read(buffer, sizeof(buffer)); got > 0; got = reader.read(buffer, sizeof(buffer)))
+	{
+		result.insert(result.end(), buffer, buffer + got);
+	}
+	NW_CHECK(reader.eof());
+	return result;
+}
+
+void test_batch_for()
+{
+	NW_CHECK(nw::compress::batch_for(1) == nw::compress::batch_blocks);
+	NW_CHECK(nw::compress::batch_for(1 << 20) == nw::compress::batch_blocks);
+	NW_CHECK(nw::compress::batch_for(nw::compress::batch_bytes / 2) == 2);
+	NW_CHECK(nw::compress::batch_for(nw::compress::batch_bytes) == 1);
+	NW_CHECK(nw::compress::batch_for(size_t(1) << 31) == 1);
+}
+
+void test_round_trip()
+{
+	for (size_t block_size : { size_t(1), size_t(7), size_t(4096), size_t(1) << 20 })
+	{
+		for (size_t size : { size_t(0), size_t(1), size_t(4095), size_t(100000) })
+		{
+			const std::vector<char> text = text_data(size);
+			NW_CHECK(unpack(pack(text, block_size)) == text);
+
+			const std::vector<char> noise = random_data(size, static_cast<unsigned>(size + block_size));
+			NW_CHECK(unpack(pack(noise, block_size)) == noise);
+		}
+	}
+
+	// Text shrinks; incompressible blocks are stored raw, not grown past the header overhead
+	const std::vector<char> text = text_data(1 << 18);
+	NW_CHECK(pack(text, 1 << 16).size() < text.size() / 2);
+	const std::vector<char> noise = random_data(1 << 18, 1);
+	NW_CHECK(pack(noise, 1 << 16).size() < noise.size() + 1024);
+}
+
+void test_large_block_size()
+{
+	// Buffers follow the input, not block size x batch (which would be 32 GiB here)
+	const std::vector<char> text = text_data(5000);
+	NW_CHECK(unpack(pack(text, size_t(1) << 31)) == text);
+
+	std::ostringstream os(std::ios::binary);
+	NW_CHECK_THROWS(nw::CompressedWriter(os, nw::codec::lz, 0), std::invalid_argument);
+	NW_CHECK_THROWS(nw::CompressedWriter(os, nw::codec::lz, (size_t(1) << 31) + 1), std::invalid_argument);
+}
+
+void test_random_access()
+{
+	const size_t block_size = 1000;
+	const std::vector<char> data = text_data(block_size * 40 + 123);
+	const std::string frame = pack(data, block_size);
+
+	std::istringstream is(frame, std::ios::binary);
+	nw::CompressedReader reader(is);
+	NW_CHECK(reader.load_index());
+	NW_CHECK(reader.block_count() == 41);
+	NW_CHECK(reader.size() == data.size());
+
+	for (size_t block : { size_t(0), size_t(17), size_t(40) })
+	{
+		const std::vector<char> raw = reader.read_block(block);
+		const size_t expected = block == 40 ? 123 : block_size;
+		NW_CHECK(raw.size() == expected);
+		NW_CHECK(std::memcmp(raw.data(), data.data() + block * block_size, raw.size()) == 0);
+	}
+	NW_CHECK_THROWS(reader.read_block(41), std::out_of_range);
+
+	for (uint64_t offset : { uint64_t(0), uint64_t(999), uint64_t(1000), uint64_t(25555), uint64_t(data.size() - 1) })
+	{
+		reader.seek(offset);
+		char byte = 0;
+		NW_CHECK(reader.read(&byte, 1) == 1);
+		NW_CHECK(byte == data[static_cast<size_t>(offset)]);
+	}
+	reader.seek(data.size());
+	char byte = 0;
+	NW_CHECK(reader.read(&byte, 1) == 0);
+	NW_CHECK_THROWS(reader.seek(data.size() + 1), std::out_of_range);
+}
+
+void test_corruption()
+{
+	// Random data is stored raw, so a flipped payload byte only shows in the CRC
+	const std::vector<char> noise = random_data(10000, 7);
+	std::string frame = pack(noise, 1000);
+	frame[nw::compress::header_size + 3 * (nw::compress::block_header_size + 1000) + nw::compress::block_header_size + 10] ^= 0x20;
+	NW_CHECK_THROWS(unpack(frame), std::invalid_argument);
+
+	std::string bad_magic = pack(noise, 1000);
+	bad_magic[0] ^= 1;
+	std::istringstream is(bad_magic, std::ios::binary);
+	NW_CHECK_THROWS(nw::CompressedReader{ is }, std::invalid_argument);
+
+	const std::string truncated = pack(noise, 1000).substr(0, 5000);
+	NW_CHECK_THROWS(unpack(truncated), std::invalid_argument);
+}
+
+int main()
+{
+	test_batch_for();
+	test_round_trip();
+	test_large_block_size();
+	test_random_access();
+	test_corruption();
+	return nw_test::result();
+}
@@ -0,0 +1,304 @@
+#include "test.hpp"
+
+#include <nowifi/util/concurrentQueue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Producer <id> sends id << 32 | 0..count-1
+uint64_t tag(uint64_t producer, uint64_t seq)
+{
+	return (producer << 32) | seq;
+}
+
+// Every value of every producer arrived exactly once
+bool exactly_once(std::vector<uint64_t> received, size_t producers, size_t count)
+{
+	if (received.size() != producers * count) return false;
+	std::sort(received.begin(), received.end());
+	for (size_t producer = 0; producer < producers; producer++)
+	{
+		for (size_t seq = 0; seq < count; seq++)
+		{
+			if (received[producer * count + seq] != tag(producer, seq)) return false;
+		}
+	}
+	return true;
+}
+
+// Each consumer sees a given producer's values in push order
+bool producer_order(const std::vector<uint64_t>& received)
+{
+	std::vector<int64_t> last;
+	for (uint64_t value : received)
+	{
+		const size_t producer = static_cast<size_t>(value >> 32);
+		if (producer >= last.size()) last.resize(producer + 1, -1);
+		if (static_cast<int64_t>(value & 0xffffffff) <= last[producer]) return false;
+		last[producer] = static_cast<int64_t>(value & 0xffffffff);
+	}
+	return true;
+}
+
+//-------------------- boundaries --------------------//
+
+template <class Queue>
+void check_boundaries()
+{
+	NW_CHECK(Queue(0).capacity() == 2);
+	NW_CHECK(Queue(2).capacity() == 2);
+	NW_CHECK(Queue(5).capacity() == 8);
+
+	Queue queue(4);
+	int out = -1;
+	NW_CHECK(queue.empty() && !queue.full());
+	NW_CHECK(!queue.try_pop(out) && out == -1);
+	NW_CHECK(queue.pop_n(&out, 1) == 0);
+
+	for (int idx = 0; idx < 4; idx++) NW_CHECK(queue.try_push(idx));
+	NW_CHECK(queue.full() && queue.size() == 4);
+	NW_CHECK(!queue.try_push(99));
+
+	// One slot frees exactly one push
+	NW_CHECK(queue.try_pop(out) && out == 0);
+	NW_CHECK(queue.try_push(4));
+	NW_CHECK(!queue.try_push(99));
+
+	// Batches stop at the boundaries
+	int batch[8] = {};
+	NW_CHECK(queue.pop_n(batch, 8) == 4);
+	NW_CHECK(batch[0] == 1 && batch[1] == 2 && batch[2] == 3 && batch[3] == 4);
+	NW_CHECK(queue.empty());
+
+	const int values[6] = { 10, 11, 12, 13, 14, 15 };
+	NW_CHECK(queue.push_n(values, 0) == 0);
+	NW_CHECK(queue.push_n(values, 3) == 3);
+	NW_CHECK(queue.push_n(values + 3, 3) == 1);
+	NW_CHECK(queue.full());
+	NW_CHECK(queue.pop_n(batch, 2) == 2 && batch[0] == 10 && batch[1] == 11);
+	NW_CHECK(queue.pop_n(batch, 0) == 0);
+	NW_CHECK(queue.pop_n(batch, 8) == 2 && batch[0] == 12 && batch[1] == 13);
+
+	// Many laps around the ring keep FIFO order
+	int expected = 0, next = 0;
+	for (int lap = 0; lap < 1000; lap++)
+	{
+		while (queue.try_push(next)) next++;
+		while (queue.try_pop(out)) NW_CHECK(out == expected++);
+	}
+	NW_CHECK(expected == next && queue.empty());
+}
+
+void test_boundaries()
+{
+	check_boundaries<nw::spsc_queue<int>>();
+	check_boundaries<nw::mpmc_queue<int>>();
+	check_boundaries<nw::blocking_spsc_queue<int>>();
+	check_boundaries<nw::blocking_mpmc_queue<int>>();
+}
+
+//-------------------- stress --------------------//
+
+void test_spsc_stress()
+{
+	constexpr uint64_t count = 200000;
+	nw::spsc_queue<uint64_t> queue(64);
+
+	std::thread producer([&queue]()
+	{
+		uint64_t next = 0;
+		uint64_t batch[7];
+		while (next < count)
+		{
+			// Alternate single pushes and batches
+			if (next % 3 == 0)
+			{
+				if (queue.try_push(next)) next++;
+				else std::this_thread::yield();
+				continue;
+			}
+			const size_t size = static_cast<size_t>(std::min<uint64_t>(7, count - next));
+			for (size_t idx = 0; idx < size; idx++) batch[idx] = next + idx;
+			const size_t pushed = queue.push_n(batch, size);
+			if (pushed == 0) std::this_thread::yield();
+			next += pushed;
+		}
+	});
+
+	uint64_t expected = 0;
+	bool ordered = true;
+	uint64_t batch[5];
+	while (expected < count)
+	{
+		const size_t popped = queue.pop_n(batch, 5);
+		if (popped == 0) std::this_thread::yield();
+		for (size_t idx = 0; idx < popped; idx++) ordered &= batch[idx] == expected++;
+	}
+	producer.join();
+	NW_CHECK(ordered);
+	NW_CHECK(queue.empty());
+}
+
+void test_mpmc_stress()
+{
+	constexpr size_t producers = 4, consumers = 3, count = 50000;
+	nw::mpmc_queue<uint64_t> queue(128);
+	std::atomic<size_t> remaining{ producers * count };
+
+	std::vector<std::thread> threads;
+	for (size_t producer = 0; producer < producers; producer++)
+	{
+		threads.emplace_back([&queue, producer]()
+		{
+			uint64_t batch[4];
+			for (size_t seq = 0; seq < count;)
+			{
+				if (producer % 2 == 0)
+				{
+					if (queue.try_push(tag(producer, seq))) seq++;
+					else std::this_thread::yield();
+					continue;
+				}
+				const size_t size = std::min<size_t>(4, count - seq);
+				for (size_t idx = 0; idx < size; idx++) batch[idx] = tag(producer, seq + idx);
+				const size_t pushed = queue.push_n(batch, size);
+				if (pushed == 0) std::this_thread::yield();
+				seq += pushed;
+			}
+		});
+	}
+
+	std::vector<std::vector<uint64_t>> received(consumers);
+	for (size_t consumer = 0; consumer < consumers; consumer++)
+	{
+		threads.emplace_back([&queue, &remaining, &received, consumer]()
+		{
+			uint64_t batch[6];
+			while (remaining.load() != 0)
+			{
+				const size_t popped = consumer == 0 ? (queue.try_pop(batch[0]) ? 1 : 0) : queue.pop_n(batch, 6);
+				if (popped == 0) std::this_thread::yield();
+				received[consumer].insert(received[consumer].end(), batch, batch + popped);
+				remaining.fetch_sub(popped);
+			}
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+
+	std::vector<uint64_t> all;
+	for (const std::vector<uint64_t>& part : received)
+	{
+		NW_CHECK(producer_order(part));
+		all.insert(all.end(), part.begin(), part.end());
+	}
+	NW_CHECK(exactly_once(all, producers, count));
+	NW_CHECK(queue.empty());
+}
+
+template <class Queue>
+void check_blocking_stress(size_t producers, size_t consumers)
+{
+	constexpr size_t count = 20000;
+	Queue queue(4);
+
+	// NW_CHECK is not thread-safe: threads report through flags and vectors
+	std::atomic<bool> pushed{ true };
+	std::vector<std::thread> senders;
+	for (size_t producer = 0; producer < producers; producer++)
+	{
+		senders.emplace_back([&queue, &pushed, producer]()
+		{
+			for (size_t seq = 0; seq < count; seq++)
+			{
+				if (!queue.push(tag(producer, seq))) pushed = false;
+			}
+		});
+	}
+
+	std::vector<std::vector<uint64_t>> received(consumers);
+	std::vector<std::thread> receivers;
+	for (size_t consumer = 0; consumer < consumers; consumer++)
+	{
+		receivers.emplace_back([&queue, &received, consumer]()
+		{
+			if (consumer % 2 == 0)
+			{
+				uint64_t value;
+				while (queue.pop(value)) received[consumer].push_back(value);
+				return;
+			}
+			uint64_t batch[3];
+			while (const size_t popped = queue.pop_n_wait(batch, 3)) received[consumer].insert(received[consumer].end(), batch, batch + popped);
+		});
+	}
+
+	for (std::thread& thread : senders) thread.join();
+	queue.close();
+	for (std::thread& thread : receivers) thread.join();
+	NW_CHECK(pushed);
+
+	std::vector<uint64_t> all;
+	for (const std::vector<uint64_t>& part : received)
+	{
+		NW_CHECK(producer_order(part));
+		all.insert(all.end(), part.begin(), part.end());
+	}
+	NW_CHECK(exactly_once(all, producers, count));
+}
+
+void test_blocking_stress()
+{
+	check_blocking_stress<nw::blocking_spsc_queue<uint64_t>>(1, 1);
+	check_blocking_stress<nw::blocking_mpmc_queue<uint64_t>>(3, 1);
+	check_blocking_stress<nw::blocking_mpmc_queue<uint64_t>>(3, 4);
+}
+
+//-------------------- close --------------------//
+
+void test_close()
+{
+	nw::blocking_mpmc_queue<int> queue(2);
+	NW_CHECK(queue.push(1) && queue.push(2));
+
+	// A producer sleeping on a full queue is released by close()
+	bool pushed = true;
+	std::thread blocked([&queue, &pushed]() { pushed = queue.push(3); });
+	queue.close();
+	blocked.join();
+	NW_CHECK(!pushed);
+	NW_CHECK(queue.closed());
+	NW_CHECK(!queue.push(4));
+
+	// What was queued before close() is still drained
+	int out = 0;
+	NW_CHECK(queue.pop(out) && out == 1);
+	int batch[4];
+	NW_CHECK(queue.pop_n_wait(batch, 4) == 1 && batch[0] == 2);
+	NW_CHECK(!queue.pop(out));
+	NW_CHECK(queue.pop_n_wait(batch, 4) == 0);
+
+	// A consumer sleeping on an empty queue is released too
+	nw::blocking_spsc_queue<int> empty(2);
+	bool popped = true;
+	std::thread waiting([&empty, &popped]()
+	{
+		int value = 0;
+		popped = empty.pop(value);
+	});
+	empty.close();
+	waiting.join();
+	NW_CHECK(!popped);
+}
+
+int main()
+{
+	test_boundaries();
+	test_spsc_stress();
+	test_mpmc_stress();
+	test_blocking_stress();
+	test_close();
+	return nw_test::result();
+}
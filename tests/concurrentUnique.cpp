@@ -0,0 +1,63 @@
+#include "test.hpp"
+
+#include <nowifi/util/concurrentUnique.hpp>
+
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+void test_threads()
+{
+	std::vector<std::string> tokens;
+	std::unordered_map<std::string, int> expected;
+	for (int idx = 0; idx < 100000; idx++)
+	{
+		tokens.push_back(std::to_string((idx * 7919) % 5000));
+		expected[tokens.back()]++;
+	}
+
+	nw::unique::sharded_map<std::string> counts(16);
+	std::vector<std::thread> threads;
+	for (size_t part = 0; part < 4; part++)
+	{
+		threads.emplace_back([&counts, &tokens, part]()
+		{
+			auto local = counts.local(1000);
+			for (size_t idx = part; idx < tokens.size(); idx += 4)
+			{
+				// Half through the locked path, half through the local map
+				if (idx % 2 == 0) local.inc(tokens[idx]);
+				else counts.inc(tokens[idx]);
+			}
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+
+	NW_CHECK(counts.size() == expected.size());
+	for (const auto& item : expected) NW_CHECK(counts.get(item.first) == item.second);
+
+	const auto collected = counts.collect();
+	NW_CHECK(collected.size() == expected.size());
+	NW_CHECK(collected.get("42", 0) == expected["42"]);
+}
+
+void test_count_parallel()
+{
+	std::vector<int> values(50000);
+	for (size_t idx = 0; idx < values.size(); idx++) values[idx] = static_cast<int>(idx % 333);
+
+	nw::unique::sharded_map<int> counts;
+	nw::unique::count_parallel(counts, values.data(), values.size());
+	NW_CHECK(counts.size() == 333);
+	NW_CHECK(counts.get(0) == 151 && counts.get(332) == 150);
+
+	NW_CHECK(nw::unique::sharded_map<int>(size_t(1) << 20).shard_count() == nw::unique::sharded_map<int>::max_shards);
+}
+
+int main()
+{
+	test_threads();
+	test_count_parallel();
+	return nw_test::result();
+}
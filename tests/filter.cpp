@@ -0,0 +1,116 @@
+#include "test.hpp"
+
+#include <nowifi/util/filter.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// <count> consecutive keys from <first>
+std::vector<uint64_t> keys(uint64_t first, size_t count)
+{
+	std::vector<uint64_t> values(count);
+	for (size_t idx = 0; idx < count; idx++) values[idx] = first + idx;
+	return values;
+}
+
+template <class Filter>
+size_t false_positives(const Filter& filter, uint64_t first, size_t count)
+{
+	size_t found = 0;
+	for (uint64_t key = first; key < first + count; key++) found += filter.contains(key);
+	return found;
+}
+
+void test_bloom()
+{
+	const std::vector<uint64_t> added = keys(0, 20000);
+	auto filter = nw::BloomFilter<uint64_t>::from_error(added.size(), 0.01);
+	filter.insert(added.data(), added.size());
+	for (uint64_t key : added) NW_CHECK(filter.contains(key));
+	NW_CHECK(false_positives(filter, 1000000, 100000) < 2000);
+
+	// Parallel build sets the same bits
+	auto parallel = nw::BloomFilter<uint64_t>::from_error(added.size(), 0.01);
+	parallel.insert(added.data(), added.size(), true);
+	const std::unique_ptr<bool[]> answers(new bool[added.size()]);
+	NW_CHECK(parallel.query(added.data(), added.size(), answers.get()) == added.size());
+
+	// Round trip
+	std::stringstream stream;
+	filter.writeBinary(stream);
+	nw::BloomFilter<uint64_t> loaded;
+	loaded.readBinary(stream);
+	NW_CHECK(loaded.block_count() == filter.block_count());
+	for (uint64_t key : added) NW_CHECK(loaded.contains(key));
+	NW_CHECK(false_positives(loaded, 1000000, 100000) == false_positives(filter, 1000000, 100000));
+
+	// Truncated input is an error and leaves the filter as it was
+	const std::string bytes = stream.str();
+	std::istringstream cut(bytes.substr(0, bytes.size() - 1));
+	NW_CHECK_THROWS(loaded.readBinary(cut), std::string);
+	NW_CHECK(loaded.block_count() == filter.block_count() && loaded.contains(added[0]));
+
+	// A huge stored count is not allocated up front
+	std::stringstream corrupt;
+	nw::Writer_writeBinary(nw::BloomFilter<uint64_t>::magic, corrupt);
+	nw::Writer_writeBinary(uint64_t(1) << 58, corrupt);
+	nw::Writer_writeBinary(uint64_t(0), corrupt);
+	NW_CHECK_THROWS(loaded.readBinary(corrupt), std::string);
+	NW_CHECK(loaded.block_count() == filter.block_count());
+}
+
+void test_cuckoo()
+{
+	const std::vector<uint64_t> added = keys(0, 20000);
+	nw::CuckooFilter<uint64_t> filter(added.size());
+	NW_CHECK(filter.insert(added.data(), added.size()) == added.size());
+	NW_CHECK(filter.size() == added.size());
+	for (uint64_t key : added) NW_CHECK(filter.contains(key));
+	NW_CHECK(false_positives(filter, 1000000, 100000) < 100);
+
+	// Round trip
+	std::stringstream stream;
+	filter.writeBinary(stream);
+	nw::CuckooFilter<uint64_t> loaded;
+	loaded.readBinary(stream);
+	NW_CHECK(loaded.size() == filter.size() && loaded.capacity() == filter.capacity());
+	for (uint64_t key : added) NW_CHECK(loaded.contains(key));
+
+	// Truncated input is an error and leaves the filter as it was
+	const std::string bytes = stream.str();
+	std::istringstream cut(bytes.substr(0, bytes.size() - 1));
+	NW_CHECK_THROWS(loaded.readBinary(cut), std::string);
+	NW_CHECK(loaded.size() == filter.size() && loaded.contains(added[0]));
+
+	// Removal
+	for (size_t idx = 0; idx < added.size(); idx += 2) NW_CHECK(filter.remove(added[idx]));
+	NW_CHECK(filter.size() == added.size() / 2);
+	for (size_t idx = 1; idx < added.size(); idx += 2) NW_CHECK(filter.contains(added[idx]));
+}
+
+void test_cuckoo_full()
+{
+	const std::vector<uint64_t> many = keys(0, 1000);
+	nw::CuckooFilter<uint64_t, uint8_t> filter(8);
+	const size_t added = filter.insert(many.data(), many.size());
+	NW_CHECK(added < many.size() && filter.full());
+
+	// The count includes the victim: every counted key is still reported present
+	NW_CHECK(filter.size() == added);
+	for (size_t idx = 0; idx < added; idx++) NW_CHECK(filter.contains(many[idx]));
+
+	// Once full nothing more is taken
+	NW_CHECK(filter.insert(many.data() + added, 10) == 0);
+	NW_CHECK(filter.size() == added);
+}
+
+int main()
+{
+	test_bloom();
+	test_cuckoo();
+	test_cuckoo_full();
+	return nw_test::result();
+}
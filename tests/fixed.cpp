@@ -0,0 +1,58 @@
+#include "test.hpp"
+
+#include <nowifi/util/fixed.hpp>
+
+#include <deque>
+#include <stack>
+
+// The ring_buffer helpers keep the semantics of the std::deque/std::stack ones
+
+void test_stack()
+{
+	std::stack<int> reference;
+	nw::ring_buffer<int, 3> ring;
+	for (int val = 1; val <= 5; val++)
+	{
+		nw::fixed::stack::push(reference, 3, val);
+		nw::fixed::stack::push(ring, val);
+	}
+	NW_CHECK(reference.size() == 3 && reference.top() == 3);
+	NW_CHECK(ring.size() == 3 && ring.back() == 3);
+	NW_CHECK(nw::fixed::stack::pop(ring) == 3);
+
+	// Explicit eviction drops the bottom instead
+	nw::ring_buffer<int, 3> evicting;
+	bool evicted = false;
+	for (int val = 1; val <= 5; val++) evicted = nw::fixed::stack::push_evict(evicting, val);
+	NW_CHECK(evicted);
+	NW_CHECK(evicting.size() == 3 && evicting.front() == 3 && evicting.back() == 5);
+}
+
+void test_deque()
+{
+	std::deque<int> reference;
+	nw::ring_buffer<int, 3> ring;
+	for (int val = 1; val <= 5; val++)
+	{
+		nw::fixed::deque::push_back(reference, 3, val);
+		nw::fixed::deque::push_back(ring, val);
+	}
+	NW_CHECK(reference.front() == 3 && reference.back() == 5);
+	NW_CHECK(ring.front() == 3 && ring.back() == 5);
+
+	nw::fixed::deque::push_front(reference, 3, 0);
+	nw::fixed::deque::push_front(ring, 0);
+	NW_CHECK(reference.front() == 0 && reference.back() == 4);
+	NW_CHECK(ring.front() == 0 && ring.back() == 4);
+
+	nw::fixed::deque::fixsize_front(reference, 1);
+	nw::fixed::deque::fixsize_front(ring, 1);
+	NW_CHECK(reference.size() == 1 && ring.size() == 1 && ring.front() == reference.front());
+}
+
+int main()
+{
+	test_stack();
+	test_deque();
+	return nw_test::result();
+}
@@ -0,0 +1,145 @@
+#include "test.hpp"
+
+#include <nowifi/util/map/flatMap.hpp>
+#include <nowifi/util/unique.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+// Every key of the form i << 32 lands on home slot 0
+struct identity_hasher
+{
+	uint64_t operator()(uint64_t key) const { return key; }
+};
+
+// Few distinct hashes: long, interleaved probe chains
+struct weak_hasher
+{
+	uint64_t operator()(uint64_t key) const { return (key % 7) * 0x9E3779B97F4A7C15ull; }
+};
+
+void test_colliding_chain()
+{
+	nw::flat_map<uint64_t, uint64_t, identity_hasher> map;
+	for (uint64_t idx = 0; idx < 600; idx++) map[idx << 32] = idx;
+	NW_CHECK(map.size() == 600);
+
+	for (uint64_t idx = 0; idx < 600; idx += 2) NW_CHECK(map.erase(idx << 32) == 1);
+	NW_CHECK(map.size() == 300);
+
+	for (uint64_t idx = 0; idx < 600; idx++)
+	{
+		const auto it = map.find(idx << 32);
+		if (idx % 2 == 0) NW_CHECK(it == map.end());
+		else NW_CHECK(it != map.end() && it->second == idx);
+	}
+
+	// Reinserting after the backward shifts lands on the same chain
+	for (uint64_t idx = 0; idx < 600; idx += 2) NW_CHECK(map.try_emplace(idx << 32, idx).second);
+	NW_CHECK(map.size() == 600);
+	for (uint64_t idx = 0; idx < 600; idx++) NW_CHECK(map.get(idx << 32, ~uint64_t(0)) == idx);
+}
+
+void test_against_unordered_map()
+{
+	nw::flat_map<uint64_t, int, weak_hasher> map;
+	std::unordered_map<uint64_t, int> expected;
+	std::mt19937_64 gen(7);
+	for (int step = 0; step < 200000; step++)
+	{
+		const uint64_t key = gen() % 3000;
+		switch (gen() % 4)
+		{
+		case 0:
+		case 1:
+			map[key] += step;
+			expected[key] += step;
+			break;
+		case 2:
+			NW_CHECK(map.erase(key) == expected.erase(key));
+			break;
+		default:
+			NW_CHECK(map.contains(key) == (expected.count(key) != 0));
+			break;
+		}
+	}
+	NW_CHECK(map.size() == expected.size());
+	for (const auto& item : expected) NW_CHECK(map.get(item.first, -1) == item.second);
+
+	size_t visited = 0;
+	for (const auto& item : map)
+	{
+		NW_CHECK(expected.at(item.first) == item.second);
+		visited++;
+	}
+	NW_CHECK(visited == expected.size());
+}
+
+void test_const_key()
+{
+	using map_type = nw::flat_map<std::string, int>;
+	static_assert(std::is_same<decltype((std::declval<map_type::iterator>()->first)), const std::string&>::value, "keys are read-only through iterator");
+	static_assert(std::is_same<decltype(((*std::declval<map_type::iterator>()).second)), int&>::value, "values are writable through iterator");
+	static_assert(std::is_same<std::iterator_traits<map_type::iterator>::reference, map_type::value_type&>::value, "iterator yields a real reference");
+
+	map_type map{ { "a", 1 }, { "b", 2 } };
+	for (auto& item : map) item.second *= 10;
+	map.find("b")->second++;
+	NW_CHECK(map.at("a") == 10 && map.at("b") == 21);
+
+	map_type::const_iterator it = map.find("a");
+	NW_CHECK(it->second == 10);
+}
+
+void test_mutable_iteration()
+{
+	nw::flat_map<std::string, std::string> map;
+	for (int idx = 0; idx < 100; idx++) map[std::to_string(idx)] = "v";
+
+	// Erasing rebuilds the moved entry in place; iteration sees the result
+	for (int idx = 0; idx < 100; idx += 3) NW_CHECK(map.erase(std::to_string(idx)) == 1);
+	for (auto& [key, value] : map) value += key;
+	std::for_each(map.begin(), map.end(), [](auto& item) { item.second += "!"; });
+
+	size_t visited = 0;
+	for (int idx = 0; idx < 100; idx++)
+	{
+		const std::string key = std::to_string(idx);
+		if (idx % 3 == 0) NW_CHECK(!map.contains(key));
+		else
+		{
+			NW_CHECK(map.at(key) == "v" + key + "!");
+			visited++;
+		}
+	}
+	NW_CHECK(visited == map.size());
+
+	// References stay valid while nothing is inserted
+	auto& first = *map.begin();
+	first.second = "changed";
+	NW_CHECK(map.at(first.first) == "changed");
+}
+
+void test_unique()
+{
+	nw::unique::map<std::string> counts;
+	for (const char* word : { "x", "y", "x", "z", "x" }) nw::unique::inc(counts, std::string(word));
+	nw::unique::dec(counts, std::string("y"));
+	NW_CHECK(nw::unique::get(counts, std::string("x")) == 3);
+	NW_CHECK(nw::unique::get(counts, std::string("y")) == 0);
+}
+
+int main()
+{
+	test_colliding_chain();
+	test_against_unordered_map();
+	test_const_key();
+	test_mutable_iteration();
+	test_unique();
+	return nw_test::result();
+}
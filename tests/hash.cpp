@@ -0,0 +1,95 @@
+#include "test.hpp"
+
+#include <nowifi/util/hash.hpp>
+#include <nowifi/util/unique.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+struct Packed
+{
+	uint32_t first;
+	uint32_t second;
+};
+
+// Padding after <tag>: hashed through std::hash below, never by bytes
+struct Padded
+{
+	char tag;
+	uint64_t value;
+
+	bool operator==(const Padded& other) const { return tag == other.tag && value == other.value; }
+};
+
+namespace std {
+	template <>
+	struct hash<Padded>
+	{
+		size_t operator()(const Padded& padded) const noexcept
+		{
+			return static_cast<size_t>(nw::hash64::hash_int(padded.value, static_cast<uint64_t>(padded.tag)));
+		}
+	};
+}
+
+template <class Ty>
+void check_float_hash()
+{
+	const nw::hash64::hasher<Ty> hasher;
+	NW_CHECK(hasher(Ty(0)) == hasher(-Ty(0)));
+	NW_CHECK(hasher(Ty(1.5)) == hasher(Ty(1.5)));
+	NW_CHECK(hasher(Ty(1.5)) != hasher(Ty(-1.5)));
+	NW_CHECK(hasher(Ty(1)) != hasher(Ty(2)));
+	NW_CHECK(hasher(std::numeric_limits<Ty>::infinity()) != hasher(-std::numeric_limits<Ty>::infinity()));
+
+	// NaNs with another sign or payload hash as one
+	Ty other_nan = -std::numeric_limits<Ty>::quiet_NaN();
+	NW_CHECK(hasher(other_nan) == hasher(std::numeric_limits<Ty>::quiet_NaN()));
+	NW_CHECK(hasher(std::numeric_limits<Ty>::signaling_NaN()) == hasher(std::numeric_limits<Ty>::quiet_NaN()));
+	NW_CHECK(hasher(static_cast<Ty>(std::nan("1"))) == hasher(static_cast<Ty>(std::nan("2"))));
+}
+
+void test_floats()
+{
+	check_float_hash<float>();
+	check_float_hash<double>();
+	check_float_hash<long double>();
+
+	// The map invariant: equal keys are one entry
+	nw::unique::map<double> counts;
+	nw::unique::inc(counts, 0.0);
+	nw::unique::inc(counts, -0.0);
+	NW_CHECK(counts.size() == 1);
+	NW_CHECK(nw::unique::get(counts, 0.0) == 2);
+}
+
+void test_fallbacks()
+{
+	// Unique object representations hash their bytes
+	const nw::hash64::hasher<Packed> packed;
+	NW_CHECK(packed(Packed{ 1, 2 }) == packed(Packed{ 1, 2 }));
+	NW_CHECK(packed(Packed{ 1, 2 }) != packed(Packed{ 2, 1 }));
+
+	// Padding is not hashed: equal values built from different garbage hash equal
+	Padded lhs, rhs;
+	std::memset(&lhs, 0x00, sizeof(Padded));
+	std::memset(&rhs, 0xAB, sizeof(Padded));
+	lhs.tag = rhs.tag = 'x';
+	lhs.value = rhs.value = 42;
+	const nw::hash64::hasher<Padded> padded;
+	NW_CHECK(padded(lhs) == padded(rhs));
+
+	NW_CHECK(nw::hash64::hasher<int>()(5) == nw::hash64::hasher<int>()(5));
+	NW_CHECK(nw::hash64::hasher<std::string>()(std::string("key")) == nw::hash64::string_hasher()("key"));
+}
+
+int main()
+{
+	test_floats();
+	test_fallbacks();
+	return nw_test::result();
+}
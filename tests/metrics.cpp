@@ -0,0 +1,106 @@
+#include "test.hpp"
+
+#include <nowifi/util/metrics.hpp>
+#include <nowifi/io/scanner.hpp>
+#include <nowifi/io/writer.hpp>
+
+#include <sstream>
+#include <string>
+
+void test_json_escape()
+{
+	NW_CHECK(nw::metrics::_json_escape("scanner.tokens") == "scanner.tokens");
+	NW_CHECK(nw::metrics::_json_escape("a\"b\\c") == "a\\\"b\\\\c");
+	NW_CHECK(nw::metrics::_json_escape(std::string("\n\t\x01\x1f", 4)) == "\\u000a\\u0009\\u0001\\u001f");
+	NW_CHECK(nw::metrics::_json_escape(std::string("\0x", 2)) == "\\u0000x");
+	NW_CHECK(nw::metrics::_json_escape("\x7f\xc3\xa9") == "\x7f\xc3\xa9");
+}
+
+void test_scanner_counts()
+{
+	const nw::metrics::Counter tokens("scanner.tokens");
+	const nw::metrics::Counter errors("scanner.errors");
+
+	// next() retries after the bad line: one error, one token
+	{
+		std::istringstream iss("bad\n5\n");
+		nw::Scanner scanner(iss, nw::global::Error_Nothing<std::string>);
+		const int64_t before_tokens = tokens.value(), before_errors = errors.value();
+		NW_CHECK(scanner.next<int>() == 5);
+		NW_CHECK(tokens.value() - before_tokens == 1);
+		NW_CHECK(errors.value() - before_errors == 1);
+	}
+
+	// A read that throws is not a token
+	{
+		std::istringstream iss("bad");
+		nw::Scanner scanner(iss);
+		const int64_t before_tokens = tokens.value();
+		NW_CHECK_THROWS(scanner.next<int>(), std::string);
+		NW_CHECK(tokens.value() == before_tokens);
+	}
+
+	// nextParam() counts only the values it read
+	{
+		std::istringstream iss("1 2 x");
+		nw::Scanner scanner(iss, nw::global::Error_Nothing<std::string>);
+		const int64_t before_tokens = tokens.value(), before_errors = errors.value();
+		int first = 0, second = 0, third = 0;
+		scanner.nextParam(first, second, third);
+		NW_CHECK(first == 1 && second == 2);
+		NW_CHECK(tokens.value() - before_tokens == 2);
+		NW_CHECK(errors.value() - before_errors == 1);
+	}
+
+	// A failed nextWord() at the end of the stream is not a token
+	{
+		std::istringstream iss("word");
+		nw::Scanner scanner(iss, nw::global::Error_Nothing<std::string>);
+		const int64_t before_tokens = tokens.value();
+		NW_CHECK(scanner.nextWord() == "word");
+		static_cast<void>(scanner.nextWord());
+		NW_CHECK(tokens.value() - before_tokens == 1);
+	}
+}
+
+void test_binary_counts()
+{
+	const nw::metrics::Counter written("writer.binary_bytes");
+	const nw::metrics::Counter writer_errors("writer.errors");
+	const nw::metrics::Counter read("scanner.binary_bytes");
+	const nw::metrics::Counter scanner_errors("scanner.errors");
+	const uint32_t words[3] = { 1, 2, 3 };
+
+	std::stringstream ss;
+	int64_t before = written.value();
+	nw::Writer_writeBinary(words[0], ss);
+	nw::Writer_writeBinaryArray(words, 3, ss);
+	NW_CHECK(written.value() - before == 4 * sizeof(uint32_t));
+
+	// A failed write counts an error and no bytes
+	std::ostream broken(nullptr);
+	before = written.value();
+	const int64_t before_writer_errors = writer_errors.value();
+	nw::Writer_writeBinary(words[0], broken, nw::global::Error_Nothing<std::string>);
+	nw::Writer_writeBinaryArray(words, 3, broken, nw::global::Error_Nothing<std::string>);
+	NW_CHECK(written.value() == before);
+	NW_CHECK(writer_errors.value() - before_writer_errors == 2);
+
+	// Same for reads: the truncated array is an error, not bytes
+	before = read.value();
+	const int64_t before_scanner_errors = scanner_errors.value();
+	uint32_t value = 0, rest[4] = {};
+	nw::Scanner_readBinary(value, ss, nw::global::Error_Nothing<std::string>);
+	NW_CHECK(value == 1 && read.value() - before == sizeof(uint32_t));
+	nw::Scanner_readBinaryArray(rest, 4, ss, nw::global::Error_Nothing<std::string>);
+	NW_CHECK(read.value() - before == sizeof(uint32_t));
+	NW_CHECK(scanner_errors.value() - before_scanner_errors == 1);
+}
+
+int main()
+{
+	test_json_escape();
+	test_scanner_counts();
+	test_binary_counts();
+	return nw_test::result();
+}
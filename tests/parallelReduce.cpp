@@ -0,0 +1,182 @@
+#include "test.hpp"
+
+#include <nowifi/math/reducer/parallel.hpp>
+#include <nowifi/math/reducer/summation.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+using namespace nw::reducer;
+
+void set_threads(int threads)
+{
+#if defined(_OPENMP)
+	omp_set_num_threads(threads);
+#else
+	static_cast<void>(threads);
+#endif
+}
+
+bool same_bits(double lhs, double rhs)
+{
+	return std::memcmp(&lhs, &rhs, sizeof(double)) == 0;
+}
+
+// Magnitudes from 1e-8 to 1e8, both signs: naive sums lose digits
+std::vector<double> spread_data(size_t size)
+{
+	std::mt19937_64 gen(5);
+	std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+	std::uniform_int_distribution<int> exponent(-8, 8);
+	std::vector<double> values(size);
+	for (double& value : values) value = mantissa(gen) * std::pow(10.0, exponent(gen));
+	return values;
+}
+
+void test_integer_matches_reduce()
+{
+	std::mt19937 gen(1);
+	std::vector<int> values(100003);
+	for (int& value : values) value = static_cast<int>(gen() % 2001) - 1000;
+
+	const auto expected = reduce(values, Sum<>(), Min(), Max(), Count(), ArgMin(), ArgMax());
+	for (size_t chunk : { size_t(1), size_t(7), size_t(1000), size_t(65536), size_t(1000000) })
+	{
+		for (int threads : { 1, 2, 3, 4 })
+		{
+			set_threads(threads);
+			NW_CHECK(parallel_reduce_chunked(chunk, values.data(), values.size(), Sum<>(), Min(), Max(), Count(), ArgMin(), ArgMax()) == expected);
+		}
+	}
+
+	// Ties across chunks keep the first index
+	std::vector<int> ties(1000, 3);
+	ties[10] = ties[500] = ties[900] = -1;
+	NW_CHECK(std::get<0>(parallel_reduce_chunked(7, ties.data(), ties.size(), ArgMin())) == std::make_pair(-1, size_t(10)));
+
+	const auto empty = parallel_reduce(values.data(), 0, Sum<>(), Count());
+	NW_CHECK(std::get<0>(empty) == 0 && std::get<1>(empty) == 0);
+}
+
+void test_float_deterministic()
+{
+	const std::vector<double> values = spread_data(200001);
+	for (size_t chunk : { size_t(1000), size_t(4096) })
+	{
+		set_threads(1);
+		const auto single = parallel_reduce_chunked(chunk, values.data(), values.size(), Sum<>(), PairwiseSum(), KahanSum(), ExactSum());
+		for (int threads : { 2, 3, 4 })
+		{
+			set_threads(threads);
+			const auto multi = parallel_reduce_chunked(chunk, values.data(), values.size(), Sum<>(), PairwiseSum(), KahanSum(), ExactSum());
+			NW_CHECK(same_bits(std::get<0>(multi), std::get<0>(single)));
+			NW_CHECK(same_bits(std::get<1>(multi), std::get<1>(single)));
+			NW_CHECK(same_bits(std::get<2>(multi), std::get<2>(single)));
+			NW_CHECK(same_bits(std::get<3>(multi), std::get<3>(single)));
+		}
+	}
+
+	// The exact sum does not depend on the chunking either
+	const double exact = std::get<0>(reduce(values, ExactSum()));
+	for (size_t chunk : { size_t(1), size_t(333), size_t(65536) })
+	{
+		NW_CHECK(same_bits(std::get<0>(parallel_reduce_chunked(chunk, values.data(), values.size(), ExactSum())), exact));
+	}
+	set_threads(1);
+}
+
+void test_accuracy()
+{
+	// Cancellation only the exact sum survives
+	const std::vector<double> cancel = { 1e100, 1.0, -1e100, 1e-30 };
+	NW_CHECK(std::get<0>(reduce(cancel, ExactSum())) == 1.0 + 1e-30);
+
+	// 0.1 ten million times: compare with the correctly rounded sum
+	const std::vector<double> tenths(10000000, 0.1);
+	const auto sums = reduce(tenths, Sum<>(), PairwiseSum(), KahanSum(), ExactSum());
+	const double exact = std::get<3>(sums);
+	NW_CHECK(exact == 1000000.0); // math.fsum([0.1] * 10000000)
+	NW_CHECK(std::fabs(std::get<2>(sums) - exact) <= 1e-9);
+	NW_CHECK(std::fabs(std::get<1>(sums) - exact) <= 1e-7);
+	NW_CHECK(std::fabs(std::get<1>(sums) - exact) <= std::fabs(std::get<0>(sums) - exact));
+
+	const std::vector<double> values = spread_data(100000);
+	const double reference = std::get<0>(reduce(values, ExactSum()));
+	NW_CHECK(std::fabs(std::get<0>(reduce(values, KahanSum())) - reference) <= 1e-6);
+	NW_CHECK(std::fabs(std::get<0>(reduce(values, PairwiseSum())) - reference) <= 1e-6);
+
+	// Infinities and NaNs
+	NW_CHECK(std::isinf(std::get<0>(reduce(std::vector<double>{ 1.0, INFINITY, 2.0 }, ExactSum()))));
+	NW_CHECK(std::isnan(std::get<0>(reduce(std::vector<double>{ INFINITY, -INFINITY }, ExactSum()))));
+}
+
+void test_merge()
+{
+	const std::vector<double> values = spread_data(10000);
+	const double reference = std::get<0>(reduce(values, ExactSum()));
+
+	KahanSumOf<double> kahan_left, kahan_right;
+	PairwiseSumOf<double> pairwise_left, pairwise_right;
+	ExactSumOf<double> exact_left, exact_right;
+	kahan_left.consume(values.data(), 3000);
+	kahan_right.consume(values.data() + 3000, 7000);
+	pairwise_left.consume(values.data(), 3000);
+	pairwise_right.consume(values.data() + 3000, 7000);
+	exact_left.consume(values.data(), 3000);
+	exact_right.consume(values.data() + 3000, 7000);
+
+	NW_CHECK(std::fabs(kahan_left.merge(kahan_right).result() - reference) <= 1e-6);
+	NW_CHECK(std::fabs(pairwise_left.merge(pairwise_right).result() - reference) <= 1e-6);
+	NW_CHECK(same_bits(exact_left.merge(exact_right).result(), reference));
+
+	// Merging the identity changes nothing
+	ExactSumOf<double> exact;
+	exact.consume(values.data(), values.size());
+	NW_CHECK(same_bits(exact.merge(identity_of(exact)).result(), reference));
+}
+
+void test_tree_merge()
+{
+	for (size_t parts : { 1, 2, 3, 5, 8, 17 })
+	{
+		std::vector<ArgMaxOf<int>> partial(parts);
+		std::vector<int> all;
+		for (size_t part = 0; part < parts; part++)
+		{
+			const std::vector<int> values = { int(part % 4), 7, int(part) };
+			partial[part].consume(values.data(), values.size());
+			all.insert(all.end(), values.begin(), values.end());
+		}
+		tree_merge(partial);
+		NW_CHECK(partial[0].result() == std::get<0>(reduce(all, ArgMax())));
+	}
+
+	// Tuples merge element-wise
+	std::vector<std::tuple<SumOf<int>, CountOf<int>>> tuples(6);
+	for (size_t part = 0; part < tuples.size(); part++)
+	{
+		std::get<0>(tuples[part]).consume(static_cast<int>(part));
+		std::get<1>(tuples[part]).consume(0);
+	}
+	tree_merge(tuples);
+	NW_CHECK(std::get<0>(tuples[0]).result() == 15);
+	NW_CHECK(std::get<1>(tuples[0]).result() == 6);
+}
+
+int main()
+{
+	test_integer_matches_reduce();
+	test_float_deterministic();
+	test_accuracy();
+	test_merge();
+	test_tree_merge();
+	return nw_test::result();
+}
@@ -0,0 +1,135 @@
+#include "test.hpp"
+
+#include <nowifi/util/profile.hpp>
+#include <nowifi/util/time.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using nw::profile::LatencyHistogram;
+
+// Powers of two, their neighbours and random values across the range
+std::vector<uint64_t> probe_values()
+{
+	std::vector<uint64_t> values = { 0, UINT64_MAX };
+	for (int bit = 0; bit < 64; bit++)
+	{
+		const uint64_t power = uint64_t(1) << bit;
+		values.push_back(power - 1);
+		values.push_back(power);
+		values.push_back(power + 1);
+	}
+	std::mt19937_64 gen(13);
+	for (int idx = 0; idx < 10000; idx++) values.push_back(gen() >> (gen() % 64));
+	return values;
+}
+
+void test_buckets()
+{
+	for (uint64_t value = 0; value < LatencyHistogram::sub_count; value++)
+	{
+		NW_CHECK(LatencyHistogram::bucket(value) == value);
+		NW_CHECK(LatencyHistogram::bucket_low(value) == value && LatencyHistogram::bucket_high(value) == value);
+	}
+
+	for (uint64_t value : probe_values())
+	{
+		const size_t idx = LatencyHistogram::bucket(value);
+		NW_CHECK(idx < LatencyHistogram::bucket_count);
+		NW_CHECK(LatencyHistogram::bucket_low(idx) <= value && value <= LatencyHistogram::bucket_high(idx));
+	}
+	NW_CHECK(LatencyHistogram::bucket(UINT64_MAX) == LatencyHistogram::bucket_count - 1);
+	NW_CHECK(LatencyHistogram::bucket_high(LatencyHistogram::bucket_count - 1) == UINT64_MAX);
+
+	// Buckets tile the range, each within 1/32 of its low edge
+	for (size_t idx = 0; idx + 1 < LatencyHistogram::bucket_count; idx++)
+	{
+		const uint64_t low = LatencyHistogram::bucket_low(idx), high = LatencyHistogram::bucket_high(idx);
+		NW_CHECK(high + 1 == LatencyHistogram::bucket_low(idx + 1));
+		NW_CHECK((high - low) <= low / LatencyHistogram::sub_count);
+	}
+}
+
+void test_quantiles()
+{
+	const auto histogram = std::make_unique<LatencyHistogram>();
+	NW_CHECK(histogram->count() == 0 && histogram->quantile(0.5) == 0 && histogram->mean() == 0.0);
+
+	constexpr uint64_t items = 100000;
+	for (uint64_t value = 1; value <= items; value++) histogram->record(value);
+	NW_CHECK(histogram->count() == items);
+	NW_CHECK(histogram->sum() == items * (items + 1) / 2);
+	NW_CHECK(histogram->min() == 1 && histogram->max() == items);
+	NW_CHECK(histogram->mean() == (items + 1) / 2.0);
+	NW_CHECK(histogram->quantile(0.0) == 1);
+	NW_CHECK(histogram->quantile(1.0) <= items);
+
+	// Bucket midpoints: within 1/32 of the exact rank
+	for (double q : { 0.001, 0.1, 0.5, 0.9, 0.99, 0.999, 1.0 })
+	{
+		const double exact = q * static_cast<double>(items);
+		const double found = static_cast<double>(histogram->quantile(q));
+		NW_CHECK(found >= exact * (1.0 - 1.0 / 32) - 1 && found <= exact * (1.0 + 1.0 / 32) + 1);
+	}
+
+	// Exact below 32
+	const auto small = std::make_unique<LatencyHistogram>();
+	for (uint64_t value : { 3, 3, 7, 20 }) small->record(value);
+	NW_CHECK(small->quantile(0.25) == 3 && small->quantile(0.5) == 3);
+	NW_CHECK(small->quantile(0.75) == 7 && small->quantile(1.0) == 20);
+}
+
+void test_merge()
+{
+	const auto whole = std::make_unique<LatencyHistogram>();
+	const auto left = std::make_unique<LatencyHistogram>();
+	const auto right = std::make_unique<LatencyHistogram>();
+	std::mt19937_64 gen(21);
+	for (int idx = 0; idx < 50000; idx++)
+	{
+		const uint64_t value = gen() >> (20 + gen() % 40);
+		whole->record(value);
+		(idx % 3 == 0 ? left : right)->record(value);
+	}
+	left->merge(*right);
+	NW_CHECK(left->count() == whole->count() && left->sum() == whole->sum());
+	NW_CHECK(left->min() == whole->min() && left->max() == whole->max());
+	for (double q : { 0.0, 0.25, 0.5, 0.75, 0.99, 1.0 }) NW_CHECK(left->quantile(q) == whole->quantile(q));
+
+	// Merging an empty histogram changes nothing
+	const auto empty = std::make_unique<LatencyHistogram>();
+	left->merge(*empty);
+	NW_CHECK(left->min() == whole->min() && left->max() == whole->max() && left->count() == whole->count());
+}
+
+void test_tsc()
+{
+	// The check is made once: every call agrees
+	NW_CHECK(nw::tsc::hardware() == nw::tsc::hardware());
+	NW_CHECK(nw::tsc::ns_per_tick() > 0.0);
+	if (!nw::tsc::hardware()) NW_CHECK(nw::tsc::ns_per_tick() == 1.0);
+
+	const uint64_t first = nw::tsc::read();
+	const auto start = std::chrono::steady_clock::now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	const uint64_t last = nw::tsc::read_ordered();
+	const double steady = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	NW_CHECK(last > first);
+
+	// Loose: the calibration is short and the machine may be busy
+	const double measured = nw::tsc::to_ns(last - first);
+	NW_CHECK(measured > 0.5 * steady && measured < 2.0 * steady);
+}
+
+int main()
+{
+	test_buckets();
+	test_quantiles();
+	test_merge();
+	test_tsc();
+	return nw_test::result();
+}
@@ -0,0 +1,107 @@
+#include "test.hpp"
+
+#include <nowifi/io/scanner.hpp>
+#include <nowifi/math/reducer/scan.hpp>
+
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace nw::reducer;
+
+// readChunked_all into a vector, with error reporting through <err>
+std::vector<int> read_all(const std::string& text, size_t chunk, const nw::Error<std::string>& err = nw::global::Error_Throw<std::string>)
+{
+	std::istringstream iss(text);
+	nw::Scanner scanner(iss, err);
+	std::vector<int> values;
+	const size_t total = scanner.readChunked_all<int>([&values](const int* arr, size_t count) { values.insert(values.end(), arr, arr + count); }, chunk);
+	NW_CHECK(total == values.size());
+	return values;
+}
+
+void test_readChunked_all()
+{
+	for (size_t chunk : { 1, 2, 3, 4, 1000 })
+	{
+		NW_CHECK(read_all("", chunk).empty());
+		NW_CHECK(read_all(" \n\t ", chunk).empty());
+		NW_CHECK(read_all("1 2 3", chunk) == std::vector<int>({ 1, 2, 3 }));
+		NW_CHECK(read_all("1 2 3\n", chunk) == std::vector<int>({ 1, 2, 3 }));
+		NW_CHECK(read_all("  1\n2\n\n3  \n\n", chunk) == std::vector<int>({ 1, 2, 3 }));
+		NW_CHECK(read_all("-1 +2 3 4 5 6", chunk) == std::vector<int>({ -1, 2, 3, 4, 5, 6 }));
+
+		// A bad token is an error wherever it is, the end of the stream included
+		NW_CHECK_THROWS(read_all("1 2 99999999999", chunk), std::string);
+		NW_CHECK_THROWS(read_all("1 2 99999999999\n", chunk), std::string);
+		NW_CHECK_THROWS(read_all("1 2 -", chunk), std::string);
+		NW_CHECK_THROWS(read_all("1 x 3", chunk), std::string);
+		NW_CHECK_THROWS(read_all("x", chunk), std::string);
+	}
+
+	// Without throwing, the values before the bad token are kept and the error still counts
+	int errors = 0;
+	const nw::Error<std::string> count_errors([&errors](const std::string&) { errors++; });
+	NW_CHECK(read_all("1 2 99999999999", 2, count_errors) == std::vector<int>({ 1, 2 }));
+	NW_CHECK(read_all("1 2 -", 1000, count_errors) == std::vector<int>({ 1, 2 }));
+	NW_CHECK(read_all("1 2 3", 1000, count_errors) == std::vector<int>({ 1, 2, 3 }));
+	NW_CHECK(errors == 2);
+}
+
+void test_nextWord_intern()
+{
+	nw::StringPool pool;
+	std::istringstream iss("alpha beta alpha");
+	nw::Scanner scanner(iss, nw::global::Error_Nothing<std::string>);
+	const auto alpha = scanner.nextWord_intern(pool);
+	const auto beta = scanner.nextWord_intern(pool);
+	NW_CHECK(alpha != beta && scanner.nextWord_intern(pool) == alpha);
+	NW_CHECK(pool.size() == 2);
+
+	// Past the end: no stale token is interned again
+	NW_CHECK(scanner.nextWord_intern(pool) == nw::StringPool::npos);
+	NW_CHECK(scanner.nextWord_intern(pool) == nw::StringPool::npos);
+	NW_CHECK(pool.size() == 2);
+
+	std::istringstream empty("");
+	nw::Scanner throwing(empty);
+	NW_CHECK_THROWS(throwing.nextWord_intern(pool), std::string);
+	NW_CHECK(pool.size() == 2);
+}
+
+void test_scan_reduce()
+{
+	{
+		std::istringstream iss("5 -3 8 1\n7");
+		nw::Scanner scanner(iss);
+		NW_CHECK(scan_reduce<int>(scanner, 4, Min(), Max(), Sum<>()) == std::make_tuple(-3, 8, int64_t(11)));
+		NW_CHECK(scanner.next<int>() == 7);
+	}
+	{
+		std::istringstream iss("5 -3 8 1\n7\n");
+		nw::Scanner scanner(iss);
+		NW_CHECK(scan_reduce_all<int>(scanner, Count(), Sum<>()) == std::make_tuple(size_t(5), int64_t(18)));
+	}
+	{
+		std::istringstream iss("5 -3 8 1 7 99999999999");
+		nw::Scanner scanner(iss);
+		NW_CHECK_THROWS(scan_reduce_all<int>(scanner, Sum<>()), std::string);
+	}
+	{
+		std::istringstream iss("1 10\n2 20\n3 30\n");
+		nw::Scanner scanner(iss);
+		const auto columns = scan_reduce_columns<int>(scanner, 3, 2, Sum<>(), Max());
+		NW_CHECK(columns.size() == 2);
+		NW_CHECK(columns[0] == std::make_tuple(int64_t(6), 3));
+		NW_CHECK(columns[1] == std::make_tuple(int64_t(60), 30));
+	}
+}
+
+int main()
+{
+	test_readChunked_all();
+	test_nextWord_intern();
+	test_scan_reduce();
+	return nw_test::result();
+}
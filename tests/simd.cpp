@@ -0,0 +1,199 @@
+#include "test.hpp"
+
+#include <nowifi/math/reducer/simd.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace simd = nw::reducer::simd;
+
+const simd::level levels[] = { simd::level::scalar, simd::level::sse42, simd::level::avx2, simd::level::avx512 };
+
+// Every size up to a few full unrolled blocks, and around the argmin/argmax block
+std::vector<size_t> sizes()
+{
+	std::vector<size_t> values;
+	for (size_t size = 0; size <= 80; size++) values.push_back(size);
+	for (size_t size : { 127, 128, 129, 4095, 4096, 4097, 3 * 4096 + 17 }) values.push_back(size);
+	return values;
+}
+
+// Few distinct values: plenty of ties
+template <class Ty>
+std::vector<Ty> sample(size_t size, uint32_t seed)
+{
+	std::mt19937 gen(seed);
+	std::vector<Ty> values(size);
+	for (Ty& value : values) value = static_cast<Ty>(static_cast<int>(gen() % 15) - (std::is_signed<Ty>::value ? 7 : 0));
+	return values;
+}
+
+template <class Ty>
+bool same(Ty lhs, Ty rhs)
+{
+	if constexpr (std::is_floating_point<Ty>::value)
+	{
+		if (std::isnan(lhs) || std::isnan(rhs)) return std::isnan(lhs) && std::isnan(rhs);
+	}
+	return lhs == rhs;
+}
+
+//-------------------- reference --------------------//
+
+// MinOf / MaxOf::consume one by one
+template <bool Max, class Ty>
+Ty extreme(const std::vector<Ty>& values, Ty init)
+{
+	for (const Ty& value : values) init = Max ? (init < value ? value : init) : (value < init ? value : init);
+	return init;
+}
+
+// First index of the extremum; a NaN first element is never replaced
+template <bool Max, class Ty>
+std::pair<Ty, size_t> arg_extreme(const std::vector<Ty>& values)
+{
+	if (values.empty()) return std::pair<Ty, size_t>(Ty(), 0);
+	size_t best = 0;
+	for (size_t idx = 1; idx < values.size(); idx++)
+	{
+		if (Max ? values[best] < values[idx] : values[idx] < values[best]) best = idx;
+	}
+	return std::pair<Ty, size_t>(values[best], best);
+}
+
+template <class Ty>
+void check(const std::vector<Ty>& values)
+{
+	const Ty lo = values.empty() ? Ty(0) : values[values.size() / 2];
+	const Ty hi = static_cast<Ty>(lo + 1);
+	const std::pair<Ty, size_t> expected_min = arg_extreme<false>(values);
+	const std::pair<Ty, size_t> expected_max = arg_extreme<true>(values);
+	for (simd::level level : levels)
+	{
+		simd::limit(level);
+		NW_CHECK(same(simd::min(values.data(), values.size(), lo), extreme<false>(values, lo)));
+		NW_CHECK(same(simd::max(values.data(), values.size(), hi), extreme<true>(values, hi)));
+
+		const std::pair<Ty, Ty> bounds = simd::minmax(values.data(), values.size(), lo, hi);
+		NW_CHECK(same(bounds.first, extreme<false>(values, lo)));
+		NW_CHECK(same(bounds.second, extreme<true>(values, hi)));
+
+		const std::pair<Ty, size_t> found_min = simd::argmin(values.data(), values.size());
+		const std::pair<Ty, size_t> found_max = simd::argmax(values.data(), values.size());
+		NW_CHECK(same(found_min.first, expected_min.first) && found_min.second == expected_min.second);
+		NW_CHECK(same(found_max.first, expected_max.first) && found_max.second == expected_max.second);
+	}
+	simd::limit(simd::level::avx512);
+}
+
+//-------------------- tests --------------------//
+
+template <class Ty>
+void check_type()
+{
+	for (size_t size : sizes())
+	{
+		const std::vector<Ty> values = sample<Ty>(size, static_cast<uint32_t>(size));
+		check(values);
+
+		// Unaligned start
+		if (size > 1) check(std::vector<Ty>(values.begin() + 1, values.end()));
+
+		// The extremum only in the tail, past the last full vector
+		if (size == 0) continue;
+		std::vector<Ty> tail = values;
+		tail.back() = std::numeric_limits<Ty>::max();
+		tail.front() = std::numeric_limits<Ty>::lowest();
+		check(tail);
+		std::swap(tail.front(), tail.back());
+		check(tail);
+	}
+}
+
+template <class Ty>
+void check_nan()
+{
+	const Ty nan = std::numeric_limits<Ty>::quiet_NaN();
+	for (size_t size : sizes())
+	{
+		if (size == 0) continue;
+		const std::vector<Ty> values = sample<Ty>(size, static_cast<uint32_t>(size) + 100);
+
+		// NaN first, in the middle, last, and in every slot
+		for (size_t pos : { size_t(0), size / 2, size - 1 })
+		{
+			std::vector<Ty> with_nan = values;
+			with_nan[pos] = nan;
+			check(with_nan);
+		}
+		check(std::vector<Ty>(size, nan));
+
+		// Distinct values: a NaN must not hide the extremum of its lane
+		if (size > 80) continue;
+		std::vector<Ty> distinct(size);
+		for (size_t idx = 0; idx < size; idx++) distinct[idx] = static_cast<Ty>(idx);
+		std::shuffle(distinct.begin(), distinct.end(), std::mt19937(static_cast<uint32_t>(size)));
+		for (size_t pos = 0; pos < size; pos++)
+		{
+			std::vector<Ty> with_nan = distinct;
+			with_nan[pos] = nan;
+			check(with_nan);
+		}
+	}
+
+	// A NaN first element is the answer; later ones are skipped
+	const std::vector<Ty> values = { nan, Ty(3), Ty(-1), nan, Ty(-1) };
+	NW_CHECK(std::isnan(simd::argmin(values.data(), values.size()).first) && simd::argmin(values.data(), values.size()).second == 0);
+	const std::vector<Ty> later = { Ty(3), nan, Ty(-1), nan, Ty(-1) };
+	NW_CHECK(simd::argmin(later.data(), later.size()) == std::make_pair(Ty(-1), size_t(2)));
+	NW_CHECK(simd::min(later.data(), later.size(), Ty(0)) == Ty(-1));
+}
+
+void test_integers()
+{
+	check_type<int32_t>();
+	check_type<uint32_t>();
+	check_type<int64_t>();
+
+	// Not vectorized: the scalar loop at every level
+	check_type<int16_t>();
+	check_type<uint64_t>();
+}
+
+void test_floats()
+{
+	check_type<float>();
+	check_type<double>();
+	check_nan<float>();
+	check_nan<double>();
+}
+
+void test_ties()
+{
+	// Equal values across blocks: the first one wins
+	std::vector<int32_t> values(3 * 4096 + 5, 9);
+	for (size_t pos : { size_t(5000), size_t(70), size_t(4096 * 2 + 1) }) values[pos] = -4;
+	values[100] = 20;
+	values[12000] = 20;
+	for (simd::level level : levels)
+	{
+		simd::limit(level);
+		NW_CHECK(simd::argmin(values.data(), values.size()) == std::make_pair(int32_t(-4), size_t(70)));
+		NW_CHECK(simd::argmax(values.data(), values.size()) == std::make_pair(int32_t(20), size_t(100)));
+	}
+	simd::limit(simd::level::avx512);
+}
+
+int main()
+{
+	test_integers();
+	test_floats();
+	test_ties();
+	return nw_test::result();
+}
@@ -0,0 +1,57 @@
+#include "test.hpp"
+
+#include <nowifi/util/sketch.hpp>
+
+#include <cmath>
+#include <string>
+
+void test_count_min()
+{
+	nw::CountMinSketch<std::string> sketch(1024, 4);
+
+	// Literal counts: the Counter of the sketch is not deduced from them
+	nw::unique::add(sketch, std::string("x"), 5);
+	nw::unique::add(sketch, "x", 2);
+	nw::unique::inc(sketch, std::string("y"));
+	NW_CHECK(nw::unique::get(sketch, std::string("x")) >= 7);
+	NW_CHECK(nw::unique::get(sketch, std::string("y")) >= 1);
+	NW_CHECK(sketch.total() == 8);
+
+	// Never underestimates
+	for (int idx = 0; idx < 10000; idx++) sketch.add(std::to_string(idx % 500), 1u);
+	for (int idx = 0; idx < 500; idx++) NW_CHECK(sketch.get(std::to_string(idx)) >= 20u);
+}
+
+void test_hyperloglog()
+{
+	nw::HyperLogLog<int> sketch(14);
+	for (int idx = 0; idx < 100000; idx++) nw::unique::inc(sketch, idx % 50000);
+	NW_CHECK(std::fabs(sketch.estimate() - 50000.0) < 50000.0 * 0.03);
+
+	nw::HyperLogLog<int> second(14);
+	for (int idx = 50000; idx < 100000; idx++) second.inc(idx);
+	sketch.merge(second);
+	NW_CHECK(std::fabs(sketch.estimate() - 100000.0) < 100000.0 * 0.03);
+}
+
+void test_space_saving()
+{
+	nw::SpaceSaving<int> sketch(16);
+	for (int idx = 0; idx < 10000; idx++)
+	{
+		nw::unique::inc(sketch, idx % 100 < 50 ? 7 : idx);
+		nw::unique::add(sketch, 9, 1);
+	}
+	NW_CHECK(sketch.get(7) >= 5000);
+	NW_CHECK(sketch.get(9) >= 10000);
+	const auto top = sketch.top(2);
+	NW_CHECK(top.size() == 2);
+}
+
+int main()
+{
+	test_count_min();
+	test_hyperloglog();
+	test_space_saving();
+	return nw_test::result();
+}
@@ -0,0 +1,272 @@
+#include "test.hpp"
+
+#include <nowifi/math/reducer/stats.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+using namespace nw::reducer;
+
+bool near(double lhs, double rhs, double tolerance)
+{
+	return std::fabs(lhs - rhs) <= tolerance * std::max(1.0, std::fabs(rhs));
+}
+
+//-------------------- MomentsOf --------------------//
+
+// Two passes: the mean, then the central sums of powers
+struct Reference
+{
+	double mean = 0, m2 = 0, m3 = 0, m4 = 0;
+	double count = 0;
+
+	explicit Reference(const std::vector<double>& values)
+		: count(static_cast<double>(values.size()))
+	{
+		for (double value : values) mean += value;
+		mean /= count;
+		for (double value : values)
+		{
+			const double delta = value - mean;
+			m2 += delta * delta;
+			m3 += delta * delta * delta;
+			m4 += delta * delta * delta * delta;
+		}
+	}
+
+	double variance() const { return m2 / count; }
+	double skewness() const { return std::sqrt(count) * m3 / std::pow(m2, 1.5); }
+	double kurtosis() const { return count * m4 / (m2 * m2) - 3; }
+};
+
+void check_moments(const MomentsOf<double>& moments, const std::vector<double>& values)
+{
+	const Reference reference(values);
+	NW_CHECK(moments.count() == values.size());
+	NW_CHECK(near(moments.mean(), reference.mean, 1e-12));
+	NW_CHECK(near(moments.variance(), reference.variance(), 1e-9));
+	NW_CHECK(near(moments.sample_variance(), reference.m2 / (reference.count - 1), 1e-9));
+	NW_CHECK(near(moments.skewness(), reference.skewness(), 1e-7));
+	NW_CHECK(near(moments.kurtosis(), reference.kurtosis(), 1e-7));
+}
+
+void test_moments()
+{
+	// Skewed and far from zero: the naive sum-of-squares formula loses it
+	std::mt19937_64 gen(7);
+	std::exponential_distribution<double> dist(0.5);
+	std::vector<double> values(5000);
+	for (double& value : values) value = 1e4 + dist(gen);
+
+	MomentsOf<double> single, bulk;
+	for (double value : values) single.consume(value);
+	bulk.consume(values.data(), values.size());
+	check_moments(single, values);
+	check_moments(bulk, values);
+
+	// Uneven parts, one of them empty, merged in order and out of order
+	const size_t cuts[] = { 0, 1, 1, 1500, 4999, 5000 };
+	std::vector<MomentsOf<double>> parts(5);
+	for (size_t part = 0; part < parts.size(); part++) parts[part].consume(values.data() + cuts[part], cuts[part + 1] - cuts[part]);
+	MomentsOf<double> forward, backward;
+	for (size_t part = 0; part < parts.size(); part++) forward.merge(parts[part]);
+	for (size_t part = parts.size(); part-- > 0;) backward.merge(parts[part]);
+	check_moments(forward, values);
+	check_moments(backward, values);
+	check_moments(std::get<0>(nw::reducer::reduce(values, Moments())), values);
+
+	// Empty and constant input
+	const MomentsOf<double> empty;
+	NW_CHECK(empty.count() == 0 && empty.mean() == 0 && empty.variance() == 0 && empty.sample_variance() == 0);
+	MomentsOf<int> constant;
+	const std::vector<int> sevens(100, 7);
+	constant.consume(sevens.data(), sevens.size());
+	NW_CHECK(constant.mean() == 7 && constant.variance() == 0 && constant.skewness() == 0 && constant.kurtosis() == 0);
+}
+
+//-------------------- TDigestOf --------------------//
+
+// Fraction of <sorted> below <value>
+double rank_of(const std::vector<double>& sorted, double value)
+{
+	return static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin()) / static_cast<double>(sorted.size());
+}
+
+// Rank error within 1% at the median, shrinking like q(1 - q) towards the tails
+void check_quantiles(const TDigestOf<double>& digest, std::vector<double> values)
+{
+	std::sort(values.begin(), values.end());
+	NW_CHECK(digest.count() == values.size());
+	NW_CHECK(digest.quantile(0) == values.front() && digest.quantile(1) == values.back());
+	NW_CHECK(digest.min() == values.front() && digest.max() == values.back());
+	for (double q : { 0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999 })
+	{
+		const double bound = 0.0005 + 0.04 * q * (1 - q);
+		NW_CHECK(std::fabs(rank_of(values, digest.quantile(q)) - q) <= bound);
+	}
+	NW_CHECK(digest.centroids().size() <= 100);
+}
+
+std::vector<std::vector<double>> distributions(size_t size)
+{
+	std::mt19937_64 gen(3);
+	std::uniform_real_distribution<double> uniform(-5.0, 5.0);
+	std::normal_distribution<double> normal(100.0, 15.0);
+	std::exponential_distribution<double> exponential(2.0);
+	std::vector<std::vector<double>> sets(3, std::vector<double>(size));
+	for (size_t idx = 0; idx < size; idx++)
+	{
+		sets[0][idx] = uniform(gen);
+		sets[1][idx] = normal(gen);
+		sets[2][idx] = exponential(gen);
+	}
+
+	// Sorted input is the worst case for the buffer
+	std::sort(sets[2].begin(), sets[2].end());
+	return sets;
+}
+
+void test_tdigest()
+{
+	for (const std::vector<double>& values : distributions(100000))
+	{
+		TDigestOf<double> digest(100);
+		digest.consume(values.data(), values.size());
+		check_quantiles(digest, values);
+
+		// Parts of different sizes merged: same bounds
+		TDigestOf<double> merged(100);
+		for (size_t begin : { size_t(0), size_t(10), size_t(60000) })
+		{
+			TDigestOf<double> part(100);
+			const size_t end = begin == 0 ? 10 : (begin == 10 ? 60000 : values.size());
+			part.consume(values.data() + begin, end - begin);
+			merged.merge(part);
+		}
+		merged.merge(TDigestOf<double>(100));
+		check_quantiles(merged, values);
+
+		// Same input in the same order: same digest
+		TDigestOf<double> again(100);
+		again.consume(values.data(), values.size());
+		NW_CHECK(again.quantile(0.3) == digest.quantile(0.3));
+	}
+
+	// Small inputs are exact at the centroids, NaNs are skipped
+	TDigestOf<double> small;
+	NW_CHECK(std::isnan(small.quantile(0.5)));
+	for (double value : { 1.0, std::nan(""), 2.0, 3.0 }) small.consume(value);
+	NW_CHECK(small.count() == 3 && small.quantile(0.5) == 2.0);
+	NW_CHECK(small.quantile(-1) == 1.0 && small.quantile(2) == 3.0);
+}
+
+//-------------------- TopKOf --------------------//
+
+template <class Compare>
+void check_topk(const std::vector<int>& values, size_t k)
+{
+	// Best first under <Compare>: the head of a stable sort
+	std::vector<int> sorted = values;
+	std::stable_sort(sorted.begin(), sorted.end(), [](int lhs, int rhs) { return Compare()(rhs, lhs); });
+	sorted.resize(std::min(k, sorted.size()));
+
+	TopKOf<int, Compare> top(k);
+	top.consume(values.data(), values.size());
+	NW_CHECK(top.result() == sorted && top.k() == k);
+
+	TopKOf<int, Compare> left(k), right(k);
+	const size_t half = values.size() / 3;
+	left.consume(values.data(), half);
+	right.consume(values.data() + half, values.size() - half);
+	NW_CHECK(left.merge(right).result() == sorted);
+}
+
+void test_topk()
+{
+	// Few distinct values: the k-th place is almost always a tie
+	std::mt19937 gen(9);
+	std::vector<int> values(2000);
+	for (int& value : values) value = static_cast<int>(gen() % 50) - 25;
+	for (size_t k : { 0, 1, 5, 40, 100, 1999, 2000, 5000 })
+	{
+		check_topk<std::less<int>>(values, k);
+		check_topk<std::greater<int>>(values, k);
+	}
+
+	// Ties all the way down
+	const std::vector<int> equal(100, 4);
+	check_topk<std::less<int>>(equal, 10);
+
+	TopKOf<int> top(3);
+	for (int value : { 5, 9, 9, 1, 9, 7 }) top.consume(value);
+	NW_CHECK(top.result() == std::vector<int>({ 9, 9, 9 }));
+	BottomKOf<int> bottom(2);
+	for (int value : { 5, 9, 9, 1, 9, 1 }) bottom.consume(value);
+	NW_CHECK(bottom.result() == std::vector<int>({ 1, 1 }));
+}
+
+//-------------------- HistogramOf --------------------//
+
+void test_histogram()
+{
+	// Width 0.5 over [-1, 3): edges are exact in binary
+	HistogramOf<double> histogram(-1, 3, 8);
+	NW_CHECK(histogram.lower(0) == -1 && histogram.upper(7) == 3);
+	for (size_t bucket = 0; bucket < histogram.buckets(); bucket++)
+	{
+		NW_CHECK(histogram.lower(bucket) == -1 + 0.5 * static_cast<double>(bucket));
+		NW_CHECK(histogram.upper(bucket) == histogram.lower(bucket) + 0.5);
+
+		// Lower edge inclusive, upper edge exclusive
+		const double low = histogram.lower(bucket), high = histogram.upper(bucket);
+		histogram.consume(low);
+		histogram.consume(std::nextafter(high, low));
+	}
+	for (size_t bucket = 0; bucket < histogram.buckets(); bucket++) NW_CHECK(histogram.count(bucket) == 2);
+
+	const double inf = std::numeric_limits<double>::infinity();
+	for (double value : { std::nextafter(-1.0, -inf), -inf, 3.0, inf, std::nan("") }) histogram.consume(value);
+	NW_CHECK(histogram.underflow() == 2 && histogram.overflow() == 2 && histogram.nan() == 1);
+	NW_CHECK(histogram.total() == 16 + 5);
+
+	// Widths that are not exact in binary: every lower edge still lands in its own bucket
+	for (size_t buckets : { 3, 10, 64, 1000 })
+	{
+		HistogramOf<double> tenths(0.1, 0.7, buckets);
+		for (size_t bucket = 0; bucket < buckets; bucket++)
+		{
+			tenths.consume(tenths.lower(bucket));
+			NW_CHECK(tenths.count(bucket) == 1);
+		}
+		NW_CHECK(tenths.upper(buckets - 1) == 0.7);
+		tenths.consume(std::nextafter(0.7, 0.0));
+		NW_CHECK(tenths.count(buckets - 1) == 2 && tenths.overflow() == 0);
+	}
+
+	// Integers, merge and bad layouts
+	HistogramOf<int> left(0, 10, 5), right(0, 10, 5);
+	for (int value = -2; value < 12; value++) (value % 2 == 0 ? left : right).consume(value);
+	left.merge(right);
+	NW_CHECK(left.counts() == std::vector<uint64_t>({ 2, 2, 2, 2, 2 }));
+	NW_CHECK(left.underflow() == 2 && left.overflow() == 2 && left.total() == 14);
+	NW_CHECK_THROWS(left.merge(HistogramOf<int>(0, 10, 4)), std::invalid_argument);
+	NW_CHECK_THROWS(left.merge(HistogramOf<int>(0, 11, 5)), std::invalid_argument);
+	NW_CHECK_THROWS(HistogramOf<int>(1, 1, 4), std::invalid_argument);
+	NW_CHECK_THROWS(HistogramOf<int>(0, 1, 0), std::invalid_argument);
+}
+
+int main()
+{
+	test_moments();
+	test_tdigest();
+	test_topk();
+	test_histogram();
+	return nw_test::result();
+}
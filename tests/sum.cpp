@@ -0,0 +1,152 @@
+#include "test.hpp"
+
+#include <nowifi/math/reducer/sum.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Adds in 64 bits and truncates: the wrapping sum of Ty
+template <class Ty>
+Ty reference_sum(const std::vector<Ty>& values, size_t first, size_t size)
+{
+	uint64_t total = 0;
+	for (size_t idx = first; idx < first + size; idx++) total += static_cast<uint64_t>(values[idx]);
+	return static_cast<Ty>(total);
+}
+
+template <class Ty>
+void check_bulk_sum(Ty lo, Ty hi)
+{
+	std::mt19937_64 gen(11);
+	std::uniform_int_distribution<long long> dist(static_cast<long long>(lo), static_cast<long long>(hi));
+	std::vector<Ty> values(5000);
+	for (Ty& value : values) value = static_cast<Ty>(dist(gen));
+
+	// Unaligned starts and tails shorter than a vector
+	for (size_t first : { 0, 1, 3 })
+	{
+		for (size_t size : { 0, 1, 7, 63, 1000, 4990 })
+		{
+			nw::SumReducer<Ty> sum(Ty(5));
+			sum.consume(values.data() + first, size);
+			NW_CHECK(sum.sum() == static_cast<Ty>(reference_sum(values, first, size) + Ty(5)));
+
+			// Bulk and one by one agree
+			nw::SumReducer<Ty> single;
+			for (size_t idx = first; idx < first + size; idx++) single.consume(values[idx]);
+			nw::SumReducer<Ty> bulk;
+			bulk.consume(values.data() + first, size);
+			NW_CHECK(single.sum() == bulk.sum());
+		}
+	}
+}
+
+void test_integer_sums()
+{
+	using level = nw::reducer::simd::level;
+	for (level cap : { level::scalar, level::sse42, level::avx2, level::avx512 })
+	{
+		nw::reducer::simd::limit(cap);
+		check_bulk_sum<int>(-2000000000, 2000000000);
+		check_bulk_sum<unsigned>(0, 4000000000u);
+		check_bulk_sum<long long>(-(1LL << 62), 1LL << 62);
+		check_bulk_sum<unsigned long long>(0, 1LL << 62);
+		check_bulk_sum<short>(-30000, 30000);
+		check_bulk_sum<unsigned char>(0, 255);
+	}
+	nw::reducer::simd::limit(level::avx512);
+}
+
+void test_wraps_like_the_type()
+{
+	std::vector<unsigned> values(10, 0x80000000u);
+	nw::SumReducer<unsigned> sum;
+	sum.consume(values.data(), values.size());
+	NW_CHECK(sum.sum() == 0);
+
+	std::vector<unsigned char> bytes(300, 1);
+	nw::SumReducer<unsigned char> small;
+	small.consume(bytes.data(), bytes.size());
+	NW_CHECK(small.sum() == 44);
+}
+
+void test_float_sums()
+{
+	std::vector<double> values(1000);
+	for (size_t idx = 0; idx < values.size(); idx++) values[idx] = static_cast<double>(idx) * 0.5;
+	nw::SumReducer<double> sum;
+	sum.consume(values.data(), values.size());
+	NW_CHECK(sum.sum() == 249750.0);
+}
+
+// Only operator+: no +=, no conversion from arithmetic types
+struct Money
+{
+	long long cents = 0;
+
+	Money() = default;
+	explicit Money(long long cents)
+		: cents(cents) { }
+
+	Money operator+(const Money& other) const
+	{
+		return Money(cents + other.cents);
+	}
+};
+
+// Derived reducers keep reading the plain Ty
+struct Doubled : nw::SumReducer<int>
+{
+	int doubled() const
+	{
+		return 2 * this->_sum;
+	}
+};
+
+void test_plus_only_types()
+{
+	nw::SumReducer<Money> sum{ Money(5) };
+	sum.consume(Money(10));
+	sum.consume(Money(-3));
+	nw::SumReducer<Money> other;
+	other.reset(Money(100));
+	sum.merge(other);
+	const Money more[3] = { Money(1), Money(2), Money(3) };
+	sum.consume(more, 3);
+	NW_CHECK(sum.sum().cents == 118);
+
+	Doubled doubled;
+	doubled.consume(20);
+	doubled.consume(1);
+	NW_CHECK(doubled.doubled() == 42);
+}
+
+void test_modes()
+{
+	// Sizes that leave a partial lane block before and after the aligned part
+	std::vector<double> values(1003);
+	for (size_t idx = 0; idx < values.size(); idx++) values[idx] = static_cast<double>(idx) * 0.25;
+	const double exact = 0.25 * 1002.0 * 1003.0 / 2.0;
+	for (size_t first : { 0, 1, 3 })
+	{
+		nw::SumReducer<double, nw::reducer::sum_mode::kahan> kahan;
+		nw::SumReducer<double, nw::reducer::sum_mode::pairwise> pairwise;
+		nw::SumReducer<double, nw::reducer::sum_mode::exact> exact_sum;
+		for (size_t idx = 0; idx < first; idx++) kahan.consume(values[idx]);
+		kahan.consume(values.data() + first, values.size() - first);
+		pairwise.consume(values.data(), values.size());
+		exact_sum.consume(values.data(), values.size());
+		NW_CHECK(kahan.sum() == exact && pairwise.sum() == exact && exact_sum.sum() == exact);
+	}
+}
+
+int main()
+{
+	test_integer_sums();
+	test_wraps_like_the_type();
+	test_float_sums();
+	test_plus_only_types();
+	test_modes();
+	return nw_test::result();
+}
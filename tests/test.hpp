@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks: a failed NW_CHECK is reported and counted, and main()
+// returns nw_test::result() so ctest sees the failure.
+
+namespace nw_test {
+
+	inline int& failures()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	inline int result()
+	{
+		if (failures() != 0) std::fprintf(stderr, "%d check(s) failed\n", failures());
+		return failures() != 0;
+	}
+
+} // namespace nw_test
+
+#define NW_CHECK(cond) \
+	do { if (!(cond)) { std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); nw_test::failures()++; } } while (0)
+
+#define NW_CHECK_THROWS(expr, exception) \
+	do { bool _nw_thrown = false; try { static_cast<void>(expr); } catch (const exception&) { _nw_thrown = true; } NW_CHECK(_nw_thrown && #expr " throws " #exception); } while (0)
@@ -0,0 +1,284 @@
+#include "test.hpp"
+
+#include <nowifi/io/scanner.hpp>
+#include <nowifi/math/safe.hpp>
+#include <nowifi/string/from_string.hpp>
+
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using nw::errc;
+
+template <class Ty>
+bool is_error(const nw::expected<Ty>& result, errc code)
+{
+	return !result && result.error() == code;
+}
+
+template <class Ty>
+bool is_value(const nw::expected<Ty>& result, const Ty& value)
+{
+	return result && *result == value;
+}
+
+void test_from_string()
+{
+	NW_CHECK(is_value(nw::from_string::try_toInt("42"), 42));
+	NW_CHECK(is_value(nw::from_string::try_toInt("  +42"), 42));
+	NW_CHECK(is_value(nw::from_string::try_toInt("-7"), -7));
+	NW_CHECK(is_value(nw::from_string::try_toInt("ff", 16), 255));
+	NW_CHECK(is_value(nw::from_string::try_toInt("0x1F", 16), 31));
+	NW_CHECK(is_value(nw::from_string::try_toInt("017", 8), 15));
+
+	// Other bases read like to(): std::setbase falls back to the prefix
+	for (int base : { 0, 1, 2, 7, 36, 37, -5 })
+	{
+		for (const char* str : { "0x1f", "017", "10", "-12" })
+		{
+			NW_CHECK(is_value(nw::from_string::try_toInt(str, base), nw::from_string::toInt(str, base)));
+		}
+		NW_CHECK(is_error(nw::from_string::try_toInt("zz", base), errc::invalid_argument));
+	}
+	NW_CHECK(is_error(nw::from_string::_try_chars<int>("10", "10" + 2, 2), errc::invalid_argument));
+	NW_CHECK(is_error(nw::from_string::try_toInt("99999999999"), errc::out_of_range));
+	NW_CHECK(is_error(nw::from_string::try_toInt("12abc"), errc::invalid_argument));
+	NW_CHECK(is_error(nw::from_string::try_toInt(""), errc::invalid_argument));
+	NW_CHECK(is_error(nw::from_string::try_toInt("+-1"), errc::invalid_argument));
+	NW_CHECK(is_error(nw::from_string::try_toUInt("-1"), errc::invalid_argument));
+	NW_CHECK(is_error(nw::from_string::try_toShort("40000"), errc::out_of_range));
+	NW_CHECK(is_value(nw::from_string::try_toDouble("2.5"), 2.5));
+	NW_CHECK(is_error(nw::from_string::try_toDouble("1e999"), errc::out_of_range));
+	NW_CHECK(is_error(nw::from_string::try_toDouble("x"), errc::invalid_argument));
+
+	// Agrees with the throwing to()
+	NW_CHECK(nw::from_string::toInt("123") == *nw::from_string::try_toInt("123"));
+	NW_CHECK_THROWS(nw::from_string::toInt("12abc"), std::invalid_argument);
+
+	// Stream path: wide strings
+	NW_CHECK(is_value(nw::from_wstring::try_toInt(L"42"), 42));
+	NW_CHECK(is_error(nw::from_wstring::try_toInt(L"4x"), errc::invalid_argument));
+
+	NW_CHECK(nw::from_string::try_toInt("x").value_or(-1) == -1);
+	NW_CHECK_THROWS(nw::from_string::try_toInt("x").value(), nw::bad_expected_access<errc>);
+}
+
+void test_safe_math()
+{
+	NW_CHECK(is_value(nw::SafeMath::try_add_int32(1, 2), 3));
+	NW_CHECK(is_error(nw::SafeMath::try_add_int32(std::numeric_limits<int>::max(), 1), errc::overflow));
+	NW_CHECK(is_error(nw::SafeMath::try_add_int32(std::numeric_limits<int>::min(), -1), errc::underflow));
+	NW_CHECK(is_error(nw::SafeMath::try_add_int32(4000000000u, 400000000u), errc::overflow));
+	NW_CHECK(is_error(nw::SafeMath::try_sub_int32(0u, 1u), errc::underflow));
+	NW_CHECK(is_error(nw::SafeMath::try_sub_int64(std::numeric_limits<long long>::max(), -1LL), errc::overflow));
+	NW_CHECK(is_value(nw::SafeMath::try_mul_int32(-46340, 46340), -46340 * 46340));
+	NW_CHECK(is_error(nw::SafeMath::try_mul_int32(65536, 65536), errc::overflow));
+	NW_CHECK(is_error(nw::SafeMath::try_mul_int32(-65536, 65536), errc::underflow));
+	NW_CHECK(is_error(nw::SafeMath::try_mul_uint16(300, 300), errc::overflow));
+
+	NW_CHECK_THROWS(nw::SafeMath::add_int32(std::numeric_limits<int>::max(), 1), std::overflow_error);
+	NW_CHECK_THROWS(nw::SafeMath::sub_int32(std::numeric_limits<int>::min(), 1), std::underflow_error);
+}
+
+void test_scanner_next()
+{
+	// Overflow is out_of_range and consumes only the number
+	{
+		std::istringstream iss("99999999999 5 -99999999999 x 6 1e999 7");
+		nw::Scanner scanner(iss);
+		NW_CHECK(is_error(scanner.try_next<int>(), errc::out_of_range));
+		NW_CHECK(is_value(scanner.try_next<int>(), 5));
+		NW_CHECK(is_error(scanner.try_next<int>(), errc::out_of_range));
+		NW_CHECK(is_error(scanner.try_next<int>(), errc::invalid_argument));
+		NW_CHECK(is_value(scanner.try_next<int>(), 6));
+		NW_CHECK(is_error(scanner.try_next<double>(), errc::out_of_range));
+		NW_CHECK(is_value(scanner.try_next<int>(), 7));
+		NW_CHECK(is_error(scanner.try_next<int>(), errc::end_of_stream));
+	}
+
+	// A bad last token is not the end of the stream
+	for (const char* text : { "99999999999", "-", "x" })
+	{
+		std::istringstream iss(text);
+		nw::Scanner scanner(iss);
+		const nw::expected<int> result = scanner.try_next<int>();
+		NW_CHECK(!result && result.error() != errc::end_of_stream);
+		NW_CHECK(is_error(scanner.try_next<int>(), errc::end_of_stream));
+	}
+
+	// Unsigned: a bad token is not mistaken for an overflow to 0
+	{
+		std::istringstream iss("x 99999999999 3");
+		nw::Scanner scanner(iss);
+		NW_CHECK(is_error(scanner.try_next<unsigned>(), errc::invalid_argument));
+		NW_CHECK(is_error(scanner.try_next<unsigned>(), errc::out_of_range));
+		NW_CHECK(is_value(scanner.try_next<unsigned>(), 3u));
+	}
+
+	// Limits themselves are values
+	{
+		std::istringstream iss("2147483647 -2147483648 4294967295");
+		nw::Scanner scanner(iss);
+		NW_CHECK(is_value(scanner.try_next<int>(), std::numeric_limits<int>::max()));
+		NW_CHECK(is_value(scanner.try_next<int>(), std::numeric_limits<int>::min()));
+		NW_CHECK(is_value(scanner.try_next<unsigned>(), std::numeric_limits<unsigned>::max()));
+	}
+
+	{
+		std::istringstream iss("  \n  ");
+		nw::Scanner scanner(iss);
+		NW_CHECK(is_error(scanner.try_next<int>(), errc::end_of_stream));
+		NW_CHECK(is_error(scanner.try_nextWord(), errc::end_of_stream));
+	}
+}
+
+void test_scanner_words()
+{
+	std::istringstream iss("hello 12abc 15 300 first line\nsecond");
+	nw::Scanner scanner(iss);
+	NW_CHECK(is_value(scanner.try_nextWord(), std::string("hello")));
+	NW_CHECK(is_error(scanner.try_nextChecked<int>(), errc::invalid_argument));
+	NW_CHECK(is_value(scanner.try_nextRanged<int>(10, 20), 15));
+	NW_CHECK(is_error(scanner.try_nextRanged<int>(10, 20), errc::out_of_range));
+	NW_CHECK(is_value(scanner.try_nextLine(), std::string(" first line")));
+	NW_CHECK(is_value(scanner.try_nextLine(), std::string("second")));
+	NW_CHECK(is_error(scanner.try_nextLine(), errc::end_of_stream));
+	NW_CHECK(is_error(scanner.try_nextChecked<int>(), errc::end_of_stream));
+	NW_CHECK(is_error(scanner.try_nextRanged<int>(0, 1), errc::end_of_stream));
+}
+
+void test_scanner_params()
+{
+	{
+		std::istringstream iss("1 2.5 word");
+		nw::Scanner scanner(iss);
+		int first = 0;
+		double second = 0;
+		std::string third;
+		NW_CHECK(scanner.try_nextParam(first, second, third) == errc::none);
+		NW_CHECK(first == 1 && second == 2.5 && third == "word");
+	}
+	{
+		std::istringstream iss("1 99999999999 3");
+		nw::Scanner scanner(iss);
+		int first = 0, second = 0, third = 0;
+		NW_CHECK(scanner.try_nextParam(first, second, third) == errc::out_of_range);
+		NW_CHECK(first == 1 && third == 0);
+	}
+	{
+		std::istringstream iss("1 2");
+		nw::Scanner scanner(iss);
+		int first = 0, second = 0, third = 0;
+		NW_CHECK(scanner.try_nextParam(first, second, third) == errc::end_of_stream);
+	}
+	{
+		std::istringstream iss("1,2,3\n4,x");
+		nw::Scanner scanner(iss);
+		NW_CHECK(is_value(scanner.try_next_separated<int>(','), 1));
+		int second = 0, third = 0, fourth = 0, fifth = 0;
+		NW_CHECK(scanner.try_nextParam_separated(',', second, third) == errc::none);
+		NW_CHECK(second == 2 && third == 3);
+		NW_CHECK(scanner.try_nextParam_separated(',', fourth, fifth) == errc::invalid_argument);
+		NW_CHECK(fourth == 4);
+		NW_CHECK(is_error(scanner.try_next_separated<int>(','), errc::end_of_stream));
+	}
+}
+
+void test_scanner_arrays()
+{
+	{
+		std::istringstream iss("1 2 99999999999");
+		nw::Scanner scanner(iss);
+		int arr[5] = {};
+		NW_CHECK(is_error(scanner.try_readArray(arr, 5), errc::out_of_range));
+		NW_CHECK(arr[0] == 1 && arr[1] == 2);
+	}
+	{
+		std::istringstream iss("1 2 -");
+		nw::Scanner scanner(iss);
+		int arr[5] = {};
+		NW_CHECK(is_error(scanner.try_readArray(arr, 5), errc::invalid_argument));
+	}
+	{
+		std::istringstream iss("1 2 3\n");
+		nw::Scanner scanner(iss);
+		int arr[5] = {};
+		NW_CHECK(is_value(scanner.try_readArray(arr, 5), size_t(3)));
+		NW_CHECK(arr[2] == 3);
+	}
+	{
+		std::istringstream iss("4;5;6");
+		nw::Scanner scanner(iss);
+		int arr[5] = {};
+		NW_CHECK(is_value(scanner.try_readArray_separated(arr, 5, ';'), size_t(3)));
+		NW_CHECK(arr[0] == 4 && arr[1] == 5 && arr[2] == 6);
+	}
+	{
+		std::istringstream iss("7 8 9 10");
+		nw::Scanner scanner(iss);
+		NW_CHECK(is_value(scanner.try_readNewVector<int>(3), std::vector<int>({ 7, 8, 9 })));
+		NW_CHECK(is_error(scanner.try_readNewVector<int>(3), errc::end_of_stream));
+	}
+}
+
+void test_scanner_chunked()
+{
+	for (size_t chunk : { 1, 2, 1000 })
+	{
+		{
+			std::istringstream iss("1 2 3 4 5");
+			nw::Scanner scanner(iss);
+			std::vector<int> values;
+			const auto collect = [&values](const int* arr, size_t count) { values.insert(values.end(), arr, arr + count); };
+			NW_CHECK(scanner.try_readChunked<int>(3, collect, chunk) == errc::none);
+			NW_CHECK(values == std::vector<int>({ 1, 2, 3 }));
+			NW_CHECK(scanner.try_readChunked<int>(3, collect, chunk) == errc::end_of_stream);
+			NW_CHECK(values == std::vector<int>({ 1, 2, 3, 4, 5 }));
+		}
+		{
+			std::istringstream iss("1 2 3\n");
+			nw::Scanner scanner(iss);
+			std::vector<int> values;
+			const nw::expected<size_t> total = scanner.try_readChunked_all<int>([&values](const int* arr, size_t count) { values.insert(values.end(), arr, arr + count); }, chunk);
+			NW_CHECK(is_value(total, size_t(3)));
+			NW_CHECK(values == std::vector<int>({ 1, 2, 3 }));
+		}
+		for (const char* text : { "1 2 99999999999", "1 2 -" })
+		{
+			std::istringstream iss(text);
+			nw::Scanner scanner(iss);
+			std::vector<int> values;
+			const nw::expected<size_t> total = scanner.try_readChunked_all<int>([&values](const int* arr, size_t count) { values.insert(values.end(), arr, arr + count); }, chunk);
+			NW_CHECK(!total && total.error() != errc::end_of_stream);
+			NW_CHECK(values == std::vector<int>({ 1, 2 }));
+		}
+		{
+			std::istringstream iss("1 10\n2 20\n3 30");
+			nw::Scanner scanner(iss);
+			long long sums[2] = {};
+			NW_CHECK(scanner.try_readChunked_columns<int>(3, 2, [&sums](size_t column, const int* arr, size_t count)
+			{
+				for (size_t idx = 0; idx < count; idx++) sums[column] += arr[idx];
+			}, chunk) == errc::none);
+			NW_CHECK(sums[0] == 6 && sums[1] == 60);
+		}
+	}
+
+	// An exception from the callback is reported, not thrown
+	std::istringstream iss("1 2 3");
+	nw::Scanner scanner(iss);
+	NW_CHECK(is_error(scanner.try_readChunked_all<int>([](const int*, size_t) { throw std::runtime_error("stop"); }), errc::io_error));
+}
+
+int main()
+{
+	test_from_string();
+	test_safe_math();
+	test_scanner_next();
+	test_scanner_words();
+	test_scanner_params();
+	test_scanner_arrays();
+	test_scanner_chunked();
+	return nw_test::result();
+}
@@ -0,0 +1,212 @@
+#include "test.hpp"
+
+#include <nowifi/util/varint.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Every power of two, its neighbours and the extremes
+std::vector<uint64_t> edge_values()
+{
+	std::vector<uint64_t> values = { 0, 1, 127, 128, 255, 16383, 16384, std::numeric_limits<uint64_t>::max() };
+	for (int bit = 1; bit < 64; bit++)
+	{
+		const uint64_t power = uint64_t(1) << bit;
+		values.push_back(power - 1);
+		values.push_back(power);
+		values.push_back(power + 1);
+	}
+	return values;
+}
+
+// Mixed magnitudes: 1 to 4 bytes in Stream VByte
+std::vector<uint32_t> mixed(size_t size, uint32_t seed)
+{
+	std::mt19937 gen(seed);
+	std::vector<uint32_t> values(size);
+	for (uint32_t& value : values) value = gen() >> (8 * (gen() % 4));
+	return values;
+}
+
+void test_leb128()
+{
+	using nw::varint::byte_type;
+	for (uint64_t value : edge_values())
+	{
+		byte_type bytes[nw::varint::max_bytes];
+		const size_t used = nw::varint::encode(value, bytes);
+		NW_CHECK(used == nw::varint::encoded_size(value));
+
+		uint64_t decoded = ~value;
+		NW_CHECK(nw::varint::decode(bytes, bytes + used, decoded) == used && decoded == value);
+
+		// Every shorter prefix is truncated
+		for (size_t size = 0; size < used; size++) NW_CHECK(nw::varint::decode(bytes, bytes + size, decoded) == 0);
+	}
+
+	// The 10th byte may only carry bit 63
+	byte_type bytes[11];
+	std::fill(bytes, bytes + 9, byte_type(0xff));
+	uint64_t decoded = 0;
+	bytes[9] = 0x01;
+	NW_CHECK(nw::varint::decode(bytes, bytes + 10, decoded) == 10 && decoded == std::numeric_limits<uint64_t>::max());
+	for (byte_type last : { 0x02, 0x7f, 0x03 })
+	{
+		bytes[9] = last;
+		NW_CHECK(nw::varint::decode(bytes, bytes + 10, decoded) == 0);
+	}
+	bytes[9] = 0x81;
+	bytes[10] = 0x00;
+	NW_CHECK(nw::varint::decode(bytes, bytes + 11, decoded) == 0);
+
+	// Arrays
+	const std::vector<uint64_t> values = edge_values();
+	std::vector<byte_type> encoded(nw::varint::max_encoded_size(values.size()));
+	const size_t used = nw::varint::encode(values.data(), values.size(), encoded.data());
+	std::vector<uint64_t> out(values.size());
+	NW_CHECK(nw::varint::decode(encoded.data(), used, out.data(), out.size()) == used);
+	NW_CHECK(out == values);
+	NW_CHECK(nw::varint::decode(encoded.data(), used - 1, out.data(), out.size()) == 0);
+}
+
+template <class Ty>
+void check_zigzag()
+{
+	using uTy = std::make_unsigned_t<Ty>;
+	NW_CHECK(nw::zigzag::encode(Ty(0)) == 0 && nw::zigzag::encode(Ty(-1)) == 1);
+	NW_CHECK(nw::zigzag::encode(Ty(1)) == 2 && nw::zigzag::encode(Ty(-2)) == 3);
+	NW_CHECK(nw::zigzag::encode(std::numeric_limits<Ty>::max()) == uTy(std::numeric_limits<uTy>::max() - 1));
+	NW_CHECK(nw::zigzag::encode(std::numeric_limits<Ty>::min()) == std::numeric_limits<uTy>::max());
+	for (Ty value : { Ty(0), Ty(1), Ty(-1), Ty(100), Ty(-100), std::numeric_limits<Ty>::max(), std::numeric_limits<Ty>::min() })
+	{
+		NW_CHECK(nw::zigzag::decode(nw::zigzag::encode(value)) == value);
+	}
+}
+
+void test_zigzag_delta()
+{
+	check_zigzag<int8_t>();
+	check_zigzag<int16_t>();
+	check_zigzag<int32_t>();
+	check_zigzag<int64_t>();
+
+	// Wrapping differences still round-trip, in place too
+	const std::vector<int32_t> values = { 5, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(), -7, 0, 3 };
+	std::vector<int32_t> deltas(values.size()), out(values.size());
+	nw::delta::encode(values.data(), values.size(), deltas.data(), 2);
+	NW_CHECK(deltas[0] == 3);
+	nw::delta::decode(deltas.data(), deltas.size(), out.data(), 2);
+	NW_CHECK(out == values);
+
+	std::vector<int32_t> inplace = values;
+	nw::delta::encode2(inplace.data(), inplace.size(), inplace.data());
+	nw::delta::decode2(inplace.data(), inplace.size(), inplace.data());
+	NW_CHECK(inplace == values);
+
+	// Evenly spaced: second differences vanish after the start
+	std::vector<uint64_t> times(10), second(10);
+	for (size_t idx = 0; idx < times.size(); idx++) times[idx] = 1000 + 15 * idx;
+	nw::delta::encode2(times.data(), times.size(), second.data());
+	NW_CHECK(std::all_of(second.begin() + 2, second.end(), [](uint64_t value) { return value == 0; }));
+}
+
+template <class Ty, int Order>
+void check_stream(const std::vector<Ty>& values)
+{
+	nw::VarintEncoder<Ty, Order> encoder;
+	encoder.put(values.data(), values.size());
+	NW_CHECK(encoder.count() == values.size());
+
+	nw::VarintDecoder<Ty, Order> decoder(encoder.bytes());
+	std::vector<Ty> out(values.size() + 1);
+	NW_CHECK(decoder.next(out.data(), out.size()) == values.size());
+	out.pop_back();
+	NW_CHECK(out == values && decoder.eof());
+
+	// Truncated: the last value is not returned
+	if (values.empty()) return;
+	nw::VarintDecoder<Ty, Order> cut(encoder.bytes().data(), encoder.bytes().size() - 1);
+	NW_CHECK(cut.next(out.data(), out.size()) == values.size() - 1);
+}
+
+void test_stream_objects()
+{
+	const std::vector<int64_t> values = { 0, 10, 20, 30, -5, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), 7 };
+	check_stream<int64_t, 0>(values);
+	check_stream<int64_t, 1>(values);
+	check_stream<int64_t, 2>(values);
+
+	const std::vector<uint64_t> edges = edge_values();
+	check_stream<uint64_t, 0>(edges);
+	check_stream<uint64_t, 1>(edges);
+	check_stream<uint64_t, 2>(edges);
+	check_stream<uint64_t, 1>({});
+}
+
+void test_streamvbyte()
+{
+	using nw::streamvbyte::byte_type;
+	for (size_t size = 0; size <= 37; size++)
+	{
+		const std::vector<uint32_t> values = mixed(size, static_cast<uint32_t>(size));
+		std::vector<byte_type> encoded(nw::streamvbyte::max_encoded_size(size));
+		const size_t used = nw::streamvbyte::encode(values.data(), size, encoded.data());
+
+		std::vector<uint32_t> out(size);
+		NW_CHECK(nw::streamvbyte::decode(encoded.data(), used, out.data(), size) == used);
+		NW_CHECK(out == values);
+		for (size_t cut = 0; cut < used && size != 0; cut++) NW_CHECK(nw::streamvbyte::decode(encoded.data(), cut, out.data(), size) == 0);
+
+		// Sorted input through the delta variant, starting from <prev>
+		std::vector<uint32_t> sorted = values;
+		std::sort(sorted.begin(), sorted.end());
+		const uint32_t prev = sorted.empty() ? 0 : sorted[0] / 2;
+		const size_t delta_used = nw::streamvbyte::encode_delta(sorted.data(), size, encoded.data(), prev);
+		NW_CHECK(nw::streamvbyte::decode_delta(encoded.data(), delta_used, out.data(), size, prev) == delta_used);
+		NW_CHECK(out == sorted);
+		if (size != 0) NW_CHECK(nw::streamvbyte::decode_delta(encoded.data(), delta_used - 1, out.data(), size, prev) == 0);
+	}
+}
+
+template <bool Delta>
+void check_streamvbyte_blocks()
+{
+	std::vector<uint32_t> values = mixed(1003, 9);
+	if (Delta) std::sort(values.begin(), values.end());
+
+	nw::StreamVByteEncoder<Delta> encoder(64);
+	encoder.put(values.data(), values.size());
+	encoder.flush();
+	nw::StreamVByteDecoder<Delta> decoder(encoder.bytes());
+	NW_CHECK(decoder.peek() == 64);
+	NW_CHECK(decoder.read_all() == values);
+	NW_CHECK(decoder.peek() == 0);
+
+	// A truncated block is an error
+	const auto bytes = encoder.bytes();
+	nw::StreamVByteDecoder<Delta> cut(bytes.data(), bytes.size() - 1);
+	NW_CHECK_THROWS(cut.read_all(), std::invalid_argument);
+	nw::StreamVByteDecoder<Delta> header(bytes.data(), 5);
+	std::vector<uint32_t> out(64);
+	NW_CHECK_THROWS(header.next_block(out.data()), std::invalid_argument);
+}
+
+void test_streamvbyte_blocks()
+{
+	check_streamvbyte_blocks<false>();
+	check_streamvbyte_blocks<true>();
+}
+
+int main()
+{
+	test_leb128();
+	test_zigzag_delta();
+	test_stream_objects();
+	test_streamvbyte();
+	test_streamvbyte_blocks();
+	return nw_test::result();
+}
@@ -0,0 +1,182 @@
+#include "test.hpp"
+
+#include <nowifi/math/reducer/window.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Window sizes: 1, small, not dividing the input, and larger than the input
+const size_t windows[] = { 1, 2, 3, 7, 64, 199, 200, 1000 };
+
+std::vector<int> sample(size_t size)
+{
+	// Few distinct values: plenty of ties
+	std::mt19937 gen(3);
+	std::vector<int> values(size);
+	for (int& value : values) value = static_cast<int>(gen() % 21) - 10;
+	return values;
+}
+
+// First index of the window that ends at <idx>
+size_t window_begin(size_t idx, size_t window)
+{
+	return idx + 1 >= window ? idx + 1 - window : 0;
+}
+
+struct Concat
+{
+	std::string operator()(const std::string& lhs, const std::string& rhs) const
+	{
+		return lhs + rhs;
+	}
+};
+
+void test_extremum()
+{
+	const std::vector<int> values = sample(200);
+	for (size_t window : windows)
+	{
+		nw::WindowMinReducer<int> min(window);
+		nw::WindowMaxReducer<int> max(window);
+		for (size_t idx = 0; idx < values.size(); idx++)
+		{
+			min.consume(values[idx]);
+			max.consume(values[idx]);
+			const auto first = values.begin() + window_begin(idx, window);
+			const auto last = values.begin() + idx + 1;
+			NW_CHECK(min.min() == *std::min_element(first, last));
+			NW_CHECK(max.max() == *std::max_element(first, last));
+			NW_CHECK(min.size() == static_cast<size_t>(last - first));
+			NW_CHECK(min.full() == (idx + 1 >= window));
+
+			// Ties report the newest position
+			NW_CHECK(values[min.index()] == min.min() && min.index() >= window_begin(idx, window));
+			NW_CHECK(std::find(values.begin() + min.index() + 1, last, min.min()) == last);
+		}
+	}
+}
+
+void test_sum()
+{
+	const std::vector<int> values = sample(200);
+	std::vector<double> reals(values.size());
+	for (size_t idx = 0; idx < values.size(); idx++) reals[idx] = values[idx] * 0.1 + 1e6 * (idx % 2);
+	for (size_t window : windows)
+	{
+		nw::WindowSumReducer<int, long long> sum(window);
+		nw::WindowSumReducer<double> real(window);
+		for (size_t idx = 0; idx < values.size(); idx++)
+		{
+			sum.consume(values[idx]);
+			real.consume(reals[idx]);
+			const size_t first = window_begin(idx, window);
+			const long long expected = std::accumulate(values.begin() + first, values.begin() + idx + 1, 0LL);
+			NW_CHECK(sum.sum() == expected);
+			NW_CHECK(sum.mean() == static_cast<double>(expected) / static_cast<double>(idx + 1 - first));
+
+			const double exact = std::accumulate(reals.begin() + first, reals.begin() + idx + 1, 0.0);
+			NW_CHECK(std::fabs(real.sum() - exact) <= 1e-6);
+		}
+	}
+}
+
+void test_reduce()
+{
+	// Concatenation is associative but not commutative: order must be kept
+	std::vector<std::string> letters(200);
+	for (size_t idx = 0; idx < letters.size(); idx++) letters[idx] = std::string(1, static_cast<char>('a' + idx % 26));
+	const std::vector<int> values = sample(200);
+	for (size_t window : windows)
+	{
+		nw::WindowReducer<std::string, Concat> concat(window);
+		nw::WindowReducer<int, std::plus<int>> plus(window);
+		for (size_t idx = 0; idx < letters.size(); idx++)
+		{
+			concat.consume(letters[idx]);
+			plus.consume(values[idx]);
+			const size_t first = window_begin(idx, window);
+			NW_CHECK(concat.value() == std::accumulate(letters.begin() + first, letters.begin() + idx + 1, std::string()));
+			NW_CHECK(plus.value() == std::accumulate(values.begin() + first, values.begin() + idx + 1, 0));
+			NW_CHECK(concat.size() == idx + 1 - first);
+		}
+	}
+}
+
+void test_median()
+{
+	const std::vector<int> values = sample(200);
+	for (size_t window : windows)
+	{
+		nw::WindowMedian<int> median(window);
+		for (size_t idx = 0; idx < values.size(); idx++)
+		{
+			median.consume(values[idx]);
+			std::vector<int> sorted(values.begin() + window_begin(idx, window), values.begin() + idx + 1);
+			std::sort(sorted.begin(), sorted.end());
+			NW_CHECK(median.median_low() == sorted[(sorted.size() - 1) / 2]);
+			NW_CHECK(median.median_high() == sorted[sorted.size() / 2]);
+			NW_CHECK(median.quantile(0.0) == sorted.front());
+			NW_CHECK(median.quantile(1.0) == sorted.back());
+			NW_CHECK(median.quantile(0.25) == sorted[static_cast<size_t>(0.25 * static_cast<double>(sorted.size() - 1) + 0.5)]);
+		}
+	}
+}
+
+void test_batch()
+{
+	const std::vector<int> values = sample(200);
+	for (size_t window : windows)
+	{
+		if (window > values.size())
+		{
+			std::vector<int> out(1);
+			NW_CHECK_THROWS(nw::window::min(values.data(), values.size(), window, out.data()), std::invalid_argument);
+			continue;
+		}
+
+		const size_t count = values.size() - window + 1;
+		std::vector<int> min(count), max(count), plus(count);
+		std::vector<long long> sum(count);
+		std::vector<double> mean(count), median(count);
+		nw::window::min(values.data(), values.size(), window, min.data());
+		nw::window::max(values.data(), values.size(), window, max.data());
+		nw::window::sum(values.data(), values.size(), window, sum.data());
+		nw::window::mean(values.data(), values.size(), window, mean.data());
+		nw::window::reduce(values.data(), values.size(), window, plus.data(), std::plus<int>());
+		nw::window::median(values.data(), values.size(), window, median.data());
+
+		for (size_t idx = 0; idx < count; idx++)
+		{
+			const auto first = values.begin() + idx;
+			const auto last = first + window;
+			const long long expected = std::accumulate(first, last, 0LL);
+			std::vector<int> sorted(first, last);
+			std::sort(sorted.begin(), sorted.end());
+			NW_CHECK(min[idx] == *std::min_element(first, last));
+			NW_CHECK(max[idx] == *std::max_element(first, last));
+			NW_CHECK(sum[idx] == expected);
+			NW_CHECK(std::fabs(mean[idx] - static_cast<double>(expected) / static_cast<double>(window)) <= 1e-9);
+			NW_CHECK(plus[idx] == expected);
+			NW_CHECK(median[idx] == (sorted[(window - 1) / 2] + sorted[window / 2]) / 2.0);
+		}
+	}
+
+	std::vector<int> out(values.size());
+	NW_CHECK_THROWS(nw::window::max(values.data(), values.size(), 0, out.data()), std::invalid_argument);
+}
+
+int main()
+{
+	test_extremum();
+	test_sum();
+	test_reduce();
+	test_median();
+	test_batch();
+	return nw_test::result();
+}